@@ -0,0 +1,65 @@
+#!/bin/sh
+#
+# bench.sh - Run fixed scenarios against serbert's loopback emulator
+#
+# Usage: bench.sh [SERBERT]
+#
+# Each scenario tests the same number of bytes over the emulator's pseudo
+# terminal or stand-in device server, or the memory loopback, and reports
+# the bytes tested a second, the CPU time the test loop used for each byte
+# and the port system calls made for each byte.
+# Compare the table before and after a change to the test loop or I/O path.
+#
+# Copyright (C) 2026 The Serbert contributors
+#
+# This file is part of Serbert.
+#
+# Serbert is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 2 of the License, or
+# any later version.
+
+SERBERT=${1:-./serbert}
+
+BYTES=${BENCH_BYTES:-50000}
+
+STATUS=0
+
+printf "%-20s %14s %14s %14s\n" "Scenario" "Bytes/s" "us CPU/byte" \
+  "Syscalls/byte"
+
+# Name, port and emulator settings for each scenario
+while read -r NAME PORT SETTINGS
+do
+
+  if [ "$SETTINGS" = "-" ]
+  then
+    SETTINGS=""
+  else
+    SETTINGS="-E $SETTINGS"
+  fi
+
+  # shellcheck disable=SC2086
+  LINE=$("$SERBERT" "$PORT" -n "$BYTES" -q $SETTINGS </dev/null 2>/dev/null |
+    grep "^Benchmark:")
+
+  if [ -z "$LINE" ]
+  then
+    printf "%-20s %14s\n" "$NAME" "failed"
+    STATUS=1
+  else
+    echo "$LINE" | sed 's/[:,]/ /g' |
+      awk -v name="$NAME" '{ printf "%-20s %14s %14s %14s\n", name, $2, $4, $9 }'
+  fi
+
+done <<SCENARIOS
+memory memory -
+echo emulator -
+delay-100us emulator 100
+paced-57600 emulator 0,5760
+chunks-16 emulator 0,0,16
+tcp tcp:emulator -
+rfc2217 rfc2217:emulator -
+SCENARIOS
+
+exit $STATUS
@@ -0,0 +1,77 @@
+#!/bin/sh
+#
+# check-faults.sh - Check the errors counted for faults injected from a seed
+#
+# Usage: check-faults.sh [SERBERT]
+#
+# Injects faults from fixed seeds with the loopback emulator, over its pseudo
+# terminal, and on the simulated line, and checks the faults injected and the
+# errors counted are exactly those the seed gives. serbert fails a run whose
+# errors don't match its own count of the faults; this also catches a change
+# to which faults are injected, or to how both sides count them. Run by
+# make check.
+#
+# Copyright (C) 2026 The Serbert contributors
+#
+# This file is part of Serbert.
+#
+# Serbert is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 2 of the License, or
+# any later version.
+
+SERBERT=${1:-./serbert}
+
+STATUS=0
+
+# Run serbert and check its results, without the run time, which on the
+# emulator is real time, and the faults it injected
+# Usage: check NAME RESULTS FAULTS PORT [SETTINGS...]
+check()
+{
+
+  NAME=$1
+  RESULTS=$2
+  FAULTS=$3
+  shift 3
+
+  OUT=$("$SERBERT" "$@" -q </dev/null 2>/dev/null)
+
+  EXIT=$?
+
+  GOT=$(echo "$OUT" | grep "^ sent:" | sed 's/ run:.*//; s/[a-z]*://g' |
+    tr -s ' ' ',' | sed 's/^,//')
+
+  GOT_FAULTS=$(echo "$OUT" | sed -n 's/^Faults injected: //p' |
+    sed 's/ [a-z]*,* */,/g; s/,$//')
+
+  if [ "$EXIT" -ne 0 ] || [ "$GOT" != "$RESULTS" ] ||
+    [ "$GOT_FAULTS" != "$FAULTS" ]
+  then
+    echo "FAIL: $NAME: expected $RESULTS and faults $FAULTS," \
+      "got $GOT and faults $GOT_FAULTS, exit $EXIT"
+    STATUS=1
+  else
+    echo "PASS: $NAME"
+  fi
+
+}
+
+# Sent, errors, timeouts and corrupt bytes, then flipped, dropped,
+# duplicated, late, framing, parity and break faults
+check emulator 3000,25,6,19 5,6,3,5,2,6,6 \
+  emulator -n 3000 -I 0.01 -R 5
+
+check emulator-bursts 2000,70,5,65 40,5,15,10,15,5,5 \
+  emulator -n 2000 -I 0.01,5 -R 11
+
+check simulate 20k,154,36,118 29,36,20,23,34,28,27 \
+  simulate -n 20000 -I 0.01 -R 5
+
+check simulate-flips 20k,199,0,199 199,0,0,0,0,0,0 \
+  simulate -n 20000 -I 0.01,1,b -R 5
+
+check simulate-bursts 20k,987,198,789 186,198,165,0,186,210,207 \
+  simulate -n 20000 -I 0.02,3,bdufpk -R 42
+
+exit $STATUS
@@ -0,0 +1,78 @@
+#!/bin/sh
+#
+# check-net.sh - Check testing ports over TCP and RFC 2217
+#
+# Usage: check-net.sh [SERBERT]
+#
+# Tests through the loopback emulator as a stand-in device server, over raw
+# TCP and over RFC 2217, and checks every byte sent comes back. Telnet's IAC
+# byte, FF hex, is sent alone and among the rest, so it must be escaped and
+# decoded; the line settings are sent with a baud rate; and faults injected
+# from a fixed seed must give exactly the errors expected, which needs the
+# purge after each byte to work. Run by make check.
+#
+# Copyright (C) 2026 The Serbert contributors
+#
+# This file is part of Serbert.
+#
+# Serbert is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 2 of the License, or
+# any later version.
+
+SERBERT=${1:-./serbert}
+
+STATUS=0
+
+# Run serbert and check its results, without the run time, and the faults
+# it injected, if any
+# Usage: check NAME RESULTS FAULTS PORT [SETTINGS...]
+check()
+{
+
+  NAME=$1
+  RESULTS=$2
+  FAULTS=$3
+  shift 3
+
+  OUT=$("$SERBERT" "$@" -q </dev/null 2>/dev/null)
+
+  EXIT=$?
+
+  GOT=$(echo "$OUT" | grep "^ sent:" | sed 's/ run:.*//; s/[a-z]*://g' |
+    tr -s ' ' ',' | sed 's/^,//')
+
+  GOT_FAULTS=$(echo "$OUT" | sed -n 's/^Faults injected: //p' |
+    sed 's/ [a-z]*,* */,/g; s/,$//')
+
+  if [ "$EXIT" -ne 0 ] || [ "$GOT" != "$RESULTS" ] ||
+    [ "$GOT_FAULTS" != "$FAULTS" ]
+  then
+    echo "FAIL: $NAME: expected $RESULTS and faults $FAULTS," \
+      "got $GOT and faults $GOT_FAULTS, exit $EXIT"
+    STATUS=1
+  else
+    echo "PASS: $NAME"
+  fi
+
+}
+
+# Sent, errors, timeouts and corrupt bytes, then flipped, dropped,
+# duplicated, late, framing, parity and break faults
+check tcp 2048,0,0,0 "" tcp:emulator -n 2048
+
+check tcp-ff 1024,0,0,0 "" tcp:emulator -n 1024 -s FF
+
+check rfc2217 2048,0,0,0 "" rfc2217:emulator -n 2048 -b 9600
+
+check rfc2217-ff 1024,0,0,0 "" rfc2217:emulator -n 1024 -s FF
+
+check rfc2217-random 2048,0,0,0 "" rfc2217:emulator -n 2048 -r -R 9
+
+check tcp-faults 3000,15,6,9 9,6,5,9,0,0,0 \
+  tcp:emulator -n 3000 -I 0.01 -R 5
+
+check rfc2217-faults 3000,15,6,9 9,6,5,9,0,0,0 \
+  rfc2217:emulator -n 3000 -I 0.01 -R 5
+
+exit $STATUS
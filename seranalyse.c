@@ -0,0 +1,850 @@
+/*****************************************************************************/
+/*                                                                           */
+/* Module: seranalyse.c                                                      */
+/*                                                                           */
+/* Description: serbert-analyse, analyses a capture using many threads       */
+/*                                                                           */
+/* Copyright (C) 2026 The Serbert contributors                               */
+/*                                                                           */
+/* This file is part of Serbert.                                             */
+/*                                                                           */
+/* Serbert is free software; you can redistribute it and/or modify           */
+/* it under the terms of the GNU General Public License as published by      */
+/* the Free Software Foundation; either version 2 of the License, or         */
+/* any later version.                                                        */
+/*                                                                           */
+/* This program is distributed in the hope that it will be useful,           */
+/* but WITHOUT ANY WARRANTY; without even the implied warranty of            */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             */
+/* GNU General Public License for more details.                              */
+/*                                                                           */
+/* You should have received a copy of the GNU General Public License         */
+/* along with this program; if not, write to the Free Software               */
+/* Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA */
+/*                                                                           */
+/*****************************************************************************/
+
+/*****************************************************************************/
+/*      INCLUDED FILES (dependencies)                                        */
+/*****************************************************************************/
+
+#include <stdio.h>       /* Standard I/O definitions - printf()            */
+#include <stdlib.h>      /* Standard library - calloc(), strtoul()         */
+#include <string.h>      /* Standard string lib - strcmp()                 */
+#include <stdbool.h>     /* Boolean types                                  */
+#include <stdint.h>      /* Fixed size types - uint32_t                    */
+#include <fcntl.h>       /* File control - open()                          */
+#include <unistd.h>      /* UNIX standard - sysconf(), close()             */
+#include <pthread.h>     /* POSIX threads - pthread_create()               */
+#include <sys/mman.h>    /* Memory mapping - mmap()                        */
+#include <sys/stat.h>    /* File status - fstat()                          */
+#include "sers.h"        /* Serial statistics library                      */
+#include "serc.h"        /* Capture file library                           */
+
+
+/*****************************************************************************/
+/*      INTERNAL TYPE DEFINITIONS                                            */
+/*****************************************************************************/
+
+/* Enums & constants */
+
+enum { i_EXIT_OK = 0 };              /* Exit status, all well                */
+
+enum { i_EXIT_FAULT = 1 };           /* Exit status, a fault                 */
+
+enum { i_MAX_THREADS = 256 };        /* Most threads that can be asked for   */
+
+/* Types */
+
+/* The part of a capture one thread analyses, and what it found */
+typedef struct i_part_t
+{
+  pthread_t thread;                  /* Thread analysing it                  */
+  const uint8_t *map;                /* The capture, mapped                  */
+  size_t map_len;                    /* Length of the mapping                */
+  const serc_capture_t *capture;     /* The capture's header and index       */
+  size_t first_block;                /* First block of the part              */
+  size_t end_block;                  /* Block after the last                 */
+  long long first_sec;               /* Second of its first sample           */
+  size_t secs;                       /* Seconds it covers                    */
+  uint32_t *sec_bytes;               /* Bytes tested in each second          */
+  uint32_t *sec_errors;              /* Errored bytes in each second         */
+  unsigned long long kinds[SERC_KINDS];
+                                     /* Bytes of each kind                   */
+  sers_hist_t latency;               /* Return times of good bytes           */
+  sers_bits_t bits;                  /* Errors by bit and byte value         */
+  sers_tod_t tod;                    /* Errors by local time of day          */
+  bool failed;                       /* Was a block not decoded?             */
+} i_part_t;
+
+
+/*****************************************************************************/
+/*      INTERNAL VARIABLE DEFINITIONS                                        */
+/*****************************************************************************/
+
+/* Names of the kinds of sample */
+static const char *i_KIND_NAMES[SERC_KINDS] =
+  { "Good", "Corrupt", "Timed out", "Framing errors" };
+
+
+/*****************************************************************************/
+/*      INTERNAL FUNCTIONS                                                   */
+/*****************************************************************************/
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: i_add_sample()                                                      */
+/*                                                                           */
+/* Description: Adds a sample to what a thread has found                     */
+/*                                                                           */
+/* Uses: sample - The sample                                                 */
+/*       context - The thread's part                                         */
+/*                                                                           */
+/* Returns: void                                                             */
+/*                                                                           */
+/*****************************************************************************/
+
+static void i_add_sample(const serc_sample_t *sample, void *context)
+{
+
+  i_part_t *part = (i_part_t *) context;  /* The thread's part          */
+  long long sec;                          /* Second of the part it's in */
+
+
+  part->kinds[sample->kind]++;
+
+  sec = (sample->time / SERS_NSEC_IN_SEC) - part->first_sec;
+
+  if( (sec >= 0) && ( (size_t) sec < part->secs) )
+  {
+
+    part->sec_bytes[sec]++;
+
+    if(sample->kind != SERC_BYTE_OK)
+    {
+
+      part->sec_errors[sec]++;
+
+    }
+
+  }
+
+  if(sample->return_time >= 0)
+  {
+
+    sers_hist_add(&part->latency, (unsigned long long) sample->return_time);
+
+  }
+
+  if(sample->kind != SERC_BYTE_OK)
+  {
+
+    part->bits.errors[sample->tx]++;
+
+  }
+
+  sers_tod_add(&part->tod,
+    (long long) part->capture->header.start_time + sample->time,
+    sample->kind != SERC_BYTE_OK, sample->kind == SERC_BYTE_TIMEOUT);
+
+  if(sample->kind == SERC_BYTE_CORRUPT)
+  {
+
+    sers_bits_corrupt(&part->bits, (unsigned char) sample->tx,
+      (unsigned char) sample->rx, false);
+
+  }
+  else if(sample->kind == SERC_BYTE_FRAMING)
+  {
+
+    sers_bits_corrupt(&part->bits, (unsigned char) sample->tx,
+      (unsigned char) sample->rx, true);
+
+  }
+
+}
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: i_analyse_part()                                                    */
+/*                                                                           */
+/* Description: Thread decoding the blocks of one part of a capture          */
+/*                                                                           */
+/* Uses: arg - The part                                                      */
+/*                                                                           */
+/* Returns: NULL                                                             */
+/*                                                                           */
+/*****************************************************************************/
+
+static void *i_analyse_part(void *arg)
+{
+
+  i_part_t *part = (i_part_t *) arg;      /* The part             */
+  const serc_index_t *entry;              /* Block's index entry  */
+  size_t block;                           /* Block being decoded  */
+
+
+  for(block = part->first_block; (block < part->end_block)
+    && (part->failed == false); block++)
+  {
+
+    entry = &part->capture->index[block];
+
+    if( (entry->offset >= part->map_len)
+      || (serc_decode_block(part->map + entry->offset,
+      part->map_len - (size_t) entry->offset,
+      part->capture->header.tick_ns, i_add_sample, part) != SERC_OK) )
+    {
+
+      part->failed = true;
+
+    }
+
+  }
+
+  return NULL;
+
+}
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: i_init_part()                                                       */
+/*                                                                           */
+/* Description: Sets up a part of a capture for a thread                     */
+/*                                                                           */
+/* Uses: part - The part                                                     */
+/*       capture - The capture                                               */
+/*       first_block - First block of the part                               */
+/*       end_block - Block after the last                                    */
+/*                                                                           */
+/* Returns: true if it was set up, false if out of memory                    */
+/*                                                                           */
+/*****************************************************************************/
+
+static bool i_init_part(i_part_t *part, const serc_capture_t *capture,
+  size_t first_block, size_t end_block)
+{
+
+  long long tick;                         /* Nanoseconds in a tick */
+  long long last_sec;                     /* Second of the last sample */
+
+
+  tick = (long long) capture->header.tick_ns;
+
+  part->capture = capture;
+
+  part->first_block = first_block;
+
+  part->end_block = end_block;
+
+  part->first_sec = (capture->index[first_block].first_time * tick)
+    / SERS_NSEC_IN_SEC;
+
+  last_sec = (capture->index[end_block - 1].last_time * tick)
+    / SERS_NSEC_IN_SEC;
+
+  part->secs = (last_sec >= part->first_sec)
+    ? (size_t) (last_sec - part->first_sec + 1) : 1;
+
+  part->sec_bytes = calloc(part->secs, sizeof(uint32_t) );
+
+  part->sec_errors = calloc(part->secs, sizeof(uint32_t) );
+
+  memset(part->kinds, 0, sizeof(part->kinds) );
+
+  sers_hist_init(&part->latency);
+
+  sers_bits_init(&part->bits);
+
+  sers_tod_init(&part->tod);
+
+  part->failed = false;
+
+  return (part->sec_bytes != NULL) && (part->sec_errors != NULL);
+
+}
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: i_print_latency()                                                   */
+/*                                                                           */
+/* Description: Prints percentiles of the return times                       */
+/*                                                                           */
+/* Uses: latency - Return times of good bytes                                */
+/*                                                                           */
+/* Returns: void                                                             */
+/*                                                                           */
+/*****************************************************************************/
+
+static void i_print_latency(const sers_hist_t *latency)
+{
+
+  if(latency->samples > 0)
+  {
+
+    printf("Return time us: p50 %llu p90 %llu p99 %llu p99.9 %llu max %llu\n",
+      sers_hist_percentile(latency, 50.0) / SERS_NSEC_IN_USEC,
+      sers_hist_percentile(latency, 90.0) / SERS_NSEC_IN_USEC,
+      sers_hist_percentile(latency, 99.0) / SERS_NSEC_IN_USEC,
+      sers_hist_percentile(latency, 99.9) / SERS_NSEC_IN_USEC,
+      latency->max / SERS_NSEC_IN_USEC);
+
+  }
+
+}
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: i_print_g821()                                                      */
+/*                                                                           */
+/* Description: Prints the G.821 error performance, worked out from the      */
+/*              bytes and errors of each second                              */
+/*                                                                           */
+/* Uses: sec_bytes - Bytes tested in each second from the start              */
+/*       sec_errors - Errored bytes in each second                           */
+/*       secs - Seconds covered                                              */
+/*                                                                           */
+/* Returns: void                                                             */
+/*                                                                           */
+/*****************************************************************************/
+
+static void i_print_g821(const uint32_t *sec_bytes,
+  const uint32_t *sec_errors, size_t secs)
+{
+
+  sers_g821_t g821;                       /* The G.821 measurements */
+  unsigned long long total;               /* Seconds measured */
+  size_t sec;                             /* Second being added */
+
+
+  sers_g821_init(&g821);
+
+  for(sec = 0; sec < secs; sec++)
+  {
+
+    sers_g821_add_second(&g821, (long long) sec, sec_bytes[sec],
+      sec_errors[sec]);
+
+  }
+
+  sers_g821_close(&g821);
+
+  total = g821.avail_secs + g821.unavail_secs;
+
+  printf("G.821 seconds measured: %llu\n", total);
+
+  printf("Available seconds: %llu\n", g821.avail_secs);
+
+  printf("Unavailable seconds: %llu\n", g821.unavail_secs);
+
+  if(g821.avail_secs > 0)
+  {
+
+    printf("Errored seconds (ES): %llu (%.3f%%)\n", g821.errored_secs,
+      ( (double) g821.errored_secs * 100.0) / (double) g821.avail_secs);
+
+    printf("Severely errored seconds (SES): %llu (%.3f%%)\n",
+      g821.severe_secs,
+      ( (double) g821.severe_secs * 100.0) / (double) g821.avail_secs);
+
+    printf("Error free seconds (EFS): %llu (%.3f%%)\n", g821.free_secs,
+      ( (double) g821.free_secs * 100.0) / (double) g821.avail_secs);
+
+  }
+
+  printf("Outages: %llu, longest %llu secs\n", g821.outages,
+    g821.longest_outage);
+
+}
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: i_print_bits()                                                      */
+/*                                                                           */
+/* Description: Prints the errors by bit position and by byte value sent     */
+/*                                                                           */
+/* Uses: bits - Errors by bit and byte value                                 */
+/*                                                                           */
+/* Returns: void                                                             */
+/*                                                                           */
+/*****************************************************************************/
+
+static void i_print_bits(const sers_bits_t *bits)
+{
+
+  unsigned int pos;                       /* Bit position or byte value */
+
+
+  printf("Bit errors by position (0 = LSB):");
+
+  for(pos = 0; pos < (unsigned int) SERS_DATA_BITS; pos++)
+  {
+
+    printf(" %llu", bits->flips[pos]);
+
+  }
+
+  printf(", stop/parity %llu\n", bits->flips[SERS_BIT_STOP]);
+
+  printf("Bits sent as 0 received as 1: %llu\n", bits->rises);
+
+  printf("Bits sent as 1 received as 0: %llu\n", bits->falls);
+
+  printf("Errors by byte sent:");
+
+  for(pos = 0; pos < (unsigned int) SERS_BYTE_VALUES; pos++)
+  {
+
+    if(bits->errors[pos] > 0)
+    {
+
+      printf("\n  %02x : %llu", pos, bits->errors[pos]);
+
+    }
+
+  }
+
+  printf("\n");
+
+}
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: i_report()                                                          */
+/*                                                                           */
+/* Description: Merges what the threads found and prints it                  */
+/*                                                                           */
+/* Uses: capture - The capture                                               */
+/*       parts - The threads' parts                                          */
+/*       threads - Number of parts                                           */
+/*                                                                           */
+/* Returns: Exit status                                                      */
+/*                                                                           */
+/*****************************************************************************/
+
+static int i_report(const serc_capture_t *capture, const i_part_t *parts,
+  unsigned int threads)
+{
+
+  int exit_status = i_EXIT_OK;            /* Exit status */
+  unsigned long long kinds[SERC_KINDS];   /* Bytes of each kind */
+  unsigned long long bytes = 0;           /* Bytes in the capture */
+  sers_hist_t latency;                    /* Return times of good bytes */
+  sers_bits_t bits;                       /* Errors by bit and byte value */
+  sers_tod_t tod;                         /* Errors by local time of day */
+  uint32_t *sec_bytes;                    /* Bytes in each second */
+  uint32_t *sec_errors;                   /* Errors in each second */
+  size_t secs;                            /* Seconds covered */
+  size_t sec;                             /* Second being merged */
+  size_t offset;                          /* Where a part's seconds go */
+  unsigned int part;                      /* Part being merged */
+  unsigned int kind;                      /* Kind being merged */
+  char port[SERC_PORT_LEN];               /* The port, terminated */
+
+
+  memset(kinds, 0, sizeof(kinds) );
+
+  sers_hist_init(&latency);
+
+  sers_bits_init(&bits);
+
+  sers_tod_init(&tod);
+
+  secs = (size_t) parts[threads - 1].first_sec + parts[threads - 1].secs;
+
+  sec_bytes = calloc(secs, sizeof(uint32_t) );
+
+  sec_errors = calloc(secs, sizeof(uint32_t) );
+
+  if( (sec_bytes == NULL) || (sec_errors == NULL) )
+  {
+
+    fprintf(stderr, "Out of memory\n");
+
+    exit_status = i_EXIT_FAULT;
+
+  }
+  else
+  {
+
+    for(part = 0; part < threads; part++)
+    {
+
+      for(kind = 0; kind < (unsigned int) SERC_KINDS; kind++)
+      {
+
+        kinds[kind] += parts[part].kinds[kind];
+
+        bytes += parts[part].kinds[kind];
+
+      }
+
+      sers_hist_merge(&latency, &parts[part].latency);
+
+      sers_bits_merge(&bits, &parts[part].bits);
+
+      sers_tod_merge(&tod, &parts[part].tod);
+
+      /* Neighbouring parts can share a second */
+      offset = (size_t) parts[part].first_sec;
+
+      for(sec = 0; sec < parts[part].secs; sec++)
+      {
+
+        sec_bytes[offset + sec] += parts[part].sec_bytes[sec];
+
+        sec_errors[offset + sec] += parts[part].sec_errors[sec];
+
+      }
+
+    }
+
+    memcpy(port, capture->header.port, sizeof(port) );
+
+    port[sizeof(port) - 1] = '\0';
+
+    printf("Capture of %s at %lu baud, %lu secs\n", port,
+      (unsigned long) capture->header.baud, (unsigned long) secs);
+
+    printf("Bytes: %llu\n", bytes);
+
+    for(kind = 0; kind < (unsigned int) SERC_KINDS; kind++)
+    {
+
+      printf("%s: %llu\n", i_KIND_NAMES[kind], kinds[kind]);
+
+    }
+
+    i_print_latency(&latency);
+
+    i_print_g821(sec_bytes, sec_errors, secs);
+
+    i_print_bits(&bits);
+
+    sers_tod_print(&tod);
+
+    printf("\n");
+
+  }
+
+  free(sec_bytes);
+
+  free(sec_errors);
+
+  return exit_status;
+
+}
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: i_analyse()                                                         */
+/*                                                                           */
+/* Description: Analyses a capture. It is mapped into memory and its blocks  */
+/*              split into as many runs of time as there are threads, each   */
+/*              decoded by its own thread, then what they found is merged.   */
+/*                                                                           */
+/* Uses: path - The capture file                                             */
+/*       threads - Threads to use                                            */
+/*                                                                           */
+/* Returns: Exit status                                                      */
+/*                                                                           */
+/*****************************************************************************/
+
+static int i_analyse(const char *path, unsigned int threads)
+{
+
+  int exit_status = i_EXIT_OK;            /* Exit status */
+  serc_capture_t capture;                 /* The capture */
+  serc_status_t load_status;              /* Was it loaded? */
+  i_part_t *parts = NULL;                 /* The threads' parts */
+  unsigned int started = 0;               /* Threads started */
+  unsigned int part;                      /* Part being set up */
+  void *map = MAP_FAILED;                 /* The capture, mapped */
+  struct stat file_stat;                  /* Its size */
+  int fd;                                 /* Its descriptor */
+
+
+  if( (load_status = serc_load(path, &capture) ) != SERC_OK)
+  {
+
+    serc_report_load(path, load_status, &capture);
+
+    exit_status = i_EXIT_FAULT;
+
+  }
+  else
+  {
+
+    fd = open(path, O_RDONLY);
+
+    if( (fd >= 0) && (fstat(fd, &file_stat) == 0) && (file_stat.st_size > 0) )
+    {
+
+      map = mmap(NULL, (size_t) file_stat.st_size, PROT_READ, MAP_PRIVATE,
+        fd, 0);
+
+    }
+
+    if(fd >= 0)
+    {
+
+      (void) close(fd);
+
+    }
+
+    threads = (capture.blocks < threads) ? (unsigned int) capture.blocks
+      : threads;
+
+    if(map == MAP_FAILED)
+    {
+
+      fprintf(stderr, "Failure mapping %s\n", path);
+
+      exit_status = i_EXIT_FAULT;
+
+    }
+    else if(threads == 0)
+    {
+
+      printf("Capture holds no bytes\n");
+
+    }
+    else
+    {
+
+      (void) madvise(map, (size_t) file_stat.st_size, MADV_SEQUENTIAL);
+
+      parts = calloc(threads, sizeof(i_part_t) );
+
+      if(parts == NULL)
+      {
+
+        exit_status = i_EXIT_FAULT;
+
+      }
+
+      for(part = 0; (part < threads) && (exit_status == i_EXIT_OK); part++)
+      {
+
+        parts[part].map = (const uint8_t *) map;
+
+        parts[part].map_len = (size_t) file_stat.st_size;
+
+        if(i_init_part(&parts[part], &capture,
+          (capture.blocks * part) / threads,
+          (capture.blocks * (part + 1) ) / threads) == false)
+        {
+
+          exit_status = i_EXIT_FAULT;
+
+        }
+
+      }
+
+      if(exit_status != i_EXIT_OK)
+      {
+
+        fprintf(stderr, "Out of memory\n");
+
+      }
+
+      for(part = 0; (part < threads) && (exit_status == i_EXIT_OK); part++)
+      {
+
+        if(pthread_create(&parts[part].thread, NULL, i_analyse_part,
+          &parts[part]) != 0)
+        {
+
+          fprintf(stderr, "Failure starting a thread\n");
+
+          exit_status = i_EXIT_FAULT;
+
+        }
+        else
+        {
+
+          started++;
+
+        }
+
+      }
+
+      for(part = 0; part < started; part++)
+      {
+
+        (void) pthread_join(parts[part].thread, NULL);
+
+        if( (parts[part].failed == true) && (exit_status == i_EXIT_OK) )
+        {
+
+          fprintf(stderr, "Failure decoding %s\n", path);
+
+          exit_status = i_EXIT_FAULT;
+
+        }
+
+      }
+
+      if(exit_status == i_EXIT_OK)
+      {
+
+        exit_status = i_report(&capture, parts, threads);
+
+      }
+
+      for(part = 0; (parts != NULL) && (part < threads); part++)
+      {
+
+        free(parts[part].sec_bytes);
+
+        free(parts[part].sec_errors);
+
+      }
+
+      free(parts);
+
+    }
+
+    if(map != MAP_FAILED)
+    {
+
+      (void) munmap(map, (size_t) file_stat.st_size);
+
+    }
+
+    serc_unload(&capture);
+
+  }
+
+  return exit_status;
+
+}
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: i_print_help()                                                      */
+/*                                                                           */
+/* Description: Prints the usage                                             */
+/*                                                                           */
+/* Uses: void                                                                */
+/*                                                                           */
+/* Returns: void                                                             */
+/*                                                                           */
+/*****************************************************************************/
+
+static void i_print_help(void)
+{
+
+  printf("\nUsage: serbert-analyse [-h] [-j THREADS] FILE\n\n");
+
+  printf("Analyses a capture made by serbert -L: bytes and errors by kind,\n");
+
+  printf("return time percentiles, G.821 performance, errors by bit and\n");
+
+  printf("byte value, and a heatmap of the error rate by local time\n\n");
+
+  printf(" -h - Print this help\n");
+
+  printf(" -j - Threads to use. 1 to %d, default one per CPU\n\n",
+    i_MAX_THREADS);
+
+}
+
+
+/*****************************************************************************/
+/*      MAIN                                                                 */
+/*****************************************************************************/
+
+int main(int argc, char *argv[])
+{
+
+  int exit_status = i_EXIT_OK;            /* Exit status */
+  bool help = false;                      /* Only printing the help? */
+  const char *path = NULL;                /* The capture file */
+  unsigned long threads;                  /* Threads to use */
+  long cpus;                              /* CPUs online */
+  char *end_ptr;                          /* End of the thread count */
+  int arg_no;                             /* Argument being processed */
+
+
+  cpus = sysconf(_SC_NPROCESSORS_ONLN);
+
+  threads = (cpus < 1) ? 1 : (unsigned long) cpus;
+
+  threads = (threads > i_MAX_THREADS) ? i_MAX_THREADS : threads;
+
+  for(arg_no = 1; (arg_no < argc) && (exit_status == i_EXIT_OK)
+    && (help == false); arg_no++)
+  {
+
+    if(strcmp(argv[arg_no], "-h") == 0)
+    {
+
+      i_print_help();
+
+      help = true;
+
+    }
+    else if( (strcmp(argv[arg_no], "-j") == 0) && (arg_no + 1 < argc) )
+    {
+
+      arg_no++;
+
+      threads = strtoul(argv[arg_no], &end_ptr, 10);
+
+      if( (*end_ptr != '\0') || (threads < 1) || (threads > i_MAX_THREADS) )
+      {
+
+        fprintf(stderr, "Invalid thread count: %s\n", argv[arg_no]);
+
+        i_print_help();
+
+        exit_status = i_EXIT_FAULT;
+
+      }
+
+    }
+    else if( (argv[arg_no][0] == '-') || (path != NULL) )
+    {
+
+      fprintf(stderr, "Invalid argument: %s\n", argv[arg_no]);
+
+      i_print_help();
+
+      exit_status = i_EXIT_FAULT;
+
+    }
+    else
+    {
+
+      path = argv[arg_no];
+
+    }
+
+  }
+
+  if( (exit_status == i_EXIT_OK) && (help == false) )
+  {
+
+    if(path == NULL)
+    {
+
+      fprintf(stderr, "No capture file given\n");
+
+      i_print_help();
+
+      exit_status = i_EXIT_FAULT;
+
+    }
+    else
+    {
+
+      exit_status = i_analyse(path, (unsigned int) threads);
+
+    }
+
+  }
+
+  return exit_status;
+
+}
@@ -34,15 +34,28 @@
 #include <string.h>      /* String manipulation lib - strlen(), memmove()   */
 #include <stdlib.h>      /* Standard library - atoi(), strtoul(), rand()    */
 #include <ctype.h>       /* Character tests - isxdigit(), tolower()         */
-#include <time.h>        /* Time defs - time(), localtime(), strftime()     */
+#include <time.h>        /* Time defs - time()                              */
                          /* nanosleep()                                     */
 #include <sys/time.h>    /* Standard time definitions - timeval, timersub   */
+#include <sys/resource.h> /* Resource use - getrusage()                      */
 #include <limits.h>      /* Variable max sizes - ULONG_MAX                  */
 #include <stdbool.h>     /* Boolean types                                   */
 #include <fcntl.h>       /* Fcntl types - fcntl()                           */
 #include <errno.h>       /* Provides errno                                  */
 #include <math.h>        /* Provides HUGE_VAL                               */
+#include <unistd.h>      /* POSIX definitions - getpid()                    */
 #include "serp.h"        /* Serial utilities library                        */
+#include "sers.h"        /* Serial statistics library                       */
+#include "serr.h"        /* Serial error reporting library                  */
+#include "seri.h"        /* Interval snapshot library                       */
+#include "sero.h"        /* Machine readable output library                 */
+#include "serm.h"        /* Prometheus metrics library                      */
+#include "serg.h"        /* Shared memory statistics library                */
+#include "serf.h"        /* Flight recorder library                         */
+#include "serc.h"        /* Capture file library                            */
+#include "sere.h"        /* Loopback emulator library                       */
+#include "serd.h"        /* Static trace probes                             */
+#include "serh.h"        /* Host tuning library                             */
 #include "serbert_config.h"
                          /* Compile time configuration options for Serbert  */
 
@@ -52,12 +65,21 @@
 /*****************************************************************************/
 
 /*****************************************************************************/
-/*  Name:                                                                    */
-/*  Description:                                                             */
+/*  Name: i_HOT                                                              */
+/*  Description: Marks a function on the path of every byte. It's inlined    */
+/*               into each variant of the send and receive, so the flags it  */
+/*               is given are constants there and their tests compile away.  */
 /*  Parameters:                                                              */
-/*  Client functions:                                                        */
+/*  Client functions: i_write_serial(), i_wait_for_write(), i_read_serial(), */
+/*                    i_wait_for_read(), i_send_n_receive()                  */
 /*****************************************************************************/
 
+#ifdef __GNUC__
+#define i_HOT inline __attribute__((always_inline))
+#else
+#define i_HOT inline
+#endif
+
 
 /*****************************************************************************/
 /*      INTERNAL TYPE DEFINITIONS                                            */
@@ -75,6 +97,9 @@ typedef arg_status_t (*i_pvf_arg_func_t)(char *);
 /* Pointer to function typedef used by i_argument_t */
 typedef arg_status_t (*i_pvf_func_t)();
 
+/* A variant of the send and receive of a byte, for a mode of the test */
+typedef void (*i_send_func_t)(void);
+
 /* Type for Binary or Decimal selection */
 typedef enum bin_not_dec_t {i_DEC, i_BIN} bin_not_dec_t;
 
@@ -136,7 +161,6 @@ enum { i_DEFAULT_WRITE_TIMEOUT = 50 };
 const bin_not_dec_t i_DEFAULT_BIN_NOT_DEC = i_DEC;
                              /* Default binary or decimal multiplier        */
 
-enum { i_TIM_STR_LEN = 50 }; /* Max length of any time strings              */
 
 enum { i_TIME_FAIL = -1 };   /* Time read failure state                     */
 
@@ -146,6 +170,18 @@ enum { i_EXIT_FAULT = 1 };   /* Flag fault on exit                          */
 
 enum { i_EXIT_OK = 0 };      /* Flag all went well on exit                  */
 
+enum { i_EXIT_TEST_FAILED = 2 };
+                             /* Flag the link failed its target on exit     */
+
+enum { i_MAX_TCP_PORT = 65535 };
+                             /* Highest TCP port number                     */
+
+enum { i_DEFAULT_RECORD_SECS = 1 };
+                             /* Default secs between output records         */
+
+static const double i_DEFAULT_CONFIDENCE = 95.0;
+                             /* Default confidence level for a target BER   */
+
 static const double i_ESCAPE_TIME = 0.1;
                              /* Chunks size to break up pauses              */
 
@@ -157,11 +193,43 @@ enum { i_CHARS_PER_LINE_HEX8 = i_TERMINAL_WIDTH / 3 };
 
 enum { i_STR_TERM = 0 };      /* String termination character               */
 
+enum { i_EMULATOR_VALUES = 3 };
+                             /* Values in the emulator argument             */
+
+enum { i_LATE_SHARE = 2 };   /* Late bytes are held for the timeout / this  */
+
+enum { i_USEC_IN_SEC = 1000000 };
+                             /* Microseconds in a second                     */
+
+enum { i_BITS_PER_BYTE = 10 };
+                             /* Bits on the line for a byte, with start and */
+                             /* stop bits, when simulating the baud rate    */
+
 /* String literals */
 
 /* Default serial port */
 static const char *i_VERSION = "Serbert version 0.3.1";
 
+/* Names of the rolling windows, in sers_roll_window_t order */
+static const char *i_WINDOW_NAMES[SERS_ROLL_WINDOWS] = { "1m", "15m", "1h" };
+
+/* Letters for the emulator's faults, in sere_fault_t order */
+static const char i_FAULT_CHARS[SERE_FAULTS + 1] = "bdulfpk";
+
+/* Names of the emulator's faults, in sere_fault_t order */
+static const char *i_FAULT_NAMES[SERE_FAULTS] =
+  { "flipped", "dropped", "duplicated", "late", "framing", "parity",
+    "break" };
+
+/* What failed tuning the host, in serh_status_t order */
+static const char *i_HOST_FAILURES[] =
+  { "", "running at real-time priority", "pinning to the CPU",
+    "locking memory", "setting the timer slack" };
+
+/* Names of the phases of sending and receiving a byte, for the stats */
+static const char *i_PHASE_NAMES[SERP_PHASES] =
+  { "wait write", "write", "wait read", "read", "flush", "clock", "keys" };
+
 /* Structs */
 
 /* Command line arguments parameters */
@@ -210,8 +278,6 @@ static time_t i_runtime;                      /* The time the test took      */
 
 static time_t i_intermediate_time;            /* When to show interm. results*/
 
-static time_t i_last_results;                 /* Last time interm. shown     */
-
 static bool i_user_set_timeout;               /* 'User has set timeout'flag  */
 
 static bool i_verbose;                        /* Verbose mode flag           */
@@ -250,6 +316,81 @@ static struct timeval i_delta_time_min;   /* The min byte turnround time     */
 
 static struct timeval i_delta_time_av;    /* The average byte turnround time */
 
+static sers_jitter_t i_jitter;            /* Byte turnround time jitter      */
+
+static sers_g821_t i_g821;                /* G.821 error performance         */
+
+static sers_burst_t i_bursts;             /* Error bursts and gaps           */
+
+static sers_roll_t i_roll;                /* Rolling windows of results      */
+
+static long long i_return_time;           /* Last byte's return time, in ns  */
+
+static sers_bits_t i_bits;                /* Errors by bit and byte value    */
+
+static sers_tod_t i_tod;                  /* Errors by local time of day     */
+
+static double i_target_ber;               /* Target BER to test, 0 if none   */
+
+static double i_confidence;               /* Confidence level for target, %  */
+
+static sers_ber_t i_ber;                  /* Progress against target BER     */
+
+static bool i_use_max_errors;             /* Stop when errors exceed a limit */
+
+static unsigned long long i_max_errors;   /* The errors allowed              */
+
+static bool i_stop_test;                  /* Test has reached a result       */
+
+static bool i_test_failed;                /* Link failed its target          */
+
+static bool i_output;                     /* Write machine readable records  */
+
+static char i_output_path[i_MAX_ARG_LEN + 1]; /* File to write them to     */
+
+static sero_format_t i_output_format;     /* Format to write them in         */
+
+static bool i_metrics;                    /* Serve Prometheus metrics        */
+
+static char i_metrics_address[i_MAX_ARG_LEN + 1]; /* Where to serve them   */
+
+static bool i_shared;                     /* Publish in shared memory        */
+
+static bool i_flight;                     /* Keep a flight record            */
+
+static char i_flight_path[i_MAX_ARG_LEN + 1]; /* File to keep it in        */
+
+static bool i_capture;                    /* Capture every byte              */
+
+static char i_capture_path[i_MAX_ARG_LEN + 1]; /* File to capture to      */
+
+static bool i_emulate;                    /* Test the loopback emulator      */
+
+static bool i_simulate;                   /* Simulate the line, in virtual   */
+                                          /* time                            */
+
+static bool i_benchmark;                  /* Measure the cost of each byte   */
+
+static sere_setup_t i_emulator;           /* How the emulator echoes         */
+
+static serh_setup_t i_host;               /* How to tune the host            */
+
+static char i_emulator_port[i_MAX_ARG_LEN + 1]; /* Its pseudo terminal    */
+
+static long long i_bench_time;            /* Test start, monotonic ns        */
+
+static long long i_bench_cpu;             /* CPU used by then, ns            */
+
+static unsigned long long i_bench_syscalls; /* Port system calls by then   */
+
+static unsigned long long i_phase_syscalls; /* Port system calls at start  */
+
+static struct rusage i_phase_usage;       /* Resources used at the start     */
+
+static int i_rx_byte;                     /* Byte received, or SERF_NO_RX    */
+
+static unsigned int i_rx_flags;           /* How it was received, SERF_...   */
+
 
 /*****************************************************************************/
 /*      INTERNAL FUNCTION DEFINITIONS                                        */
@@ -381,44 +522,6 @@ static void i_print_big_num(unsigned long long number,
 }
 
 
-/*****************************************************************************/
-/*                                                                           */
-/* Name: i_print_date_n_time()                                               */
-/*                                                                           */
-/* Description: Print out the current time and date                          */
-/*                                                                           */
-/* Uses: void                                                                */
-/*                                                                           */
-/* Returns: void                                                             */
-/*                                                                           */
-/*****************************************************************************/
-
-static void i_print_date_n_time(void)
-{
-
-  time_t time_data;             /* Data from time()            */
-  struct tm *time_struct;       /* Data structure holding time */
-  char time_str[i_TIM_STR_LEN]; /* Buffer for time string      */
-
-
-  /* Get current time */
-  time_data = time(NULL);
-
-  /* Was time obtained successfully */
-  if(time_data != i_TIME_FAIL)
-  {
-
-    time_struct = localtime(&time_data);
-
-    (void) strftime(time_str, i_TIM_STR_LEN, "%Y-%m-%d %H:%M:%S", time_struct);
-
-    printf("%s - ", time_str);
-
-  }
-
-}
-
-
 /*****************************************************************************/
 /*                                                                           */
 /* Name: i_print_time()                                                      */
@@ -490,6 +593,33 @@ static void i_print_runtime(void)
 }
 
 
+/*****************************************************************************/
+/*                                                                           */
+/* Name: i_get_time()                                                        */
+/*                                                                           */
+/* Description: Read the time on the port's clock, which is virtual when     */
+/*              the line is simulated                                        */
+/*                                                                           */
+/* Uses: void                                                                */
+/*                                                                           */
+/* Returns: The time in seconds, or i_TIME_FAIL                              */
+/*                                                                           */
+/*****************************************************************************/
+
+static time_t i_get_time(void)
+{
+
+  struct timeval now;       /* The time now    */
+  time_t time_now;          /* ... in seconds  */
+
+
+  time_now = (serp_get_time(&now) == 0) ? now.tv_sec : (time_t) i_TIME_FAIL;
+
+  return time_now;
+
+}
+
+
 /*****************************************************************************/
 /*                                                                           */
 /* Name: i_get_runtime()                                                     */
@@ -509,7 +639,7 @@ static time_t i_get_runtime(void)
   time_t runtime = 0;       /* Length of time the test has run in seconds */
 
 
-  time_now = time(NULL);
+  time_now = i_get_time();
 
   /* Calculate runtime */
   if( (i_start_time == i_TIME_FAIL) || (time_now == i_TIME_FAIL) )
@@ -535,86 +665,100 @@ static time_t i_get_runtime(void)
 
 /*****************************************************************************/
 /*                                                                           */
-/* Name: i_report_stats()                                                    */
+/* Name: i_timeval_to_ns()                                                   */
 /*                                                                           */
-/* Description: Report the test stats                                        */
+/* Description: Convert a timeval into nanoseconds                           */
 /*                                                                           */
-/* Uses: void                                                                */
+/* Uses: time_val - The time to convert                                      */
 /*                                                                           */
-/* Returns: void                                                             */
+/* Returns: The time in nanoseconds                                          */
 /*                                                                           */
 /*****************************************************************************/
 
-static void i_report_stats(void)
+static long long i_timeval_to_ns(struct timeval time_val)
 {
 
-  if (i_show_stats == true)
-  {
+  return ( (long long) time_val.tv_sec * SERS_NSEC_IN_SEC) +
+    ( (long long) time_val.tv_usec * SERS_NSEC_IN_USEC);
 
-    printf("\nMin return time = %ld.%06ld\n", (long) i_delta_time_min.tv_sec,
-           (long) i_delta_time_min.tv_usec);
+}
 
-    printf("Max return time = %ld.%06ld\n", (long) i_delta_time_max.tv_sec,
-           (long) i_delta_time_max.tv_usec);
 
-    printf("Average return time = %ld.%06ld", (long) i_delta_time_av.tv_sec,
-           (long) i_delta_time_av.tv_usec);
+/*****************************************************************************/
+/*                                                                           */
+/* Name: i_print_ns()                                                        */
+/*                                                                           */
+/* Description: Print a time given in nanoseconds as seconds                 */
+/*                                                                           */
+/* Uses: time_ns - The time to print                                         */
+/*                                                                           */
+/* Returns: void                                                             */
+/*                                                                           */
+/*****************************************************************************/
 
-  }
+static void i_print_ns(long long time_ns)
+{
+
+  printf("%lld.%09lld", time_ns / SERS_NSEC_IN_SEC,
+    time_ns % SERS_NSEC_IN_SEC);
 
 }
 
 
 /*****************************************************************************/
 /*                                                                           */
-/* Name: i_report_results()                                                  */
+/* Name: i_print_hist()                                                      */
 /*                                                                           */
-/* Description: Report how the test went                                     */
+/* Description: Print out the non-empty buckets of a histogram               */
 /*                                                                           */
-/* Uses: void                                                                */
+/* Uses: hist    - The histogram to print                                    */
+/*       is_time - Does the histogram hold times rather than counts?         */
 /*                                                                           */
 /* Returns: void                                                             */
 /*                                                                           */
 /*****************************************************************************/
 
-static void i_report_results(void)
+static void i_print_hist(const sers_hist_t *hist, bool is_time)
 {
 
-  printf(" sent:");
+  unsigned int bucket;  /* The current bucket */
 
-  i_print_big_num(i_bytes_sent, i_bin_not_dec);
 
-  printf(" errs:");
+  for(bucket = 0; bucket < (unsigned int) SERS_HIST_BUCKETS; bucket++)
+  {
 
-  i_print_big_num(i_num_errors, i_bin_not_dec);
+    if(hist->count[bucket] > 0)
+    {
 
-  printf(" timeouts:");
+      printf("\n  >= ");
 
-  i_print_big_num(i_num_timeouts, i_bin_not_dec);
+      if(is_time == true)
+      {
 
-  printf(" corrupt:");
+        i_print_ns( (long long) sers_hist_bucket_low(bucket) );
 
-  i_print_big_num(i_num_corrupts, i_bin_not_dec);
+      }
+      else
+      {
 
-  i_print_runtime();
+        printf("%llu", sers_hist_bucket_low(bucket) );
 
-  if (i_show_stats == true)
-  {
+      }
 
-    printf(" Av:%ld.%06ld", (long) i_delta_time_av.tv_sec,
-           (long) i_delta_time_av.tv_usec);
+      printf(" : %llu", hist->count[bucket]);
+
+    }
 
   }
-  
-  
+
 }
 
 
 /*****************************************************************************/
 /*                                                                           */
-/* Name: i_show_intermediate()                                               */
+/* Name: i_report_jitter()                                                   */
 /*                                                                           */
-/* Description: Show intermediate test results                               */
+/* Description: Report the return time jitter                                */
 /*                                                                           */
 /* Uses: void                                                                */
 /*                                                                           */
@@ -622,55 +766,36 @@ static void i_report_results(void)
 /*                                                                           */
 /*****************************************************************************/
 
-static void i_show_intermediate(void)
+static void i_report_jitter(void)
 {
 
-  time_t runtime = 0;       /* Length of time the test has run in seconds */
-
-
-  /* Have intermediate results been requested? */
-
-  if( (i_intermediate == true) || (i_i_pressed == true) )
-  {
-
-    runtime = i_get_runtime();
-
-    /* Did we get runtime ok? */
-    if(runtime != i_TIME_FAIL)
-    {
-
-      /* Are we ready to show results? */
-      if( (runtime >= (i_last_results + i_intermediate_time) )
-        || (i_i_pressed == true) )
-      {
+  /* Include the last part second in the peak-to-peak figures */
+  sers_jitter_close(&i_jitter);
 
-        i_runtime = runtime;
+  printf("\nJitter (RFC 3550) = ");
 
-        /* Show the intermediate results */
-        i_report_results();
+  i_print_ns(sers_jitter_get(&i_jitter) );
 
-        if(i_i_pressed == true)
-        {
+  printf("\nMax peak-to-peak jitter in 1 sec = ");
 
-          printf("\n");
+  i_print_ns(i_jitter.ptp_max);
 
-        }
-        else
-        {
+  /* Only show the histograms if there is something in them */
+  if(i_jitter.diff_hist.samples > 0)
+  {
 
-          printf("      \r");
+    printf("\nReturn time change between bytes:");
 
-        }
+    i_print_hist(&(i_jitter.diff_hist), true);
 
-        /* Note when we last displayed results */
-        i_last_results = runtime;
+  }
 
-        /* Reset 'i' pressed flag */
-        i_i_pressed = false;
+  if(i_jitter.ptp_hist.samples > 0)
+  {
 
-      }
+    printf("\nPeak-to-peak jitter per second:");
 
-    }
+    i_print_hist(&(i_jitter.ptp_hist), true);
 
   }
 
@@ -679,30 +804,27 @@ static void i_show_intermediate(void)
 
 /*****************************************************************************/
 /*                                                                           */
-/* Name: i_print_baud()                                                      */
+/* Name: i_print_secs_pc()                                                   */
 /*                                                                           */
-/* Description: Prints out the current baud rate                             */
+/* Description: Print a number of seconds and what percentage it is of a     */
+/*              total                                                        */
 /*                                                                           */
-/* Uses: baud_rate - The baud rate to be printed                             */
+/* Uses: secs  - The number of seconds                                       */
+/*       total - The total number of seconds                                 */
 /*                                                                           */
 /* Returns: void                                                             */
 /*                                                                           */
 /*****************************************************************************/
 
-static void i_print_baud(speed_t baud_rate)
+static void i_print_secs_pc(unsigned long long secs, unsigned long long total)
 {
 
-  serp_baud_str_t baud_str;               /* The baud rate as a string */
-  serp_baud_str_status_t baud_str_status; /* The 'get' status          */
-
-
-  /* Get the string for the baud rate */
-  baud_str_status = serp_get_baud_str(baud_rate, baud_str);
+  printf("%llu", secs);
 
-  if(baud_str_status != SERP_GET_BAUD_STR_FAIL)
+  if(total > 0)
   {
 
-    printf("%s", (char *) baud_str);
+    printf(" (%.3f%%)", ( (double) secs * 100.0) / (double) total);
 
   }
 
@@ -711,61 +833,63 @@ static void i_print_baud(speed_t baud_rate)
 
 /*****************************************************************************/
 /*                                                                           */
-/* Name: i_print_str()                                                       */
+/* Name: i_report_g821()                                                     */
 /*                                                                           */
-/* Description: Prints out the given string in a format for diagnostics.     */
+/* Description: Report the ITU-T G.821 error performance. Errored, severely  */
+/*              errored and error free seconds are only counted while the    */
+/*              link is available, so are given as a percentage of that.     */
 /*                                                                           */
-/* Uses: str_buf - The buffer for the string                                 */
-/*       str_len - The string length                                         */
+/* Uses: void                                                                */
 /*                                                                           */
 /* Returns: void                                                             */
 /*                                                                           */
 /*****************************************************************************/
 
-static void i_print_str(unsigned char str_buf[], unsigned int str_len)
+static void i_report_g821(void)
 {
 
-  unsigned int char_count = 0;          /* The loop count */
+  unsigned long long total;  /* Total seconds in the test */
 
 
-  if(str_len > i_CHARS_PER_LINE_HEX8 )
-  {
+  /* Count the last part second */
+  sers_g821_close(&i_g821);
 
-    printf("\n");
+  total = i_g821.avail_secs + i_g821.unavail_secs;
 
-  }
+  printf("\nG.821 seconds measured = %llu", total);
 
-  /* Loop round the string */
-  for(char_count = 0; char_count < str_len; char_count++)
-  {
+  printf("\nAvailable seconds = ");
 
-    printf("%02x", (unsigned int) str_buf[char_count]);
+  i_print_secs_pc(i_g821.avail_secs, total);
 
-    if( ( (char_count + 1) % i_CHARS_PER_LINE_HEX8) == 0)
-    {
+  printf("\nUnavailable seconds = ");
 
-      printf("\n");
+  i_print_secs_pc(i_g821.unavail_secs, total);
 
-    }
-    else
-    {
+  printf("\nErrored seconds (ES) = ");
 
-      printf(" ");
+  i_print_secs_pc(i_g821.errored_secs, i_g821.avail_secs);
 
-    }
+  printf("\nSeverely errored seconds (SES) = ");
 
-  }
+  i_print_secs_pc(i_g821.severe_secs, i_g821.avail_secs);
 
-  printf("\n");
+  printf("\nError free seconds (EFS) = ");
+
+  i_print_secs_pc(i_g821.free_secs, i_g821.avail_secs);
+
+  printf("\nOutages = %llu", i_g821.outages);
+
+  printf("\nLongest outage = %llu secs", i_g821.longest_outage);
 
 }
 
 
 /*****************************************************************************/
 /*                                                                           */
-/* Name: i_get_timeout()                                                     */
+/* Name: i_report_bursts()                                                   */
 /*                                                                           */
-/* Description: Calculates the timeout for the current baud rate             */
+/* Description: Report the lengths of error bursts and the gaps between them */
 /*                                                                           */
 /* Uses: void                                                                */
 /*                                                                           */
@@ -773,23 +897,37 @@ static void i_print_str(unsigned char str_buf[], unsigned int str_len)
 /*                                                                           */
 /*****************************************************************************/
 
-static void i_get_timeout(void)
+static void i_report_bursts(void)
 {
 
-  serp_timeout_t timeout; /* The timeout */
+  /* Include any burst still going when the test stopped */
+  sers_burst_close(&i_bursts);
 
+  printf("\nError bursts = %llu", i_bursts.len_bytes.samples);
 
-  if (i_user_set_timeout == false)
+  if(i_bursts.len_bytes.samples > 0)
   {
 
-    timeout = serp_get_timeout(i_baud_rate);
+    printf("\nBurst length in bytes:");
 
-    if(timeout != SERP_GET_TIMEOUT_FAIL)
-    {
+    i_print_hist(&(i_bursts.len_bytes), false);
 
-      i_read_timeout = timeout;
+    printf("\nBurst length in seconds:");
 
-    }
+    i_print_hist(&(i_bursts.len_time), true);
+
+  }
+
+  if(i_bursts.gap_bytes_hist.samples > 0)
+  {
+
+    printf("\nGap between bursts in bytes:");
+
+    i_print_hist(&(i_bursts.gap_bytes_hist), false);
+
+    printf("\nGap between bursts in seconds:");
+
+    i_print_hist(&(i_bursts.gap_time), true);
 
   }
 
@@ -798,64 +936,69 @@ static void i_get_timeout(void)
 
 /*****************************************************************************/
 /*                                                                           */
-/* Name: i_write_serial()                                                    */
+/* Name: i_report_bits()                                                     */
 /*                                                                           */
-/* Description: Write to the serial port                                     */
+/* Description: Report errors by bit position and direction, and the error   */
+/*              rate of each byte value sent which had errors                */
 /*                                                                           */
-/* Uses: send_buf - buffer for the bytes to send.                            */
+/* Uses: void                                                                */
 /*                                                                           */
 /* Returns: void                                                             */
 /*                                                                           */
 /*****************************************************************************/
 
-static void i_write_serial(unsigned char send_buf)
+static void i_report_bits(void)
 {
 
-  serp_tx_buf_t tx_buf; /* Struct for transmit byte & returned status */
+  unsigned int pos;            /* Bit position or byte value       */
+  unsigned long long flips;    /* Total data bits flipped          */
 
 
-  /* Put the byte to transmit in the TX buffer */
-  tx_buf.tx_byte = send_buf;
+  printf("\nBit errors by position (0 = LSB):");
 
-  /* Clear the status */
-  tx_buf.tx_status = 0;
+  for(pos = 0; pos < (unsigned int) SERS_DATA_BITS; pos++)
+  {
 
-  /* Set the file descriptor */
-  tx_buf.fd = i_fd;
+    printf("\n  bit %u : %llu", pos, i_bits.flips[pos]);
 
-  /* Write byte to serial port */
-  serp_write_port(&tx_buf, i_diags);
+  }
 
-  /* Did we transmit without problem */
-  if( (tx_buf.tx_status & SERP_WRITE_OK) > 0)
-  {
+  printf("\n  stop/parity : %llu", i_bits.flips[SERS_BIT_STOP]);
 
-    if( (tx_buf.tx_status & SERP_WRITE_TIME_FAIL) == 0)
-    {
+  printf("\nBits sent as 0 received as 1 = %llu", i_bits.rises);
 
-      /* Store away the transmit time */
-      i_tx_time.tv_sec = tx_buf.tx_time.tv_sec;
+  printf("\nBits sent as 1 received as 0 = %llu", i_bits.falls);
 
-      i_tx_time.tv_usec = tx_buf.tx_time.tv_usec;
+  flips = i_bits.rises + i_bits.falls;
 
-    }
-    else
-    {
+  /* Positive when bits tend to be received high, negative when low */
+  if(flips > 0)
+  {
 
-      /* Indicate time read failure */
-      i_tx_time.tv_sec = i_TIME_FAIL;
+    printf("\nBit error asymmetry = %+.1f%%",
+      ( ( (double) i_bits.rises - (double) i_bits.falls) * 100.0)
+      / (double) flips);
 
-    }
+  }
+
+  if(i_num_errors > 0)
+  {
+
+    printf("\nError rate by byte sent:");
 
-    if(i_verbose == true)
+    for(pos = 0; pos < (unsigned int) SERS_BYTE_VALUES; pos++)
     {
 
-      printf("TX: %02x\n", (unsigned int) send_buf);
+      if(i_bits.errors[pos] > 0)
+      {
 
-    }
+        printf("\n  %02x : %llu in %llu (%.3e)", pos, i_bits.errors[pos],
+          i_bits.sent[pos],
+          (double) i_bits.errors[pos] / (double) i_bits.sent[pos]);
 
-    /* Inc the number of bytes that have been sent */
-    i_bytes_sent++;
+      }
+
+    }
 
   }
 
@@ -864,30 +1007,40 @@ static void i_write_serial(unsigned char send_buf)
 
 /*****************************************************************************/
 /*                                                                           */
-/* Name: i_wait_for_write()                                                  */
+/* Name: i_report_stats()                                                    */
 /*                                                                           */
-/* Description: Wait until the serial port is ready to send a byte           */
+/* Description: Report the test stats                                        */
 /*                                                                           */
-/* Uses: send_buf - buffer for the byte to send.                             */
+/* Uses: void                                                                */
 /*                                                                           */
 /* Returns: void                                                             */
 /*                                                                           */
 /*****************************************************************************/
 
-static void i_wait_for_write(unsigned char send_buf)
+static void i_report_stats(void)
 {
 
-  serp_tx_wait_status_t wait_status; /* Result of waiting for TX */
+  if (i_show_stats == true)
+  {
 
+    printf("\nMin return time = %ld.%06ld\n", (long) i_delta_time_min.tv_sec,
+           (long) i_delta_time_min.tv_usec);
 
-  /* Wait until we are ready to write, or timeout */
-  wait_status = serp_wait_for_write(i_fd, i_DEFAULT_WRITE_TIMEOUT, i_diags);
+    printf("Max return time = %ld.%06ld\n", (long) i_delta_time_max.tv_sec,
+           (long) i_delta_time_max.tv_usec);
 
-  /* Ready to write? */
-  if( (wait_status & SERP_TX_WAIT_READY) > 0)
-  {
+    printf("Average return time = %ld.%06ld", (long) i_delta_time_av.tv_sec,
+           (long) i_delta_time_av.tv_usec);
+
+    i_report_jitter();
+
+    i_report_g821();
 
-    i_write_serial(send_buf);
+    i_report_bursts();
+
+    i_report_bits();
+
+    sers_tod_print(&i_tod);
 
   }
 
@@ -896,38 +1049,50 @@ static void i_wait_for_write(unsigned char send_buf)
 
 /*****************************************************************************/
 /*                                                                           */
-/* Name: i_store_max_delta()                                                 */
+/* Name: i_report_windows()                                                  */
 /*                                                                           */
-/* Description: Store a max delta time, if it is a new max                   */
+/* Description: Report the error rate, timeout rate and median and 99th      */
+/*              percentile return times over each of the rolling windows     */
 /*                                                                           */
-/* Uses: delta_time - The potential new max time                             */
+/* Uses: void                                                                */
 /*                                                                           */
 /* Returns: void                                                             */
 /*                                                                           */
 /*****************************************************************************/
 
-static void i_store_max_delta(struct timeval delta_time)
+static void i_report_windows(void)
 {
 
-  /* store the max delta time */
-  if (delta_time.tv_sec > i_delta_time_max.tv_sec)
+  struct timeval now;          /* The time now              */
+  const sers_roll_slot_t *win; /* The current window        */
+  unsigned int window;         /* Index of the window       */
+  double bytes;                /* Bytes tested in the window*/
+
+
+  /* Drop anything too old, in case nothing has been tested for a while */
+  if(serp_get_time(&now) == 0)
   {
 
-    i_delta_time_max.tv_sec = delta_time.tv_sec;
-    i_delta_time_max.tv_usec = delta_time.tv_usec;
+    sers_roll_advance(&i_roll, i_timeval_to_ns(now) );
 
   }
-  else
+
+  for(window = 0; window < (unsigned int) SERS_ROLL_WINDOWS; window++)
   {
 
-    if ( (delta_time.tv_usec > i_delta_time_max.tv_usec)
-       && (delta_time.tv_sec == i_delta_time_max.tv_sec) )
-    {
+    win = &(i_roll.window[window]);
 
-      i_delta_time_max.tv_sec = delta_time.tv_sec;
-      i_delta_time_max.tv_usec = delta_time.tv_usec;
+    /* Avoid dividing by zero */
+    bytes = (win->bytes > 0) ? (double) win->bytes : 1.0;
 
-    }
+    printf(" %s:err:%.1e to:%.1e p50:", i_WINDOW_NAMES[window],
+      (double) win->errors / bytes, (double) win->timeouts / bytes);
+
+    i_print_ns( (long long) sers_hist_percentile(&(win->latency), 50.0) );
+
+    printf(" p99:");
+
+    i_print_ns( (long long) sers_hist_percentile(&(win->latency), 99.0) );
 
   }
 
@@ -936,106 +1101,122 @@ static void i_store_max_delta(struct timeval delta_time)
 
 /*****************************************************************************/
 /*                                                                           */
-/* Name: i_store_min_delta()                                                 */
+/* Name: i_report_results()                                                  */
 /*                                                                           */
-/* Description: Store a min delta time, if it is a new min                   */
+/* Description: Report how the test went                                     */
 /*                                                                           */
-/* Uses: delta_time - The potential new min time                             */
+/* Uses: void                                                                */
 /*                                                                           */
 /* Returns: void                                                             */
 /*                                                                           */
 /*****************************************************************************/
 
-static void i_store_min_delta(struct timeval delta_time)
+static void i_report_results(void)
 {
 
-  if (delta_time.tv_sec < i_delta_time_min.tv_sec)
-  {
+  printf(" sent:");
 
-    i_delta_time_min.tv_sec = delta_time.tv_sec;
-    i_delta_time_min.tv_usec = delta_time.tv_usec;
+  i_print_big_num(i_bytes_sent, i_bin_not_dec);
 
-  }
-  else
+  printf(" errs:");
+
+  i_print_big_num(i_num_errors, i_bin_not_dec);
+
+  printf(" timeouts:");
+
+  i_print_big_num(i_num_timeouts, i_bin_not_dec);
+
+  printf(" corrupt:");
+
+  i_print_big_num(i_num_corrupts, i_bin_not_dec);
+
+  i_print_runtime();
+
+  if (i_show_stats == true)
   {
 
-    if ( (delta_time.tv_usec < i_delta_time_min.tv_usec)
-       && (delta_time.tv_sec == i_delta_time_min.tv_sec) )
-    {
+    printf(" Av:%ld.%06ld", (long) i_delta_time_av.tv_sec,
+           (long) i_delta_time_av.tv_usec);
 
-      i_delta_time_min.tv_sec = delta_time.tv_sec;
-      i_delta_time_min.tv_usec = delta_time.tv_usec;
+    printf(" Jit:");
 
-    }
+    i_print_ns(sers_jitter_get(&i_jitter) );
 
-  }
+    i_report_windows();
 
+  }
+  
+  
 }
 
 
 /*****************************************************************************/
 /*                                                                           */
-/* Name: i_store_av_delta()                                                  */
+/* Name: i_get_clock()                                                       */
 /*                                                                           */
-/* Description: Calculate the average delta time                             */
+/* Description: Read a clock in nanoseconds                                  */
 /*                                                                           */
-/* Uses: delta_time                                                          */
+/* Uses: clock_id - The clock                                                */
 /*                                                                           */
-/* Returns: void                                                             */
+/* Returns: The clock's time, in ns                                          */
 /*                                                                           */
 /*****************************************************************************/
 
-static void i_store_av_delta(struct timeval delta_time)
+static long long i_get_clock(clockid_t clock_id)
 {
-  unsigned long long total;
-  unsigned long long remainder;
-  unsigned long long rollover = 0;
 
-  /* Set up the value on the first loop */
-  if(  i_bytes_sent == 1 )
-  {
+  struct timespec now;         /* The clock's time */
 
-    i_delta_time_av.tv_sec = delta_time.tv_sec;
-    i_delta_time_av.tv_usec = delta_time.tv_usec;
 
-  }
-  else
-  {
+  now.tv_sec = 0;
 
-    /* Calculate new average */
+  now.tv_nsec = 0;
 
-    /* Interger part */
-    total = (i_delta_time_av.tv_sec * (i_bytes_sent - 1) ) + delta_time.tv_sec;
+  (void) clock_gettime(clock_id, &now);
 
-    i_delta_time_av.tv_sec = total / i_bytes_sent;
+  return ( (long long) now.tv_sec * SERS_NSEC_IN_SEC) + now.tv_nsec;
 
-    /* Calc any remainder for the fractional part */
-    remainder = 1000000 * (total % i_bytes_sent);
+}
 
-    if (remainder > 0)
-    {
 
-      rollover = remainder / i_bytes_sent;
+/*****************************************************************************/
+/*                                                                           */
+/* Name: i_start_bench()                                                     */
+/*                                                                           */
+/* Description: Note the time, CPU and port system calls used so far, when   */
+/*              testing the emulator or memory loopback, to measure the cost */
+/*              of each byte. With the stats, start timing the phases of     */
+/*              each byte too.                                               */
+/*                                                                           */
+/* Uses: void                                                                */
+/*                                                                           */
+/* Returns: void                                                             */
+/*                                                                           */
+/*****************************************************************************/
 
-    }
+static void i_start_bench(void)
+{
 
-    /* Fractional part */
-    total = (i_delta_time_av.tv_usec * (i_bytes_sent - 1) ) + delta_time.tv_usec;
+  if(i_benchmark == true)
+  {
 
-    i_delta_time_av.tv_usec = total / i_bytes_sent;
+    i_bench_time = i_get_clock(CLOCK_MONOTONIC);
 
-    /* Add the remainder from the interger part */
-    i_delta_time_av.tv_usec = i_delta_time_av.tv_usec + rollover;
+    /* Only this thread's CPU, not the emulator's */
+    i_bench_cpu = i_get_clock(CLOCK_THREAD_CPUTIME_ID);
 
-    /* Check for overflow, to feed back to the integer part */
-    if( i_delta_time_av.tv_usec >= 1000000)
-    {
+    i_bench_syscalls = serp_get_syscalls();
 
-       i_delta_time_av.tv_usec = i_delta_time_av.tv_usec - 1000000;
+  }
 
-       i_delta_time_av.tv_sec++;
+  if(i_show_stats == true)
+  {
 
-    }
+    serp_set_timing(true);
+
+    i_phase_syscalls = serp_get_syscalls();
+
+    (void) getrusage(RUSAGE_SELF, &i_phase_usage);
 
   }
 
@@ -1044,133 +1225,136 @@ static void i_store_av_delta(struct timeval delta_time)
 
 /*****************************************************************************/
 /*                                                                           */
-/* Name: i_read_serial()                                                     */
+/* Name: i_report_bench()                                                    */
 /*                                                                           */
-/* Description: Read from the serial port                                    */
+/* Description: Report the bytes tested a second, and the CPU time and port  */
+/*              system calls used for each, when testing the emulator or     */
+/*              memory loopback. These measure the test loop itself,         */
+/*              without a real port's speed.                                 */
 /*                                                                           */
-/* Uses: sent_byte - The byte previously been sent                           */
+/* Uses: void                                                                */
 /*                                                                           */
 /* Returns: void                                                             */
 /*                                                                           */
 /*****************************************************************************/
 
-static void i_read_serial(unsigned char sent_byte)
+static void i_report_bench(void)
 {
 
-  serp_rx_buf_t rx_buf;       /* Struct for received byte & status */
-
-  struct timeval delta_time;  /* The time taken from tx to rx      */
-
+  double bytes;                /* Bytes tested            */
+  double secs;                 /* Time taken, in seconds  */
 
-  /* Clear status */
-  rx_buf.rx_status = 0;
-
-  rx_buf.fd = i_fd;
 
-  /* Read byte from serial port */
-  serp_read_port(&rx_buf, i_diags);
-
-  /* Did all go well? */
-  if( (rx_buf.rx_status & SERP_READ_OK) > 0)
+  if( (i_benchmark == true) && (i_bytes_sent > 0) )
   {
 
-    /* Did a framing error occur? */
-    if( (rx_buf.rx_status & SERP_READ_FRAMERR) > 0)
-    {
-
-      /* Don't report duff bytes if in quiet mode */
-      if(i_quiet == false)
-      {
-
-        /* Print out current time */
-        i_print_date_n_time();
+    bytes = (double) i_bytes_sent;
 
-        /* Print out error message */
-        printf("Framing error: TX: %02x RX: %02x\n",
-          (unsigned int) sent_byte, (unsigned int) rx_buf.rx_byte);
+    secs = (double) (i_get_clock(CLOCK_MONOTONIC) - i_bench_time)
+      / SERS_NSEC_IN_SEC;
 
-      }
+    printf("\nBenchmark: %.0f bytes/s, %.3f us CPU per byte,",
+      (secs > 0.0) ? bytes / secs : 0.0,
+      (double) (i_get_clock(CLOCK_THREAD_CPUTIME_ID) - i_bench_cpu)
+      / (bytes * SERS_NSEC_IN_USEC) );
 
-      i_num_errors++;
+    printf(" %.2f port syscalls per byte",
+      (double) (serp_get_syscalls() - i_bench_syscalls) / bytes);
 
-      i_num_corrupts++;
+  }
 
-    }
-    else
-    {
+}
 
-      /* No RX error occured */
 
-      /* Only report byte in verbose mode */
-      if(i_verbose == true)
-      {
+/*****************************************************************************/
+/*                                                                           */
+/* Name: i_usage_us()                                                        */
+/*                                                                           */
+/* Description: Work out the microseconds between two times of resource use  */
+/*                                                                           */
+/* Uses: now - The later time                                                */
+/*       then - The earlier time                                             */
+/*                                                                           */
+/* Returns: The microseconds between them                                    */
+/*                                                                           */
+/*****************************************************************************/
 
-        printf("RX: %02x\n", (unsigned int) rx_buf.rx_byte);
+static double i_usage_us(const struct timeval *now,
+  const struct timeval *then)
+{
 
-      }
+  struct timeval taken;        /* Time between them */
 
-      /* Is the byte the same as the one sent */
-      if(rx_buf.rx_byte != sent_byte)
-      {
 
-        /* Don't report duff bytes if in quiet mode */
-        if(i_quiet == false)
-        {
+  timersub(now, then, &taken);
 
-          /* Print out current time */
-          i_print_date_n_time();
+  return ( (double) taken.tv_sec * i_USEC_IN_SEC) + taken.tv_usec;
 
-          /* Print out error message */
-          printf("Corrupt byte: TX: %02x RX: %02x\n",
-            (unsigned int) sent_byte, (unsigned int) rx_buf.rx_byte);
+}
 
-        }
 
-        i_num_errors++;
+/*****************************************************************************/
+/*                                                                           */
+/* Name: i_report_phases()                                                   */
+/*                                                                           */
+/* Description: Report, for each byte sent, the calls, port system calls and */
+/*              time spent in each phase of sending and receiving it, with   */
+/*              the longest time a phase took. Then the port system calls,   */
+/*              the CPU time and the context switches of the whole process   */
+/*              for each byte, from getrusage().                             */
+/*                                                                           */
+/* Uses: void                                                                */
+/*                                                                           */
+/* Returns: void                                                             */
+/*                                                                           */
+/*****************************************************************************/
 
-        i_num_corrupts++;
+static void i_report_phases(void)
+{
 
-      }
-      else
-      {
+  serp_phase_time_t phases[SERP_PHASES];   /* Time spent in each phase    */
+  struct rusage usage;                     /* Resources used by now       */
+  double bytes;                            /* Bytes sent                  */
+  double calls;                            /* Calls made in a phase       */
+  int phase;                               /* Phase being reported        */
 
-        /* Are times ok? */
-        if( ( (rx_buf.rx_status & SERP_READ_TIME_FAIL) == 0) 
-          && (i_tx_time.tv_sec != i_TIME_FAIL) )
-        {
 
-          /* Get the delta time, i.e. the time from tx to rx */
-          timersub(&rx_buf.rx_time, &i_tx_time, &delta_time);
+  if( (i_show_stats == true) && (i_bytes_sent > 0) )
+  {
 
-          /* Why are negatives coming through? Don't know, */
-          /* but protect against them                      */
-          if( (delta_time.tv_sec >= 0) && (delta_time.tv_usec >= 0) )
-          {
+    serp_get_phases(phases);
 
-            /* store the max delta time */
-            i_store_max_delta(delta_time);
+    (void) getrusage(RUSAGE_SELF, &usage);
 
-            /* store the min delta time */
-            i_store_min_delta(delta_time);
+    bytes = (double) i_bytes_sent;
 
-            /* store the average delta time */
-            i_store_av_delta(delta_time);
+    printf("\n\nPer byte:    calls  syscalls        ns  "
+      "avg ns/call  max ns/call");
 
-            if( (i_show_stats == true) && (i_verbose == true) )
-            {
+    for(phase = 0; phase < SERP_PHASES; phase++)
+    {
 
-              printf("Char return time: %ld.%06ld\n", (long) delta_time.tv_sec,
-                     (long) delta_time.tv_usec);
+      calls = (double) phases[phase].calls;
 
-            }
+      printf("\n%-10s %7.2f %9.2f %9.0f %12.0f %12llu", i_PHASE_NAMES[phase],
+        calls / bytes, (double) phases[phase].syscalls / bytes,
+        (double) phases[phase].total_ns / bytes,
+        (calls > 0.0) ? (double) phases[phase].total_ns / calls : 0.0,
+        phases[phase].max_ns);
 
-          }
+    }
 
-        }
+    printf("\nPort syscalls per byte = %.2f",
+      (double) (serp_get_syscalls() - i_phase_syscalls) / bytes);
 
-      }
+    printf("\nCPU per byte = %.3f us user, %.3f us system",
+      i_usage_us(&usage.ru_utime, &i_phase_usage.ru_utime) / bytes,
+      i_usage_us(&usage.ru_stime, &i_phase_usage.ru_stime) / bytes);
 
-    }
+    printf("\nContext switches per byte = %.3f voluntary, "
+      "%.3f involuntary",
+      (double) (usage.ru_nvcsw - i_phase_usage.ru_nvcsw) / bytes,
+      (double) (usage.ru_nivcsw - i_phase_usage.ru_nivcsw) / bytes);
 
   }
 
@@ -1179,77 +1363,71 @@ static void i_read_serial(unsigned char sent_byte)
 
 /*****************************************************************************/
 /*                                                                           */
-/* Name: i_wait_for_read()                                                   */
+/* Name: i_check_faults()                                                    */
 /*                                                                           */
-/* Description: Wait until a read from the serial port is ready, or timeout  */
+/* Description: Report the faults the emulator injected, and check the       */
+/*              errors counted against them. As each byte is waited for and  */
+/*              the port flushed after it, flipped bytes and markers should  */
+/*              be counted as corrupt, dropped bytes as timeouts, and        */
+/*              duplicated and late bytes not at all.                        */
 /*                                                                           */
-/* Uses: sent_byte - The byte to be sent.                                    */
+/* Uses: void                                                                */
 /*                                                                           */
-/* Returns: void                                                             */
+/* Returns: false if the counts don't match the faults, else true            */
 /*                                                                           */
 /*****************************************************************************/
 
-static void i_wait_for_read(unsigned char sent_byte)
+static bool i_check_faults(void)
 {
 
-  serp_rx_wait_status_t wait_status; /* Result of waiting for byte */
-
+  bool match = true;                            /* Counts as expected      */
+  unsigned long long injected[SERE_FAULTS];     /* Bytes given each fault  */
+  unsigned long long corrupts;                  /* Corrupt bytes expected  */
+  int fault;                                    /* Fault being reported    */
 
-  /* Wait until we are ready to read, or timeout */
-  wait_status = serp_wait_for_read(i_fd, i_read_timeout, i_diags);
 
-  /* Choose what we do now */
-  switch (wait_status)
+  if( ( (i_emulate == true) || (i_simulate == true) )
+    && (i_emulator.faults != 0) )
   {
 
-    case SERP_RX_WAIT_FAILURE: /* Did it all go wrong */
-
-      /* Do nothing */
-
-      break;
-
-    case SERP_RX_WAIT_READY: /* Got something to read? */
-
-      i_read_serial(sent_byte);
-
-      break;
-
-    case SERP_RX_WAIT_TIMEOUT: /* Or did we timeout */
-
-      /* Don't report timeout if in quiet mode */
-      if(i_quiet == false)
-      {
+    sere_get_injected(injected);
 
-        /* Print out current time */
-        i_print_date_n_time();
+    printf("\nFaults injected:");
 
-        printf("Timeout\n");
+    for(fault = 0; fault < SERE_FAULTS; fault++)
+    {
 
-      }
+      printf("%s %llu %s", (fault == 0) ? "" : ",", injected[fault],
+        i_FAULT_NAMES[fault]);
 
-      i_num_errors++;
+    }
 
-      i_num_timeouts++;
+    corrupts = injected[SERE_FLIP] + injected[SERE_FRAMING]
+      + injected[SERE_PARITY] + injected[SERE_BREAK];
 
-      break;
+    match = (i_num_corrupts == corrupts)
+      && (i_num_timeouts == injected[SERE_DROP])
+      && (i_num_errors == corrupts + injected[SERE_DROP]);
 
-    default:
+    printf("\nExpected %llu corrupt and %llu timeouts, counted %llu and %llu",
+      corrupts, injected[SERE_DROP], (unsigned long long) i_num_corrupts,
+      (unsigned long long) i_num_timeouts);
 
-      /* Invalid value */
-      fprintf(stderr, "Unknown value when waiting for read\n");
+    printf(" - %s", (match == true) ? "match" : "MISMATCH");
 
-      break;
+  }
 
-  } /* End switch() */
+  return match;
 
 }
 
 
 /*****************************************************************************/
 /*                                                                           */
-/* Name: i_send_n_receive()                                                  */
+/* Name: i_report_target()                                                   */
 /*                                                                           */
-/* Description: Pick a byte, send it & wait for it to come back              */
+/* Description: Report how the link did against its target BER and the       */
+/*              errors allowed, if they were given                           */
 /*                                                                           */
 /* Uses: void                                                                */
 /*                                                                           */
@@ -1257,100 +1435,107 @@ static void i_wait_for_read(unsigned char sent_byte)
 /*                                                                           */
 /*****************************************************************************/
 
-static void i_send_n_receive()
+static void i_report_target(void)
 {
 
-  unsigned char tx_byte;  /* The byte to transmit  */
-  int flush_result;       /* Result of the flush   */
+  unsigned long long bits;     /* Bits tested */
 
 
-  /* Are we in random mode */
-  if(i_random == true)
+  if(i_target_ber > 0.0)
   {
 
-    /* Generate random byte to send */
-    tx_byte = (unsigned char) rand();
+    bits = i_bytes_sent * SERS_DATA_BITS;
 
-  }
-  else
-  {
+    printf("\nTarget BER %.1e ", i_target_ber);
 
-    /* Get next byte to send */
-    tx_byte = i_tx_buf[i_tx_ptr];
+    switch (i_ber.state)
+    {
 
-    /* Increment pointer to the byte to send */
-    i_tx_ptr++;
+      case SERS_BER_PROVEN:
 
-    /* Wrap round the pointer to the beginning of the buffer */
-    i_tx_ptr %= i_str_len;
+        printf("proven");
+
+        break;
+
+      case SERS_BER_DISPROVEN:
+
+        printf("disproven");
+
+        break;
+
+      default:
+
+        printf("not proven or disproven");
+
+        break;
+
+    }
+
+    printf(" at %.1f%% confidence", i_confidence);
+
+    printf("\nBER upper bound = %.2e", sers_ber_upper(&i_ber, bits) );
+
+    /* Say how much more testing would be needed */
+    if( (i_ber.state == SERS_BER_TESTING)
+      && (i_ber.proof_bits > (double) bits) )
+    {
+
+      printf("\nBytes still needed to prove it with no more errors = %.0f",
+        (i_ber.proof_bits - (double) bits) / (double) SERS_DATA_BITS);
+
+    }
 
   }
 
-  /* Write to the port */
-  i_wait_for_write(tx_byte);
+  if( (i_use_max_errors == true) && (i_num_errors > i_max_errors) )
+  {
 
-  /* Read from the port */
-  i_wait_for_read(tx_byte);
+    printf("\nErrors allowed (");
 
-  /* Flush port to get rid of any bits of the last RX */
-  /* Dump flush result                                */
-  flush_result = serp_flush_port(i_fd, i_diags);
+    i_print_big_num(i_max_errors, i_bin_not_dec);
+
+    printf(") exceeded");
+
+  }
 
 }
 
 
 /*****************************************************************************/
 /*                                                                           */
-/* Name: i_check_keys()                                                      */
+/* Name: i_latency_to_record()                                               */
 /*                                                                           */
-/* Description: Check and process keypresses                                 */
+/* Description: Put the return times from a histogram into an output record  */
 /*                                                                           */
-/* Uses: void                                                                */
+/* Uses: latency - The return times                                          */
+/*       record  - The record                                                */
 /*                                                                           */
 /* Returns: void                                                             */
 /*                                                                           */
 /*****************************************************************************/
 
-static void i_check_keys(void)
+static void i_latency_to_record(const sers_hist_t *latency,
+  sero_record_t *record)
 {
 
-  int key_buf;  /* Buffer for keypresses */
-
-
-  /* Check the keyboard */
-  key_buf = getchar();
-
-  /* Has there been a keypress? */
-  if(key_buf != -1)
+  if(latency->samples > 0)
   {
 
-    /* Make all chars lower case */
-    key_buf = tolower(key_buf);
-
-    /* Check what was pressed, and act on it */
-    switch (key_buf)
-    {
-
-      case 'q': /* 'q' pressed, flag we want to quit */
-
-        i_q_pressed = true;
-
-        break;
-
-      case 'i': /* 'i' pressed, flag we want intermediate results */
+    record->p50 = (long long) sers_hist_percentile(latency, 50.0);
 
-        i_i_pressed = true;
+    record->p99 = (long long) sers_hist_percentile(latency, 99.0);
 
-        break;
+    record->max = (long long) latency->max;
 
-      default:
+  }
+  else
+  {
 
-        /* Don't know what to do with that char, so bell */
-        printf("\a");
+    record->p50 = SERO_NONE;
 
-        break;
+    record->p99 = SERO_NONE;
 
-    } /* End switch() */
+    record->max = SERO_NONE;
 
   }
 
@@ -1359,231 +1544,405 @@ static void i_check_keys(void)
 
 /*****************************************************************************/
 /*                                                                           */
-/* Name: i_pause()                                                           */
+/* Name: i_close_output()                                                    */
 /*                                                                           */
-/* Description: Wait, for a bit                                              */
+/* Description: Write the summary record and close the output, if records    */
+/*              are wanted                                                   */
 /*                                                                           */
 /* Uses: void                                                                */
 /*                                                                           */
-/* Returns: A flag indicating success or failure                             */
+/* Returns: i_EXIT_OK if the records were written, else i_EXIT_FAULT         */
 /*                                                                           */
 /*****************************************************************************/
 
-static int i_pause(double pause_time)
+static int i_close_output(void)
 {
 
-  struct timespec tv;        /* Structure to hold the requested time */
-  int nanosleep_result = 0;  /* The return from the nanosleep call   */
-  bool finished = false;     /* Have we finished sleeping yet?       */
+  int exit_status = i_EXIT_OK;  /* Were the records written? */
+  sero_record_t record;         /* Summary of the test       */
+  seri_counts_t counts;         /* Counts from the snapshots */
 
 
-  if( pause_time != (double) 0)
+  if(i_output == true)
   {
 
-    /* Sort out the seconds */
-    tv.tv_sec = (time_t) pause_time;
+    memset(&record, 0, sizeof(record) );
 
-    /* ... and then the remainder in nanoseconds. */
-    tv.tv_nsec = (long) ((pause_time - tv.tv_sec) * 1e+9);
+    record.type = SERO_SUMMARY;
 
-    while (finished == false)
-    {
+    record.bytes = i_bytes_sent;
 
-      /* Sleep for the time specified in tv. If interrupted by a      */
-      /* signal, place the remaining time left to sleep back into tv. */
-      nanosleep_result = nanosleep(&tv, &tv);
+    record.errors = i_num_errors;
 
-      /* Have we finished yet? */
-      if (nanosleep_result == 0)
-      {
+    record.timeouts = i_num_timeouts;
 
-        /* Completed the entire sleep time; all done, Let's exit. */
-        finished = true;
+    record.corrupts = i_num_corrupts;
 
-      }
-      else
-      {
+    seri_read(&counts);
 
-        /* Did an error occur? If not stay in loop */
-        if (errno != EINTR)
-        {
+    i_latency_to_record(&counts.latency, &record);
 
-          /* An error did occur; bail out. */
-          finished = true;
+    if(sero_close(&record) != SERO_OK)
+    {
 
-        }
+      fprintf(stderr, "Failure writing %s\n", i_output_path);
 
-      }
+      exit_status = i_EXIT_FAULT;
 
-    } /* End while */
+    }
 
   }
 
-  return nanosleep_result; /*  */
+  return exit_status;
 
 }
 
 
 /*****************************************************************************/
 /*                                                                           */
-/* Name: i_char_pause()                                                      */
+/* Name: i_show_intermediate()                                               */
 /*                                                                           */
-/* Description: Add a delay between chars, if requested.                     */
+/* Description: Show intermediate test results if 'i' has been pressed.      */
+/*              Results at each interval are shown by i_print_interval().    */
 /*                                                                           */
 /* Uses: void                                                                */
 /*                                                                           */
-/* Returns: A flag indicating success or failure                             */
+/* Returns: void                                                             */
 /*                                                                           */
 /*****************************************************************************/
 
-static int i_char_pause(void)
+static void i_show_intermediate(void)
 {
 
-  int pause_result = 0;  /* The return from the nanosleep call   */
-  double time_portion;   /* A small chunk of time to delay       */
-  double remaining_time; /* The time remaining                   */
-
+  time_t runtime = 0;       /* Length of time the test has run in seconds */
 
-  remaining_time = i_paced_time;
 
-  while(remaining_time > 0)
+  if(i_i_pressed == true)
   {
 
-    if(remaining_time <= i_ESCAPE_TIME)
-    {
-
-      time_portion = remaining_time;
-
-      remaining_time = 0;
+    runtime = i_get_runtime();
 
-    }
-    else
+    /* Did we get runtime ok? */
+    if(runtime != i_TIME_FAIL)
     {
 
-      time_portion = i_ESCAPE_TIME;
+      i_runtime = runtime;
 
-      remaining_time = remaining_time - i_ESCAPE_TIME;
+      /* Show the intermediate results */
+      i_report_results();
 
-    }
+      if(i_show_stats == true)
+      {
 
-    pause_result = i_pause(time_portion);
+        sers_tod_print(&i_tod);
 
-    /* Check for keypresses */
-    i_check_keys();
+      }
 
-    /* Show intermediate results */
-    i_show_intermediate();
+      printf("\n");
 
-    if(i_q_pressed == true)
-    {
+    }
 
-      /* Break out of while loop */
-      remaining_time = 0;
+    /* Reset 'i' pressed flag */
+    i_i_pressed = false;
 
-    }
+  }
 
-  } /* End while */
-  
-  return pause_result;
-  
 }
 
 
 /*****************************************************************************/
 /*                                                                           */
-/* Name: i_bert_by_num()                                                     */
+/* Name: i_print_interval()                                                  */
 /*                                                                           */
-/* Description: Perform a bit error rate test for a given number of bytes    */
+/* Description: Show the results for an interval, and the totals so far      */
 /*                                                                           */
-/* Uses: void                                                                */
+/* Uses: snap - Snapshot of the counts at the end of the interval            */
 /*                                                                           */
 /* Returns: void                                                             */
 /*                                                                           */
 /*****************************************************************************/
 
-static void i_bert_by_num()
+static void i_print_interval(const seri_snap_t *snap)
 {
 
-  unsigned long long bytes_sent; /* Current count of bytes sent  */
+  double span_secs;         /* Length of the interval in seconds */
 
-  /* Send bytes to send */
-  for(bytes_sent = 0; ( (bytes_sent < i_tx_len) && (i_q_pressed == false) );
-    bytes_sent++)
+
+  span_secs = (double) snap->span / (double) SERS_NSEC_IN_SEC;
+
+  /* Keep the line together, whatever else is printing */
+  flockfile(stdout);
+
+  printf("+");
+
+  i_print_time( (time_t) ( (snap->elapsed + (SERS_NSEC_IN_SEC / 2) ) /
+    SERS_NSEC_IN_SEC) );
+
+  printf(" sent:");
+
+  i_print_big_num(snap->delta.bytes, i_bin_not_dec);
+
+  printf(" errs:");
+
+  i_print_big_num(snap->delta.errors, i_bin_not_dec);
+
+  printf(" timeouts:");
+
+  i_print_big_num(snap->delta.timeouts, i_bin_not_dec);
+
+  if(span_secs > 0.0)
   {
 
-    /* Do the sending and receiving stuff */
-    i_send_n_receive(i_fd);
+    printf(" rate:");
 
-    /* Check for keypresses */
-    i_check_keys();
+    i_print_big_num( (unsigned long long)
+      ( (double) snap->delta.bytes / span_secs), i_bin_not_dec);
 
-    /* Show intermediate results */
-    i_show_intermediate();
+    printf("/s");
 
-    /* Put in a delay for paced output */
-    (void) i_char_pause();
+  }
+
+  if(snap->delta.latency.samples > 0)
+  {
+
+    printf(" p50:");
+
+    i_print_ns( (long long) sers_hist_percentile(&snap->delta.latency, 50.0) );
+
+    printf(" p99:");
+
+    i_print_ns( (long long) sers_hist_percentile(&snap->delta.latency, 99.0) );
+
+    printf(" max:");
+
+    i_print_ns( (long long) snap->delta.latency.max);
 
   }
 
+  printf(" total sent:");
+
+  i_print_big_num(snap->total.bytes, i_bin_not_dec);
+
+  printf(" errs:");
+
+  i_print_big_num(snap->total.errors, i_bin_not_dec);
+
+  printf(" timeouts:");
+
+  i_print_big_num(snap->total.timeouts, i_bin_not_dec);
+
+  printf("\n");
+
+  (void) fflush(stdout);
+
+  funlockfile(stdout);
+
 }
 
 
 /*****************************************************************************/
 /*                                                                           */
-/* Name: i_bert_by_time()                                                    */
+/* Name: i_record_interval()                                                 */
 /*                                                                           */
-/* Description: Perform a bit error rate test for a given time               */
+/* Description: Write a record of the results for an interval                */
 /*                                                                           */
-/* Uses: void                                                                */
+/* Uses: snap - Snapshot of the counts at the end of the interval            */
 /*                                                                           */
 /* Returns: void                                                             */
 /*                                                                           */
 /*****************************************************************************/
 
-static void i_bert_by_time()
+static void i_record_interval(const seri_snap_t *snap)
 {
 
-  time_t runtime = 0;       /* Length of time the test has run in seconds */
+  sero_record_t record;     /* Record of the interval */
 
 
-  /* Send bytes for given time */
-  while( (runtime < i_send_time) && (i_q_pressed == false) )
-  {
+  memset(&record, 0, sizeof(record) );
 
-    /* Do the sending and receiving stuff */
-    i_send_n_receive(i_fd);
+  record.type = SERO_INTERVAL;
 
-    /* Check for keypresses */
-    i_check_keys();
+  record.number = snap->number;
 
-    /* Show intermediate results */
-    i_show_intermediate();
+  record.elapsed = snap->elapsed;
 
-    /* Check the runtime */
-    runtime = i_get_runtime();
+  record.span = snap->span;
 
-    /* Did we get runtime ok? */
-    if(runtime == i_TIME_FAIL)
+  record.bytes = snap->delta.bytes;
+
+  record.errors = snap->delta.errors;
+
+  record.timeouts = snap->delta.timeouts;
+
+  i_latency_to_record(&snap->delta.latency, &record);
+
+  record.total_bytes = snap->total.bytes;
+
+  record.total_errors = snap->total.errors;
+
+  record.total_timeouts = snap->total.timeouts;
+
+  sero_add(&record);
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: i_report_interval()                                                 */
+/*                                                                           */
+/* Description: Show and record the results for an interval, as wanted.      */
+/*              Called from the interval timer thread.                       */
+/*                                                                           */
+/* Uses: snap - Snapshot of the counts at the end of the interval            */
+/*                                                                           */
+/* Returns: void                                                             */
+/*                                                                           */
+/*****************************************************************************/
+
+static void i_report_interval(const seri_snap_t *snap)
+{
+
+  SERD_PROBE5(interval, snap->number, snap->elapsed, snap->delta.bytes,
+    snap->delta.errors, snap->delta.timeouts);
+
+  if(i_output == true)
+  {
+
+    i_record_interval(snap);
+
+  }
+
+  if(i_intermediate == true)
+  {
+
+    i_print_interval(snap);
+
+  }
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: i_print_baud()                                                      */
+/*                                                                           */
+/* Description: Prints out the current baud rate                             */
+/*                                                                           */
+/* Uses: baud_rate - The baud rate to be printed                             */
+/*                                                                           */
+/* Returns: void                                                             */
+/*                                                                           */
+/*****************************************************************************/
+
+static void i_print_baud(speed_t baud_rate)
+{
+
+  serp_baud_str_t baud_str;               /* The baud rate as a string */
+  serp_baud_str_status_t baud_str_status; /* The 'get' status          */
+
+
+  /* Get the string for the baud rate */
+  baud_str_status = serp_get_baud_str(baud_rate, baud_str);
+
+  if(baud_str_status != SERP_GET_BAUD_STR_FAIL)
+  {
+
+    printf("%s", (char *) baud_str);
+
+  }
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: i_get_baud_num()                                                    */
+/*                                                                           */
+/* Description: Gets a baud rate as a number                                */
+/*                                                                           */
+/* Uses: baud_rate - The baud rate                                           */
+/*                                                                           */
+/* Returns: The baud rate, or 0 if it isn't known                            */
+/*                                                                           */
+/*****************************************************************************/
+
+static unsigned long i_get_baud_num(speed_t baud_rate)
+{
+
+  serp_baud_str_t baud_str;               /* The baud rate as a string */
+  unsigned long baud_num = 0;             /* The baud rate as a number */
+
+
+  if(serp_get_baud_str(baud_rate, baud_str) != SERP_GET_BAUD_STR_FAIL)
+  {
+
+    baud_num = strtoul( (char *) baud_str, (char **) NULL, 10);
+
+  }
+
+  return baud_num;
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: i_print_str()                                                       */
+/*                                                                           */
+/* Description: Prints out the given string in a format for diagnostics.     */
+/*                                                                           */
+/* Uses: str_buf - The buffer for the string                                 */
+/*       str_len - The string length                                         */
+/*                                                                           */
+/* Returns: void                                                             */
+/*                                                                           */
+/*****************************************************************************/
+
+static void i_print_str(unsigned char str_buf[], unsigned int str_len)
+{
+
+  unsigned int char_count = 0;          /* The loop count */
+
+
+  if(str_len > i_CHARS_PER_LINE_HEX8 )
+  {
+
+    printf("\n");
+
+  }
+
+  /* Loop round the string */
+  for(char_count = 0; char_count < str_len; char_count++)
+  {
+
+    printf("%02x", (unsigned int) str_buf[char_count]);
+
+    if( ( (char_count + 1) % i_CHARS_PER_LINE_HEX8) == 0)
     {
 
-      /* Cause breakout of program */
-      runtime = i_send_time;
+      printf("\n");
 
     }
+    else
+    {
 
-    /* Put in a delay for paced output */
-    (void) i_char_pause();
+      printf(" ");
 
-  } /* End while */
+    }
+
+  }
+
+  printf("\n");
 
 }
 
 
 /*****************************************************************************/
 /*                                                                           */
-/* Name: i_bert_continuous()                                                 */
+/* Name: i_get_timeout()                                                     */
 /*                                                                           */
-/* Description: Perform a bit error rate test continuously                   */
+/* Description: Calculates the timeout for the current baud rate             */
 /*                                                                           */
 /* Uses: void                                                                */
 /*                                                                           */
@@ -1591,138 +1950,2072 @@ static void i_bert_by_time()
 /*                                                                           */
 /*****************************************************************************/
 
-static void i_bert_continuous()
+static void i_get_timeout(void)
 {
 
-  /* Send bytes for given time */
-  while(i_q_pressed == false)
+  serp_timeout_t timeout; /* The timeout */
+
+
+  if (i_user_set_timeout == false)
   {
 
-    /* Do the sending and receiving stuff */
-    i_send_n_receive(i_fd);
+    timeout = serp_get_timeout(i_baud_rate);
 
-    /* Check for keypresses */
-    i_check_keys();
+    if(timeout != SERP_GET_TIMEOUT_FAIL)
+    {
 
-    /* Show intermediate results */
-    i_show_intermediate();
+      i_read_timeout = timeout;
 
-    /* Put in a delay for paced output */
-    (void) i_char_pause();
+    }
 
-  } /* End while */
+  }
 
 }
 
 
 /*****************************************************************************/
 /*                                                                           */
-/* Name: i_bert()                                                            */
+/* Name: i_write_serial()                                                    */
 /*                                                                           */
-/* Description: Perform a bit error rate test                                */
+/* Description: Write to the serial port                                     */
 /*                                                                           */
-/* Uses: void                                                                */
+/* Uses: send_buf - buffer for the bytes to send.                            */
+/*       verbose - Show the byte sent                                        */
+/*       diags - Give detailed diagnostics of failures                       */
 /*                                                                           */
 /* Returns: void                                                             */
 /*                                                                           */
 /*****************************************************************************/
 
-static void i_bert()
+static i_HOT void i_write_serial(unsigned char send_buf, bool verbose,
+  bool diags)
 {
 
-  time_t stop_time;  /* The time the test finished */
+  serp_tx_buf_t tx_buf; /* Struct for transmit byte & returned status */
+
 
+  /* Put the byte to transmit in the TX buffer */
+  tx_buf.tx_byte = send_buf;
+
+  /* Clear the status */
+  tx_buf.tx_status = 0;
+
+  /* Set the file descriptor */
+  tx_buf.fd = i_fd;
 
-  i_start_time = time(NULL);
+  /* Write byte to serial port */
+  serp_write_port(&tx_buf, diags);
 
-  /* Select how to do the test: number, time or continuous */
-  switch (i_how_test)
+  /* Did we transmit without problem */
+  if( (tx_buf.tx_status & SERP_WRITE_OK) > 0)
   {
 
-    case i_TEST_NUM: /* Test by the number of bytes to send */
+    if( (tx_buf.tx_status & SERP_WRITE_TIME_FAIL) == 0)
+    {
 
-      i_bert_by_num(i_fd);
+      /* Store away the transmit time */
+      i_tx_time.tv_sec = tx_buf.tx_time.tv_sec;
 
-      break;
+      i_tx_time.tv_usec = tx_buf.tx_time.tv_usec;
 
-    case i_TEST_TIME: /* Test by time */
+    }
+    else
+    {
 
-      i_bert_by_time(i_fd);
+      /* Indicate time read failure */
+      i_tx_time.tv_sec = i_TIME_FAIL;
 
-      break;
+    }
 
-    case i_TEST_CONTINUOUS: /* Test continuously */
+    if(verbose == true)
+    {
 
-      i_bert_continuous(i_fd);
+      printf("TX: %02x\n", (unsigned int) send_buf);
 
-      break;
+    }
 
-    default:
+    /* Inc the number of bytes that have been sent */
+    i_bytes_sent++;
 
-      /* Don't know what to do, so test by number */
-      i_bert_by_num(i_fd);
+    SERD_PROBE4(byte_sent, send_buf, i_bytes_sent, i_tx_time.tv_sec,
+      i_tx_time.tv_usec);
 
-      break;
+  }
 
-  } /* End switch() */
+}
 
-  stop_time = time(NULL);
 
-  /* Calculate runtime */
-  if( (i_start_time != i_TIME_FAIL) && (stop_time != i_TIME_FAIL) )
+/*****************************************************************************/
+/*                                                                           */
+/* Name: i_wait_for_write()                                                  */
+/*                                                                           */
+/* Description: Wait until the serial port is ready to send a byte           */
+/*                                                                           */
+/* Uses: send_buf - buffer for the byte to send.                             */
+/*       verbose - Show the byte sent                                        */
+/*       diags - Give detailed diagnostics of failures                       */
+/*                                                                           */
+/* Returns: void                                                             */
+/*                                                                           */
+/*****************************************************************************/
+
+static i_HOT void i_wait_for_write(unsigned char send_buf, bool verbose,
+  bool diags)
+{
+
+  serp_tx_wait_status_t wait_status; /* Result of waiting for TX */
+
+
+  /* Wait until we are ready to write, or timeout */
+  wait_status = serp_wait_for_write(i_fd, i_DEFAULT_WRITE_TIMEOUT, diags);
+
+  /* Ready to write? */
+  if( (wait_status & SERP_TX_WAIT_READY) > 0)
   {
 
-    i_runtime = (time_t) difftime(stop_time, i_start_time);
+    i_write_serial(send_buf, verbose, diags);
+
+  }
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: i_store_max_delta()                                                 */
+/*                                                                           */
+/* Description: Store a max delta time, if it is a new max                   */
+/*                                                                           */
+/* Uses: delta_time - The potential new max time                             */
+/*                                                                           */
+/* Returns: void                                                             */
+/*                                                                           */
+/*****************************************************************************/
+
+static void i_store_max_delta(struct timeval delta_time)
+{
+
+  /* store the max delta time */
+  if (delta_time.tv_sec > i_delta_time_max.tv_sec)
+  {
+
+    i_delta_time_max.tv_sec = delta_time.tv_sec;
+    i_delta_time_max.tv_usec = delta_time.tv_usec;
+
+  }
+  else
+  {
+
+    if ( (delta_time.tv_usec > i_delta_time_max.tv_usec)
+       && (delta_time.tv_sec == i_delta_time_max.tv_sec) )
+    {
+
+      i_delta_time_max.tv_sec = delta_time.tv_sec;
+      i_delta_time_max.tv_usec = delta_time.tv_usec;
+
+    }
+
+  }
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: i_store_min_delta()                                                 */
+/*                                                                           */
+/* Description: Store a min delta time, if it is a new min                   */
+/*                                                                           */
+/* Uses: delta_time - The potential new min time                             */
+/*                                                                           */
+/* Returns: void                                                             */
+/*                                                                           */
+/*****************************************************************************/
+
+static void i_store_min_delta(struct timeval delta_time)
+{
+
+  if (delta_time.tv_sec < i_delta_time_min.tv_sec)
+  {
+
+    i_delta_time_min.tv_sec = delta_time.tv_sec;
+    i_delta_time_min.tv_usec = delta_time.tv_usec;
+
+  }
+  else
+  {
+
+    if ( (delta_time.tv_usec < i_delta_time_min.tv_usec)
+       && (delta_time.tv_sec == i_delta_time_min.tv_sec) )
+    {
+
+      i_delta_time_min.tv_sec = delta_time.tv_sec;
+      i_delta_time_min.tv_usec = delta_time.tv_usec;
+
+    }
+
+  }
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: i_store_av_delta()                                                  */
+/*                                                                           */
+/* Description: Calculate the average delta time                             */
+/*                                                                           */
+/* Uses: delta_time                                                          */
+/*                                                                           */
+/* Returns: void                                                             */
+/*                                                                           */
+/*****************************************************************************/
+
+static void i_store_av_delta(struct timeval delta_time)
+{
+  unsigned long long total;
+  unsigned long long remainder;
+  unsigned long long rollover = 0;
+
+  /* Set up the value on the first loop */
+  if(  i_bytes_sent == 1 )
+  {
+
+    i_delta_time_av.tv_sec = delta_time.tv_sec;
+    i_delta_time_av.tv_usec = delta_time.tv_usec;
+
+  }
+  else
+  {
+
+    /* Calculate new average */
+
+    /* Interger part */
+    total = (i_delta_time_av.tv_sec * (i_bytes_sent - 1) ) + delta_time.tv_sec;
+
+    i_delta_time_av.tv_sec = total / i_bytes_sent;
+
+    /* Calc any remainder for the fractional part */
+    remainder = 1000000 * (total % i_bytes_sent);
+
+    if (remainder > 0)
+    {
+
+      rollover = remainder / i_bytes_sent;
+
+    }
+
+    /* Fractional part */
+    total = (i_delta_time_av.tv_usec * (i_bytes_sent - 1) ) + delta_time.tv_usec;
+
+    i_delta_time_av.tv_usec = total / i_bytes_sent;
+
+    /* Add the remainder from the interger part */
+    i_delta_time_av.tv_usec = i_delta_time_av.tv_usec + rollover;
+
+    /* Check for overflow, to feed back to the integer part */
+    if( i_delta_time_av.tv_usec >= 1000000)
+    {
+
+       i_delta_time_av.tv_usec = i_delta_time_av.tv_usec - 1000000;
+
+       i_delta_time_av.tv_sec++;
+
+    }
+
+  }
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: i_record_error()                                                    */
+/*                                                                           */
+/* Description: Write a record of an error, if records are wanted            */
+/*                                                                           */
+/* Uses: kind - The kind of error                                            */
+/*       tx   - The byte sent                                                */
+/*       rx   - The byte received, or SERO_NONE                              */
+/*                                                                           */
+/* Returns: void                                                             */
+/*                                                                           */
+/*****************************************************************************/
+
+static void i_record_error(sero_kind_t kind, unsigned char tx, int rx)
+{
+
+  sero_record_t record;     /* Record of the error */
+
+
+  if(i_output == true)
+  {
+
+    memset(&record, 0, sizeof(record) );
+
+    record.type = SERO_ERROR;
+
+    record.kind = kind;
+
+    record.tx = (int) tx;
+
+    record.rx = rx;
+
+    /* The errored byte has already been counted as sent */
+    record.bytes = i_bytes_sent - 1;
+
+    sero_add(&record);
+
+  }
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: i_read_serial()                                                     */
+/*                                                                           */
+/* Description: Read from the serial port                                    */
+/*                                                                           */
+/* Uses: sent_byte - The byte previously been sent                           */
+/*       verbose - Show the byte received, and its return time with the      */
+/*                 stats                                                     */
+/*       diags - Give detailed diagnostics of failures                       */
+/*                                                                           */
+/* Returns: void                                                             */
+/*                                                                           */
+/*****************************************************************************/
+
+static i_HOT void i_read_serial(unsigned char sent_byte, bool verbose,
+  bool diags)
+{
+
+  serp_rx_buf_t rx_buf;       /* Struct for received byte & status */
+
+  struct timeval delta_time;  /* The time taken from tx to rx      */
+
+
+  /* Clear status */
+  rx_buf.rx_status = 0;
+
+  rx_buf.fd = i_fd;
+
+  /* Read byte from serial port */
+  serp_read_port(&rx_buf, diags);
+
+  /* Did all go well? */
+  if( (rx_buf.rx_status & SERP_READ_OK) > 0)
+  {
+
+    /* Keep the byte for the flight record */
+    i_rx_byte = (int) rx_buf.rx_byte;
+
+    SERD_PROBE5(byte_received, sent_byte, rx_buf.rx_byte, rx_buf.rx_status,
+      rx_buf.rx_time.tv_sec, rx_buf.rx_time.tv_usec);
+
+    /* Did a framing error occur? */
+    if( (rx_buf.rx_status & SERP_READ_FRAMERR) > 0)
+    {
+
+      i_rx_flags |= SERF_FRAMING;
+
+      /* Don't report duff bytes if in quiet mode */
+      if(i_quiet == false)
+      {
+
+        serr_report(SERR_FRAMING, i_get_time(), sent_byte, rx_buf.rx_byte);
+
+      }
+
+      i_record_error(SERO_FRAMING, sent_byte, (int) rx_buf.rx_byte);
+
+      SERD_PROBE4(error, sent_byte, rx_buf.rx_byte, rx_buf.rx_status,
+        i_bytes_sent);
+
+      sers_bits_corrupt(&i_bits, sent_byte, rx_buf.rx_byte, true);
+
+      i_num_errors++;
+
+      i_num_corrupts++;
+
+    }
+    else
+    {
+
+      /* No RX error occured */
+
+      /* Only report byte in verbose mode */
+      if(verbose == true)
+      {
+
+        printf("RX: %02x\n", (unsigned int) rx_buf.rx_byte);
+
+      }
+
+      /* Is the byte the same as the one sent */
+      if(rx_buf.rx_byte != sent_byte)
+      {
+
+        /* Don't report duff bytes if in quiet mode */
+        if(i_quiet == false)
+        {
+
+          serr_report(SERR_CORRUPT, i_get_time(), sent_byte, rx_buf.rx_byte);
+
+        }
+
+        i_record_error(SERO_CORRUPT, sent_byte, (int) rx_buf.rx_byte);
+
+        SERD_PROBE4(error, sent_byte, rx_buf.rx_byte, rx_buf.rx_status,
+          i_bytes_sent);
+
+        sers_bits_corrupt(&i_bits, sent_byte, rx_buf.rx_byte, false);
+
+        i_num_errors++;
+
+        i_num_corrupts++;
+
+      }
+      else
+      {
+
+        /* Are times ok? */
+        if( ( (rx_buf.rx_status & SERP_READ_TIME_FAIL) == 0) 
+          && (i_tx_time.tv_sec != i_TIME_FAIL) )
+        {
+
+          /* Get the delta time, i.e. the time from tx to rx */
+          timersub(&rx_buf.rx_time, &i_tx_time, &delta_time);
+
+          /* Why are negatives coming through? Don't know, */
+          /* but protect against them                      */
+          if( (delta_time.tv_sec >= 0) && (delta_time.tv_usec >= 0) )
+          {
+
+            /* store the max delta time */
+            i_store_max_delta(delta_time);
+
+            /* store the min delta time */
+            i_store_min_delta(delta_time);
+
+            /* store the average delta time */
+            i_store_av_delta(delta_time);
+
+            /* Track the change in delta time from byte to byte */
+            sers_jitter_add(&i_jitter, i_timeval_to_ns(delta_time),
+              i_timeval_to_ns(rx_buf.rx_time) );
+
+            /* Keep the return time for the rolling windows */
+            i_return_time = i_timeval_to_ns(delta_time);
+
+            if( (verbose == true) && (i_show_stats == true) )
+            {
+
+              printf("Char return time: %ld.%06ld\n", (long) delta_time.tv_sec,
+                     (long) delta_time.tv_usec);
+
+            }
+
+          }
+
+        }
+
+      }
+
+    }
+
+  }
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: i_wait_for_read()                                                   */
+/*                                                                           */
+/* Description: Wait until a read from the serial port is ready, or timeout  */
+/*                                                                           */
+/* Uses: sent_byte - The byte to be sent.                                    */
+/*       verbose - Show the byte received                                    */
+/*       diags - Give detailed diagnostics of failures                       */
+/*                                                                           */
+/* Returns: void                                                             */
+/*                                                                           */
+/*****************************************************************************/
+
+static i_HOT void i_wait_for_read(unsigned char sent_byte, bool verbose,
+  bool diags)
+{
+
+  serp_rx_wait_status_t wait_status; /* Result of waiting for byte */
+
+
+  /* Wait until we are ready to read, or timeout */
+  wait_status = serp_wait_for_read(i_fd, i_read_timeout, diags);
+
+  /* Choose what we do now */
+  switch (wait_status)
+  {
+
+    case SERP_RX_WAIT_FAILURE: /* Did it all go wrong */
+
+      /* Do nothing */
+
+      break;
+
+    case SERP_RX_WAIT_READY: /* Got something to read? */
+
+      i_read_serial(sent_byte, verbose, diags);
+
+      break;
+
+    case SERP_RX_WAIT_TIMEOUT: /* Or did we timeout */
+
+      /* Don't report timeout if in quiet mode */
+      if(i_quiet == false)
+      {
+
+        serr_report(SERR_TIMEOUT, i_get_time(), sent_byte, 0);
+
+      }
+
+      i_record_error(SERO_TIMEOUT, sent_byte, SERO_NONE);
+
+      SERD_PROBE3(timeout, sent_byte, i_read_timeout, i_bytes_sent);
+
+      i_num_errors++;
+
+      i_num_timeouts++;
+
+      break;
+
+    default:
+
+      /* Invalid value */
+      fprintf(stderr, "Unknown value when waiting for read\n");
+
+      break;
+
+  } /* End switch() */
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: i_check_stop()                                                      */
+/*                                                                           */
+/* Description: Stop the test once the target BER is proven or disproven,    */
+/*              or the errors allowed are exceeded. Each errored byte is     */
+/*              taken as one bit error in 8 data bits, which can only make   */
+/*              the BER look worse than it is.                               */
+/*                                                                           */
+/* Uses: void                                                                */
+/*                                                                           */
+/* Returns: void                                                             */
+/*                                                                           */
+/*****************************************************************************/
+
+static void i_check_stop(void)
+{
+
+  sers_ber_state_t ber_state;   /* Progress against the target BER */
+
+
+  if(i_target_ber > 0.0)
+  {
+
+    ber_state = sers_ber_update(&i_ber, i_bytes_sent * SERS_DATA_BITS,
+      i_num_errors);
+
+    if(ber_state == SERS_BER_PROVEN)
+    {
+
+      i_stop_test = true;
+
+    }
+    else if(ber_state == SERS_BER_DISPROVEN)
+    {
+
+      i_stop_test = true;
+
+      i_test_failed = true;
+
+    }
+
+  }
+
+  if( (i_use_max_errors == true) && (i_num_errors > i_max_errors) )
+  {
+
+    i_stop_test = true;
+
+    i_test_failed = true;
+
+  }
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: i_count_byte()                                                      */
+/*                                                                           */
+/* Description: Add the result of testing a byte to the error statistics     */
+/*                                                                           */
+/* Uses: tx_byte   - The byte sent                                           */
+/*       errored   - Was the byte corrupt or did it time out?                */
+/*       timed_out - Did the byte time out?                                  */
+/*                                                                           */
+/* Returns: void                                                             */
+/*                                                                           */
+/*****************************************************************************/
+
+static void i_count_byte(unsigned char tx_byte, bool errored, bool timed_out)
+{
+
+  struct timeval end_time;    /* When the test of the byte ended */
+  unsigned int flags;         /* Flags for the flight record     */
+  serc_kind_t kind = SERC_BYTE_OK; /* What happened, for the capture */
+
+
+  flags = i_rx_flags;
+
+  if(errored == true)
+  {
+
+    flags |= SERF_ERROR;
+
+  }
+
+  if(timed_out == true)
+  {
+
+    flags |= SERF_TIMEOUT;
+
+  }
+
+  serf_add(tx_byte, i_rx_byte, flags, i_return_time);
+
+  if(timed_out == true)
+  {
+
+    kind = SERC_BYTE_TIMEOUT;
+
+  }
+  else if( (i_rx_flags & SERF_FRAMING) != 0)
+  {
+
+    kind = SERC_BYTE_FRAMING;
+
+  }
+  else if(errored == true)
+  {
+
+    kind = SERC_BYTE_CORRUPT;
+
+  }
+
+  serc_add(kind, tx_byte, i_rx_byte, i_return_time);
+
+  sers_bits_add(&i_bits, tx_byte, errored);
+
+  seri_add(errored, timed_out, i_return_time);
+
+  serg_add(errored, timed_out, i_return_time);
+
+  /* The rest need to know when, so need the time to be ok */
+  if(serp_get_time(&end_time) == 0)
+  {
+
+    sers_burst_add(&i_bursts, i_timeval_to_ns(end_time), errored);
+
+    sers_roll_add(&i_roll, i_timeval_to_ns(end_time), errored, timed_out,
+      i_return_time);
+
+    sers_tod_add(&i_tod, i_timeval_to_ns(end_time), errored, timed_out);
+
+    /* G.821 seconds also need to know when the byte went */
+    if(i_tx_time.tv_sec != i_TIME_FAIL)
+    {
+
+      sers_g821_add(&i_g821, i_timeval_to_ns(i_tx_time),
+        i_timeval_to_ns(end_time), errored);
+
+    }
+
+  }
+
+  i_check_stop();
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: i_send_n_receive()                                                  */
+/*                                                                           */
+/* Description: Pick a byte, send it & wait for it to come back              */
+/*                                                                           */
+/* Uses: random - Send random bytes, not the TX buffer                       */
+/*       verbose - Show the bytes sent and received                          */
+/*       diags - Give detailed diagnostics of failures                       */
+/*                                                                           */
+/* Returns: void                                                             */
+/*                                                                           */
+/*****************************************************************************/
+
+static i_HOT void i_send_n_receive(bool random, bool verbose, bool diags)
+{
+
+  unsigned char tx_byte;  /* The byte to transmit  */
+  int flush_result;       /* Result of the flush   */
+
+  unsigned long long bytes_before;  /* Bytes sent before this one        */
+  unsigned long long errors_before; /* Errors before this byte           */
+  unsigned long long timeouts_before; /* Timeouts before this byte      */
+
+
+  /* Are we in random mode */
+  if(random == true)
+  {
+
+    /* Generate random byte to send */
+    tx_byte = (unsigned char) rand();
+
+  }
+  else
+  {
+
+    /* Get next byte to send */
+    tx_byte = i_tx_buf[i_tx_ptr];
+
+    /* Increment pointer to the byte to send */
+    i_tx_ptr++;
+
+    /* Wrap round the pointer to the beginning of the buffer */
+    i_tx_ptr %= i_str_len;
+
+  }
+
+  bytes_before = i_bytes_sent;
+
+  errors_before = i_num_errors;
+
+  timeouts_before = i_num_timeouts;
+
+  /* No return time until the byte comes back ok */
+  i_return_time = -1;
+
+  /* Nor any byte received */
+  i_rx_byte = SERF_NO_RX;
+
+  i_rx_flags = 0;
+
+  /* Write to the port */
+  i_wait_for_write(tx_byte, verbose, diags);
+
+  /* Read from the port */
+  i_wait_for_read(tx_byte, verbose, diags);
+
+  /* Add the byte to the error statistics, if it went */
+  if(i_bytes_sent > bytes_before)
+  {
+
+    i_count_byte(tx_byte, i_num_errors > errors_before,
+      i_num_timeouts > timeouts_before);
+
+  }
+
+  /* Flush port to get rid of any bits of the last RX */
+  /* Dump flush result                                */
+  flush_result = serp_flush_port(i_fd, diags);
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: i_send_buf_plain()                                                  */
+/*                                                                           */
+/* Description: Send and receive the next byte of the TX buffer, neither     */
+/*              verbose nor with diagnostics. The fast path.                 */
+/*                                                                           */
+/* Uses: void                                                                */
+/*                                                                           */
+/* Returns: void                                                             */
+/*                                                                           */
+/*****************************************************************************/
+
+static void i_send_buf_plain(void)
+{
+
+  i_send_n_receive(false, false, false);
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: i_send_random_plain()                                               */
+/*                                                                           */
+/* Description: Send and receive a random byte, neither verbose nor with     */
+/*              diagnostics                                                  */
+/*                                                                           */
+/* Uses: void                                                                */
+/*                                                                           */
+/* Returns: void                                                             */
+/*                                                                           */
+/*****************************************************************************/
+
+static void i_send_random_plain(void)
+{
+
+  i_send_n_receive(true, false, false);
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: i_send_buf()                                                        */
+/*                                                                           */
+/* Description: Send and receive the next byte of the TX buffer, verbose or  */
+/*              with diagnostics as asked                                    */
+/*                                                                           */
+/* Uses: void                                                                */
+/*                                                                           */
+/* Returns: void                                                             */
+/*                                                                           */
+/*****************************************************************************/
+
+static void i_send_buf(void)
+{
+
+  i_send_n_receive(false, i_verbose, i_diags);
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: i_send_random()                                                     */
+/*                                                                           */
+/* Description: Send and receive a random byte, verbose or with diagnostics  */
+/*              as asked                                                     */
+/*                                                                           */
+/* Uses: void                                                                */
+/*                                                                           */
+/* Returns: void                                                             */
+/*                                                                           */
+/*****************************************************************************/
+
+static void i_send_random(void)
+{
+
+  i_send_n_receive(true, i_verbose, i_diags);
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: i_pick_send()                                                       */
+/*                                                                           */
+/* Description: Pick the variant of the send and receive for the test's      */
+/*              mode, once before it starts                                  */
+/*                                                                           */
+/* Uses: void                                                                */
+/*                                                                           */
+/* Returns: The variant                                                      */
+/*                                                                           */
+/*****************************************************************************/
+
+static i_send_func_t i_pick_send(void)
+{
+
+  i_send_func_t send;          /* The variant picked */
+
+
+  if( (i_verbose == false) && (i_diags == false) )
+  {
+
+    send = (i_random == true) ? i_send_random_plain : i_send_buf_plain;
+
+  }
+  else
+  {
+
+    send = (i_random == true) ? i_send_random : i_send_buf;
+
+  }
+
+  return send;
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: i_check_keys()                                                      */
+/*                                                                           */
+/* Description: Check and process keypresses                                 */
+/*                                                                           */
+/* Uses: void                                                                */
+/*                                                                           */
+/* Returns: void                                                             */
+/*                                                                           */
+/*****************************************************************************/
+
+static void i_check_keys(void)
+{
+
+  int key_buf;             /* Buffer for keypresses       */
+  serp_phase_mark_t mark;  /* Start of the keypress check */
+
+
+  /* Check the keyboard */
+  serp_phase_start(&mark);
+
+  key_buf = getchar();
+
+  serp_phase_end(SERP_PHASE_KEYS, &mark);
+
+  /* Has there been a keypress? */
+  if(key_buf != -1)
+  {
+
+    /* Make all chars lower case */
+    key_buf = tolower(key_buf);
+
+    /* Check what was pressed, and act on it */
+    switch (key_buf)
+    {
+
+      case 'q': /* 'q' pressed, flag we want to quit */
+
+        i_q_pressed = true;
+
+        break;
+
+      case 'i': /* 'i' pressed, flag we want intermediate results */
+
+        i_i_pressed = true;
+
+        break;
+
+      default:
+
+        /* Don't know what to do with that char, so bell */
+        printf("\a");
+
+        break;
+
+    } /* End switch() */
+
+  }
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: i_pause()                                                           */
+/*                                                                           */
+/* Description: Wait, for a bit                                              */
+/*                                                                           */
+/* Uses: void                                                                */
+/*                                                                           */
+/* Returns: A flag indicating success or failure                             */
+/*                                                                           */
+/*****************************************************************************/
+
+static int i_pause(double pause_time)
+{
+
+  struct timespec tv;        /* Structure to hold the requested time */
+  int nanosleep_result = 0;  /* The return from the nanosleep call   */
+  bool finished = false;     /* Have we finished sleeping yet?       */
+
+
+  if( pause_time != (double) 0)
+  {
+
+    /* Sort out the seconds */
+    tv.tv_sec = (time_t) pause_time;
+
+    /* ... and then the remainder in nanoseconds. */
+    tv.tv_nsec = (long) ((pause_time - tv.tv_sec) * 1e+9);
+
+    while (finished == false)
+    {
+
+      /* Sleep for the time specified in tv. If interrupted by a      */
+      /* signal, place the remaining time left to sleep back into tv. */
+      nanosleep_result = serp_sleep(&tv);
+
+      /* Have we finished yet? */
+      if (nanosleep_result == 0)
+      {
+
+        /* Completed the entire sleep time; all done, Let's exit. */
+        finished = true;
+
+      }
+      else
+      {
+
+        /* Did an error occur? If not stay in loop */
+        if (errno != EINTR)
+        {
+
+          /* An error did occur; bail out. */
+          finished = true;
+
+        }
+
+      }
+
+    } /* End while */
+
+  }
+
+  return nanosleep_result; /*  */
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: i_char_pause()                                                      */
+/*                                                                           */
+/* Description: Add a delay between chars, if requested.                     */
+/*                                                                           */
+/* Uses: void                                                                */
+/*                                                                           */
+/* Returns: A flag indicating success or failure                             */
+/*                                                                           */
+/*****************************************************************************/
+
+static int i_char_pause(void)
+{
+
+  int pause_result = 0;  /* The return from the nanosleep call   */
+  double time_portion;   /* A small chunk of time to delay       */
+  double remaining_time; /* The time remaining                   */
+
+
+  remaining_time = i_paced_time;
+
+  while(remaining_time > 0)
+  {
+
+    if(remaining_time <= i_ESCAPE_TIME)
+    {
+
+      time_portion = remaining_time;
+
+      remaining_time = 0;
+
+    }
+    else
+    {
+
+      time_portion = i_ESCAPE_TIME;
+
+      remaining_time = remaining_time - i_ESCAPE_TIME;
+
+    }
+
+    pause_result = i_pause(time_portion);
+
+    /* Check for keypresses */
+    i_check_keys();
+
+    /* Show intermediate results */
+    i_show_intermediate();
+
+    if(i_q_pressed == true)
+    {
+
+      /* Break out of while loop */
+      remaining_time = 0;
+
+    }
+
+  } /* End while */
+  
+  return pause_result;
+  
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: i_bert_by_num()                                                     */
+/*                                                                           */
+/* Description: Perform a bit error rate test for a given number of bytes    */
+/*                                                                           */
+/* Uses: send - The variant of the send and receive for the mode             */
+/*                                                                           */
+/* Returns: void                                                             */
+/*                                                                           */
+/*****************************************************************************/
+
+static void i_bert_by_num(i_send_func_t send)
+{
+
+  unsigned long long bytes_sent; /* Current count of bytes sent  */
+
+  /* Send bytes to send */
+  for(bytes_sent = 0; ( (bytes_sent < i_tx_len) && (i_q_pressed == false)
+    && (i_stop_test == false) ); bytes_sent++)
+  {
+
+    /* Do the sending and receiving stuff */
+    send();
+
+    /* Check for keypresses */
+    i_check_keys();
+
+    /* Show intermediate results */
+    i_show_intermediate();
+
+    /* Put in a delay for paced output */
+    (void) i_char_pause();
+
+  }
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: i_bert_by_time()                                                    */
+/*                                                                           */
+/* Description: Perform a bit error rate test for a given time               */
+/*                                                                           */
+/* Uses: send - The variant of the send and receive for the mode             */
+/*                                                                           */
+/* Returns: void                                                             */
+/*                                                                           */
+/*****************************************************************************/
+
+static void i_bert_by_time(i_send_func_t send)
+{
+
+  time_t runtime = 0;       /* Length of time the test has run in seconds */
+
+
+  /* Send bytes for given time */
+  while( (runtime < i_send_time) && (i_q_pressed == false)
+    && (i_stop_test == false) )
+  {
+
+    /* Do the sending and receiving stuff */
+    send();
+
+    /* Check for keypresses */
+    i_check_keys();
+
+    /* Show intermediate results */
+    i_show_intermediate();
+
+    /* Check the runtime */
+    runtime = i_get_runtime();
+
+    /* Did we get runtime ok? */
+    if(runtime == i_TIME_FAIL)
+    {
+
+      /* Cause breakout of program */
+      runtime = i_send_time;
+
+    }
+
+    /* Put in a delay for paced output */
+    (void) i_char_pause();
+
+  } /* End while */
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: i_bert_continuous()                                                 */
+/*                                                                           */
+/* Description: Perform a bit error rate test continuously                   */
+/*                                                                           */
+/* Uses: send - The variant of the send and receive for the mode             */
+/*                                                                           */
+/* Returns: void                                                             */
+/*                                                                           */
+/*****************************************************************************/
+
+static void i_bert_continuous(i_send_func_t send)
+{
+
+  /* Send bytes for given time */
+  while( (i_q_pressed == false) && (i_stop_test == false) )
+  {
+
+    /* Do the sending and receiving stuff */
+    send();
+
+    /* Check for keypresses */
+    i_check_keys();
+
+    /* Show intermediate results */
+    i_show_intermediate();
+
+    /* Put in a delay for paced output */
+    (void) i_char_pause();
+
+  } /* End while */
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: i_bert()                                                            */
+/*                                                                           */
+/* Description: Perform a bit error rate test. The host is tuned for this   */
+/*              thread once the threads reporting errors and intervals have  */
+/*              started, so they keep the normal scheduling and any CPU.     */
+/*                                                                           */
+/* Uses: void                                                                */
+/*                                                                           */
+/* Returns: Whether the test was run, or the host couldn't be tuned          */
+/*                                                                           */
+/*****************************************************************************/
+
+static bool i_bert()
+{
+
+  time_t stop_time;  /* The time the test finished */
+  time_t interval;   /* Secs between snapshots      */
+  i_send_func_t send; /* Send and receive for the mode */
+  serh_status_t host_status; /* Result of tuning the host */
+
+
+  i_start_time = i_get_time();
+
+  send = i_pick_send();
+
+  /* Start testing against the target BER, if there is one */
+  if(i_target_ber > 0.0)
+  {
+
+    sers_ber_init(&i_ber, i_target_ber, i_confidence);
+
+  }
+
+  /* Report errors from their own thread, so a flood of them doesn't slow */
+  /* the test down. In verbose mode they're kept in line with each byte.  */
+  if(i_verbose == false)
+  {
+
+    if(serr_start() == SERR_OK)
+    {
+
+      serp_set_report_func(serr_message);
+
+    }
+
+  }
+
+  /* Take snapshots of the results at each interval, if wanted */
+  if(i_intermediate == true)
+  {
+
+    interval = i_intermediate_time;
+
+  }
+  else
+  {
+
+    interval = (time_t) i_DEFAULT_RECORD_SECS;
+
+  }
+
+  if( (i_intermediate == true) || (i_output == true) )
+  {
+
+    if(seri_start( (long long) interval * SERS_NSEC_IN_SEC,
+      i_report_interval) != SERI_OK)
+    {
+
+      fprintf(stderr, "Failure starting interval timer\n");
+
+    }
+
+  }
+
+  /* Tune the host for this thread alone, now the others have started */
+  host_status = serh_apply(&i_host);
+
+  if(host_status != SERH_OK)
+  {
+
+    fprintf(stderr, "Failure %s: %s\n", i_HOST_FAILURES[host_status],
+      strerror(errno) );
+
+  }
+  else
+  {
+
+    /* Select how to do the test: number, time or continuous */
+    switch (i_how_test)
+    {
+
+      case i_TEST_NUM: /* Test by the number of bytes to send */
+
+        i_bert_by_num(send);
+
+        break;
+
+      case i_TEST_TIME: /* Test by time */
+
+        i_bert_by_time(send);
+
+        break;
+
+      case i_TEST_CONTINUOUS: /* Test continuously */
+
+        i_bert_continuous(send);
+
+        break;
+
+      default:
+
+        /* Don't know what to do, so test by number */
+        i_bert_by_num(send);
+
+        break;
+
+    } /* End switch() */
+
+  }
+
+  stop_time = i_get_time();
+
+  seri_stop();
+
+  /* Wait for any errors still waiting to be reported */
+  serp_set_report_func(NULL);
+
+  serr_stop();
+
+  /* Calculate runtime */
+  if( (i_start_time != i_TIME_FAIL) && (stop_time != i_TIME_FAIL) )
+  {
+
+    i_runtime = (time_t) difftime(stop_time, i_start_time);
+
+  }
+
+  return (host_status == SERH_OK);
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: i_process_paced()                                                   */
+/*                                                                           */
+/* Description: Check and process the time between sending bytes. The str    */
+/*              terminating char indicates secs or msecs.                    */
+/*                                                                           */
+/* Uses: paced_str - Pointer to a string which is the time, in secs or       */
+/*                   msecs, to delay sending a byte.                         */
+/*                                                                           */
+/* Returns: Status indicating if the given time string is valid, or not      */
+/*                                                                           */
+/*****************************************************************************/
+
+static arg_status_t i_process_paced(char *paced_str)
+{
+
+  arg_status_t arg_status = i_ARG_VALID; /* Flag indicating if arg is valid */
+  double paced_time = 0;                 /* The time between chars          */
+
+
+  /* Convert time to numeric */
+  paced_time = strtod(paced_str, (char**) NULL);
+
+
+  /* strtod signals an overflow and underflow error with HUGE_VAL and 0 */
+  /* respectively. Also, nanopause does not like values over 2147483647 */
+  /* (LONG_MAX) (Sees it as negative?) and we want 1 nanosec as the     */
+  /* minimum.                                                           */
+  if( (paced_time == HUGE_VAL) || (paced_time < 0.000000001) || 
+    (paced_time > LONG_MAX))
+  {
+
+    /* Given string is out of range */
+    fprintf(stderr, "Invalid paced time\n");
+
+    arg_status = i_ARG_INVALID;
+
+  }
+  else
+  {
+
+    /* Store paced delay time */
+    i_paced_time = paced_time;
+
+  }
+
+  /* Return status - was the string OK, or not */
+  return arg_status;
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: i_process_knum_bytes()                                              */
+/*                                                                           */
+/* Description: Check and process the number of bytes to send in k or K      */
+/*                                                                           */
+/* Uses: knum_str - Pointer to a string which is the num of bytes to send    */
+/*       bin_not_dec - Is the multiplier binary or decimal: 1000 or 1024     */
+/*                                                                           */
+/* Returns: Status indicating if the bytes to send string is valid, or not   */
+/*                                                                           */
+/*****************************************************************************/
+
+static arg_status_t i_process_knum_bytes(char *knum_str,
+  bin_not_dec_t bin_not_dec)
+{
+
+  arg_status_t arg_status = i_ARG_VALID; /* Flag indicating if arg is valid */
+  unsigned long knum_bytes = 0;          /* No. of k bytes as a number      */
+  unsigned long kbyte;                   /* Value for 1 k - 1000 or 1024    */
+
+
+  /* Select the value for 1K - 1000 or 1024 */
+  if(bin_not_dec == i_BIN)
+  {
+
+    kbyte = i_KIBIBYTE;
+
+  }
+  else
+  {
+
+    kbyte = i_KILOBYTE;
+
+  }
+
+  /* Convert knum bytes string into an unsigned long */
+  knum_bytes = strtoul(knum_str, (char**) NULL, 10);
+
+  /* Is value invalid? */
+  if( (knum_bytes >= ULONG_MAX) || (knum_bytes < 1) )
+  {
+
+    fprintf(stderr, "Invalid number of bytes to send argument\n");
+
+    arg_status = i_ARG_INVALID;
+
+  }
+  else
+  {
+
+    /* Store valid number of bytes to transmit, multiplied by 1k */
+    i_tx_len = knum_bytes * kbyte;
+
+    /* Set binary or decimal multipliers to decimal (1000) */
+    i_bin_not_dec = bin_not_dec;
+
+    /* Note the user has requested to send by number of bytes */
+    i_how_test = i_TEST_NUM;
+
+    arg_status = i_ARG_VALID;
+
+  }
+
+  /* Return status - was the string OK, or not */
+  return arg_status;
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: i_process_dec_knum_bytes()                                          */
+/*                                                                           */
+/* Description: Check and process the number of bytes to send in k (1000)    */
+/*                                                                           */
+/* Uses: knum_str - Pointer to a string which is the num of bytes to send    */
+/*                                                                           */
+/* Returns: Status indicating if the bytes to send string is valid, or not   */
+/*                                                                           */
+/*****************************************************************************/
+
+static arg_status_t i_process_dec_knum_bytes(char *knum_str)
+{
+
+  return i_process_knum_bytes(knum_str, i_DEC);
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: i_process_bin_knum_bytes()                                          */
+/*                                                                           */
+/* Description: Check and process the number of bytes to send in K (1024)    */
+/*                                                                           */
+/* Uses: knum_str - Pointer to a string which is the num of bytes to send    */
+/*                                                                           */
+/* Returns: Status indicating if the bytes to send string is valid, or not   */
+/*                                                                           */
+/*****************************************************************************/
+
+static arg_status_t i_process_bin_knum_bytes(char *knum_str)
+{
+
+  return i_process_knum_bytes(knum_str, i_BIN);
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: i_process_num_bytes()                                               */
+/*                                                                           */
+/* Description: Check and process the number of bytes to send                */
+/*                                                                           */
+/* Uses: num_str - Pointer to a string which is the num of bytes to send     */
+/*                                                                           */
+/* Returns: Status indicating if the bytes to send string is valid, or not   */
+/*                                                                           */
+/*****************************************************************************/
+
+static arg_status_t i_process_num_bytes(char *num_str)
+{
+
+  arg_status_t arg_status = i_ARG_VALID;  /* Flag indicating if arg is valid */
+  unsigned long num_bytes = 0;            /* No. of bytes as a number        */
+
+
+  /* Convert num bytes string into an unsigned long */
+  num_bytes = strtoul(num_str, (char**) NULL, 10);
+
+  /* Is value invalid? */
+  if( (num_bytes >= ULONG_MAX) || (num_bytes < 1) )
+  {
+
+    fprintf(stderr, "Invalid number of bytes to send argument\n");
+
+    arg_status = i_ARG_INVALID;
+
+  }
+  else
+  {
+
+    /* Store valid number of bytes to transmit */
+    i_tx_len = (unsigned long long) num_bytes;
+
+    /* Note the user has requested to send by number of bytes */
+    i_how_test = i_TEST_NUM;
+
+    arg_status = i_ARG_VALID;
+
+  }
+
+  /* Return status - was the string OK, or not */
+  return arg_status;
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: i_process_mins()                                                    */
+/*                                                                           */
+/* Description: Check and process the minutes to send command line argument  */
+/*                                                                           */
+/* Uses: mins_str - Pointer to a string which is the number of mins to use   */
+/*                                                                           */
+/* Returns: Status indicating if the mins string is valid, or not            */
+/*                                                                           */
+/*****************************************************************************/
+
+static arg_status_t i_process_mins(char *mins_str)
+{
+
+  arg_status_t arg_status = i_ARG_VALID; /* Flag indicating if arg is valid */
+  time_t mins_num = 0;                   /* Minutes as a number             */
+
+
+  /* Convert mins string into an long */
+  mins_num = (time_t) strtol(mins_str, (char**) NULL, 10);
+
+  /* Is value invalid? */
+  if( (mins_num > ( i_TIME_MAX / i_SEC_IN_MIN) ) || (mins_num < 1) )
+  {
+
+    fprintf(stderr, "Invalid minutes argument\n");
+
+    arg_status = i_ARG_INVALID;
+
+  }
+  else
+  {
+
+    /* Store valid send time value in seconds */
+    i_send_time = mins_num * (time_t) i_SEC_IN_MIN;
+
+    /* Note the user has requested to send by time */
+    i_how_test = i_TEST_TIME;
+
+    arg_status = i_ARG_VALID;
+
+  }
+
+  /* Return status - was the string OK, or not */
+  return arg_status;
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: i_process_hours()                                                   */
+/*                                                                           */
+/* Description: Check and process the hours to send command line argument    */
+/*                                                                           */
+/* Uses: hours_str - Pointer to a string which is the number of hours to use */
+/*                                                                           */
+/* Returns: Status indicating if the hours string is valid, or not           */
+/*                                                                           */
+/*****************************************************************************/
+
+static arg_status_t i_process_hours(char *hours_str)
+{
+
+  arg_status_t arg_status = i_ARG_VALID; /* Flag indicating if arg is valid */
+  time_t hours_num = 0;                  /* Hours as a number               */
+
+
+  /* Convert hours string into an long */
+  hours_num = (time_t) strtol(hours_str, (char**) NULL, 10);
+
+  /* Is value invalid? */
+  if( (hours_num > ( i_TIME_MAX / i_SEC_IN_HOUR) ) || (hours_num < 1) )
+  {
+
+    fprintf(stderr, "Invalid hours argument\n");
+
+    arg_status = i_ARG_INVALID;
+
+  }
+  else
+  {
+
+    /* Store valid send time value in seconds */
+    i_send_time = hours_num * (time_t) i_SEC_IN_HOUR;
+
+    /* Note the user has requested to send by time */
+    i_how_test = i_TEST_TIME;
+
+    arg_status = i_ARG_VALID;
+
+  }
+
+  /* Return status - was the string OK, or not */
+  return arg_status;
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: i_process_intermediate()                                            */
+/*                                                                           */
+/* Description: Check and process the intermediate command line argument     */
+/*                                                                           */
+/* Uses: disp_tim_str - Pointer to a string which is the No. of secs to use  */
+/*                                                                           */
+/* Returns: Status indicating if the seconds string is valid,or not          */
+/*                                                                           */
+/*****************************************************************************/
+
+static arg_status_t i_process_intermediate(char *disp_tim_str)
+{
+
+  arg_status_t arg_status = i_ARG_VALID; /* Flag indicating if arg is valid */
+  time_t disp_tim_num = 0;               /* Display time as a number        */
+
+
+  /* Convert display time string into an long */
+  disp_tim_num = (time_t) strtol(disp_tim_str, (char**) NULL, 10);
+
+  /* Is value invalid? */
+  if( (disp_tim_num >= (time_t) LONG_MAX) || (disp_tim_num < 1) )
+  {
+
+    fprintf(stderr, "Invalid intermediate (i-) argument\n");
+
+    arg_status = i_ARG_INVALID;
+
+  }
+  else
+  {
+
+    /* Store valid display time value */
+    i_intermediate_time = disp_tim_num;
+
+    /* Note the user has requested intermediate results */
+    i_intermediate = true;
+
+    /* Quiet mode would be a good idea */
+    i_quiet = true;
+
+    /* Intermediate and verbose don't mix */
+    i_verbose = false;
+
+    arg_status = i_ARG_VALID;
+
+  }
+
+  /* Return status - was the string OK, or not */
+  return arg_status;
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: i_process_timeout()                                                 */
+/*                                                                           */
+/* Description: Check and process the read timeout command line argument     */
+/*                                                                           */
+/* Uses: timeout_str - Pointer to a string which is the read timeout to use  */
+/*                                                                           */
+/* Returns: Status indicating if the timeout string is valid, or not         */
+/*                                                                           */
+/*****************************************************************************/
+
+static arg_status_t i_process_timeout(char *timeout_str)
+{
+
+  arg_status_t arg_status = i_ARG_VALID; /* Flag indicating if arg is valid */
+  serp_timeout_t timeout_num = 0;        /* Timeout as a number             */
+
+
+  /* Convert timeout string into an unsigned long */
+  timeout_num = (serp_timeout_t) strtoul(timeout_str, (char**) NULL, 10);
+
+  /* Is value invalid? (greater than 10 secs or less than 1 microsec) */
+  if( (timeout_num > SERP_TIMEOUT_MAX) || (timeout_num < 1) )
+  {
+
+    fprintf(stderr, "Invalid timeout argument\n");
+
+    arg_status = i_ARG_INVALID;
+
+  }
+  else
+  {
+
+    /* Store valid read timeout value*/
+    i_read_timeout = timeout_num;
+
+    /* Note the user has set the timeout */
+    i_user_set_timeout = true;
+
+    arg_status = i_ARG_VALID;
+
+  }
+
+  /* Return status - was the string OK, or not */
+  return arg_status;
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: i_process_target_ber()                                              */
+/*                                                                           */
+/* Description: Check and process the target BER command line argument      */
+/*                                                                           */
+/* Uses: ber_str - Pointer to a string which is the target BER, e.g. 1e-9    */
+/*                                                                           */
+/* Returns: Status indicating if the target BER string is valid, or not      */
+/*                                                                           */
+/*****************************************************************************/
+
+static arg_status_t i_process_target_ber(char *ber_str)
+{
+
+  arg_status_t arg_status = i_ARG_VALID; /* Flag indicating if arg is valid */
+  double target_ber = 0;                 /* The target BER                  */
+
+
+  /* Convert BER to numeric */
+  target_ber = strtod(ber_str, (char**) NULL);
+
+  /* A BER is a ratio, so must be above 0 and below 1 */
+  if( (target_ber <= 0.0) || (target_ber >= 1.0) )
+  {
+
+    fprintf(stderr, "Invalid target BER\n");
+
+    arg_status = i_ARG_INVALID;
+
+  }
+  else
+  {
+
+    /* Store target BER */
+    i_target_ber = target_ber;
+
+  }
+
+  /* Return status - was the string OK, or not */
+  return arg_status;
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: i_process_confidence()                                              */
+/*                                                                           */
+/* Description: Check and process the confidence level command line argument */
+/*                                                                           */
+/* Uses: conf_str - Pointer to a string which is the confidence level, in %  */
+/*                                                                           */
+/* Returns: Status indicating if the confidence string is valid, or not      */
+/*                                                                           */
+/*****************************************************************************/
+
+static arg_status_t i_process_confidence(char *conf_str)
+{
+
+  arg_status_t arg_status = i_ARG_VALID; /* Flag indicating if arg is valid */
+  double confidence = 0;                 /* The confidence level            */
+
+
+  /* Convert confidence to numeric */
+  confidence = strtod(conf_str, (char**) NULL);
+
+  /* 100% confidence would need an infinite test */
+  if( (confidence <= 0.0) || (confidence >= 100.0) )
+  {
+
+    fprintf(stderr, "Invalid confidence level\n");
+
+    arg_status = i_ARG_INVALID;
+
+  }
+  else
+  {
+
+    /* Store confidence level */
+    i_confidence = confidence;
+
+  }
+
+  /* Return status - was the string OK, or not */
+  return arg_status;
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: i_process_max_errors()                                              */
+/*                                                                           */
+/* Description: Check and process the errors allowed command line argument   */
+/*                                                                           */
+/* Uses: errors_str - Pointer to a string which is the errors allowed        */
+/*                                                                           */
+/* Returns: Status indicating if the errors string is valid, or not          */
+/*                                                                           */
+/*****************************************************************************/
+
+static arg_status_t i_process_max_errors(char *errors_str)
+{
+
+  arg_status_t arg_status = i_ARG_VALID; /* Flag indicating if arg is valid */
+  unsigned long long max_errors = 0;     /* The errors allowed              */
+  char *end_ptr;                         /* End of the number in the string */
+
+
+  errno = 0;
+
+  /* Convert errors allowed into a number */
+  max_errors = strtoull(errors_str, &end_ptr, 10);
+
+  /* Must be a plain number */
+  if( (errno != 0) || (end_ptr == errors_str) || (*end_ptr != '\0')
+    || (errors_str[0] == '-') )
+  {
+
+    fprintf(stderr, "Invalid errors allowed (x-) argument\n");
+
+    arg_status = i_ARG_INVALID;
+
+  }
+  else
+  {
+
+    /* Store errors allowed */
+    i_max_errors = max_errors;
+
+    i_use_max_errors = true;
+
+  }
+
+  /* Return status - was the string OK, or not */
+  return arg_status;
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: i_set_output()                                                      */
+/*                                                                           */
+/* Description: Note where to write machine readable records, and how        */
+/*                                                                           */
+/* Uses: path_str - Pointer to a string which is the file, or "-"            */
+/*       format   - The format to write the records in                       */
+/*                                                                           */
+/* Returns: Status indicating if the file string is valid, or not            */
+/*                                                                           */
+/*****************************************************************************/
+
+static arg_status_t i_set_output(char *path_str, sero_format_t format)
+{
+
+  arg_status_t arg_status = i_ARG_VALID; /* Flag indicating if arg is valid */
+
+
+  /* Only one output is allowed */
+  if( (strlen(path_str) == 0) || (i_output == true) )
+  {
+
+    fprintf(stderr, "Invalid output file (w- or W-) argument\n");
+
+    arg_status = i_ARG_INVALID;
+
+  }
+  else
+  {
+
+    (void) strncpy(i_output_path, path_str, i_MAX_ARG_LEN);
+
+    i_output_path[i_MAX_ARG_LEN] = i_STR_TERM;
+
+    i_output_format = format;
+
+    i_output = true;
+
+  }
+
+  /* Return status - was the string OK, or not */
+  return arg_status;
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: i_process_json_output()                                             */
+/*                                                                           */
+/* Description: Check and process the JSON Lines output command line         */
+/*              argument                                                     */
+/*                                                                           */
+/* Uses: path_str - Pointer to a string which is the file, or "-"            */
+/*                                                                           */
+/* Returns: Status indicating if the file string is valid, or not            */
+/*                                                                           */
+/*****************************************************************************/
+
+static arg_status_t i_process_json_output(char *path_str)
+{
+
+  return i_set_output(path_str, SERO_JSON);
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: i_process_csv_output()                                              */
+/*                                                                           */
+/* Description: Check and process the CSV output command line argument       */
+/*                                                                           */
+/* Uses: path_str - Pointer to a string which is the file, or "-"            */
+/*                                                                           */
+/* Returns: Status indicating if the file string is valid, or not            */
+/*                                                                           */
+/*****************************************************************************/
+
+static arg_status_t i_process_csv_output(char *path_str)
+{
 
-  }
+  return i_set_output(path_str, SERO_CSV);
 
 }
 
 
 /*****************************************************************************/
 /*                                                                           */
-/* Name: i_process_paced()                                                   */
+/* Name: i_process_metrics()                                                 */
 /*                                                                           */
-/* Description: Check and process the time between sending bytes. The str    */
-/*              terminating char indicates secs or msecs.                    */
+/* Description: Check and process the metrics command line argument          */
 /*                                                                           */
-/* Uses: paced_str - Pointer to a string which is the time, in secs or       */
-/*                   msecs, to delay sending a byte.                         */
+/* Uses: address_str - Pointer to a string which is the TCP port number, or  */
+/*                     the Unix socket path                                  */
 /*                                                                           */
-/* Returns: Status indicating if the given time string is valid, or not      */
+/* Returns: Status indicating if the address string is valid, or not         */
 /*                                                                           */
 /*****************************************************************************/
 
-static arg_status_t i_process_paced(char *paced_str)
+static arg_status_t i_process_metrics(char *address_str)
 {
 
   arg_status_t arg_status = i_ARG_VALID; /* Flag indicating if arg is valid */
-  double paced_time = 0;                 /* The time between chars          */
+  unsigned long tcp_port;                /* TCP port number                 */
+  char *end_ptr;                         /* End of the number in the string */
 
 
-  /* Convert time to numeric */
-  paced_time = strtod(paced_str, (char**) NULL);
+  /* Must be a socket path, or a plain number that is a TCP port */
+  if(address_str[0] != '/')
+  {
 
+    tcp_port = strtoul(address_str, &end_ptr, 10);
 
-  /* strtod signals an overflow and underflow error with HUGE_VAL and 0 */
-  /* respectively. Also, nanopause does not like values over 2147483647 */
-  /* (LONG_MAX) (Sees it as negative?) and we want 1 nanosec as the     */
-  /* minimum.                                                           */
-  if( (paced_time == HUGE_VAL) || (paced_time < 0.000000001) || 
-    (paced_time > LONG_MAX))
-  {
+    if( (end_ptr == address_str) || (*end_ptr != '\0') || (tcp_port < 1)
+      || (tcp_port > (unsigned long) i_MAX_TCP_PORT) )
+    {
 
-    /* Given string is out of range */
-    fprintf(stderr, "Invalid paced time\n");
+      fprintf(stderr, "Invalid metrics (M-) argument\n");
 
-    arg_status = i_ARG_INVALID;
+      arg_status = i_ARG_INVALID;
+
+    }
 
   }
-  else
+
+  if(arg_status == i_ARG_VALID)
   {
 
-    /* Store paced delay time */
-    i_paced_time = paced_time;
+    (void) strncpy(i_metrics_address, address_str, i_MAX_ARG_LEN);
+
+    i_metrics_address[i_MAX_ARG_LEN] = i_STR_TERM;
+
+    i_metrics = true;
 
   }
 
@@ -1734,48 +4027,49 @@ static arg_status_t i_process_paced(char *paced_str)
 
 /*****************************************************************************/
 /*                                                                           */
-/* Name: i_process_knum_bytes()                                              */
+/* Name: i_process_shared()                                                  */
 /*                                                                           */
-/* Description: Check and process the number of bytes to send in k or K      */
+/* Description: Check and process the shared memory command line argument    */
 /*                                                                           */
-/* Uses: knum_str - Pointer to a string which is the num of bytes to send    */
-/*       bin_not_dec - Is the multiplier binary or decimal: 1000 or 1024     */
+/* Uses: void                                                                */
 /*                                                                           */
-/* Returns: Status indicating if the bytes to send string is valid, or not   */
+/* Returns: Status indicating if argument is valid, or not                   */
 /*                                                                           */
 /*****************************************************************************/
 
-static arg_status_t i_process_knum_bytes(char *knum_str,
-  bin_not_dec_t bin_not_dec)
+static arg_status_t i_process_shared(void)
 {
 
-  arg_status_t arg_status = i_ARG_VALID; /* Flag indicating if arg is valid */
-  unsigned long knum_bytes = 0;          /* No. of k bytes as a number      */
-  unsigned long kbyte;                   /* Value for 1 k - 1000 or 1024    */
+  /* Publish the statistics for monitors */
+  i_shared = true;
 
+  return i_ARG_VALID;
 
-  /* Select the value for 1K - 1000 or 1024 */
-  if(bin_not_dec == i_BIN)
-  {
+}
 
-    kbyte = i_KIBIBYTE;
 
-  }
-  else
-  {
+/*****************************************************************************/
+/*                                                                           */
+/* Name: i_process_flight()                                                  */
+/*                                                                           */
+/* Description: Check and process the flight record command line argument    */
+/*                                                                           */
+/* Uses: path_str - The file to keep the flight record in                    */
+/*                                                                           */
+/* Returns: Status indicating if argument is valid, or not                   */
+/*                                                                           */
+/*****************************************************************************/
 
-    kbyte = i_KILOBYTE;
+static arg_status_t i_process_flight(char *path_str)
+{
 
-  }
+  arg_status_t arg_status = i_ARG_VALID; /* Flag indicating if arg is valid */
 
-  /* Convert knum bytes string into an unsigned long */
-  knum_bytes = strtoul(knum_str, (char**) NULL, 10);
 
-  /* Is value invalid? */
-  if( (knum_bytes >= ULONG_MAX) || (knum_bytes < 1) )
+  if(strlen(path_str) == 0)
   {
 
-    fprintf(stderr, "Invalid number of bytes to send argument\n");
+    fprintf(stderr, "Invalid flight record (F-) argument\n");
 
     arg_status = i_ARG_INVALID;
 
@@ -1783,16 +4077,11 @@ static arg_status_t i_process_knum_bytes(char *knum_str,
   else
   {
 
-    /* Store valid number of bytes to transmit, multiplied by 1k */
-    i_tx_len = knum_bytes * kbyte;
-
-    /* Set binary or decimal multipliers to decimal (1000) */
-    i_bin_not_dec = bin_not_dec;
+    (void) strncpy(i_flight_path, path_str, i_MAX_ARG_LEN);
 
-    /* Note the user has requested to send by number of bytes */
-    i_how_test = i_TEST_NUM;
+    i_flight_path[i_MAX_ARG_LEN] = i_STR_TERM;
 
-    arg_status = i_ARG_VALID;
+    i_flight = true;
 
   }
 
@@ -1804,71 +4093,99 @@ static arg_status_t i_process_knum_bytes(char *knum_str,
 
 /*****************************************************************************/
 /*                                                                           */
-/* Name: i_process_dec_knum_bytes()                                          */
+/* Name: i_process_capture()                                                 */
 /*                                                                           */
-/* Description: Check and process the number of bytes to send in k (1000)    */
+/* Description: Check and process the capture file command line argument     */
 /*                                                                           */
-/* Uses: knum_str - Pointer to a string which is the num of bytes to send    */
+/* Uses: path_str - The file to capture every byte to                        */
 /*                                                                           */
-/* Returns: Status indicating if the bytes to send string is valid, or not   */
+/* Returns: Status indicating if argument is valid, or not                   */
 /*                                                                           */
 /*****************************************************************************/
 
-static arg_status_t i_process_dec_knum_bytes(char *knum_str)
+static arg_status_t i_process_capture(char *path_str)
 {
 
-  return i_process_knum_bytes(knum_str, i_DEC);
+  arg_status_t arg_status = i_ARG_VALID; /* Flag indicating if arg is valid */
 
-}
 
+  if(strlen(path_str) == 0)
+  {
 
-/*****************************************************************************/
-/*                                                                           */
-/* Name: i_process_bin_knum_bytes()                                          */
-/*                                                                           */
-/* Description: Check and process the number of bytes to send in K (1024)    */
-/*                                                                           */
-/* Uses: knum_str - Pointer to a string which is the num of bytes to send    */
-/*                                                                           */
-/* Returns: Status indicating if the bytes to send string is valid, or not   */
-/*                                                                           */
-/*****************************************************************************/
+    fprintf(stderr, "Invalid capture file (L-) argument\n");
 
-static arg_status_t i_process_bin_knum_bytes(char *knum_str)
-{
+    arg_status = i_ARG_INVALID;
 
-  return i_process_knum_bytes(knum_str, i_BIN);
+  }
+  else
+  {
+
+    (void) strncpy(i_capture_path, path_str, i_MAX_ARG_LEN);
+
+    i_capture_path[i_MAX_ARG_LEN] = i_STR_TERM;
+
+    i_capture = true;
+
+  }
+
+  /* Return status - was the string OK, or not */
+  return arg_status;
 
 }
 
 
 /*****************************************************************************/
 /*                                                                           */
-/* Name: i_process_num_bytes()                                               */
+/* Name: i_process_emulator()                                                */
 /*                                                                           */
-/* Description: Check and process the number of bytes to send                */
+/* Description: Check and process the loopback emulator command line         */
+/*              argument: the delay in microseconds, then optionally the     */
+/*              most bytes a second and the most bytes echoed at once,       */
+/*              separated by commas                                          */
 /*                                                                           */
-/* Uses: num_str - Pointer to a string which is the num of bytes to send     */
+/* Uses: spec_str - Pointer to a string which is the emulator settings       */
 /*                                                                           */
-/* Returns: Status indicating if the bytes to send string is valid, or not   */
+/* Returns: Status indicating if argument is valid, or not                   */
 /*                                                                           */
 /*****************************************************************************/
 
-static arg_status_t i_process_num_bytes(char *num_str)
+static arg_status_t i_process_emulator(char *spec_str)
 {
 
-  arg_status_t arg_status = i_ARG_VALID;  /* Flag indicating if arg is valid */
-  unsigned long num_bytes = 0;            /* No. of bytes as a number        */
+  arg_status_t arg_status = i_ARG_VALID; /* Flag indicating if arg is valid */
+  unsigned long values[i_EMULATOR_VALUES] = { 0, 0, 0 };
+                                         /* Delay, rate and chunk           */
+  unsigned int value_no = 0;             /* Value being converted           */
+  char *value_str = spec_str;            /* Start of the value              */
+  char *end_ptr;                         /* End of the value                */
 
 
-  /* Convert num bytes string into an unsigned long */
-  num_bytes = strtoul(num_str, (char**) NULL, 10);
+  do
+  {
 
-  /* Is value invalid? */
-  if( (num_bytes >= ULONG_MAX) || (num_bytes < 1) )
+    errno = 0;
+
+    values[value_no] = strtoul(value_str, &end_ptr, 10);
+
+    if( (errno != 0) || (end_ptr == value_str) || (value_str[0] == '-') )
+    {
+
+      arg_status = i_ARG_INVALID;
+
+    }
+
+    value_no++;
+
+    value_str = end_ptr + 1;
+
+  } while( (arg_status == i_ARG_VALID) && (*end_ptr == ',')
+    && (value_no < (unsigned int) i_EMULATOR_VALUES) );
+
+  if( (arg_status == i_ARG_INVALID) || (*end_ptr != '\0')
+    || (values[2] > (unsigned long) SERE_BUF_LEN) )
   {
 
-    fprintf(stderr, "Invalid number of bytes to send argument\n");
+    fprintf(stderr, "Invalid emulator (E-) argument\n");
 
     arg_status = i_ARG_INVALID;
 
@@ -1876,13 +4193,11 @@ static arg_status_t i_process_num_bytes(char *num_str)
   else
   {
 
-    /* Store valid number of bytes to transmit */
-    i_tx_len = (unsigned long long) num_bytes;
+    i_emulator.delay_us = values[0];
 
-    /* Note the user has requested to send by number of bytes */
-    i_how_test = i_TEST_NUM;
+    i_emulator.rate = values[1];
 
-    arg_status = i_ARG_VALID;
+    i_emulator.chunk = (unsigned int) values[2];
 
   }
 
@@ -1894,31 +4209,91 @@ static arg_status_t i_process_num_bytes(char *num_str)
 
 /*****************************************************************************/
 /*                                                                           */
-/* Name: i_process_mins()                                                    */
+/* Name: i_process_faults()                                                  */
 /*                                                                           */
-/* Description: Check and process the minutes to send command line argument  */
+/* Description: Check and process the fault injection command line argument: */
+/*              the chance of a burst of faults starting at each byte, then  */
+/*              optionally the bytes in each burst and the letters of the    */
+/*              faults allowed, separated by commas                          */
 /*                                                                           */
-/* Uses: mins_str - Pointer to a string which is the number of mins to use   */
+/* Uses: spec_str - Pointer to a string which is the fault settings          */
 /*                                                                           */
-/* Returns: Status indicating if the mins string is valid, or not            */
+/* Returns: Status indicating if argument is valid, or not                   */
 /*                                                                           */
 /*****************************************************************************/
 
-static arg_status_t i_process_mins(char *mins_str)
+static arg_status_t i_process_faults(char *spec_str)
 {
 
   arg_status_t arg_status = i_ARG_VALID; /* Flag indicating if arg is valid */
-  time_t mins_num = 0;                   /* Minutes as a number             */
+  double rate;                           /* Chance of a burst starting      */
+  unsigned long burst = 1;               /* Bytes in each burst             */
+  unsigned int faults = 0;               /* Faults allowed                  */
+  char *end_ptr;                         /* End of the value                */
+  char *value_str;                       /* Start of the next value         */
+  const char *letter;                    /* A fault's letter                */
 
 
-  /* Convert mins string into an long */
-  mins_num = (time_t) strtol(mins_str, (char**) NULL, 10);
+  errno = 0;
 
-  /* Is value invalid? */
-  if( (mins_num > ( i_TIME_MAX / i_SEC_IN_MIN) ) || (mins_num < 1) )
+  rate = strtod(spec_str, &end_ptr);
+
+  if( (errno != 0) || (end_ptr == spec_str) || (rate <= 0.0)
+    || (rate > 1.0) )
   {
 
-    fprintf(stderr, "Invalid minutes argument\n");
+    arg_status = i_ARG_INVALID;
+
+  }
+  else if(*end_ptr == ',')
+  {
+
+    value_str = end_ptr + 1;
+
+    burst = strtoul(value_str, &end_ptr, 10);
+
+    if( (end_ptr == value_str) || (value_str[0] == '-') || (burst < 1)
+      || (burst > (unsigned long) SERE_MAX_BURST) )
+    {
+
+      arg_status = i_ARG_INVALID;
+
+    }
+    else if(*end_ptr == ',')
+    {
+
+      end_ptr++;
+
+      while( (*end_ptr != '\0') && (arg_status == i_ARG_VALID) )
+      {
+
+        letter = strchr(i_FAULT_CHARS, *end_ptr);
+
+        if(letter == NULL)
+        {
+
+          arg_status = i_ARG_INVALID;
+
+        }
+        else
+        {
+
+          faults |= 1U << (letter - i_FAULT_CHARS);
+
+          end_ptr++;
+
+        }
+
+      }
+
+    }
+
+  }
+
+  if( (arg_status == i_ARG_INVALID) || (*end_ptr != '\0') )
+  {
+
+    fprintf(stderr, "Invalid fault injection (I-) argument\n");
 
     arg_status = i_ARG_INVALID;
 
@@ -1926,13 +4301,12 @@ static arg_status_t i_process_mins(char *mins_str)
   else
   {
 
-    /* Store valid send time value in seconds */
-    i_send_time = mins_num * (time_t) i_SEC_IN_MIN;
+    i_emulator.fault_rate = rate;
 
-    /* Note the user has requested to send by time */
-    i_how_test = i_TEST_TIME;
+    i_emulator.burst = (unsigned int) burst;
 
-    arg_status = i_ARG_VALID;
+    /* All faults, unless some were picked */
+    i_emulator.faults = (faults != 0) ? faults : (1U << SERE_FAULTS) - 1;
 
   }
 
@@ -1944,31 +4318,35 @@ static arg_status_t i_process_mins(char *mins_str)
 
 /*****************************************************************************/
 /*                                                                           */
-/* Name: i_process_hours()                                                   */
+/* Name: i_process_seed()                                                    */
 /*                                                                           */
-/* Description: Check and process the hours to send command line argument    */
+/* Description: Check and process the seed command line argument, which      */
+/*              seeds the random bytes sent and the emulator's faults, so a  */
+/*              run can be repeated                                          */
 /*                                                                           */
-/* Uses: hours_str - Pointer to a string which is the number of hours to use */
+/* Uses: seed_str - Pointer to a string which is the seed                    */
 /*                                                                           */
-/* Returns: Status indicating if the hours string is valid, or not           */
+/* Returns: Status indicating if argument is valid, or not                   */
 /*                                                                           */
 /*****************************************************************************/
 
-static arg_status_t i_process_hours(char *hours_str)
+static arg_status_t i_process_seed(char *seed_str)
 {
 
   arg_status_t arg_status = i_ARG_VALID; /* Flag indicating if arg is valid */
-  time_t hours_num = 0;                  /* Hours as a number               */
+  unsigned long seed;                    /* The seed given                  */
+  char *end_ptr;                         /* End of the value                */
 
 
-  /* Convert hours string into an long */
-  hours_num = (time_t) strtol(hours_str, (char**) NULL, 10);
+  errno = 0;
 
-  /* Is value invalid? */
-  if( (hours_num > ( i_TIME_MAX / i_SEC_IN_HOUR) ) || (hours_num < 1) )
+  seed = strtoul(seed_str, &end_ptr, 10);
+
+  if( (errno != 0) || (end_ptr == seed_str) || (*end_ptr != '\0')
+    || (seed_str[0] == '-') || (seed > (unsigned long) UINT_MAX) )
   {
 
-    fprintf(stderr, "Invalid hours argument\n");
+    fprintf(stderr, "Invalid seed (R-) argument\n");
 
     arg_status = i_ARG_INVALID;
 
@@ -1976,13 +4354,9 @@ static arg_status_t i_process_hours(char *hours_str)
   else
   {
 
-    /* Store valid send time value in seconds */
-    i_send_time = hours_num * (time_t) i_SEC_IN_HOUR;
-
-    /* Note the user has requested to send by time */
-    i_how_test = i_TEST_TIME;
+    srand( (unsigned int) seed);
 
-    arg_status = i_ARG_VALID;
+    i_emulator.seed = (unsigned int) seed;
 
   }
 
@@ -1994,31 +4368,35 @@ static arg_status_t i_process_hours(char *hours_str)
 
 /*****************************************************************************/
 /*                                                                           */
-/* Name: i_process_intermediate()                                            */
+/* Name: i_process_priority()                                                */
 /*                                                                           */
-/* Description: Check and process the intermediate command line argument     */
+/* Description: Check and process the real-time priority command line        */
+/*              argument. The test runs under SCHED_FIFO at this priority,   */
+/*              so nothing else on the host can delay it.                    */
 /*                                                                           */
-/* Uses: disp_tim_str - Pointer to a string which is the No. of secs to use  */
+/* Uses: priority_str - Pointer to a string which is the priority            */
 /*                                                                           */
-/* Returns: Status indicating if the seconds string is valid,or not          */
+/* Returns: Status indicating if argument is valid, or not                   */
 /*                                                                           */
 /*****************************************************************************/
 
-static arg_status_t i_process_intermediate(char *disp_tim_str)
+static arg_status_t i_process_priority(char *priority_str)
 {
 
   arg_status_t arg_status = i_ARG_VALID; /* Flag indicating if arg is valid */
-  time_t disp_tim_num = 0;               /* Display time as a number        */
+  long priority;                         /* The priority given              */
+  char *end_ptr;                         /* End of the value                */
 
 
-  /* Convert display time string into an long */
-  disp_tim_num = (time_t) strtol(disp_tim_str, (char**) NULL, 10);
+  errno = 0;
 
-  /* Is value invalid? */
-  if( (disp_tim_num >= (time_t) LONG_MAX) || (disp_tim_num < 1) )
+  priority = strtol(priority_str, &end_ptr, 10);
+
+  if( (errno != 0) || (end_ptr == priority_str) || (*end_ptr != '\0')
+    || (priority < SERH_MIN_PRIORITY) || (priority > SERH_MAX_PRIORITY) )
   {
 
-    fprintf(stderr, "Invalid intermediate (i-) argument\n");
+    fprintf(stderr, "Invalid real-time priority (P-) argument\n");
 
     arg_status = i_ARG_INVALID;
 
@@ -2026,19 +4404,7 @@ static arg_status_t i_process_intermediate(char *disp_tim_str)
   else
   {
 
-    /* Store valid display time value */
-    i_intermediate_time = disp_tim_num;
-
-    /* Note the user has requested intermediate results */
-    i_intermediate = true;
-
-    /* Quiet mode would be a good idea */
-    i_quiet = true;
-
-    /* Intermediate and verbose don't mix */
-    i_verbose = false;
-
-    arg_status = i_ARG_VALID;
+    i_host.priority = (int) priority;
 
   }
 
@@ -2050,31 +4416,34 @@ static arg_status_t i_process_intermediate(char *disp_tim_str)
 
 /*****************************************************************************/
 /*                                                                           */
-/* Name: i_process_timeout()                                                 */
+/* Name: i_process_cpu()                                                     */
 /*                                                                           */
-/* Description: Check and process the read timeout command line argument     */
+/* Description: Check and process the CPU command line argument. The test    */
+/*              is pinned to this CPU, so it isn't moved between caches.     */
 /*                                                                           */
-/* Uses: timeout_str - Pointer to a string which is the read timeout to use  */
+/* Uses: cpu_str - Pointer to a string which is the CPU, from 0              */
 /*                                                                           */
-/* Returns: Status indicating if the timeout string is valid, or not         */
+/* Returns: Status indicating if argument is valid, or not                   */
 /*                                                                           */
 /*****************************************************************************/
 
-static arg_status_t i_process_timeout(char *timeout_str)
+static arg_status_t i_process_cpu(char *cpu_str)
 {
 
   arg_status_t arg_status = i_ARG_VALID; /* Flag indicating if arg is valid */
-  serp_timeout_t timeout_num = 0;        /* Timeout as a number             */
+  long cpu;                              /* The CPU given                   */
+  char *end_ptr;                         /* End of the value                */
 
 
-  /* Convert timeout string into an unsigned long */
-  timeout_num = (serp_timeout_t) strtoul(timeout_str, (char**) NULL, 10);
+  errno = 0;
 
-  /* Is value invalid? (greater than 10 secs or less than 1 microsec) */
-  if( (timeout_num > SERP_TIMEOUT_MAX) || (timeout_num < 1) )
+  cpu = strtol(cpu_str, &end_ptr, 10);
+
+  if( (errno != 0) || (end_ptr == cpu_str) || (*end_ptr != '\0')
+    || (cpu < 0) || (cpu >= serh_cpus() ) )
   {
 
-    fprintf(stderr, "Invalid timeout argument\n");
+    fprintf(stderr, "Invalid CPU (A-) argument\n");
 
     arg_status = i_ARG_INVALID;
 
@@ -2082,13 +4451,7 @@ static arg_status_t i_process_timeout(char *timeout_str)
   else
   {
 
-    /* Store valid read timeout value*/
-    i_read_timeout = timeout_num;
-
-    /* Note the user has set the timeout */
-    i_user_set_timeout = true;
-
-    arg_status = i_ARG_VALID;
+    i_host.cpu = (int) cpu;
 
   }
 
@@ -2098,6 +4461,35 @@ static arg_status_t i_process_timeout(char *timeout_str)
 }
 
 
+/*****************************************************************************/
+/*                                                                           */
+/* Name: i_process_lock()                                                    */
+/*                                                                           */
+/* Description: Check and process the lock memory command line argument.     */
+/*              Memory is locked and pre-faulted, so the test never waits    */
+/*              for a page, and timers are allowed the least slack.          */
+/*                                                                           */
+/* Uses: void                                                                */
+/*                                                                           */
+/* Returns: Status indicating if argument is valid, or not                   */
+/*                                                                           */
+/*****************************************************************************/
+
+static arg_status_t i_process_lock(void)
+{
+
+  arg_status_t arg_status = i_ARG_VALID;
+                                 /* Flag indicating if argument is valid  */
+
+
+  i_host.lock = true;
+
+  /* Return status */
+  return arg_status;
+
+}
+
+
 /*****************************************************************************/
 /*                                                                           */
 /* Name: i_hex_to_byte()                                                     */
@@ -2332,6 +4724,18 @@ static arg_status_t i_process_port(char *port)
     /* Store port string */
     dummy_ptr = memmove(i_serial_port, port,(arg_len + 1));
 
+    /* Test the loopback emulator instead of a port? */
+    i_emulate = (strcmp(port, SERE_PORT) == 0)
+      || (strcmp(port, SERE_TCP_PORT) == 0)
+      || (strcmp(port, SERE_RFC2217_PORT) == 0);
+
+    /* ... or simulate the line as the emulator would, in virtual time? */
+    i_simulate = (strcmp(port, SERP_SIM_PORT) == 0);
+
+    /* Neither is a real port, so the loop itself can be measured */
+    i_benchmark = (i_emulate == true)
+      || (strcmp(port, SERP_MEMORY_PORT) == 0);
+
     arg_status =  i_ARG_VALID;
 
   }
@@ -2555,34 +4959,58 @@ static void i_show_help(void)
 {
 
   i_print_version();
-  printf("\nUsage: serbert PORT [-cdfhlqrv] [-b BAUD] [-i SECS] [-k kBYTES]");
+  printf("\nUsage: serbert PORT [-cdfhlqrSvZ] [-b BAUD] [-i SECS]");
+  printf(" [-k kBYTES]");
   printf(" [-K KBYTES]\n               [-m MINS] [-n BYTES] [-o HOURS]");
-  printf(" [-p TIME] [-s STRING]\n               [-t TIMEOUT]\n\n");
+  printf(" [-p TIME] [-s STRING]\n               [-t TIMEOUT] [-e BER]");
+  printf(" [-C PERCENT] [-x ERRORS]\n               [-w FILE] [-W FILE]");
+  printf(" [-M ADDRESS] [-F FILE]\n               [-L FILE]");
+  printf(" [-E DELAY,RATE,CHUNK]\n");
+  printf("               [-I RATE,BURST,FAULTS] [-R SEED] [-P PRIORITY]");
+  printf(" [-A CPU]\n\n");
   printf("Performs a serial Bit Error Rate Test (BERT) using the given port.");
   printf(" Transmits\nbytes and waits for their uncorrupted return. Press");
   printf("'q' for quit and 'i' for\nintermediate results.\n");
   printf("Options: [Defaults in square brackets]\n");
+  printf(" -A - Pin the test to this CPU, from 0\n");
   printf(" -b - Baud rate to use: 50 - 115200           [");
   i_print_baud(i_DEFAULT_BAUD_RATE);
   printf("]\n -c - Continuous mode\n");
+  printf(" -C - Confidence level for the target BER, %%  [%.0f]\n",
+    i_DEFAULT_CONFIDENCE);
   printf(" -d - Diagnostic mode\n");
+  printf(" -e - Target BER, stop when proven or not\n");
+  printf(" -E - Emulator delay in us, bytes/s and bytes at once [0,0,0]\n");
   printf(" -f - Further information\n");
+  printf(" -F - Keep a flight record in a file, for serbert-dump\n");
   printf(" -h - Display this help\n");
   printf(" -i - Display intermediate results\n");
+  printf(" -I - Emulator fault chance per byte, burst and faults of %s\n",
+    i_FAULT_CHARS);
   printf(" -k - Number of bytes to send in k (* 1000)\n");
   printf(" -K - Number of bytes to send in K (* 1024)\n");
   printf(" -l - Use low latency\n");
+  printf(" -L - Capture every byte to a file, for serbert-read\n");
   printf(" -m - Number of minutes to send\n");
+  printf(" -M - Serve metrics at this localhost TCP port or Unix socket\n");
   printf(" -n - Number of bytes to send                 [");
   i_print_big_num(i_DEFAULT_TX_SIZE, i_bin_not_dec);
   printf("]\n -o - Number of hours to send\n");
   printf(" -p - Time between bytes. 0.000000001 to 9999\n");
+  printf(" -P - Run the test under SCHED_FIFO at this priority, %d - %d\n",
+    SERH_MIN_PRIORITY, SERH_MAX_PRIORITY);
   printf(" -q - Quiet mode\n");
   printf(" -r - Send random bytes mode\n");
+  printf(" -R - Seed for random bytes and emulator faults, to repeat a run\n");
   printf(" -s - The string to send in hex               [00-FF]\n");
+  printf(" -S - Publish statistics for serbert-mon\n");
   printf(" -t - The read timeout to use in microseconds [%lu]\n",
     serp_get_timeout(i_DEFAULT_BAUD_RATE) );
   printf(" -v - Verbose mode\n");
+  printf(" -w - Write results as JSON Lines to a file, - for stdout\n");
+  printf(" -W - Write results as CSV to a file, - for stdout\n");
+  printf(" -x - Stop when errors exceed this number\n");
+  printf(" -Z - Lock and pre-fault memory, with the least timer slack\n");
 
 }
 
@@ -2725,24 +5153,36 @@ static arg_status_t i_select_function(int argc, char *argv[], int arg,
 /*      start_arg - No. of next argument to process                          */
 /*                                                                           */
 /* Valid command line arguments:                                             */
+/*   -A Pin the test to a CPU                                                */
 /*   -b Baud rate to use                                                     */
 /*   -c Continuous mode                                                      */
 /*   -d Diagnostic mode                                                      */
+/*   -E Shape the loopback emulator                                          */
 /*   -f Display further information                                          */
+/*   -F Keep a flight record                                                 */
 /*   -h Display help text                                                    */
 /*   -i Display intermediate results                                         */
+/*   -I Inject faults with the loopback emulator                             */
 /*   -k Number of bytes to send in k (1000)                                  */
 /*   -K Number of bytes to send in K (1024)                                  */
 /*   -l Use low latency                                                      */
+/*   -L Capture every byte                                                   */
 /*   -m Number of minutes to send                                            */
+/*   -M Serve Prometheus metrics                                             */
 /*   -n Number of bytes to send                                              */
 /*   -o Number of hours to send                                              */
 /*   -p Paced output                                                         */
+/*   -P Run under SCHED_FIFO                                                 */
 /*   -q Quiet mode                                                           */
 /*   -r Random mode                                                          */
+/*   -R Seed the random bytes and faults                                     */
 /*   -s The string to send                                                   */
+/*   -S Publish statistics in shared memory                                  */
 /*   -t The read timeout to use                                              */
 /*   -v Verbose mode                                                         */
+/*   -w Write records as JSON Lines                                          */
+/*   -W Write records as CSV                                                 */
+/*   -Z Lock memory                                                          */
 /*                                                                           */
 /* Returns: Status indicating if arguments are valid, or not                 */
 /*                                                                           */
@@ -2764,24 +5204,39 @@ static arg_status_t i_process_args_params(int argc, char *argv[],
   struct i_argument_t arg_list[] =
   {
   /*  arg  function                  parameters */
+    { 'A', i_process_cpu,            1 },
     { 'b', i_process_baud,           1 },
     { 'c', i_process_cont,           0 },
+    { 'C', i_process_confidence,     1 },
     { 'd', i_process_diag,           0 },
+    { 'e', i_process_target_ber,     1 },
+    { 'E', i_process_emulator,       1 },
     { 'f', i_process_further,        0 },
+    { 'F', i_process_flight,         1 },
     { 'h', i_process_help,           0 },
     { 'i', i_process_intermediate,   1 },
+    { 'I', i_process_faults,         1 },
     { 'k', i_process_dec_knum_bytes, 1 },
     { 'K', i_process_bin_knum_bytes, 1 },
     { 'l', i_process_low_latency,    0 },
+    { 'L', i_process_capture,        1 },
     { 'm', i_process_mins,           1 },
+    { 'M', i_process_metrics,        1 },
     { 'n', i_process_num_bytes,      1 },
     { 'o', i_process_hours,          1 },
     { 'p', i_process_paced,          1 },
+    { 'P', i_process_priority,       1 },
     { 'q', i_process_quiet,          0 },
     { 'r', i_process_random,         0 },
+    { 'R', i_process_seed,           1 },
     { 's', i_process_str,            1 },
+    { 'S', i_process_shared,         0 },
     { 't', i_process_timeout,        1 },
     { 'v', i_process_verbose,        0 },
+    { 'w', i_process_json_output,    1 },
+    { 'W', i_process_csv_output,     1 },
+    { 'x', i_process_max_errors,     1 },
+    { 'Z', i_process_lock,           0 },
     { '0',  NULL,                    0 }
   };
 
@@ -2971,6 +5426,79 @@ static arg_status_t i_process_arguments(int argc, char *argv[])
 }
 
 
+/*****************************************************************************/
+/*                                                                           */
+/* Name: i_open_port()                                                       */
+/*                                                                           */
+/* Description: Open the serial port. If the port is the emulator, it is     */
+/*              started and its pseudo terminal, or its stand-in device      */
+/*              server, opened instead. The simulated line is set up as the  */
+/*              emulator would be, sending at the baud rate unless a rate is */
+/*              given.                                                       */
+/*                                                                           */
+/* Uses: void                                                                */
+/*                                                                           */
+/* Returns: The port's descriptor, or SERP_PORT_FAILURE                      */
+/*                                                                           */
+/*****************************************************************************/
+
+static int i_open_port(void)
+{
+
+  int fd = SERP_PORT_FAILURE;     /* The port's descriptor   */
+  sere_status_t started;          /* Did the emulator start? */
+
+
+  /* Late bytes are held well within the timeout, so should not be errors */
+  i_emulator.late_us = i_read_timeout / i_LATE_SHARE;
+
+  if(i_simulate == true)
+  {
+
+    i_emulator.rate = (i_emulator.rate != 0) ? i_emulator.rate
+      : i_get_baud_num(i_baud_rate) / i_BITS_PER_BYTE;
+
+    sere_set_up(&i_emulator);
+
+    fd = serp_open_port(i_serial_port, i_diags);
+
+  }
+  else if(i_emulate == false)
+  {
+
+    fd = serp_open_port(i_serial_port, i_diags);
+
+  }
+  else
+  {
+
+    /* On a pty, or as a stand-in device server */
+    started = (strcmp(i_serial_port, SERE_PORT) == 0)
+      ? sere_start(&i_emulator, i_emulator_port, sizeof(i_emulator_port) )
+      : sere_serve(&i_emulator,
+        (strcmp(i_serial_port, SERE_RFC2217_PORT) == 0), i_emulator_port,
+        sizeof(i_emulator_port) );
+
+    if(started == SERE_OK)
+    {
+
+      fd = serp_open_port(i_emulator_port, i_diags);
+
+    }
+    else
+    {
+
+      fprintf(stderr, "Failure starting the loopback emulator\n");
+
+    }
+
+  }
+
+  return fd;
+
+}
+
+
 /*****************************************************************************/
 /*                                                                           */
 /* Name: i_set_port_config()                                                 */
@@ -3141,6 +5669,79 @@ static void i_report_settings(void)
 
     printf("Pause between test bytes: %.9f secs\n", i_paced_time);
 
+    if(i_target_ber > 0.0)
+    {
+
+      printf("Target BER: %.1e at %.1f%% confidence\n", i_target_ber,
+        i_confidence);
+
+    }
+
+    if(i_use_max_errors == true)
+    {
+
+      printf("Errors allowed: ");
+
+      i_print_big_num(i_max_errors, i_bin_not_dec);
+
+      printf("\n");
+
+    }
+
+    if(i_shared == true)
+    {
+
+      printf("Statistics published in: %s%s%ld\n", SERG_DIR, SERG_PREFIX,
+        (long) getpid() );
+
+    }
+
+    if(i_flight == true)
+    {
+
+      printf("Flight record kept in: %s\n", i_flight_path);
+
+    }
+
+    if(i_capture == true)
+    {
+
+      printf("Every byte captured to: %s\n", i_capture_path);
+
+    }
+
+    if( (i_emulate == true) || (i_simulate == true) )
+    {
+
+      printf("%s: %lu us delay, %lu bytes/s, %u at once\n",
+        (i_simulate == true) ? "Simulated line" : "Loopback emulator",
+        i_emulator.delay_us, i_emulator.rate, i_emulator.chunk);
+
+      if(i_emulator.faults != 0)
+      {
+
+        printf("Injected faults: %g per byte, in bursts of %u\n",
+          i_emulator.fault_rate, i_emulator.burst);
+
+      }
+
+    }
+
+    if(i_metrics == true)
+    {
+
+      printf("Metrics served on: %s\n", i_metrics_address);
+
+    }
+
+    if(i_output == true)
+    {
+
+      printf("Records written as %s to: %s\n",
+        (i_output_format == SERO_CSV) ? "CSV" : "JSON Lines", i_output_path);
+
+    }
+
     printf("Low Latency is ");
 
     if(i_low_latency == true)
@@ -3156,6 +5757,34 @@ static void i_report_settings(void)
 
     }
 
+    if(i_host.priority != SERH_NONE)
+    {
+
+      printf("Real-time priority: SCHED_FIFO %d\n", i_host.priority);
+
+    }
+
+    if(i_host.cpu != SERH_NONE)
+    {
+
+      printf("Pinned to CPU: %d\n", i_host.cpu);
+
+    }
+
+    if(i_host.lock == true)
+    {
+
+      printf("Memory locked and pre-faulted\n");
+
+    }
+
+    if( (i_host.lock == true) || (i_host.priority != SERH_NONE) )
+    {
+
+      printf("Timer slack: %d ns\n", SERH_TIMER_SLACK_NS);
+
+    }
+
     printf("\n");
 
   } /* End i_diags if */
@@ -3416,6 +6045,89 @@ static void i_initialise_settings(void)
   i_delta_time_av.tv_sec   = 0;
   i_delta_time_av.tv_usec  = 0;
 
+  /* The byte turnround time jitter */
+  sers_jitter_init(&i_jitter);
+
+  sers_g821_init(&i_g821);
+
+  sers_burst_init(&i_bursts);
+
+  sers_roll_init(&i_roll);
+
+  sers_bits_init(&i_bits);
+
+  sers_tod_init(&i_tod);
+
+  /* No target BER or errors allowed */
+  i_target_ber = 0.0;
+
+  i_confidence = i_DEFAULT_CONFIDENCE;
+
+  i_use_max_errors = false;
+
+  i_max_errors = 0;
+
+  i_stop_test = false;
+
+  /* No machine readable records */
+  i_output = false;
+
+  i_output_path[0] = i_STR_TERM;
+
+  i_output_format = SERO_JSON;
+
+  /* No metrics served */
+  i_metrics = false;
+
+  i_metrics_address[0] = i_STR_TERM;
+
+  /* Statistics not published */
+  i_shared = false;
+
+  /* No flight record */
+  i_flight = false;
+
+  i_flight_path[0] = i_STR_TERM;
+
+  /* No capture */
+  i_capture = false;
+
+  i_capture_path[0] = i_STR_TERM;
+
+  /* A real port, unless the emulator is given; echoing as fast as it can */
+  i_emulate = false;
+
+  i_simulate = false;
+
+  i_benchmark = false;
+
+  i_emulator.delay_us = 0;
+
+  i_emulator.rate = 0;
+
+  i_emulator.chunk = 0;
+
+  i_emulator.fault_rate = 0.0;
+
+  i_emulator.burst = 1;
+
+  i_emulator.faults = 0;
+
+  i_emulator.late_us = 0;
+
+  /* The emulator's own seed, unless one is given */
+  i_emulator.seed = 0;
+
+  i_emulator_port[0] = i_STR_TERM;
+
+  i_host.priority = SERH_NONE;
+
+  i_host.cpu = SERH_NONE;
+
+  i_host.lock = false;
+
+  i_test_failed = false;
+
   i_initialise_console();
 
 }
@@ -3467,6 +6179,7 @@ extern int main(int argc, char *argv[])
   int configure_status;           /* Status of configuring a port            */
   int save_configure_status;      /* Status of the save configuration        */
   int exit_status = i_EXIT_OK;    /* Status to be returned                   */
+  bool faults_match;              /* Errors counted match those injected     */
   arg_status_t arg_status = i_ARG_VALID;
                /* Flag indicating if command line arguments are valid or not */
 
@@ -3477,6 +6190,18 @@ extern int main(int argc, char *argv[])
   /* Check and process the command line arguments */
   arg_status = i_process_arguments(argc, argv);
 
+  /* Records written to stdout have it to themselves, so they can be piped */
+  /* to another program; everything else printed goes to stderr            */
+  if( (arg_status == i_ARG_VALID) && (i_output == true)
+    && (strcmp(i_output_path, "-") == 0) && (sero_keep_stdout() != SERO_OK) )
+  {
+
+    fprintf(stderr, "Failure keeping stdout for the output\n");
+
+    arg_status = i_ARG_INVALID;
+
+  }
+
   if(arg_status == i_ARG_VALID)
   {
 
@@ -3485,8 +6210,9 @@ extern int main(int argc, char *argv[])
 
 #ifdef SERBERT_LOCK
 
-    /* Lock the serial port */
-    lock_status = serp_lock_port(i_serial_port);
+    /* Lock the serial port. The emulator's is our own, so isn't locked. */
+    lock_status = (i_emulate == true)
+      ? SERP_LOCK_OK : serp_lock_port(i_serial_port);
 
     if(lock_status == SERP_LOCK_OK)
     {
@@ -3494,8 +6220,8 @@ extern int main(int argc, char *argv[])
 #endif /* SERBERT_LOCK */
 
 
-      /* Open the serial port */
-      i_fd = serp_open_port(i_serial_port, i_diags);
+      /* Open the serial port, or the emulator's pseudo terminal */
+      i_fd = i_open_port();
 
       /* Was port opened successfully? */
       if(i_fd != SERP_PORT_FAILURE)
@@ -3512,15 +6238,130 @@ extern int main(int argc, char *argv[])
           (save_configure_status != SERP_PORT_FAILURE) )
         {
 
-          /* Do the bert thing */
-          i_bert();
+          /* Serve metrics, publish the statistics, and open the flight */
+          /* record, the capture and the machine readable output, as    */
+          /* wanted                                                     */
+          if( (i_metrics == true)
+            && (serm_start(i_metrics_address, i_serial_port) != SERM_OK) )
+          {
+
+            fprintf(stderr, "Failure serving metrics on %s\n",
+              i_metrics_address);
+
+            exit_status = i_EXIT_FAULT;
+
+          }
+          else if( (i_shared == true) && (serg_open(i_serial_port,
+            i_get_baud_num(i_baud_rate) ) != SERG_OK) )
+          {
+
+            fprintf(stderr, "Failure publishing statistics in %s\n",
+              SERG_DIR);
+
+            exit_status = i_EXIT_FAULT;
+
+          }
+          else if( (i_flight == true) && (serf_open(i_flight_path,
+            i_serial_port, i_get_baud_num(i_baud_rate) ) != SERF_OK) )
+          {
+
+            fprintf(stderr, "Failure opening %s\n", i_flight_path);
+
+            exit_status = i_EXIT_FAULT;
+
+          }
+          else if( (i_capture == true) && (serc_open(i_capture_path,
+            i_serial_port, i_get_baud_num(i_baud_rate) ) != SERC_OK) )
+          {
+
+            fprintf(stderr, "Failure opening %s\n", i_capture_path);
+
+            exit_status = i_EXIT_FAULT;
+
+          }
+          else if( (i_output == true)
+            && (sero_open(i_output_path, i_output_format) != SERO_OK) )
+          {
+
+            fprintf(stderr, "Failure opening %s\n", i_output_path);
+
+            exit_status = i_EXIT_FAULT;
+
+          }
+          else
+          {
+
+            i_start_bench();
+
+            /* Do the bert thing */
+            if(i_bert() == false)
+            {
+
+              /* Stop the output's writer; the test didn't run */
+              (void) i_close_output();
+
+              exit_status = i_EXIT_FAULT;
 
-          /* Report how we got on */
-          i_report_results();
+            }
+            else
+            {
+
+              /* Report how we got on */
+              i_report_results();
+
+              i_report_target();
+
+              i_report_stats();
+
+              i_report_bench();
+
+              i_report_phases();
+
+              faults_match = i_check_faults();
+
+              printf("\n");
+
+              exit_status = i_close_output();
+
+              if(serc_close() != SERC_OK)
+              {
+
+                fprintf(stderr, "Failure writing %s\n", i_capture_path);
+
+                exit_status = i_EXIT_FAULT;
+
+              }
+
+              /* Were errors miscounted? */
+              if(faults_match == false)
+              {
+
+                fprintf(stderr, "Errors counted don't match the faults\n");
 
-          i_report_stats();
+                exit_status = i_EXIT_FAULT;
 
-          printf("\n");
+              }
+
+              /* Did the link fail its target? */
+              if(i_test_failed == true)
+              {
+
+                exit_status = i_EXIT_TEST_FAILED;
+
+              }
+
+            }
+
+          }
+
+          serm_stop();
+
+          serg_close();
+
+          serf_close();
+
+          /* Already closed, unless the test didn't run */
+          (void) serc_close();
 
         } /* End of config if */
         else
@@ -3546,10 +6387,18 @@ extern int main(int argc, char *argv[])
 
       }
 
+      /* Does nothing unless the emulator was started */
+      sere_stop();
+
 #ifdef SERBERT_LOCK
 
       /* Unlock the serial port */
-      serp_unlock_port(i_serial_port);
+      if(i_emulate == false)
+      {
+
+        serp_unlock_port(i_serial_port);
+
+      }
 
     }  /* End of lock if */
     else
@@ -3574,7 +6423,7 @@ extern int main(int argc, char *argv[])
   /* Restore system stuff */
   i_restore_settings();
 
-  /* Return 0 if happy, 1 if a fault occured */
+  /* Return 0 if happy, 1 if a fault occured, 2 if the link failed */
   return exit_status;
 
 }
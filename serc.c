@@ -0,0 +1,1312 @@
+/*****************************************************************************/
+/*                                                                           */
+/* Module: serc.c                                                            */
+/*                                                                           */
+/* Description: Capture files for serial Bit Error Rate Tests                */
+/*                                                                           */
+/* Copyright (C) 2026 The Serbert contributors                               */
+/*                                                                           */
+/* This file is part of Serbert.                                             */
+/*                                                                           */
+/* Serbert is free software; you can redistribute it and/or modify           */
+/* it under the terms of the GNU General Public License as published by      */
+/* the Free Software Foundation; either version 2 of the License, or         */
+/* any later version.                                                        */
+/*                                                                           */
+/* This program is distributed in the hope that it will be useful,           */
+/* but WITHOUT ANY WARRANTY; without even the implied warranty of            */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             */
+/* GNU General Public License for more details.                              */
+/*                                                                           */
+/* You should have received a copy of the GNU General Public License         */
+/* along with this program; if not, write to the Free Software               */
+/* Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA */
+/*                                                                           */
+/*****************************************************************************/
+
+
+/*****************************************************************************/
+/*      INCLUDED FILES (dependencies)                                        */
+/*****************************************************************************/
+
+#include <stdio.h>       /* Standard I/O definitions - fopen(), fwrite()   */
+#include <stdlib.h>      /* Standard library - realloc(), free()           */
+#include <string.h>      /* Standard string lib - strncpy(), memset()      */
+#include <stdint.h>      /* Fixed size integers - uint64_t                 */
+#include <stdbool.h>     /* Boolean types                                  */
+#include <errno.h>       /* Error numbers - errno                          */
+#include <time.h>        /* Time defs - clock_gettime()                    */
+#include <sys/types.h>   /* System types - off_t                           */
+#include "sers.h"        /* Serial statistics library - SERS_NSEC_IN_SEC   */
+#include "serc.h"        /* Header file for this library                   */
+
+
+/*****************************************************************************/
+/*      INTERNAL MACRO DEFINITIONS                                           */
+/*****************************************************************************/
+
+/*****************************************************************************/
+/*  Name:                                                                    */
+/*  Description:                                                             */
+/*  Parameters:                                                              */
+/*  Client functions:                                                        */
+/*****************************************************************************/
+
+
+/*****************************************************************************/
+/*      INTERNAL TYPE DEFINITIONS                                            */
+/*****************************************************************************/
+
+/* The samples in a block are a series of entries. Each entry starts with   */
+/* a varint: the low 2 bits are a serc_kind_t; for SERC_BYTE_OK the rest is */
+/* the number of ok bytes in the run, otherwise the entry is for one byte   */
+/* and the byte sent follows, then the byte received unless it timed out.   */
+/* For each byte there's then the zigzag varint change in the change of its */
+/* time, and for an ok byte the zigzag varint change in its return time     */
+/* plus one, which is zero if there was none. The first byte of a block is  */
+/* taken to follow one at the block's first time, with no change.           */
+
+enum { i_KIND_BITS = 2 };            /* Bits of an entry's varint for kind   */
+
+enum { i_KIND_MASK = 0x03 };         /* Mask for them                        */
+
+enum { i_VARINT_BITS = 7 };          /* Bits held by each byte of a varint   */
+
+enum { i_VARINT_MORE = 0x80 };       /* Set on all but a varint's last byte  */
+
+enum { i_VARINT_MASK = 0x7f };       /* Mask for the bits held               */
+
+enum { i_VARINT_MAX_LEN = 10 };      /* Longest varint of 64 bits            */
+
+enum { i_RUN_LEN = 3 };              /* Varint bytes kept for a run's length */
+
+enum { i_MAX_ENTRY = 32 };           /* Longest entry for one byte           */
+
+enum { i_FIRST_INDEX_LEN = 1024 };   /* First room made in the index         */
+
+/* Where a run's length goes; the run's still open while this is set */
+enum { i_NO_RUN = -1 };
+
+
+/*****************************************************************************/
+/*      INTERNAL VARIABLE DEFINITIONS                                        */
+/*****************************************************************************/
+
+/* Capturing */
+
+static FILE *i_file = NULL;               /* The capture file                */
+
+static bool i_failed;                     /* Has a write failed?             */
+
+static int64_t i_start_mono;              /* When it started, monotonic ns   */
+
+static uint8_t i_block[SERC_BLOCK_LEN];   /* The block being filled          */
+
+static serc_block_t i_block_head;         /* Its header                      */
+
+static size_t i_used;                     /* Bytes of it used                */
+
+static long i_run_pos;                    /* Where the open run's length goes*/
+
+static uint64_t i_run_count;              /* Bytes in the open run           */
+
+static int64_t i_prev_time;               /* Time of the last byte, ticks    */
+
+static int64_t i_prev_delta;              /* Change in time to it            */
+
+static int64_t i_prev_return;             /* Its return time plus one, ticks */
+
+static unsigned long long i_bytes;        /* Bytes captured                  */
+
+static uint64_t i_offset;                 /* Where the next block goes       */
+
+static serc_index_t *i_index = NULL;      /* Index of the blocks written     */
+
+static size_t i_blocks;                   /* Number of them                  */
+
+static size_t i_index_len;                /* Room in the index               */
+
+/* Reading */
+
+static uint8_t i_read_buf[sizeof(serc_block_t) + SERC_BLOCK_LEN];
+                                          /* The block being read            */
+
+
+/*****************************************************************************/
+/*      INTERNAL FUNCTION DEFINITIONS                                        */
+/*****************************************************************************/
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: i_zigzag()                                                          */
+/*                                                                           */
+/* Description: Map a signed number to an unsigned one, small either way     */
+/*                                                                           */
+/* Uses: value - The number                                                  */
+/*                                                                           */
+/* Returns: The mapped number                                                */
+/*                                                                           */
+/*****************************************************************************/
+
+static uint64_t i_zigzag(int64_t value)
+{
+
+  return ( (uint64_t) value << 1) ^ (uint64_t) (value >> 63);
+
+}
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: i_unzigzag()                                                        */
+/*                                                                           */
+/* Description: Undo i_zigzag()                                              */
+/*                                                                           */
+/* Uses: value - The mapped number                                           */
+/*                                                                           */
+/* Returns: The signed number                                                */
+/*                                                                           */
+/*****************************************************************************/
+
+static int64_t i_unzigzag(uint64_t value)
+{
+
+  return (int64_t) (value >> 1) ^ -(int64_t) (value & 1);
+
+}
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: i_put_varint()                                                      */
+/*                                                                           */
+/* Description: Add a varint to the block being filled                       */
+/*                                                                           */
+/* Uses: value - The number                                                  */
+/*                                                                           */
+/* Returns: void                                                             */
+/*                                                                           */
+/*****************************************************************************/
+
+static void i_put_varint(uint64_t value)
+{
+
+  while(value > i_VARINT_MASK)
+  {
+
+    i_block[i_used] = (uint8_t) ( (value & i_VARINT_MASK) | i_VARINT_MORE);
+
+    i_used++;
+
+    value >>= i_VARINT_BITS;
+
+  }
+
+  i_block[i_used] = (uint8_t) value;
+
+  i_used++;
+
+}
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: i_get_varint()                                                      */
+/*                                                                           */
+/* Description: Take a varint from a block being decoded                     */
+/*                                                                           */
+/* Uses: payload - The block's samples                                       */
+/*       pos - Where it starts; moved past it                                */
+/*       end - The end of the block                                          */
+/*       value - Where to put the number                                     */
+/*                                                                           */
+/* Returns: true if the varint was whole, else false                         */
+/*                                                                           */
+/*****************************************************************************/
+
+static bool i_get_varint(const uint8_t *payload, size_t *pos, size_t end,
+  uint64_t *value)
+{
+
+  bool whole = false;           /* Was the varint whole?        */
+  unsigned int len = 0;         /* Bytes of the varint taken    */
+  uint8_t byte = i_VARINT_MORE; /* Byte of the varint           */
+
+
+  *value = 0;
+
+  while( (*pos < end) && (len < i_VARINT_MAX_LEN)
+    && ( (byte & i_VARINT_MORE) != 0) )
+  {
+
+    byte = payload[*pos];
+
+    *value |= (uint64_t) (byte & i_VARINT_MASK) << (len * i_VARINT_BITS);
+
+    (*pos)++;
+
+    len++;
+
+    if( (byte & i_VARINT_MORE) == 0)
+    {
+
+      whole = true;
+
+    }
+
+  }
+
+  return whole;
+
+}
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: i_close_run()                                                       */
+/*                                                                           */
+/* Description: Fill in the length of the open run of ok bytes. It's kept    */
+/*              as a varint padded to i_RUN_LEN bytes, so the room for it    */
+/*              can be kept before the length is known.                      */
+/*                                                                           */
+/* Uses: void                                                                */
+/*                                                                           */
+/* Returns: void                                                             */
+/*                                                                           */
+/*****************************************************************************/
+
+static void i_close_run(void)
+{
+
+  uint64_t value;               /* The run's varint */
+  unsigned int byte_no;         /* Byte of it       */
+
+
+  if(i_run_pos != i_NO_RUN)
+  {
+
+    value = (i_run_count << i_KIND_BITS) | SERC_BYTE_OK;
+
+    for(byte_no = 0; byte_no < i_RUN_LEN; byte_no++)
+    {
+
+      i_block[i_run_pos + byte_no] = (uint8_t) (value & i_VARINT_MASK);
+
+      if(byte_no < i_RUN_LEN - 1)
+      {
+
+        i_block[i_run_pos + byte_no] |= i_VARINT_MORE;
+
+      }
+
+      value >>= i_VARINT_BITS;
+
+    }
+
+    i_run_pos = i_NO_RUN;
+
+  }
+
+}
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: i_write_block()                                                     */
+/*                                                                           */
+/* Description: Write the block being filled, if it holds anything, and      */
+/*              index it                                                     */
+/*                                                                           */
+/* Uses: void                                                                */
+/*                                                                           */
+/* Returns: void                                                             */
+/*                                                                           */
+/*****************************************************************************/
+
+static void i_write_block(void)
+{
+
+  serc_index_t *index;          /* The index, with more room */
+  size_t index_len;             /* Room in it                */
+
+
+  if(i_block_head.samples > 0)
+  {
+
+    i_close_run();
+
+    i_block_head.magic = SERC_BLOCK_MAGIC;
+
+    i_block_head.length = (uint32_t) i_used;
+
+    if( (fwrite(&i_block_head, sizeof(i_block_head), 1, i_file) != 1)
+      || (fwrite(i_block, i_used, 1, i_file) != 1) )
+    {
+
+      i_failed = true;
+
+    }
+
+    if(i_blocks == i_index_len)
+    {
+
+      index_len = (i_index_len == 0) ? i_FIRST_INDEX_LEN : i_index_len * 2;
+
+      index = realloc(i_index, index_len * sizeof(serc_index_t) );
+
+      if(index == NULL)
+      {
+
+        i_failed = true;
+
+      }
+      else
+      {
+
+        i_index = index;
+
+        i_index_len = index_len;
+
+      }
+
+    }
+
+    if(i_blocks < i_index_len)
+    {
+
+      i_index[i_blocks].offset = i_offset;
+
+      i_index[i_blocks].first_byte = i_block_head.first_byte;
+
+      i_index[i_blocks].first_time = i_block_head.first_time;
+
+      i_index[i_blocks].last_time = i_block_head.last_time;
+
+      i_blocks++;
+
+    }
+
+    i_offset += sizeof(i_block_head) + i_used;
+
+  }
+
+  memset(&i_block_head, 0, sizeof(i_block_head) );
+
+  i_used = 0;
+
+  i_run_pos = i_NO_RUN;
+
+}
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: i_read_header()                                                     */
+/*                                                                           */
+/* Description: Read and check a capture file's header, and leave the file   */
+/*              at its end                                                   */
+/*                                                                           */
+/* Uses: capture - The capture, with its file open                           */
+/*                                                                           */
+/* Returns: SERC_OK if the header is of this version, else why not           */
+/*                                                                           */
+/*****************************************************************************/
+
+static serc_status_t i_read_header(serc_capture_t *capture)
+{
+
+  serc_status_t status = SERC_OK;       /* Is the header good? */
+
+
+  if(fread(&capture->header, sizeof(capture->header), 1, capture->file) != 1)
+  {
+
+    if(ferror(capture->file) != 0)
+    {
+
+      status = SERC_READ_FAILURE;
+
+      capture->error = errno;
+
+    }
+    else
+    {
+
+      status = SERC_SHORT_FAILURE;
+
+    }
+
+  }
+  else if( (capture->header.magic != SERC_MAGIC)
+    || (capture->header.version != SERC_VERSION)
+    || (capture->header.tick_ns == 0) )
+  {
+
+    status = SERC_VERSION_FAILURE;
+
+  }
+  else if(fseeko(capture->file, 0, SEEK_END) != 0)
+  {
+
+    status = SERC_READ_FAILURE;
+
+    capture->error = errno;
+
+  }
+
+  return status;
+
+}
+
+
+/*****************************************************************************/
+/*      EXTERNAL VARIABLE DEFINITIONS                                        */
+/*****************************************************************************/
+
+
+/*****************************************************************************/
+/*      EXTERNAL FUNCTION DEFINITIONS                                        */
+/*****************************************************************************/
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: serc_open()                                                         */
+/*                                                                           */
+/* Description: Create a capture file and write its header                   */
+/*                                                                           */
+/* Internal functions used: i_write_block()                                  */
+/*                                                                           */
+/* Internal variables used: i_file, i_failed, i_start_mono, i_bytes,         */
+/*                          i_offset, i_blocks                               */
+/*                                                                           */
+/* Parameters:                                                               */
+/*   Name            Type           Comments                                 */
+/*   ------------    ------------   -----------------------------------      */
+/*   path            const char *   The file to capture in                   */
+/*   port            const char *   Serial port being tested                 */
+/*   baud            unsigned long  Baud rate being tested                   */
+/*                                                                           */
+/* Returns: SERC_OK if the file is ready, else SERC_FAILURE                  */
+/*                                                                           */
+/*****************************************************************************/
+
+extern serc_status_t serc_open(const char *path, const char *port,
+  unsigned long baud)
+{
+
+  serc_status_t status = SERC_FAILURE;  /* Is the file ready? */
+  serc_header_t header;                 /* The file header    */
+  struct timespec time_now;             /* The current time   */
+
+
+  if(i_file == NULL)
+  {
+
+    i_file = fopen(path, "wb");
+
+    if(i_file != NULL)
+    {
+
+      memset(&header, 0, sizeof(header) );
+
+      (void) clock_gettime(CLOCK_REALTIME, &time_now);
+
+      header.start_time = ( (int64_t) time_now.tv_sec * SERS_NSEC_IN_SEC) +
+        (int64_t) time_now.tv_nsec;
+
+      /* Samples are timed on the monotonic clock, which doesn't jump  */
+      /* and is shared by every process, so captures of ports tested   */
+      /* at the same time can be lined up                              */
+      (void) clock_gettime(CLOCK_MONOTONIC, &time_now);
+
+      i_start_mono = ( (int64_t) time_now.tv_sec * SERS_NSEC_IN_SEC) +
+        (int64_t) time_now.tv_nsec;
+
+      header.start_mono = i_start_mono;
+
+      header.magic = SERC_MAGIC;
+
+      header.version = SERC_VERSION;
+
+      header.tick_ns = SERC_TICK_NS;
+
+      header.baud = (uint32_t) baud;
+
+      (void) strncpy(header.port, port, SERC_PORT_LEN - 1);
+
+      /* Blocks are written whole, so stdio needn't buffer them */
+      (void) setvbuf(i_file, NULL, _IONBF, 0);
+
+      if(fwrite(&header, sizeof(header), 1, i_file) == 1)
+      {
+
+        i_failed = false;
+
+        i_bytes = 0;
+
+        i_offset = sizeof(header);
+
+        i_blocks = 0;
+
+        i_write_block();
+
+        status = SERC_OK;
+
+      }
+      else
+      {
+
+        (void) fclose(i_file);
+
+        i_file = NULL;
+
+      }
+
+    }
+
+  }
+
+  return status;
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: serc_add()                                                          */
+/*                                                                           */
+/* Description: Capture a tested byte                                        */
+/*                                                                           */
+/* Internal functions used: i_write_block(), i_close_run(), i_put_varint(),  */
+/*                          i_zigzag()                                       */
+/*                                                                           */
+/* Internal variables used: i_file, i_block, i_block_head, i_used,           */
+/*                          i_run_pos, i_run_count, i_prev_time,             */
+/*                          i_prev_delta, i_prev_return, i_bytes             */
+/*                                                                           */
+/* Parameters:                                                               */
+/*   Name            Type           Comments                                 */
+/*   ------------    ------------   -----------------------------------      */
+/*   kind            serc_kind_t    What happened to the byte                */
+/*   tx              unsigned char  The byte sent                            */
+/*   rx              int            The byte received, or SERC_NO_RX         */
+/*   return_time     long long      The byte's return time in ns, or -1      */
+/*                                                                           */
+/* Returns: void                                                             */
+/*                                                                           */
+/*****************************************************************************/
+
+extern void serc_add(serc_kind_t kind, unsigned char tx, int rx,
+  long long return_time)
+{
+
+  struct timespec time_now;     /* The current time               */
+  int64_t time;                 /* The byte's time, in ticks      */
+  int64_t delta;                /* Change in time since the last  */
+  int64_t return_value;         /* Return time plus one, in ticks */
+
+
+  if(i_file != NULL)
+  {
+
+    (void) clock_gettime(CLOCK_MONOTONIC, &time_now);
+
+    time = ( ( (int64_t) time_now.tv_sec * SERS_NSEC_IN_SEC) +
+      (int64_t) time_now.tv_nsec - i_start_mono) / SERC_TICK_NS;
+
+    if(i_used + i_MAX_ENTRY > SERC_BLOCK_LEN)
+    {
+
+      i_write_block();
+
+    }
+
+    if(i_block_head.samples == 0)
+    {
+
+      i_block_head.first_byte = i_bytes;
+
+      i_block_head.first_time = time;
+
+      i_prev_time = time;
+
+      i_prev_delta = 0;
+
+      i_prev_return = 0;
+
+    }
+
+    if(kind == SERC_BYTE_OK)
+    {
+
+      /* Keep room for the run's length, to fill in when it ends */
+      if(i_run_pos == i_NO_RUN)
+      {
+
+        i_run_pos = (long) i_used;
+
+        i_run_count = 0;
+
+        i_used += i_RUN_LEN;
+
+      }
+
+      i_run_count++;
+
+    }
+    else
+    {
+
+      i_close_run();
+
+      i_put_varint( (uint64_t) kind);
+
+      i_block[i_used] = (uint8_t) tx;
+
+      i_used++;
+
+      if(kind != SERC_BYTE_TIMEOUT)
+      {
+
+        i_block[i_used] = (uint8_t) ( (rx == SERC_NO_RX) ? 0 : rx);
+
+        i_used++;
+
+      }
+
+    }
+
+    delta = time - i_prev_time;
+
+    i_put_varint(i_zigzag(delta - i_prev_delta) );
+
+    i_prev_time = time;
+
+    i_prev_delta = delta;
+
+    if(kind == SERC_BYTE_OK)
+    {
+
+      return_value = (return_time < 0) ? 0 : (return_time / SERC_TICK_NS) + 1;
+
+      i_put_varint(i_zigzag(return_value - i_prev_return) );
+
+      i_prev_return = return_value;
+
+    }
+
+    i_block_head.samples++;
+
+    i_block_head.last_time = time;
+
+    i_bytes++;
+
+  }
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: serc_close()                                                        */
+/*                                                                           */
+/* Description: Write the last block and the index, and close the file       */
+/*                                                                           */
+/* Internal functions used: i_write_block()                                  */
+/*                                                                           */
+/* Internal variables used: i_file, i_failed, i_index, i_blocks,             */
+/*                          i_index_len, i_offset                            */
+/*                                                                           */
+/* Parameters:                                                               */
+/*   Name            Type           Comments                                 */
+/*   ------------    ------------   -----------------------------------      */
+/*                                                                           */
+/* Returns: SERC_OK if everything was written, else SERC_FAILURE             */
+/*                                                                           */
+/*****************************************************************************/
+
+extern serc_status_t serc_close(void)
+{
+
+  serc_status_t status = SERC_OK;       /* Was everything written? */
+  serc_trailer_t trailer;               /* The index's trailer     */
+
+
+  if(i_file != NULL)
+  {
+
+    i_write_block();
+
+    memset(&trailer, 0, sizeof(trailer) );
+
+    trailer.magic = SERC_INDEX_MAGIC;
+
+    trailer.blocks = i_blocks;
+
+    trailer.index_offset = i_offset;
+
+    if( ( (i_blocks > 0) && (fwrite(i_index, sizeof(serc_index_t),
+      i_blocks, i_file) != i_blocks) )
+      || (fwrite(&trailer, sizeof(trailer), 1, i_file) != 1) )
+    {
+
+      i_failed = true;
+
+    }
+
+    if( (fclose(i_file) != 0) || (i_failed == true) )
+    {
+
+      status = SERC_FAILURE;
+
+    }
+
+    i_file = NULL;
+
+    free(i_index);
+
+    i_index = NULL;
+
+    i_index_len = 0;
+
+  }
+
+  return status;
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: serc_load()                                                         */
+/*                                                                           */
+/* Description: Open a capture file for reading, and load its index          */
+/*                                                                           */
+/* Internal functions used: i_read_header()                                  */
+/*                                                                           */
+/* Internal variables used:                                                  */
+/*                                                                           */
+/* Parameters:                                                               */
+/*   Name            Type           Comments                                 */
+/*   ------------    ------------   -----------------------------------      */
+/*   path            const char *   The capture file                         */
+/*   capture         serc_capture_t The capture, filled in                   */
+/*                                                                           */
+/* Returns: SERC_OK if the file is a capture, else why it couldn't be        */
+/*          loaded                                                           */
+/*                                                                           */
+/*****************************************************************************/
+
+extern serc_status_t serc_load(const char *path, serc_capture_t *capture)
+{
+
+  serc_status_t status = SERC_FAILURE;  /* Is the file a capture?    */
+  serc_trailer_t trailer;               /* The index's trailer       */
+  serc_block_t block;                   /* A block's header          */
+  serc_index_t *index;                  /* The index, with more room */
+  size_t index_len = 0;                 /* Room in it                */
+  off_t file_len;                       /* Length of the file        */
+  off_t offset;                         /* Where the next block is   */
+  bool more = true;                     /* More blocks to look for?  */
+
+
+  memset(capture, 0, sizeof(*capture) );
+
+  capture->file = fopen(path, "rb");
+
+  if(capture->file == NULL)
+  {
+
+    status = SERC_OPEN_FAILURE;
+
+    capture->error = errno;
+
+  }
+  else
+  {
+
+    status = i_read_header(capture);
+
+    if(status == SERC_OK)
+    {
+
+      file_len = ftello(capture->file);
+
+      /* A file closed cleanly ends with its index */
+      if( (file_len >= (off_t) (sizeof(capture->header) + sizeof(trailer) ) )
+        && (fseeko(capture->file, file_len - (off_t) sizeof(trailer),
+        SEEK_SET) == 0)
+        && (fread(&trailer, sizeof(trailer), 1, capture->file) == 1)
+        && (trailer.magic == SERC_INDEX_MAGIC)
+        && (trailer.index_offset + (trailer.blocks * sizeof(serc_index_t) )
+        + sizeof(trailer) == (uint64_t) file_len) )
+      {
+
+        capture->index = malloc( (trailer.blocks + 1) * sizeof(serc_index_t) );
+
+        if( (capture->index != NULL)
+          && (fseeko(capture->file, (off_t) trailer.index_offset,
+          SEEK_SET) == 0)
+          && (fread(capture->index, sizeof(serc_index_t),
+          (size_t) trailer.blocks, capture->file) == trailer.blocks) )
+        {
+
+          capture->blocks = (size_t) trailer.blocks;
+
+          capture->indexed = true;
+
+        }
+
+      }
+
+      /* Otherwise the blocks are found from their headers, up to the */
+      /* first that wasn't written whole                              */
+      if(capture->indexed == false)
+      {
+
+        offset = (off_t) sizeof(capture->header);
+
+        while(more == true)
+        {
+
+          more = false;
+
+          if( (fseeko(capture->file, offset, SEEK_SET) == 0)
+            && (fread(&block, sizeof(block), 1, capture->file) == 1)
+            && (block.magic == SERC_BLOCK_MAGIC)
+            && (block.length <= SERC_BLOCK_LEN)
+            && (offset + (off_t) (sizeof(block) + block.length) <= file_len) )
+          {
+
+            if(capture->blocks == index_len)
+            {
+
+              index_len = (index_len == 0) ? i_FIRST_INDEX_LEN : index_len * 2;
+
+              index = realloc(capture->index,
+                index_len * sizeof(serc_index_t) );
+
+              if(index != NULL)
+              {
+
+                capture->index = index;
+
+                more = true;
+
+              }
+
+            }
+            else
+            {
+
+              more = true;
+
+            }
+
+            if(more == true)
+            {
+
+              capture->index[capture->blocks].offset = (uint64_t) offset;
+
+              capture->index[capture->blocks].first_byte = block.first_byte;
+
+              capture->index[capture->blocks].first_time = block.first_time;
+
+              capture->index[capture->blocks].last_time = block.last_time;
+
+              capture->blocks++;
+
+              offset += (off_t) (sizeof(block) + block.length);
+
+            }
+
+          }
+
+        }
+
+      }
+
+    }
+
+    if(status != SERC_OK)
+    {
+
+      (void) fclose(capture->file);
+
+      capture->file = NULL;
+
+    }
+
+  }
+
+  return status;
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: serc_report_load()                                                  */
+/*                                                                           */
+/* Description: Print why a capture file couldn't be loaded to stderr        */
+/*                                                                           */
+/* Internal functions used:                                                  */
+/*                                                                           */
+/* Internal variables used:                                                  */
+/*                                                                           */
+/* Parameters:                                                               */
+/*   Name            Type           Comments                                 */
+/*   ------------    ------------   -----------------------------------      */
+/*   path            const char *   The capture file                         */
+/*   status          serc_status_t  What serc_load() returned                */
+/*   capture         serc_capture_t The capture it was given                 */
+/*                                                                           */
+/* Returns: void                                                             */
+/*                                                                           */
+/*****************************************************************************/
+
+extern void serc_report_load(const char *path, serc_status_t status,
+  const serc_capture_t *capture)
+{
+
+  switch(status)
+  {
+
+    case SERC_OPEN_FAILURE:
+
+      fprintf(stderr, "Cannot open %s: %s\n", path,
+        strerror(capture->error) );
+
+      break;
+
+    case SERC_READ_FAILURE:
+
+      fprintf(stderr, "Cannot read %s: %s\n", path,
+        strerror(capture->error) );
+
+      break;
+
+    case SERC_SHORT_FAILURE:
+
+      fprintf(stderr, "%s is too short to be a capture file\n", path);
+
+      break;
+
+    default:
+
+      fprintf(stderr, "%s is not a capture file of this version\n", path);
+
+      break;
+
+  }
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: serc_find()                                                         */
+/*                                                                           */
+/* Description: Find the first block that may hold samples at or after a     */
+/*              time                                                         */
+/*                                                                           */
+/* Internal functions used:                                                  */
+/*                                                                           */
+/* Internal variables used:                                                  */
+/*                                                                           */
+/* Parameters:                                                               */
+/*   Name            Type           Comments                                 */
+/*   ------------    ------------   -----------------------------------      */
+/*   capture         serc_capture_t The capture                              */
+/*   time            long long      The time, in ns from the start           */
+/*                                                                           */
+/* Returns: The block's number, or the number of blocks if there is none     */
+/*                                                                           */
+/*****************************************************************************/
+
+extern size_t serc_find(const serc_capture_t *capture, long long time)
+{
+
+  size_t low = 0;                       /* First block it may be     */
+  size_t high = capture->blocks;        /* One past the last         */
+  size_t middle;                        /* Block being looked at     */
+  int64_t ticks;                        /* The time, in ticks        */
+
+
+  ticks = time / (long long) capture->header.tick_ns;
+
+  /* Blocks are in time order, so find the first ending at or after it */
+  while(low < high)
+  {
+
+    middle = low + ( (high - low) / 2);
+
+    if(capture->index[middle].last_time < ticks)
+    {
+
+      low = middle + 1;
+
+    }
+    else
+    {
+
+      high = middle;
+
+    }
+
+  }
+
+  return low;
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: serc_decode_block()                                                 */
+/*                                                                           */
+/* Description: Decode a block held in memory, passing each sample to a      */
+/*              function                                                     */
+/*                                                                           */
+/* Internal functions used: i_get_varint(), i_unzigzag()                     */
+/*                                                                           */
+/* Internal variables used:                                                  */
+/*                                                                           */
+/* Parameters:                                                               */
+/*   Name            Type           Comments                                 */
+/*   ------------    ------------   -----------------------------------      */
+/*   data            const void *   The block, starting with its header      */
+/*   len             size_t         Bytes there, at least the block's        */
+/*   tick_ns         unsigned long  Nanoseconds in a tick, from the header   */
+/*   func            serc_sample_func_t Called with each sample              */
+/*   context         void *         Passed to func                           */
+/*                                                                           */
+/* Returns: SERC_OK if the block was decoded, else SERC_FAILURE              */
+/*                                                                           */
+/*****************************************************************************/
+
+extern serc_status_t serc_decode_block(const void *data, size_t len,
+  unsigned long tick_ns, serc_sample_func_t func, void *context)
+{
+
+  serc_status_t status = SERC_FAILURE;  /* Was the block decoded?       */
+  serc_block_t head;                    /* The block's header           */
+  const uint8_t *payload;               /* The block's samples          */
+  serc_sample_t sample;                 /* Sample decoded               */
+  size_t pos = 0;                       /* Where decoding has got to    */
+  bool whole = true;                    /* Has everything been whole?   */
+  uint64_t value;                       /* Varint taken                 */
+  uint64_t count;                       /* Bytes in the entry           */
+  int64_t time;                         /* Time of the last, in ticks   */
+  int64_t delta = 0;                    /* Change in time to it         */
+  int64_t return_value = 0;             /* Its return time plus one     */
+  int64_t tick;                         /* Nanoseconds in a tick        */
+
+
+  /* A mapped block needn't be aligned, so its header is copied out */
+  if(len >= sizeof(head) )
+  {
+
+    memcpy(&head, data, sizeof(head) );
+
+  }
+
+  if( (len >= sizeof(head) ) && (head.magic == SERC_BLOCK_MAGIC)
+    && (head.length <= SERC_BLOCK_LEN)
+    && (sizeof(head) + head.length <= len) )
+  {
+
+    payload = (const uint8_t *) data + sizeof(head);
+
+    tick = (int64_t) tick_ns;
+
+    time = head.first_time;
+
+    sample.number = head.first_byte;
+
+    while( (pos < head.length) && (whole == true) )
+    {
+
+      whole = i_get_varint(payload, &pos, head.length, &value);
+
+      sample.kind = (serc_kind_t) (value & i_KIND_MASK);
+
+      count = (sample.kind == SERC_BYTE_OK) ? value >> i_KIND_BITS : 1;
+
+      sample.tx = -1;
+
+      sample.rx = SERC_NO_RX;
+
+      if(sample.kind != SERC_BYTE_OK)
+      {
+
+        whole = whole && (pos < head.length);
+
+        if(whole == true)
+        {
+
+          sample.tx = (int) payload[pos];
+
+          pos++;
+
+        }
+
+        if(sample.kind != SERC_BYTE_TIMEOUT)
+        {
+
+          whole = whole && (pos < head.length);
+
+          if(whole == true)
+          {
+
+            sample.rx = (int) payload[pos];
+
+            pos++;
+
+          }
+
+        }
+
+      }
+
+      while( (count > 0) && (whole == true) )
+      {
+
+        whole = i_get_varint(payload, &pos, head.length, &value);
+
+        delta += i_unzigzag(value);
+
+        time += delta;
+
+        sample.time = time * tick;
+
+        sample.return_time = -1;
+
+        if( (sample.kind == SERC_BYTE_OK) && (whole == true) )
+        {
+
+          whole = i_get_varint(payload, &pos, head.length, &value);
+
+          return_value += i_unzigzag(value);
+
+          if(return_value > 0)
+          {
+
+            sample.return_time = (return_value - 1) * tick;
+
+          }
+
+        }
+
+        if(whole == true)
+        {
+
+          func(&sample, context);
+
+          sample.number++;
+
+        }
+
+        count--;
+
+      }
+
+    }
+
+    if(whole == true)
+    {
+
+      status = SERC_OK;
+
+    }
+
+  }
+
+  return status;
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: serc_read_block()                                                   */
+/*                                                                           */
+/* Description: Read and decode a block, passing each sample to a function   */
+/*                                                                           */
+/* Internal functions used:                                                  */
+/*                                                                           */
+/* Internal variables used: i_read_buf                                       */
+/*                                                                           */
+/* Parameters:                                                               */
+/*   Name            Type           Comments                                 */
+/*   ------------    ------------   -----------------------------------      */
+/*   capture         serc_capture_t The capture                              */
+/*   block           size_t         The block's number                       */
+/*   func            serc_sample_func_t Called with each sample              */
+/*   context         void *         Passed to func                           */
+/*                                                                           */
+/* Returns: SERC_OK if the block was decoded, else SERC_FAILURE              */
+/*                                                                           */
+/*****************************************************************************/
+
+extern serc_status_t serc_read_block(serc_capture_t *capture, size_t block,
+  serc_sample_func_t func, void *context)
+{
+
+  serc_status_t status = SERC_FAILURE;  /* Was the block decoded? */
+  serc_block_t head;                    /* The block's header     */
+
+
+  if( (block < capture->blocks)
+    && (fseeko(capture->file, (off_t) capture->index[block].offset,
+    SEEK_SET) == 0)
+    && (fread(&head, sizeof(head), 1, capture->file) == 1)
+    && (head.length <= SERC_BLOCK_LEN)
+    && ( (head.length == 0) || (fread(i_read_buf + sizeof(head),
+    head.length, 1, capture->file) == 1) ) )
+  {
+
+    memcpy(i_read_buf, &head, sizeof(head) );
+
+    status = serc_decode_block(i_read_buf, sizeof(head) + head.length,
+      capture->header.tick_ns, func, context);
+
+  }
+
+  return status;
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: serc_unload()                                                       */
+/*                                                                           */
+/* Description: Close a capture file opened for reading                      */
+/*                                                                           */
+/* Internal functions used:                                                  */
+/*                                                                           */
+/* Internal variables used:                                                  */
+/*                                                                           */
+/* Parameters:                                                               */
+/*   Name            Type           Comments                                 */
+/*   ------------    ------------   -----------------------------------      */
+/*   capture         serc_capture_t The capture                              */
+/*                                                                           */
+/* Returns: void                                                             */
+/*                                                                           */
+/*****************************************************************************/
+
+extern void serc_unload(serc_capture_t *capture)
+{
+
+  if(capture->file != NULL)
+  {
+
+    (void) fclose(capture->file);
+
+    capture->file = NULL;
+
+  }
+
+  free(capture->index);
+
+  capture->index = NULL;
+
+  capture->blocks = 0;
+
+}
@@ -0,0 +1,399 @@
+/*****************************************************************************/
+/*                                                                           */
+/* Module: serc.h                                                            */
+/*                                                                           */
+/* Description: Header file for serc.c                                       */
+/*                                                                           */
+/* Copyright (C) 2026 The Serbert contributors                               */
+/*                                                                           */
+/* This file is part of Serbert.                                             */
+/*                                                                           */
+/* Serbert is free software; you can redistribute it and/or modify           */
+/* it under the terms of the GNU General Public License as published by      */
+/* the Free Software Foundation; either version 2 of the License, or         */
+/* any later version.                                                        */
+/*                                                                           */
+/* This program is distributed in the hope that it will be useful,           */
+/* but WITHOUT ANY WARRANTY; without even the implied warranty of            */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             */
+/* GNU General Public License for more details.                              */
+/*                                                                           */
+/* You should have received a copy of the GNU General Public License         */
+/* along with this program; if not, write to the Free Software               */
+/* Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA */
+/*                                                                           */
+/*****************************************************************************/
+
+#ifndef SERC_H
+
+#define SERC_H
+
+/*****************************************************************************/
+/*      INCLUDED FILES (dependencies)                                        */
+/*****************************************************************************/
+
+#include <stdio.h>       /* Standard I/O definitions - FILE                */
+#include <stdint.h>      /* Fixed size integers - uint64_t                 */
+#include <stddef.h>      /* Standard definitions - size_t                  */
+#include <stdbool.h>     /* Boolean types                                  */
+
+
+/*****************************************************************************/
+/*      MACRO DEFINITIONS                                                    */
+/*****************************************************************************/
+
+/*****************************************************************************/
+/*  Name:                                                                    */
+/*  Description:                                                             */
+/*  Parameters:                                                              */
+/*****************************************************************************/
+
+
+/*****************************************************************************/
+/*      TYPE DEFINITIONS                                                     */
+/*****************************************************************************/
+
+/* Enums & constants */
+
+enum { SERC_MAGIC = 0x53424350 };    /* Marks a capture file, "SBCP"         */
+
+enum { SERC_BLOCK_MAGIC = 0x5342424b };
+                                     /* Marks a block, "SBBK"                */
+
+enum { SERC_INDEX_MAGIC = 0x53424958 };
+                                     /* Marks the index trailer, "SBIX"      */
+
+enum { SERC_VERSION = 2 };           /* Format version; bumped on any change */
+
+enum { SERC_PORT_LEN = 128 };        /* Longest port name held               */
+
+enum { SERC_BLOCK_LEN = 65536 };     /* Most bytes of samples in a block     */
+
+enum { SERC_TICK_NS = 1000 };        /* Resolution of times, in nanoseconds  */
+
+enum { SERC_NO_RX = -1 };            /* No byte was received                 */
+
+/* What happened to a byte */
+typedef enum serc_kind_t
+{
+  SERC_BYTE_OK,                      /* Came back ok                         */
+  SERC_BYTE_CORRUPT,                 /* Came back corrupt                    */
+  SERC_BYTE_TIMEOUT,                 /* Timed out                            */
+  SERC_BYTE_FRAMING,                 /* Came back with a framing error       */
+  SERC_KINDS                         /* Number of kinds                      */
+} serc_kind_t;
+
+/* Status of a capture call */
+typedef enum serc_status_t
+{
+  SERC_OK,                           /* All went well                        */
+  SERC_FAILURE,                      /* Failed                               */
+  SERC_OPEN_FAILURE,                 /* The file couldn't be opened          */
+  SERC_READ_FAILURE,                 /* The file couldn't be read            */
+  SERC_SHORT_FAILURE,                /* The file ended before its header did */
+  SERC_VERSION_FAILURE               /* Not a capture file of this version   */
+} serc_status_t;
+
+/* Types */
+
+/* The file header. Times are in ticks of tick_ns from the start, timed on */
+/* the monotonic clock.                                                    */
+typedef struct serc_header_t
+{
+  uint32_t magic;                    /* SERC_MAGIC                           */
+  uint32_t version;                  /* SERC_VERSION                         */
+  uint32_t tick_ns;                  /* Nanoseconds in a tick                */
+  uint32_t baud;                     /* Baud rate tested                     */
+  int64_t start_time;                /* When it started, in ns since epoch   */
+  int64_t start_mono;                /* When, in ns of the monotonic clock   */
+  char port[SERC_PORT_LEN];          /* Serial port tested                   */
+} serc_header_t;
+
+/* The header of a block of samples. Each block can be decoded alone. */
+typedef struct serc_block_t
+{
+  uint32_t magic;                    /* SERC_BLOCK_MAGIC                     */
+  uint32_t length;                   /* Bytes of samples that follow         */
+  uint32_t samples;                  /* Number of samples                    */
+  uint32_t spare;                    /* Unused, zero                         */
+  uint64_t first_byte;               /* Number of the first byte             */
+  int64_t first_time;                /* Time of the first sample, in ticks   */
+  int64_t last_time;                 /* Time of the last sample, in ticks    */
+} serc_block_t;
+
+/* An index entry, one for each block */
+typedef struct serc_index_t
+{
+  uint64_t offset;                   /* Where the block starts in the file   */
+  uint64_t first_byte;               /* Number of its first byte             */
+  int64_t first_time;                /* Time of its first sample, in ticks   */
+  int64_t last_time;                 /* Time of its last sample, in ticks    */
+} serc_index_t;
+
+/* The trailer, last in a file that was closed cleanly */
+typedef struct serc_trailer_t
+{
+  uint32_t magic;                    /* SERC_INDEX_MAGIC                     */
+  uint32_t spare;                    /* Unused, zero                         */
+  uint64_t blocks;                   /* Number of index entries              */
+  uint64_t index_offset;             /* Where the index starts               */
+} serc_trailer_t;
+
+/* A sample, as decoded */
+typedef struct serc_sample_t
+{
+  unsigned long long number;         /* Number of the byte                   */
+  long long time;                    /* When its test ended, ns from start   */
+  long long return_time;             /* Return time in ns, or -1             */
+  serc_kind_t kind;                  /* What happened to it                  */
+  int tx;                            /* Byte sent, -1 if it came back ok     */
+  int rx;                            /* Byte received, or SERC_NO_RX         */
+} serc_sample_t;
+
+/* A capture file opened for reading */
+typedef struct serc_capture_t
+{
+  FILE *file;                        /* The file                             */
+  serc_header_t header;              /* Its header                           */
+  serc_index_t *index;               /* Its index                            */
+  size_t blocks;                     /* Number of blocks                     */
+  bool indexed;                      /* Was the index read from the file?    */
+  int error;                         /* errno, if it couldn't be loaded      */
+} serc_capture_t;
+
+/* Called with each sample decoded */
+typedef void (*serc_sample_func_t)(const serc_sample_t *sample,
+  void *context);
+
+
+/*****************************************************************************/
+/*      GLOBAL VARIABLES                                                     */
+/*****************************************************************************/
+
+
+/*****************************************************************************/
+/*      FUNCTION PROTOTYPES                                                  */
+/*****************************************************************************/
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: serc_open()                                                         */
+/*                                                                           */
+/* Description: Create a capture file and write its header                   */
+/*                                                                           */
+/* Parameters:                                                               */
+/*   Name            Type           Comments                                 */
+/*   ------------    ------------  -----------------------------------       */
+/*   path            const char *  The file to capture in                    */
+/*   port            const char *  Serial port being tested                  */
+/*   baud            unsigned long Baud rate being tested                    */
+/*                                                                           */
+/* Returns: SERC_OK if the file is ready, else SERC_FAILURE                  */
+/*                                                                           */
+/* Pre-conditions: Capture not open                                          */
+/*                                                                           */
+/* Post-conditions: Samples added are captured                               */
+/*                                                                           */
+/*****************************************************************************/
+
+extern serc_status_t serc_open(const char *path, const char *port,
+  unsigned long baud);
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: serc_add()                                                          */
+/*                                                                           */
+/* Description: Capture a tested byte. Only one thread may add bytes. The    */
+/*              file is only written when a block fills.                     */
+/*                                                                           */
+/* Parameters:                                                               */
+/*   Name            Type           Comments                                 */
+/*   ------------    ------------  -----------------------------------       */
+/*   kind            serc_kind_t   What happened to the byte                 */
+/*   tx              unsigned char The byte sent                             */
+/*   rx              int           The byte received, or SERC_NO_RX          */
+/*   return_time     long long     The byte's return time in ns, or -1       */
+/*                                                                           */
+/* Returns: void                                                             */
+/*                                                                           */
+/* Pre-conditions:                                                           */
+/*                                                                           */
+/* Post-conditions: Byte captured, if the capture is open                    */
+/*                                                                           */
+/*****************************************************************************/
+
+extern void serc_add(serc_kind_t kind, unsigned char tx, int rx,
+  long long return_time);
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: serc_close()                                                        */
+/*                                                                           */
+/* Description: Write the last block and the index, and close the file       */
+/*                                                                           */
+/* Parameters:                                                               */
+/*   Name            Type           Comments                                 */
+/*   ------------    ------------  -----------------------------------       */
+/*                                                                           */
+/* Returns: SERC_OK if everything was written, else SERC_FAILURE             */
+/*                                                                           */
+/* Pre-conditions:                                                           */
+/*                                                                           */
+/* Post-conditions: Capture closed                                           */
+/*                                                                           */
+/*****************************************************************************/
+
+extern serc_status_t serc_close(void);
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: serc_load()                                                         */
+/*                                                                           */
+/* Description: Open a capture file for reading, and load its index. If the  */
+/*              file has no index, as when the test crashed, the block       */
+/*              headers are read instead; the samples are not decoded.       */
+/*                                                                           */
+/* Parameters:                                                               */
+/*   Name            Type           Comments                                 */
+/*   ------------    ------------  -----------------------------------       */
+/*   path            const char *  The capture file                          */
+/*   capture         serc_capture_t The capture, filled in                   */
+/*                                                                           */
+/* Returns: SERC_OK if the file is a capture, else why it couldn't be        */
+/*          loaded; the errno of an open or read failure is in the capture   */
+/*                                                                           */
+/* Pre-conditions:                                                           */
+/*                                                                           */
+/* Post-conditions: serc_unload() must be called if successful               */
+/*                                                                           */
+/*****************************************************************************/
+
+extern serc_status_t serc_load(const char *path, serc_capture_t *capture);
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: serc_report_load()                                                  */
+/*                                                                           */
+/* Description: Print why a capture file couldn't be loaded to stderr        */
+/*                                                                           */
+/* Parameters:                                                               */
+/*   Name            Type           Comments                                 */
+/*   ------------    ------------  -----------------------------------       */
+/*   path            const char *  The capture file                          */
+/*   status          serc_status_t What serc_load() returned                 */
+/*   capture         serc_capture_t The capture it was given                 */
+/*                                                                           */
+/* Returns: void                                                             */
+/*                                                                           */
+/*****************************************************************************/
+
+extern void serc_report_load(const char *path, serc_status_t status,
+  const serc_capture_t *capture);
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: serc_find()                                                         */
+/*                                                                           */
+/* Description: Find the first block that may hold samples at or after a     */
+/*              time                                                         */
+/*                                                                           */
+/* Parameters:                                                               */
+/*   Name            Type           Comments                                 */
+/*   ------------    ------------  -----------------------------------       */
+/*   capture         serc_capture_t The capture                              */
+/*   time            long long     The time, in ns from the start            */
+/*                                                                           */
+/* Returns: The block's number, or the number of blocks if there is none     */
+/*                                                                           */
+/* Pre-conditions: Capture loaded                                            */
+/*                                                                           */
+/* Post-conditions:                                                          */
+/*                                                                           */
+/*****************************************************************************/
+
+extern size_t serc_find(const serc_capture_t *capture, long long time);
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: serc_decode_block()                                                 */
+/*                                                                           */
+/* Description: Decode a block held in memory, as from a mapped capture      */
+/*              file, passing each sample to a function. Several threads may */
+/*              decode blocks at once.                                       */
+/*                                                                           */
+/* Parameters:                                                               */
+/*   Name            Type           Comments                                 */
+/*   ------------    ------------  -----------------------------------       */
+/*   data            const void *  The block, starting with its header       */
+/*   len             size_t        Bytes there, at least the block's         */
+/*   tick_ns         unsigned long Nanoseconds in a tick, from the header    */
+/*   func            serc_sample_func_t Called with each sample              */
+/*   context         void *        Passed to func                            */
+/*                                                                           */
+/* Returns: SERC_OK if the block was decoded, else SERC_FAILURE              */
+/*                                                                           */
+/* Pre-conditions:                                                           */
+/*                                                                           */
+/* Post-conditions:                                                          */
+/*                                                                           */
+/*****************************************************************************/
+
+extern serc_status_t serc_decode_block(const void *data, size_t len,
+  unsigned long tick_ns, serc_sample_func_t func, void *context);
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: serc_read_block()                                                   */
+/*                                                                           */
+/* Description: Read and decode a block, passing each sample to a function   */
+/*                                                                           */
+/* Parameters:                                                               */
+/*   Name            Type           Comments                                 */
+/*   ------------    ------------  -----------------------------------       */
+/*   capture         serc_capture_t The capture                              */
+/*   block           size_t        The block's number                        */
+/*   func            serc_sample_func_t Called with each sample              */
+/*   context         void *        Passed to func                            */
+/*                                                                           */
+/* Returns: SERC_OK if the block was decoded, else SERC_FAILURE              */
+/*                                                                           */
+/* Pre-conditions: Capture loaded                                            */
+/*                                                                           */
+/* Post-conditions:                                                          */
+/*                                                                           */
+/*****************************************************************************/
+
+extern serc_status_t serc_read_block(serc_capture_t *capture, size_t block,
+  serc_sample_func_t func, void *context);
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: serc_unload()                                                       */
+/*                                                                           */
+/* Description: Close a capture file opened for reading                      */
+/*                                                                           */
+/* Parameters:                                                               */
+/*   Name            Type           Comments                                 */
+/*   ------------    ------------  -----------------------------------       */
+/*   capture         serc_capture_t The capture                              */
+/*                                                                           */
+/* Returns: void                                                             */
+/*                                                                           */
+/* Pre-conditions: Capture loaded                                            */
+/*                                                                           */
+/* Post-conditions: Capture closed                                           */
+/*                                                                           */
+/*****************************************************************************/
+
+extern void serc_unload(serc_capture_t *capture);
+
+
+#endif /* SERC_H */
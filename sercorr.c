@@ -0,0 +1,794 @@
+/*****************************************************************************/
+/*                                                                           */
+/* Module: sercorr.c                                                         */
+/*                                                                           */
+/* Description: serbert-correlate, finds errors together on many ports       */
+/*                                                                           */
+/* Copyright (C) 2026 The Serbert contributors                               */
+/*                                                                           */
+/* This file is part of Serbert.                                             */
+/*                                                                           */
+/* Serbert is free software; you can redistribute it and/or modify           */
+/* it under the terms of the GNU General Public License as published by      */
+/* the Free Software Foundation; either version 2 of the License, or         */
+/* any later version.                                                        */
+/*                                                                           */
+/* This program is distributed in the hope that it will be useful,           */
+/* but WITHOUT ANY WARRANTY; without even the implied warranty of            */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             */
+/* GNU General Public License for more details.                              */
+/*                                                                           */
+/* You should have received a copy of the GNU General Public License         */
+/* along with this program; if not, write to the Free Software               */
+/* Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA */
+/*                                                                           */
+/*****************************************************************************/
+
+/*****************************************************************************/
+/*      INCLUDED FILES (dependencies)                                        */
+/*****************************************************************************/
+
+#include <stdio.h>       /* Standard I/O definitions - printf()            */
+#include <stdlib.h>      /* Standard library - qsort(), strtod()           */
+#include <string.h>      /* Standard string lib - strcmp()                 */
+#include <stdbool.h>     /* Boolean types                                  */
+#include <stdint.h>      /* Fixed size types - int64_t                     */
+#include <time.h>        /* Time functions - localtime_r()                 */
+#include "sers.h"        /* Serial statistics library - SERS_NSEC_IN_SEC   */
+#include "serc.h"        /* Capture file library                           */
+
+
+/*****************************************************************************/
+/*      INTERNAL TYPE DEFINITIONS                                            */
+/*****************************************************************************/
+
+/* Enums & constants */
+
+enum { i_EXIT_OK = 0 };              /* Exit status, all well                */
+
+enum { i_EXIT_FAULT = 1 };           /* Exit status, a fault                 */
+
+enum { i_MAX_PORTS = 64 };           /* Most captures that can be compared   */
+
+enum { i_NS_PER_US = 1000 };         /* Nanoseconds in a microsecond         */
+
+enum { i_NS_PER_MS = 1000000 };      /* Nanoseconds in a millisecond         */
+
+enum { i_DEFAULT_WINDOW_MS = 10 };   /* Default gap allowed within a cluster */
+
+enum { i_MAX_WINDOW_MS = 3600000 };  /* Largest gap allowed, an hour         */
+
+enum { i_FIRST_EVENTS = 4096 };      /* Events room is first made for        */
+
+enum { i_DATE_LEN = 32 };            /* Room for a printed date and time     */
+
+/* Types */
+
+/* An errored byte on a port */
+typedef struct i_event_t
+{
+  int64_t time;                      /* When, in monotonic ns                */
+  unsigned int port;                 /* Which port                           */
+} i_event_t;
+
+/* A port, from its capture */
+typedef struct i_port_t
+{
+  const char *path;                  /* The capture file                     */
+  char name[SERC_PORT_LEN];          /* The port, terminated                 */
+  int64_t offset;                    /* Monotonic time of its start          */
+  unsigned long long errors;         /* Errored bytes                        */
+  unsigned long long clustered;      /* Of those, ones in clusters           */
+  unsigned long long episodes;       /* Runs of errors within the window     */
+  int64_t first_time;                /* Monotonic time of its first byte     */
+  int64_t last_time;                 /* And of its last                      */
+} i_port_t;
+
+/* Errors on all the ports, in the order found */
+typedef struct i_events_t
+{
+  i_event_t *event;                  /* The errors                           */
+  size_t used;                       /* Number of them                       */
+  size_t size;                       /* Room for them                        */
+  bool failed;                       /* Did making room fail?                */
+  i_port_t *port;                    /* Port being read                      */
+  unsigned int port_no;              /* Its number                           */
+} i_events_t;
+
+
+/*****************************************************************************/
+/*      INTERNAL VARIABLE DEFINITIONS                                        */
+/*****************************************************************************/
+
+static i_port_t i_ports[i_MAX_PORTS];       /* The ports compared            */
+
+static unsigned long long i_pairs[i_MAX_PORTS][i_MAX_PORTS];
+                                            /* Clusters each pair was in     */
+
+
+/*****************************************************************************/
+/*      INTERNAL FUNCTIONS                                                   */
+/*****************************************************************************/
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: i_add_event()                                                       */
+/*                                                                           */
+/* Description: Keeps a sample if it was an error                            */
+/*                                                                           */
+/* Uses: sample - The sample                                                 */
+/*       context - The errors so far                                         */
+/*                                                                           */
+/* Returns: void                                                             */
+/*                                                                           */
+/*****************************************************************************/
+
+static void i_add_event(const serc_sample_t *sample, void *context)
+{
+
+  i_events_t *events = (i_events_t *) context; /* The errors so far  */
+  i_event_t *bigger;                           /* More room for them */
+
+
+  if( (sample->kind != SERC_BYTE_OK) && (events->failed == false) )
+  {
+
+    if(events->used == events->size)
+    {
+
+      events->size = (events->size == 0) ? i_FIRST_EVENTS
+        : events->size * 2;
+
+      bigger = realloc(events->event, events->size * sizeof(i_event_t) );
+
+      if(bigger == NULL)
+      {
+
+        events->failed = true;
+
+      }
+      else
+      {
+
+        events->event = bigger;
+
+      }
+
+    }
+
+    if(events->failed == false)
+    {
+
+      events->event[events->used].time = events->port->offset
+        + (int64_t) sample->time;
+
+      events->event[events->used].port = events->port_no;
+
+      events->used++;
+
+      events->port->errors++;
+
+    }
+
+  }
+
+}
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: i_compare_events()                                                  */
+/*                                                                           */
+/* Description: Orders errors by time, for qsort()                           */
+/*                                                                           */
+/* Uses: a, b - The errors                                                   */
+/*                                                                           */
+/* Returns: Less than, equal to or more than 0 as a is before, with or after */
+/*          b                                                                */
+/*                                                                           */
+/*****************************************************************************/
+
+static int i_compare_events(const void *a, const void *b)
+{
+
+  const i_event_t *event_a = (const i_event_t *) a; /* First error  */
+  const i_event_t *event_b = (const i_event_t *) b; /* Second error */
+
+
+  return (event_a->time > event_b->time) - (event_a->time < event_b->time);
+
+}
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: i_read_port()                                                       */
+/*                                                                           */
+/* Description: Reads the errors from a capture. Its times are put on the    */
+/*              monotonic clock of the first capture, so all the ports can   */
+/*              be compared. A capture from another boot of the machine has  */
+/*              a different monotonic clock, so is lined up by the wall      */
+/*              clock instead.                                               */
+/*                                                                           */
+/* Uses: port_no - The port's number                                         */
+/*       first - The first capture's header                                  */
+/*       events - The errors so far                                          */
+/*                                                                           */
+/* Returns: Exit status                                                      */
+/*                                                                           */
+/*****************************************************************************/
+
+static int i_read_port(unsigned int port_no, serc_header_t *first,
+  i_events_t *events)
+{
+
+  int exit_status = i_EXIT_OK;            /* Exit status */
+  serc_capture_t capture;                 /* The capture */
+  serc_status_t load_status;              /* Was it loaded? */
+  i_port_t *port = &i_ports[port_no];     /* The port */
+  int64_t mono_gap;                       /* Start after the first's */
+  int64_t wall_gap;                       /* The same by the wall clock */
+  int64_t tick;                           /* Nanoseconds in a tick */
+  size_t block;                           /* Block being read */
+
+
+  if( (load_status = serc_load(port->path, &capture) ) != SERC_OK)
+  {
+
+    serc_report_load(port->path, load_status, &capture);
+
+    exit_status = i_EXIT_FAULT;
+
+  }
+  else
+  {
+
+    memcpy(port->name, capture.header.port, sizeof(port->name) );
+
+    port->name[sizeof(port->name) - 1] = '\0';
+
+    if(port_no == 0)
+    {
+
+      *first = capture.header;
+
+    }
+
+    mono_gap = capture.header.start_mono - first->start_mono;
+
+    wall_gap = capture.header.start_time - first->start_time;
+
+    port->offset = first->start_mono + mono_gap;
+
+    if(llabs( (long long) (mono_gap - wall_gap) ) > SERS_NSEC_IN_SEC)
+    {
+
+      fprintf(stderr, "%s is from another boot, lined up by wall clock\n",
+        port->path);
+
+      port->offset = first->start_mono + wall_gap;
+
+    }
+
+    tick = (int64_t) capture.header.tick_ns;
+
+    port->first_time = port->offset;
+
+    port->last_time = port->offset;
+
+    if(capture.blocks > 0)
+    {
+
+      port->first_time += capture.index[0].first_time * tick;
+
+      port->last_time += capture.index[capture.blocks - 1].last_time * tick;
+
+    }
+
+    events->port = port;
+
+    events->port_no = port_no;
+
+    for(block = 0; (block < capture.blocks) && (exit_status == i_EXIT_OK);
+      block++)
+    {
+
+      if(serc_read_block(&capture, block, i_add_event, events) != SERC_OK)
+      {
+
+        fprintf(stderr, "Failure reading block %lu of %s\n",
+          (unsigned long) block, port->path);
+
+        exit_status = i_EXIT_FAULT;
+
+      }
+      else if(events->failed == true)
+      {
+
+        fprintf(stderr, "Out of memory\n");
+
+        exit_status = i_EXIT_FAULT;
+
+      }
+
+    }
+
+    serc_unload(&capture);
+
+  }
+
+  return exit_status;
+
+}
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: i_print_cluster()                                                   */
+/*                                                                           */
+/* Description: Prints a cluster of errors, and counts the ports in it       */
+/*              together                                                     */
+/*                                                                           */
+/* Uses: first - The cluster's first error                                   */
+/*       end - The error after its last                                      */
+/*       counts - Errors from each port in it                                */
+/*       ports - Number of ports                                             */
+/*       to_wall - Added to a monotonic time to give the wall clock time     */
+/*                                                                           */
+/* Returns: void                                                             */
+/*                                                                           */
+/*****************************************************************************/
+
+static void i_print_cluster(const i_event_t *first, const i_event_t *end,
+  const unsigned long long *counts, unsigned int ports, int64_t to_wall)
+{
+
+  int64_t wall;                           /* Wall clock time of the first */
+  time_t secs;                            /* Its whole seconds */
+  struct tm local;                        /* Its local time */
+  char date[i_DATE_LEN];                  /* It printed */
+  unsigned int port;                      /* Port being printed */
+  unsigned int other;                     /* Port it was with */
+
+
+  wall = first->time + to_wall;
+
+  secs = (time_t) (wall / SERS_NSEC_IN_SEC);
+
+  date[0] = '\0';
+
+  if(localtime_r(&secs, &local) != NULL)
+  {
+
+    (void) strftime(date, sizeof(date), "%Y-%m-%d %H:%M:%S", &local);
+
+  }
+
+  printf("%s.%06lld for %lld us:", date,
+    (long long) ( (wall % SERS_NSEC_IN_SEC) / i_NS_PER_US),
+    (long long) ( (end[-1].time - first->time) / i_NS_PER_US) );
+
+  for(port = 0; port < ports; port++)
+  {
+
+    if(counts[port] > 0)
+    {
+
+      printf(" %u (%llu)", port + 1, counts[port]);
+
+      i_ports[port].clustered += counts[port];
+
+      for(other = port + 1; other < ports; other++)
+      {
+
+        if(counts[other] > 0)
+        {
+
+          i_pairs[port][other]++;
+
+        }
+
+      }
+
+    }
+
+  }
+
+  printf("\n");
+
+}
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: i_find_clusters()                                                   */
+/*                                                                           */
+/* Description: Finds and prints clusters of errors on more than one port.   */
+/*              Errors are in the same cluster when each is within the       */
+/*              window of the one before, so a cluster can last longer than  */
+/*              the window while an event goes on.                           */
+/*                                                                           */
+/* Uses: events - The errors, in time order                                  */
+/*       ports - Number of ports                                             */
+/*       window - Most time between errors in a cluster, in ns               */
+/*       to_wall - Added to a monotonic time to give the wall clock time     */
+/*                                                                           */
+/* Returns: Number of clusters                                               */
+/*                                                                           */
+/*****************************************************************************/
+
+static unsigned long long i_find_clusters(const i_events_t *events,
+  unsigned int ports, int64_t window, int64_t to_wall)
+{
+
+  unsigned long long clusters = 0;        /* Clusters found */
+  unsigned long long counts[i_MAX_PORTS]; /* Errors from each port */
+  unsigned int taking_part;               /* Ports in the cluster */
+  size_t first = 0;                       /* Cluster's first error */
+  size_t end;                             /* Error after its last */
+
+
+  while(first < events->used)
+  {
+
+    memset(counts, 0, sizeof(counts) );
+
+    taking_part = 0;
+
+    end = first;
+
+    do
+    {
+
+      if(counts[events->event[end].port] == 0)
+      {
+
+        taking_part++;
+
+      }
+
+      counts[events->event[end].port]++;
+
+      end++;
+
+    } while( (end < events->used)
+      && (events->event[end].time - events->event[end - 1].time <= window) );
+
+    if(taking_part > 1)
+    {
+
+      i_print_cluster(&events->event[first], &events->event[end], counts,
+        ports, to_wall);
+
+      clusters++;
+
+    }
+
+    first = end;
+
+  }
+
+  return clusters;
+
+}
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: i_count_episodes()                                                  */
+/*                                                                           */
+/* Description: Counts each port's runs of errors, taking errors within the  */
+/*              window of the one before on the same port as one run         */
+/*                                                                           */
+/* Uses: events - The errors, in time order                                  */
+/*       window - Most time between errors in a run, in ns                   */
+/*                                                                           */
+/* Returns: void                                                             */
+/*                                                                           */
+/*****************************************************************************/
+
+static void i_count_episodes(const i_events_t *events, int64_t window)
+{
+
+  int64_t last[i_MAX_PORTS];              /* Each port's last error */
+  bool seen[i_MAX_PORTS];                 /* Has it had one yet? */
+  const i_event_t *event;                 /* Error being counted */
+  size_t event_no;                        /* Its number */
+
+
+  memset(seen, 0, sizeof(seen) );
+
+  for(event_no = 0; event_no < events->used; event_no++)
+  {
+
+    event = &events->event[event_no];
+
+    if( (seen[event->port] == false)
+      || (event->time - last[event->port] > window) )
+    {
+
+      i_ports[event->port].episodes++;
+
+    }
+
+    last[event->port] = event->time;
+
+    seen[event->port] = true;
+
+  }
+
+}
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: i_get_chance()                                                      */
+/*                                                                           */
+/* Description: Gets roughly how many clusters two ports would be in         */
+/*              together by chance, if their runs of errors were independent */
+/*              and spread evenly over the time both were tested             */
+/*                                                                           */
+/* Uses: a, b - The ports                                                    */
+/*       window - Most time between errors in a cluster, in ns               */
+/*                                                                           */
+/* Returns: The clusters expected                                            */
+/*                                                                           */
+/*****************************************************************************/
+
+static double i_get_chance(const i_port_t *a, const i_port_t *b,
+  int64_t window)
+{
+
+  double chance = 0.0;                    /* Clusters expected */
+  int64_t overlap;                        /* Time both were tested */
+
+
+  overlap = ( (a->last_time < b->last_time) ? a->last_time : b->last_time)
+    - ( (a->first_time > b->first_time) ? a->first_time : b->first_time);
+
+  if(overlap > 0)
+  {
+
+    /* A run on one port falls within the window either side of a run */
+    /* on the other                                                    */
+    chance = ( (double) a->episodes * (double) b->episodes * 2.0
+      * (double) window) / (double) overlap;
+
+  }
+
+  return chance;
+
+}
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: i_correlate()                                                       */
+/*                                                                           */
+/* Description: Reads the errors from all the captures, then reports the     */
+/*              clusters of errors on more than one port, how many of each   */
+/*              port's errors were in them, and which ports erred together   */
+/*                                                                           */
+/* Uses: ports - Number of captures                                          */
+/*       window - Most time between errors in a cluster, in ns               */
+/*                                                                           */
+/* Returns: Exit status                                                      */
+/*                                                                           */
+/*****************************************************************************/
+
+static int i_correlate(unsigned int ports, int64_t window)
+{
+
+  int exit_status = i_EXIT_OK;            /* Exit status */
+  i_events_t events;                      /* Errors on all the ports */
+  serc_header_t first;                    /* The first capture's header */
+  unsigned long long clusters;            /* Clusters found */
+  unsigned int port;                      /* Port being read */
+  unsigned int other;                     /* Port it was with */
+
+
+  memset(&first, 0, sizeof(first) );
+
+  events.event = NULL;
+
+  events.used = 0;
+
+  events.size = 0;
+
+  events.failed = false;
+
+  for(port = 0; (port < ports) && (exit_status == i_EXIT_OK); port++)
+  {
+
+    exit_status = i_read_port(port, &first, &events);
+
+  }
+
+  if(exit_status == i_EXIT_OK)
+  {
+
+    qsort(events.event, events.used, sizeof(i_event_t), i_compare_events);
+
+    printf("Clusters of errors on more than one port, within %lld us:\n",
+      (long long) (window / i_NS_PER_US) );
+
+    clusters = i_find_clusters(&events, ports, window,
+      first.start_time - first.start_mono);
+
+    i_count_episodes(&events, window);
+
+    printf("Clusters: %llu\n", clusters);
+
+    printf("Ports:\n");
+
+    for(port = 0; port < ports; port++)
+    {
+
+      printf("  %u %s (%s): %llu errors, %llu in clusters", port + 1,
+        i_ports[port].name, i_ports[port].path, i_ports[port].errors,
+        i_ports[port].clustered);
+
+      if(i_ports[port].errors > 0)
+      {
+
+        printf(" (%.1f%%)", ( (double) i_ports[port].clustered * 100.0)
+          / (double) i_ports[port].errors);
+
+      }
+
+      printf("\n");
+
+    }
+
+    if(clusters > 0)
+    {
+
+      printf("Ports in clusters together:\n");
+
+      for(port = 0; port < ports; port++)
+      {
+
+        for(other = port + 1; other < ports; other++)
+        {
+
+          if(i_pairs[port][other] > 0)
+          {
+
+            printf("  %u and %u: %llu, about %.1f expected by chance\n",
+              port + 1, other + 1, i_pairs[port][other],
+              i_get_chance(&i_ports[port], &i_ports[other], window) );
+
+          }
+
+        }
+
+      }
+
+    }
+
+  }
+
+  free(events.event);
+
+  return exit_status;
+
+}
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: i_print_help()                                                      */
+/*                                                                           */
+/* Description: Prints the usage                                             */
+/*                                                                           */
+/* Uses: void                                                                */
+/*                                                                           */
+/* Returns: void                                                             */
+/*                                                                           */
+/*****************************************************************************/
+
+static void i_print_help(void)
+{
+
+  printf("\nUsage: serbert-correlate [-h] [-w MS] FILE FILE...\n\n");
+
+  printf("Finds errors at the same moments on ports captured by serbert -L\n");
+
+  printf("at the same time, which point to a common cause, and prints each\n");
+
+  printf("cluster of them with the ports taking part and their errors\n\n");
+
+  printf(" -h - Print this help\n");
+
+  printf(" -w - Most time between errors in a cluster, in ms. Default %d\n\n",
+    i_DEFAULT_WINDOW_MS);
+
+}
+
+
+/*****************************************************************************/
+/*      MAIN                                                                 */
+/*****************************************************************************/
+
+int main(int argc, char *argv[])
+{
+
+  int exit_status = i_EXIT_OK;            /* Exit status */
+  bool help = false;                      /* Only printing the help? */
+  unsigned int ports = 0;                 /* Captures given */
+  double window_ms = i_DEFAULT_WINDOW_MS; /* Window in ms */
+  char *end_ptr;                          /* End of the window */
+  int arg_no;                             /* Argument being processed */
+
+
+  for(arg_no = 1; (arg_no < argc) && (exit_status == i_EXIT_OK)
+    && (help == false); arg_no++)
+  {
+
+    if(strcmp(argv[arg_no], "-h") == 0)
+    {
+
+      i_print_help();
+
+      help = true;
+
+    }
+    else if( (strcmp(argv[arg_no], "-w") == 0) && (arg_no + 1 < argc) )
+    {
+
+      arg_no++;
+
+      window_ms = strtod(argv[arg_no], &end_ptr);
+
+      if( (end_ptr == argv[arg_no]) || (*end_ptr != '\0')
+        || (window_ms <= 0.0) || (window_ms > i_MAX_WINDOW_MS) )
+      {
+
+        fprintf(stderr, "Invalid window: %s\n", argv[arg_no]);
+
+        i_print_help();
+
+        exit_status = i_EXIT_FAULT;
+
+      }
+
+    }
+    else if( (argv[arg_no][0] == '-') || (ports == i_MAX_PORTS) )
+    {
+
+      fprintf(stderr, "Invalid argument: %s\n", argv[arg_no]);
+
+      i_print_help();
+
+      exit_status = i_EXIT_FAULT;
+
+    }
+    else
+    {
+
+      i_ports[ports].path = argv[arg_no];
+
+      ports++;
+
+    }
+
+  }
+
+  if( (exit_status == i_EXIT_OK) && (help == false) )
+  {
+
+    if(ports < 2)
+    {
+
+      fprintf(stderr, "At least two capture files are needed\n");
+
+      i_print_help();
+
+      exit_status = i_EXIT_FAULT;
+
+    }
+    else
+    {
+
+      exit_status = i_correlate(ports,
+        (int64_t) (window_ms * i_NS_PER_MS) );
+
+    }
+
+  }
+
+  return exit_status;
+
+}
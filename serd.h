@@ -0,0 +1,97 @@
+/*****************************************************************************/
+/*                                                                           */
+/* Module: serd.h                                                            */
+/*                                                                           */
+/* Description: Static trace probes for perf, bpftrace and SystemTap         */
+/*                                                                           */
+/* Copyright (C) 2026 The Serbert contributors                               */
+/*                                                                           */
+/* This file is part of Serbert.                                             */
+/*                                                                           */
+/* Serbert is free software; you can redistribute it and/or modify           */
+/* it under the terms of the GNU General Public License as published by      */
+/* the Free Software Foundation; either version 2 of the License, or         */
+/* any later version.                                                        */
+/*                                                                           */
+/* This program is distributed in the hope that it will be useful,           */
+/* but WITHOUT ANY WARRANTY; without even the implied warranty of            */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             */
+/* GNU General Public License for more details.                              */
+/*                                                                           */
+/* You should have received a copy of the GNU General Public License         */
+/* along with this program; if not, write to the Free Software               */
+/* Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA */
+/*                                                                           */
+/*****************************************************************************/
+
+#ifndef SERD_H
+
+#define SERD_H
+
+/*****************************************************************************/
+/*      INCLUDED FILES (dependencies)                                        */
+/*****************************************************************************/
+
+/* Only when configure found it, else the probes compile to nothing */
+#ifdef HAVE_SYS_SDT_H
+#include <sys/sdt.h>     /* Statically defined tracing - DTRACE_PROBE()    */
+#endif
+
+
+/*****************************************************************************/
+/*      MACRO DEFINITIONS                                                    */
+/*****************************************************************************/
+
+/*****************************************************************************/
+/*  Name: SERD_PROBEn()                                                      */
+/*  Description: Marks a place the test can be traced from, as a probe of    */
+/*               the serbert provider. With sys/sdt.h each probe is a single */
+/*               nop, with its arguments noted in an ELF note for the tracer */
+/*               to find, so costs nothing until a tracer attaches. Without  */
+/*               it, the probe goes and its arguments are only evaluated.    */
+/*               List them with e.g. perf list sdt or bpftrace -l.           */
+/*  Parameters: name - The probe's name                                      */
+/*              a1 to a5 - Its arguments, integers or pointers               */
+/*****************************************************************************/
+
+#ifdef HAVE_SYS_SDT_H
+
+#define SERD_PROBE1(name, a1) \
+  DTRACE_PROBE1(serbert, name, a1)
+
+#define SERD_PROBE2(name, a1, a2) \
+  DTRACE_PROBE2(serbert, name, a1, a2)
+
+#define SERD_PROBE3(name, a1, a2, a3) \
+  DTRACE_PROBE3(serbert, name, a1, a2, a3)
+
+#define SERD_PROBE4(name, a1, a2, a3, a4) \
+  DTRACE_PROBE4(serbert, name, a1, a2, a3, a4)
+
+#define SERD_PROBE5(name, a1, a2, a3, a4, a5) \
+  DTRACE_PROBE5(serbert, name, a1, a2, a3, a4, a5)
+
+#else
+
+#define SERD_PROBE1(name, a1) \
+  do { (void) (a1); } while(0)
+
+#define SERD_PROBE2(name, a1, a2) \
+  do { (void) (a1); (void) (a2); } while(0)
+
+#define SERD_PROBE3(name, a1, a2, a3) \
+  do { (void) (a1); (void) (a2); (void) (a3); } while(0)
+
+#define SERD_PROBE4(name, a1, a2, a3, a4) \
+  do { (void) (a1); (void) (a2); (void) (a3); (void) (a4); } while(0)
+
+#define SERD_PROBE5(name, a1, a2, a3, a4, a5) \
+  do \
+  { \
+    (void) (a1); (void) (a2); (void) (a3); (void) (a4); (void) (a5); \
+  } while(0)
+
+#endif /* HAVE_SYS_SDT_H */
+
+
+#endif /* SERD_H */
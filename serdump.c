@@ -0,0 +1,525 @@
+/*****************************************************************************/
+/*                                                                           */
+/* Module: serdump.c                                                         */
+/*                                                                           */
+/* Description: serbert-dump, decodes a serbert flight record                */
+/*                                                                           */
+/* Copyright (C) 2026 The Serbert contributors                               */
+/*                                                                           */
+/* This file is part of Serbert.                                             */
+/*                                                                           */
+/* Serbert is free software; you can redistribute it and/or modify           */
+/* it under the terms of the GNU General Public License as published by      */
+/* the Free Software Foundation; either version 2 of the License, or         */
+/* any later version.                                                        */
+/*                                                                           */
+/* This program is distributed in the hope that it will be useful,           */
+/* but WITHOUT ANY WARRANTY; without even the implied warranty of            */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             */
+/* GNU General Public License for more details.                              */
+/*                                                                           */
+/* You should have received a copy of the GNU General Public License         */
+/* along with this program; if not, write to the Free Software               */
+/* Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA */
+/*                                                                           */
+/*****************************************************************************/
+
+/*****************************************************************************/
+/*      INCLUDED FILES (dependencies)                                        */
+/*****************************************************************************/
+
+#include <stdio.h>       /* Standard I/O definitions - printf()            */
+#include <string.h>      /* Standard string lib - strcmp(), memcpy()       */
+#include <stdbool.h>     /* Boolean types                                  */
+#include <time.h>        /* Time defs - localtime_r(), strftime()          */
+#include <unistd.h>      /* UNIX standard - close()                        */
+#include <fcntl.h>       /* File control - open()                          */
+#include <sys/stat.h>    /* File status - fstat()                          */
+#include <sys/mman.h>    /* Memory mapping - mmap()                        */
+#include "sers.h"        /* Serial statistics library - SERS_NSEC_IN_SEC   */
+#include "serf.h"        /* Flight recorder library                        */
+
+
+/*****************************************************************************/
+/*      INTERNAL TYPE DEFINITIONS                                            */
+/*****************************************************************************/
+
+/* Enums & constants */
+
+enum { i_EXIT_OK = 0 };              /* Exit status, all well                */
+
+enum { i_EXIT_FAULT = 1 };           /* Exit status, a fault                 */
+
+enum { i_OPEN_FAIL = -1 };           /* open() failure state                 */
+
+enum { i_NS_PER_US = 1000 };         /* Nanoseconds in a microsecond         */
+
+enum { i_TIME_STR_LEN = 32 };        /* Room for a date and time             */
+
+
+/*****************************************************************************/
+/*      INTERNAL FUNCTIONS                                                   */
+/*****************************************************************************/
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: i_print_time()                                                      */
+/*                                                                           */
+/* Description: Prints a time in ns since the epoch as local time, to the    */
+/*              microsecond                                                  */
+/*                                                                           */
+/* Uses: time_ns - The time                                                  */
+/*       format - strftime() format for the whole seconds                    */
+/*                                                                           */
+/* Returns: void                                                             */
+/*                                                                           */
+/*****************************************************************************/
+
+static void i_print_time(int64_t time_ns, const char *format)
+{
+
+  time_t secs;                            /* Whole seconds */
+  struct tm local;                        /* As local time */
+  char time_str[i_TIME_STR_LEN];          /* As a string */
+
+
+  secs = (time_t) (time_ns / SERS_NSEC_IN_SEC);
+
+  time_str[0] = '\0';
+
+  if(localtime_r(&secs, &local) != NULL)
+  {
+
+    (void) strftime(time_str, sizeof(time_str), format, &local);
+
+  }
+
+  printf("%s.%06ld", time_str,
+    (long) ( (time_ns % SERS_NSEC_IN_SEC) / i_NS_PER_US) );
+
+}
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: i_print_byte()                                                      */
+/*                                                                           */
+/* Description: Prints a line for a recorded byte                            */
+/*                                                                           */
+/* Uses: number - The byte's number                                          */
+/*       byte - The byte's record                                            */
+/*       trigger - Is it the byte that started a freeze?                     */
+/*                                                                           */
+/* Returns: void                                                             */
+/*                                                                           */
+/*****************************************************************************/
+
+static void i_print_byte(unsigned long long number, const serf_byte_t *byte,
+  bool trigger)
+{
+
+  printf("%c %12llu  ", (trigger == true) ? '*' : ' ', number);
+
+  i_print_time(byte->time, "%H:%M:%S");
+
+  printf("  %02x  ", (unsigned int) byte->tx);
+
+  if( (byte->flags & SERF_RX) != 0)
+  {
+
+    printf("%02x  ", (unsigned int) byte->rx);
+
+  }
+  else
+  {
+
+    printf("--  ");
+
+  }
+
+  if(byte->return_time > 0)
+  {
+
+    printf("%10lu", (unsigned long) (byte->return_time / i_NS_PER_US) );
+
+  }
+  else
+  {
+
+    printf("%10s", "-");
+
+  }
+
+  printf("%s%s%s\n", ( (byte->flags & SERF_ERROR) != 0) ? "  error" : "",
+    ( (byte->flags & SERF_TIMEOUT) != 0) ? " timeout" : "",
+    ( (byte->flags & SERF_FRAMING) != 0) ? " framing" : "");
+
+}
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: i_print_heading()                                                   */
+/*                                                                           */
+/* Description: Prints the heading for a list of bytes                       */
+/*                                                                           */
+/* Uses: void                                                                */
+/*                                                                           */
+/* Returns: void                                                             */
+/*                                                                           */
+/*****************************************************************************/
+
+static void i_print_heading(void)
+{
+
+  printf("  %12s  %-15s  TX  RX  RETURN/us  FLAGS\n", "BYTE", "TIME");
+
+}
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: i_dump_freezes()                                                    */
+/*                                                                           */
+/* Description: Prints the freezes kept, oldest first                        */
+/*                                                                           */
+/* Uses: file - The flight record                                            */
+/*                                                                           */
+/* Returns: void                                                             */
+/*                                                                           */
+/*****************************************************************************/
+
+static void i_dump_freezes(const serf_file_t *file)
+{
+
+  unsigned long long frozen;              /* Freezes started */
+  unsigned long long freeze_no;           /* Freeze being printed */
+  const serf_freeze_t *freeze;            /* The freeze */
+  unsigned long long first;               /* Its first byte */
+  unsigned long long trigger;             /* Its errored byte */
+  unsigned int count;                     /* Bytes it holds */
+  unsigned int byte_no;                   /* Byte being printed */
+
+
+  frozen = atomic_load(&file->frozen);
+
+  freeze_no = (frozen > SERF_FREEZES) ? frozen - SERF_FREEZES : 0;
+
+  for( ; freeze_no < frozen; freeze_no++)
+  {
+
+    freeze = &file->freeze[freeze_no % SERF_FREEZES];
+
+    count = atomic_load(&freeze->count);
+
+    first = atomic_load(&freeze->first);
+
+    trigger = atomic_load(&freeze->trigger);
+
+    if(count > SERF_FREEZE_LEN)
+    {
+
+      count = SERF_FREEZE_LEN;
+
+    }
+
+    /* A freeze being started when the test died holds nothing */
+    if(count > 0)
+    {
+
+      printf("\nFreeze %llu: error at byte %llu\n", freeze_no + 1, trigger);
+
+      i_print_heading();
+
+      for(byte_no = 0; byte_no < count; byte_no++)
+      {
+
+        i_print_byte(first + byte_no, &freeze->bytes[byte_no],
+          first + byte_no == trigger);
+
+      }
+
+    }
+
+  }
+
+}
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: i_dump_ring()                                                       */
+/*                                                                           */
+/* Description: Prints the latest bytes, oldest first                        */
+/*                                                                           */
+/* Uses: file - The flight record                                            */
+/*                                                                           */
+/* Returns: void                                                             */
+/*                                                                           */
+/*****************************************************************************/
+
+static void i_dump_ring(const serf_file_t *file)
+{
+
+  unsigned long long bytes;               /* Bytes recorded */
+  unsigned long long byte_no;             /* Byte being printed */
+
+
+  bytes = atomic_load(&file->bytes);
+
+  byte_no = (bytes > SERF_RING_LEN) ? bytes - SERF_RING_LEN : 0;
+
+  printf("\nLatest %llu bytes:\n", bytes - byte_no);
+
+  i_print_heading();
+
+  for( ; byte_no < bytes; byte_no++)
+  {
+
+    i_print_byte(byte_no, &file->ring[byte_no & (SERF_RING_LEN - 1)],
+      false);
+
+  }
+
+}
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: i_dump()                                                            */
+/*                                                                           */
+/* Description: Prints a flight record                                       */
+/*                                                                           */
+/* Uses: file - The flight record                                            */
+/*       all - Print all the latest bytes, not just the freezes?             */
+/*                                                                           */
+/* Returns: void                                                             */
+/*                                                                           */
+/*****************************************************************************/
+
+static void i_dump(const serf_file_t *file, bool all)
+{
+
+  char port[SERF_PORT_LEN];               /* The port, terminated */
+  unsigned long long frozen;              /* Freezes started */
+
+
+  memcpy(port, file->port, sizeof(port) );
+
+  port[sizeof(port) - 1] = '\0';
+
+  frozen = atomic_load(&file->frozen);
+
+  printf("Flight record of %s at %lu baud, process %ld\n", port,
+    (unsigned long) file->baud, (long) file->pid);
+
+  printf("Started: ");
+
+  i_print_time(file->start_time, "%Y-%m-%d %H:%M:%S");
+
+  printf("\nBytes recorded: %llu\n", atomic_load(&file->bytes) );
+
+  printf("Errors frozen: %llu, latest %llu kept\n", frozen,
+    (frozen > SERF_FREEZES) ? (unsigned long long) SERF_FREEZES : frozen);
+
+  printf("Test %s\n", (atomic_load(&file->finished) != 0) ? "finished" :
+    "did not finish");
+
+  i_dump_freezes(file);
+
+  if(all == true)
+  {
+
+    i_dump_ring(file);
+
+  }
+
+}
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: i_dump_file()                                                       */
+/*                                                                           */
+/* Description: Maps a flight record file, checks it, and prints it          */
+/*                                                                           */
+/* Uses: path - The file                                                     */
+/*       all - Print all the latest bytes, not just the freezes?             */
+/*                                                                           */
+/* Returns: Exit status                                                      */
+/*                                                                           */
+/*****************************************************************************/
+
+static int i_dump_file(const char *path, bool all)
+{
+
+  int exit_status = i_EXIT_FAULT;         /* Exit status */
+  int file;                               /* The flight record file */
+  struct stat file_stat;                  /* Its size */
+  serf_file_t *record;                    /* The flight record, mapped */
+
+
+  file = open(path, O_RDONLY);
+
+  if(file == i_OPEN_FAIL)
+  {
+
+    fprintf(stderr, "Failure opening %s\n", path);
+
+  }
+  else
+  {
+
+    if( (fstat(file, &file_stat) != 0)
+      || ( (size_t) file_stat.st_size < sizeof(serf_file_t) ) )
+    {
+
+      fprintf(stderr, "%s is not a flight record\n", path);
+
+    }
+    else
+    {
+
+      record = mmap(NULL, sizeof(serf_file_t), PROT_READ, MAP_SHARED, file,
+        0);
+
+      if(record == MAP_FAILED)
+      {
+
+        fprintf(stderr, "Failure reading %s\n", path);
+
+      }
+      else
+      {
+
+        if( (atomic_load(&record->magic) != SERF_MAGIC)
+          || (record->version != SERF_VERSION)
+          || (record->size != sizeof(serf_file_t) )
+          || (record->ring_len != SERF_RING_LEN)
+          || (record->freeze_len != SERF_FREEZE_LEN)
+          || (record->freezes != SERF_FREEZES) )
+        {
+
+          fprintf(stderr, "%s is not a flight record of this version\n",
+            path);
+
+        }
+        else
+        {
+
+          i_dump(record, all);
+
+          exit_status = i_EXIT_OK;
+
+        }
+
+        (void) munmap(record, sizeof(serf_file_t) );
+
+      }
+
+    }
+
+    (void) close(file);
+
+  }
+
+  return exit_status;
+
+}
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: i_print_help()                                                      */
+/*                                                                           */
+/* Description: Prints the usage                                             */
+/*                                                                           */
+/* Uses: void                                                                */
+/*                                                                           */
+/* Returns: void                                                             */
+/*                                                                           */
+/*****************************************************************************/
+
+static void i_print_help(void)
+{
+
+  printf("\nUsage: serbert-dump [-a] FILE\n\n");
+
+  printf("Prints a flight record kept by serbert -F\n\n");
+
+  printf(" -a - Print all the latest bytes, not just those around errors\n");
+
+  printf(" -h - Print this help\n\n");
+
+}
+
+
+/*****************************************************************************/
+/*      MAIN                                                                 */
+/*****************************************************************************/
+
+int main(int argc, char *argv[])
+{
+
+  int exit_status = i_EXIT_OK;            /* Exit status */
+  bool all = false;                       /* Printing all the bytes? */
+  bool help = false;                      /* Only printing the help? */
+  const char *path = NULL;                /* The flight record file */
+  int arg_no;                             /* Argument being processed */
+
+
+  for(arg_no = 1; (arg_no < argc) && (exit_status == i_EXIT_OK)
+    && (help == false); arg_no++)
+  {
+
+    if(strcmp(argv[arg_no], "-a") == 0)
+    {
+
+      all = true;
+
+    }
+    else if(strcmp(argv[arg_no], "-h") == 0)
+    {
+
+      i_print_help();
+
+      help = true;
+
+    }
+    else if( (argv[arg_no][0] == '-') || (path != NULL) )
+    {
+
+      fprintf(stderr, "Invalid argument: %s\n", argv[arg_no]);
+
+      i_print_help();
+
+      exit_status = i_EXIT_FAULT;
+
+    }
+    else
+    {
+
+      path = argv[arg_no];
+
+    }
+
+  }
+
+  if( (exit_status == i_EXIT_OK) && (help == false) )
+  {
+
+    if(path == NULL)
+    {
+
+      fprintf(stderr, "No flight record given\n");
+
+      i_print_help();
+
+      exit_status = i_EXIT_FAULT;
+
+    }
+    else
+    {
+
+      exit_status = i_dump_file(path, all);
+
+    }
+
+  }
+
+  return exit_status;
+
+}
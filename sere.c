@@ -0,0 +1,1051 @@
+/*****************************************************************************/
+/*                                                                           */
+/* Module: sere.c                                                            */
+/*                                                                           */
+/* Description: Pseudo terminal loopback emulator, to test without hardware  */
+/*                                                                           */
+/* Copyright (C) 2026 The Serbert contributors                               */
+/*                                                                           */
+/* This file is part of Serbert.                                             */
+/*                                                                           */
+/* Serbert is free software; you can redistribute it and/or modify           */
+/* it under the terms of the GNU General Public License as published by      */
+/* the Free Software Foundation; either version 2 of the License, or         */
+/* any later version.                                                        */
+/*                                                                           */
+/* This program is distributed in the hope that it will be useful,           */
+/* but WITHOUT ANY WARRANTY; without even the implied warranty of            */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             */
+/* GNU General Public License for more details.                              */
+/*                                                                           */
+/* You should have received a copy of the GNU General Public License         */
+/* along with this program; if not, write to the Free Software               */
+/* Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA */
+/*                                                                           */
+/*****************************************************************************/
+
+/*****************************************************************************/
+/*      INCLUDED FILES (dependencies)                                        */
+/*****************************************************************************/
+
+#include <stdio.h>       /* Standard I/O definitions - snprintf()          */
+#include <string.h>      /* Standard string lib - strlen()                 */
+#include <stdbool.h>     /* Boolean types                                  */
+#include <stdint.h>      /* Fixed size integers - uint8_t                  */
+#include <limits.h>      /* Variable max sizes - PATH_MAX                  */
+#include <stdatomic.h>   /* Atomic types - atomic_bool                     */
+#include <pthread.h>     /* Threads - pthread_create()                     */
+#include <unistd.h>      /* UNIX standard - read(), write(), close()       */
+#include <fcntl.h>       /* File control - fcntl()                         */
+#include <poll.h>        /* Waiting on descriptors - poll()                */
+#include <time.h>        /* Time functions - clock_nanosleep()             */
+#include <termios.h>     /* Terminal settings - cfmakeraw()                */
+#include <pty.h>         /* Pseudo terminals - openpty()                   */
+#include <sys/socket.h>  /* Sockets - socket(), bind(), accept()           */
+#include <netinet/in.h>  /* Internet sockets - sockaddr_in                 */
+#include <netinet/tcp.h> /* TCP options - TCP_NODELAY                      */
+#include <arpa/inet.h>   /* Internet addresses - htonl(), ntohs()          */
+#include "sers.h"        /* Serial statistics library - SERS_NSEC_IN_SEC   */
+#include "sert.h"        /* Serial transports - SERT_TCP_PREFIX            */
+#include "sern.h"        /* Telnet coding - sern_decode()                  */
+#include "sere.h"        /* Header file for this library                   */
+
+
+/*****************************************************************************/
+/*      INTERNAL MACRO DEFINITIONS                                           */
+/*****************************************************************************/
+
+/*****************************************************************************/
+/*  Name:                                                                    */
+/*  Description:                                                             */
+/*  Parameters:                                                              */
+/*  Client functions:                                                        */
+/*****************************************************************************/
+
+
+/*****************************************************************************/
+/*      INTERNAL TYPE DEFINITIONS                                            */
+/*****************************************************************************/
+
+enum { i_NO_FD = -1 };               /* No descriptor open                   */
+
+enum { i_ESCAPE = 0xFF };            /* First byte of a PARMRK marker        */
+
+enum { i_BITS = 8 };                 /* Bits in a byte                       */
+
+enum { i_SEED = 1 };                 /* Fault generator seed, so runs repeat */
+
+enum { i_MARKER_FAULTS = (1U << SERE_FRAMING) | (1U << SERE_PARITY)
+  | (1U << SERE_BREAK) };            /* Faults needing PARMRK markers        */
+
+
+/*****************************************************************************/
+/*      INTERNAL VARIABLE DEFINITIONS                                        */
+/*****************************************************************************/
+
+static int i_master = i_NO_FD;                /* Emulator's end of the pty  */
+
+static int i_slave = i_NO_FD;                 /* The end tested, kept open  */
+
+static int i_listener = i_NO_FD;              /* Stand-in server's socket   */
+
+static bool i_rfc2217 = false;                /* It speaks RFC 2217         */
+
+static sern_decoder_t i_decoder;              /* Its telnet decoder         */
+
+static bool i_escaping = true;                /* 0xFF doubled when echoed   */
+
+static sere_setup_t i_setup;                  /* How bytes are echoed       */
+
+static uint8_t i_buf[SERE_BUF_LEN];           /* Bytes being echoed         */
+
+static uint8_t i_out[SERE_BUF_LEN * SERE_MARK_LEN]; /* As written back      */
+
+static bool i_marking;                        /* PARMRK taken from the pty  */
+
+static uint32_t i_seed;                       /* Fault generator state      */
+
+static sere_fault_t i_burst_fault;            /* Fault in the current burst */
+
+static unsigned int i_burst_left;             /* Bytes left in the burst    */
+
+static atomic_ullong i_injected[SERE_FAULTS]; /* Bytes given each fault     */
+
+static atomic_bool i_stopping;                /* Emulator asked to stop     */
+
+static bool i_running = false;                /* Emulator running           */
+
+static pthread_t i_thread;                    /* The echo thread            */
+
+
+/*****************************************************************************/
+/*      INTERNAL FUNCTION DEFINITIONS                                        */
+/*****************************************************************************/
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: i_get_time()                                                        */
+/*                                                                           */
+/* Description: Get the time on the monotonic clock                          */
+/*                                                                           */
+/* Uses: void                                                                */
+/*                                                                           */
+/* Returns: The time in ns                                                   */
+/*                                                                           */
+/*****************************************************************************/
+
+static long long i_get_time(void)
+{
+
+  struct timespec now;          /* The time now */
+
+
+  (void) clock_gettime(CLOCK_MONOTONIC, &now);
+
+  return ( (long long) now.tv_sec * SERS_NSEC_IN_SEC) + now.tv_nsec;
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: i_sleep_until()                                                     */
+/*                                                                           */
+/* Description: Wait until a time on the monotonic clock                     */
+/*                                                                           */
+/* Uses: time - The time in ns                                               */
+/*                                                                           */
+/* Returns: void                                                             */
+/*                                                                           */
+/*****************************************************************************/
+
+static void i_sleep_until(long long time)
+{
+
+  struct timespec until;        /* The time to wait until */
+
+
+  until.tv_sec = (time_t) (time / SERS_NSEC_IN_SEC);
+
+  until.tv_nsec = (long) (time % SERS_NSEC_IN_SEC);
+
+  (void) clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &until, NULL);
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: i_random()                                                          */
+/*                                                                           */
+/* Description: Get the next number from the fault generator, a xorshift.    */
+/*              rand() isn't used, as serbert's random mode relies on its    */
+/*              sequence and it isn't safe in this thread.                   */
+/*                                                                           */
+/* Uses: void                                                                */
+/*                                                                           */
+/* Returns: The number                                                       */
+/*                                                                           */
+/*****************************************************************************/
+
+static uint32_t i_random(void)
+{
+
+  i_seed ^= i_seed << 13;
+
+  i_seed ^= i_seed >> 17;
+
+  i_seed ^= i_seed << 5;
+
+  return i_seed;
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: i_pick_fault()                                                      */
+/*                                                                           */
+/* Description: Pick the fault for the next byte. A burst starts at the      */
+/*              fault rate, with one of the faults allowed, and carries on   */
+/*              for the burst length.                                        */
+/*                                                                           */
+/* Uses: void                                                                */
+/*                                                                           */
+/* Returns: The fault, or SERE_FAULTS for none                               */
+/*                                                                           */
+/*****************************************************************************/
+
+static sere_fault_t i_pick_fault(void)
+{
+
+  sere_fault_t fault = SERE_FAULTS;  /* The byte's fault */
+
+
+  if(i_burst_left > 0)
+  {
+
+    i_burst_left--;
+
+    fault = i_burst_fault;
+
+  }
+  else if( (i_setup.faults != 0)
+    && ( (double) i_random() < (i_setup.fault_rate * (double) UINT32_MAX) ) )
+  {
+
+    do
+    {
+
+      fault = (sere_fault_t) (i_random() % (uint32_t) SERE_FAULTS);
+
+    } while( (i_setup.faults & (1U << fault) ) == 0);
+
+    i_burst_fault = fault;
+
+    i_burst_left = (i_setup.burst > 1) ? i_setup.burst - 1 : 0;
+
+  }
+
+  if(fault != SERE_FAULTS)
+  {
+
+    (void) atomic_fetch_add(&i_injected[fault], 1);
+
+  }
+
+  return fault;
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: i_add_byte()                                                        */
+/*                                                                           */
+/* Description: Add a received byte to those to write back, doubling 0xFF    */
+/*              as the line discipline does with PARMRK set, and as telnet   */
+/*              escapes it                                                   */
+/*                                                                           */
+/* Uses: out - The bytes to write back                                       */
+/*       len - Bytes to write back so far                                    */
+/*       byte - The byte                                                     */
+/*                                                                           */
+/* Returns: Bytes to write back now                                          */
+/*                                                                           */
+/*****************************************************************************/
+
+static size_t i_add_byte(uint8_t *out, size_t len, uint8_t byte)
+{
+
+  out[len] = byte;
+
+  len++;
+
+  if( (byte == (uint8_t) i_ESCAPE) && (i_escaping == true) )
+  {
+
+    out[len] = byte;
+
+    len++;
+
+  }
+
+  return len;
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: i_add_marker()                                                      */
+/*                                                                           */
+/* Description: Add a PARMRK marker to those to write back                   */
+/*                                                                           */
+/* Uses: out - The bytes to write back                                       */
+/*       len - Bytes to write back so far                                    */
+/*       byte - The byte marked as errored                                   */
+/*                                                                           */
+/* Returns: Bytes to write back now                                          */
+/*                                                                           */
+/*****************************************************************************/
+
+static size_t i_add_marker(uint8_t *out, size_t len, uint8_t byte)
+{
+
+  out[len] = (uint8_t) i_ESCAPE;
+
+  out[len + 1] = 0;
+
+  out[len + 2] = byte;
+
+  return len + 3;
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: i_add_fault()                                                       */
+/*                                                                           */
+/* Description: Add a byte to those to write back, as its fault leaves it    */
+/*                                                                           */
+/* Uses: out - The bytes to write back                                       */
+/*       len - Bytes to write back so far                                    */
+/*       byte - The byte                                                     */
+/*       late - Set if the byte is to be held late                           */
+/*                                                                           */
+/* Returns: Bytes to write back now                                          */
+/*                                                                           */
+/*****************************************************************************/
+
+static size_t i_add_fault(uint8_t *out, size_t len, uint8_t byte, bool *late)
+{
+
+  uint8_t flip;     /* A bit to flip */
+
+
+  flip = (uint8_t) (1U << (i_random() % (uint32_t) i_BITS) );
+
+  switch(i_pick_fault() )
+  {
+
+    case SERE_FLIP:
+
+      len = i_add_byte(out, len, byte ^ flip);
+
+      break;
+
+    case SERE_DROP:
+
+      /* Nothing echoed */
+
+      break;
+
+    case SERE_DUPLICATE:
+
+      len = i_add_byte(out, i_add_byte(out, len, byte), byte);
+
+      break;
+
+    case SERE_LATE:
+
+      len = i_add_byte(out, len, byte);
+
+      *late = true;
+
+      break;
+
+    case SERE_FRAMING:
+
+      len = i_add_marker(out, len, byte ^ flip);
+
+      break;
+
+    case SERE_PARITY:
+
+      len = i_add_marker(out, len, byte);
+
+      break;
+
+    case SERE_BREAK:
+
+      len = i_add_marker(out, len, 0);
+
+      break;
+
+    default:
+
+      len = i_add_byte(out, len, byte);
+
+      break;
+
+  }
+
+  return len;
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: i_take_marking()                                                    */
+/*                                                                           */
+/* Description: Turn off PARMRK on the pty, once serbert has set the port    */
+/*              up, so the emulator's markers reach it unchanged. The        */
+/*              emulator doubles 0xFF itself instead.                        */
+/*                                                                           */
+/* Uses: void                                                                */
+/*                                                                           */
+/* Returns: void                                                             */
+/*                                                                           */
+/*****************************************************************************/
+
+static void i_take_marking(void)
+{
+
+  struct termios options;       /* The terminal's settings */
+
+
+  if( (i_marking == false) && (tcgetattr(i_slave, &options) == 0) )
+  {
+
+    options.c_iflag &= ~PARMRK;
+
+    (void) tcsetattr(i_slave, TCSANOW, &options);
+
+    i_marking = true;
+
+  }
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: i_accept()                                                          */
+/*                                                                           */
+/* Description: Wait for serbert to connect to the stand-in server, then     */
+/*              echo on the connection as on a pty                           */
+/*                                                                           */
+/* Uses: void                                                                */
+/*                                                                           */
+/* Returns: void                                                             */
+/*                                                                           */
+/*****************************************************************************/
+
+static void i_accept(void)
+{
+
+  struct pollfd listen_poll;    /* Waiting for serbert        */
+  int nodelay = 1;              /* Send each echo at once     */
+
+
+  listen_poll.fd = i_listener;
+
+  listen_poll.events = POLLIN;
+
+  if(poll(&listen_poll, 1, SERE_POLL_MSEC) > 0)
+  {
+
+    i_master = accept(i_listener, NULL, NULL);
+
+    if(i_master != i_NO_FD)
+    {
+
+      (void) setsockopt(i_master, IPPROTO_TCP, TCP_NODELAY, &nodelay,
+        sizeof(nodelay) );
+
+      (void) fcntl(i_master, F_SETFL, fcntl(i_master, F_GETFL) | O_NONBLOCK);
+
+      sern_reset(&i_decoder);
+
+    }
+
+  }
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: i_write_back()                                                      */
+/*                                                                           */
+/* Description: Write bytes back to serbert, on the pty or the connection    */
+/*                                                                           */
+/* Uses: out - The bytes                                                     */
+/*       len - Bytes to write                                                */
+/*                                                                           */
+/* Returns: The bytes written, or -1 if full                                 */
+/*                                                                           */
+/*****************************************************************************/
+
+static ssize_t i_write_back(const uint8_t *out, size_t len)
+{
+
+  ssize_t written;      /* Bytes written */
+
+
+  if(i_listener == i_NO_FD)
+  {
+
+    written = write(i_master, out, len);
+
+  }
+  else
+  {
+
+    /* Not killed if serbert has gone */
+    written = send(i_master, out, len, MSG_NOSIGNAL);
+
+  }
+
+  return written;
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: i_echo()                                                            */
+/*                                                                           */
+/* Description: The echo thread. Bytes read from the pty are given their     */
+/*              faults and held for the delay, then written back no faster   */
+/*              than the rate allows. Bytes that don't fit in the pty are    */
+/*              dropped, as they would be by a real line that overran. The   */
+/*              stand-in server does the same on its connection, once        */
+/*              serbert has connected, taking out the telnet negotiation.    */
+/*                                                                           */
+/* Uses: arg - Not used                                                      */
+/*                                                                           */
+/* Returns: NULL                                                             */
+/*                                                                           */
+/*****************************************************************************/
+
+static void *i_echo(void *arg)
+{
+
+  struct pollfd master_poll;    /* Waiting for bytes               */
+  size_t chunk;                 /* Most bytes to take at once      */
+  ssize_t got;                  /* Bytes taken                     */
+  size_t len;                   /* Bytes to write back             */
+  size_t sent;                  /* Bytes written back              */
+  ssize_t written;              /* Bytes written each time         */
+  bool late;                    /* Bytes to be held late           */
+  long long due;                /* When they are to be written     */
+  long long free_at = 0;        /* When the rate allows more       */
+
+
+  (void) arg;
+
+  master_poll.events = POLLIN;
+
+  chunk = ( (i_setup.chunk == 0) || (i_setup.chunk > SERE_BUF_LEN) )
+    ? SERE_BUF_LEN : i_setup.chunk;
+
+  while(atomic_load(&i_stopping) == false)
+  {
+
+    master_poll.fd = i_master;
+
+    if(i_master == i_NO_FD)
+    {
+
+      i_accept();
+
+    }
+    else if(poll(&master_poll, 1, SERE_POLL_MSEC) > 0)
+    {
+
+      got = read(i_master, i_buf, chunk);
+
+      if( (got == 0) && (i_listener != i_NO_FD) )
+      {
+
+        /* Serbert has gone, so wait for it to connect again */
+        (void) close(i_master);
+
+        i_master = i_NO_FD;
+
+      }
+      else if( (got > 0) && (i_rfc2217 == true) )
+      {
+
+        got = (ssize_t) sern_decode(&i_decoder, i_master, SERN_SERVER,
+          i_buf, (size_t) got, i_buf);
+
+      }
+
+      if(got > 0)
+      {
+
+        i_take_marking();
+
+        len = sere_inject(i_buf, (size_t) got, i_out, &late);
+
+        /* A late byte holds up the rest of its chunk */
+        due = i_get_time() + ( (long long) i_setup.delay_us
+          * SERS_NSEC_IN_USEC);
+
+        due += late ? (long long) i_setup.late_us * SERS_NSEC_IN_USEC : 0;
+
+        due = (due < free_at) ? free_at : due;
+
+        i_sleep_until(due);
+
+        sent = 0;
+
+        while(sent < len)
+        {
+
+          written = i_write_back(i_out + sent, len - sent);
+
+          /* Drop the rest if the pty is full */
+          sent = (written > 0) ? sent + (size_t) written : len;
+
+        }
+
+        if(i_setup.rate > 0)
+        {
+
+          free_at = due + ( ( (long long) got * SERS_NSEC_IN_SEC)
+            / (long long) i_setup.rate);
+
+        }
+
+      }
+
+    }
+
+  }
+
+  return NULL;
+
+}
+
+
+/*****************************************************************************/
+/*      EXTERNAL FUNCTION DEFINITIONS                                        */
+/*****************************************************************************/
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: sere_start()                                                        */
+/*                                                                           */
+/* Description: Open a pseudo terminal and start a thread echoing back       */
+/*              whatever is written to it                                    */
+/*                                                                           */
+/* Internal functions used: i_echo()                                         */
+/*                                                                           */
+/* Internal variables used: i_master, i_slave, i_stopping, i_running,        */
+/*                          i_thread, i_marking                              */
+/*                                                                           */
+/* Parameters:                                                               */
+/*   Name            Type           Comments                                 */
+/*   ------------    ------------   -----------------------------------      */
+/*   setup           sere_setup_t   How bytes are echoed                     */
+/*   port            char *         Where to put the terminal's name         */
+/*   port_len        size_t         Room there                               */
+/*                                                                           */
+/* Returns: SERE_OK if the emulator is running, else SERE_FAILURE            */
+/*                                                                           */
+/*****************************************************************************/
+
+extern sere_status_t sere_start(const sere_setup_t *setup, char *port,
+  size_t port_len)
+{
+
+  sere_status_t status = SERE_FAILURE;  /* Did the emulator start? */
+  struct termios options;               /* The terminal's settings */
+  char name[PATH_MAX];                  /* The terminal's name     */
+
+
+  if( (i_running == false)
+    && (openpty(&i_master, &i_slave, name, NULL, NULL) == 0) )
+  {
+
+    sere_set_up(setup);
+
+    /* No echo or line editing until serbert configures the port, and */
+    /* writes back to the pty mustn't block the thread                */
+    if( (tcgetattr(i_slave, &options) == 0) && (strlen(name) < port_len) )
+    {
+
+      cfmakeraw(&options);
+
+      (void) tcsetattr(i_slave, TCSANOW, &options);
+
+      (void) fcntl(i_master, F_SETFL, fcntl(i_master, F_GETFL) | O_NONBLOCK);
+
+      (void) snprintf(port, port_len, "%s", name);
+
+      atomic_store(&i_stopping, false);
+
+      i_marking = false;
+
+      if(pthread_create(&i_thread, NULL, i_echo, NULL) == 0)
+      {
+
+        i_running = true;
+
+        status = SERE_OK;
+
+      }
+
+    }
+
+    if(status != SERE_OK)
+    {
+
+      sere_stop();
+
+    }
+
+  }
+
+  return status;
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: sere_serve()                                                        */
+/*                                                                           */
+/* Description: Start a stand-in device server at localhost, echoing back    */
+/*              whatever serbert sends, raw or with RFC 2217 negotiation.    */
+/*              Faults needing PARMRK markers can't be sent over TCP, so     */
+/*              are left out.                                                */
+/*                                                                           */
+/* Internal functions used: i_echo()                                         */
+/*                                                                           */
+/* Internal variables used: i_listener, i_stopping, i_running, i_thread,     */
+/*                          i_marking, i_setup, i_rfc2217, i_escaping        */
+/*                                                                           */
+/* Parameters:                                                               */
+/*   Name            Type           Comments                                 */
+/*   ------------    ------------   -----------------------------------      */
+/*   setup           sere_setup_t   How bytes are echoed                     */
+/*   rfc2217         bool           Negotiate with RFC 2217, not raw         */
+/*   port            char *         Where to put the server's port name      */
+/*   port_len        size_t         Room there                               */
+/*                                                                           */
+/* Returns: SERE_OK if the server is running, else SERE_FAILURE              */
+/*                                                                           */
+/*****************************************************************************/
+
+extern sere_status_t sere_serve(const sere_setup_t *setup, bool rfc2217,
+  char *port, size_t port_len)
+{
+
+  sere_status_t status = SERE_FAILURE;  /* Did the server start?   */
+  struct sockaddr_in address;           /* Where it listens        */
+  socklen_t address_len;                /* ... and its length      */
+  int written;                          /* Characters in port name */
+
+
+  if(i_running == false)
+  {
+
+    i_listener = socket(AF_INET, SOCK_STREAM, 0);
+
+  }
+
+  if( (i_running == false) && (i_listener != i_NO_FD) )
+  {
+
+    /* Any free port at localhost */
+    (void) memset(&address, 0, sizeof(address) );
+
+    address.sin_family = AF_INET;
+
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+    address.sin_port = 0;
+
+    address_len = sizeof(address);
+
+    if( (bind(i_listener, (struct sockaddr *) &address, address_len) == 0)
+      && (listen(i_listener, 1) == 0)
+      && (getsockname(i_listener, (struct sockaddr *) &address,
+      &address_len) == 0) )
+    {
+
+      written = snprintf(port, port_len, "%s127.0.0.1:%u",
+        (rfc2217 == true) ? SERT_RFC2217_PREFIX : SERT_TCP_PREFIX,
+        (unsigned int) ntohs(address.sin_port) );
+
+      sere_set_up(setup);
+
+      i_setup.faults &= ~(unsigned int) i_MARKER_FAULTS;
+
+      i_rfc2217 = rfc2217;
+
+      /* Telnet escapes 0xFF, but a raw connection carries it as it is */
+      i_escaping = rfc2217;
+
+      i_marking = true;
+
+      atomic_store(&i_stopping, false);
+
+      if( (written > 0) && ( (size_t) written < port_len)
+        && (pthread_create(&i_thread, NULL, i_echo, NULL) == 0) )
+      {
+
+        i_running = true;
+
+        status = SERE_OK;
+
+      }
+
+    }
+
+    if(status != SERE_OK)
+    {
+
+      sere_stop();
+
+    }
+
+  }
+
+  return status;
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: sere_stop()                                                         */
+/*                                                                           */
+/* Description: Stop the emulator and close its pseudo terminal, or the      */
+/*              stand-in server's sockets                                    */
+/*                                                                           */
+/* Internal functions used:                                                  */
+/*                                                                           */
+/* Internal variables used: i_master, i_slave, i_listener, i_stopping,       */
+/*                          i_running, i_thread, i_rfc2217, i_escaping       */
+/*                                                                           */
+/* Parameters:                                                               */
+/*   Name            Type           Comments                                 */
+/*   ------------    ------------   -----------------------------------      */
+/*                                                                           */
+/* Returns: void                                                             */
+/*                                                                           */
+/*****************************************************************************/
+
+extern void sere_stop(void)
+{
+
+  if(i_running == true)
+  {
+
+    atomic_store(&i_stopping, true);
+
+    (void) pthread_join(i_thread, NULL);
+
+    i_running = false;
+
+  }
+
+  if(i_master != i_NO_FD)
+  {
+
+    (void) close(i_master);
+
+    i_master = i_NO_FD;
+
+  }
+
+  if(i_slave != i_NO_FD)
+  {
+
+    (void) close(i_slave);
+
+    i_slave = i_NO_FD;
+
+  }
+
+  if(i_listener != i_NO_FD)
+  {
+
+    (void) close(i_listener);
+
+    i_listener = i_NO_FD;
+
+  }
+
+  i_rfc2217 = false;
+
+  i_escaping = true;
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: sere_get_injected()                                                 */
+/*                                                                           */
+/* Description: Get the number of bytes given each fault so far              */
+/*                                                                           */
+/* Internal functions used:                                                  */
+/*                                                                           */
+/* Internal variables used: i_injected                                       */
+/*                                                                           */
+/* Parameters:                                                               */
+/*   Name            Type           Comments                                 */
+/*   ------------    ------------   -----------------------------------      */
+/*   injected        unsigned long long[]  Bytes given each fault            */
+/*                                                                           */
+/* Returns: void                                                             */
+/*                                                                           */
+/*****************************************************************************/
+
+extern void sere_get_injected(unsigned long long injected[SERE_FAULTS])
+{
+
+  int fault;     /* Fault being got */
+
+
+  for(fault = 0; fault < SERE_FAULTS; fault++)
+  {
+
+    injected[fault] = atomic_load(&i_injected[fault]);
+
+  }
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: sere_set_up()                                                       */
+/*                                                                           */
+/* Description: Set how bytes are echoed, and restart the fault generator    */
+/*              from its seed, with no faults injected yet                   */
+/*                                                                           */
+/* Internal functions used:                                                  */
+/*                                                                           */
+/* Internal variables used: i_setup, i_seed, i_burst_left, i_injected        */
+/*                                                                           */
+/* Parameters:                                                               */
+/*   Name            Type           Comments                                 */
+/*   ------------    ------------   -----------------------------------      */
+/*   setup           sere_setup_t   How bytes are echoed                     */
+/*                                                                           */
+/* Returns: void                                                             */
+/*                                                                           */
+/*****************************************************************************/
+
+extern void sere_set_up(const sere_setup_t *setup)
+{
+
+  int fault;                            /* Fault being cleared     */
+
+
+  i_setup = *setup;
+
+  /* A xorshift never leaves 0 */
+  i_seed = (setup->seed != 0) ? (uint32_t) setup->seed : (uint32_t) i_SEED;
+
+  i_burst_left = 0;
+
+  for(fault = 0; fault < SERE_FAULTS; fault++)
+  {
+
+    atomic_store(&i_injected[fault], 0);
+
+  }
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: sere_get_setup()                                                    */
+/*                                                                           */
+/* Description: Get how bytes are echoed, as last set                        */
+/*                                                                           */
+/* Internal functions used:                                                  */
+/*                                                                           */
+/* Internal variables used: i_setup                                          */
+/*                                                                           */
+/* Parameters:                                                               */
+/*   Name            Type           Comments                                 */
+/*   ------------    ------------   -----------------------------------      */
+/*                                                                           */
+/* Returns: The setup                                                        */
+/*                                                                           */
+/*****************************************************************************/
+
+extern const sere_setup_t *sere_get_setup(void)
+{
+
+  return &i_setup;
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: sere_inject()                                                       */
+/*                                                                           */
+/* Description: Give a block of bytes their faults, and encode them as the   */
+/*              line discipline would with PARMRK set                        */
+/*                                                                           */
+/* Internal functions used: i_add_fault()                                    */
+/*                                                                           */
+/* Internal variables used:                                                  */
+/*                                                                           */
+/* Parameters:                                                               */
+/*   Name            Type           Comments                                 */
+/*   ------------    ------------   -----------------------------------      */
+/*   in              const uint8_t *  The bytes sent                         */
+/*   len             size_t         Bytes sent                               */
+/*   out             uint8_t *      Where to put the bytes to echo           */
+/*   late            bool *         Set if they are to be held late          */
+/*                                                                           */
+/* Returns: Bytes to echo                                                    */
+/*                                                                           */
+/*****************************************************************************/
+
+extern size_t sere_inject(const uint8_t *in, size_t len, uint8_t *out,
+  bool *late)
+{
+
+  size_t out_len = 0;           /* Bytes to echo   */
+  size_t byte_no;               /* Byte being sent */
+
+
+  *late = false;
+
+  for(byte_no = 0; byte_no < len; byte_no++)
+  {
+
+    out_len = i_add_fault(out, out_len, in[byte_no], late);
+
+  }
+
+  return out_len;
+
+}
@@ -0,0 +1,287 @@
+/*****************************************************************************/
+/*                                                                           */
+/* Module: sere.h                                                            */
+/*                                                                           */
+/* Description: Header file for sere.c                                       */
+/*                                                                           */
+/* Copyright (C) 2026 The Serbert contributors                               */
+/*                                                                           */
+/* This file is part of Serbert.                                             */
+/*                                                                           */
+/* Serbert is free software; you can redistribute it and/or modify           */
+/* it under the terms of the GNU General Public License as published by      */
+/* the Free Software Foundation; either version 2 of the License, or         */
+/* any later version.                                                        */
+/*                                                                           */
+/* This program is distributed in the hope that it will be useful,           */
+/* but WITHOUT ANY WARRANTY; without even the implied warranty of            */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             */
+/* GNU General Public License for more details.                              */
+/*                                                                           */
+/* You should have received a copy of the GNU General Public License         */
+/* along with this program; if not, write to the Free Software               */
+/* Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA */
+/*                                                                           */
+/*****************************************************************************/
+
+#ifndef SERE_H
+
+#define SERE_H
+
+/*****************************************************************************/
+/*      INCLUDED FILES (dependencies)                                        */
+/*****************************************************************************/
+
+#include <stddef.h>      /* Standard definitions - size_t                  */
+#include <stdint.h>      /* Fixed size integers - uint8_t                  */
+#include <stdbool.h>     /* Boolean types                                  */
+
+
+/*****************************************************************************/
+/*      MACRO DEFINITIONS                                                    */
+/*****************************************************************************/
+
+/*****************************************************************************/
+/*  Name:                                                                    */
+/*  Description:                                                             */
+/*  Parameters:                                                              */
+/*****************************************************************************/
+
+
+/*****************************************************************************/
+/*      TYPE DEFINITIONS                                                     */
+/*****************************************************************************/
+
+/* Enums & constants */
+
+enum { SERE_BUF_LEN = 4096 };        /* Most bytes echoed at a time          */
+
+enum { SERE_POLL_MSEC = 100 };       /* Longest wait before checking to stop */
+
+enum { SERE_MARK_LEN = 4 };          /* Most bytes one byte can be echoed as */
+
+enum { SERE_MAX_BURST = 1000 };      /* Most bytes in a burst of faults      */
+
+#define SERE_PORT "emulator"
+                                     /* Port name that tests the emulator    */
+
+#define SERE_TCP_PORT "tcp:emulator"
+                                     /* ... as a raw TCP device server       */
+
+#define SERE_RFC2217_PORT "rfc2217:emulator"
+                                     /* ... as an RFC 2217 device server     */
+
+/* Status of starting the emulator */
+typedef enum sere_status_t
+{
+  SERE_OK,                           /* The emulator is running              */
+  SERE_FAILURE                       /* It could not be started              */
+} sere_status_t;
+
+/* Faults the emulator can inject. Markers are written as the line */
+/* discipline would with PARMRK set, 0xFF 0x00 then the byte      */
+typedef enum sere_fault_t
+{
+  SERE_FLIP,                         /* One bit of the byte flipped          */
+  SERE_DROP,                         /* The byte not echoed                  */
+  SERE_DUPLICATE,                    /* The byte echoed twice                */
+  SERE_LATE,                         /* The byte held for late_us more       */
+  SERE_FRAMING,                      /* Framing marker, with a flipped bit   */
+  SERE_PARITY,                       /* Parity marker, with the byte         */
+  SERE_BREAK,                        /* Break marker, 0xFF 0x00 0x00         */
+  SERE_FAULTS                        /* Number of faults                     */
+} sere_fault_t;
+
+/* How the emulator treats the bytes it echoes */
+typedef struct sere_setup_t
+{
+  unsigned long delay_us;            /* Time each byte is held, microsecs    */
+  unsigned long rate;                /* Most bytes a second, 0 for no limit  */
+  unsigned int chunk;                /* Most bytes echoed at once, 0 for any */
+  double fault_rate;                 /* Chance of a burst starting, per byte */
+  unsigned int burst;                /* Bytes in each burst of faults        */
+  unsigned int faults;               /* Faults allowed, 1 bit per fault      */
+  unsigned long late_us;             /* Extra time late bytes are held       */
+  unsigned int seed;                 /* Fault generator seed, 0 for default  */
+} sere_setup_t;
+
+
+/*****************************************************************************/
+/*      GLOBAL VARIABLES                                                     */
+/*****************************************************************************/
+
+
+/*****************************************************************************/
+/*      FUNCTION PROTOTYPES                                                  */
+/*****************************************************************************/
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: sere_start()                                                        */
+/*                                                                           */
+/* Description: Open a pseudo terminal and start a thread echoing back       */
+/*              whatever is written to it, as a loopback plug would          */
+/*                                                                           */
+/* Parameters:                                                               */
+/*   Name            Type           Comments                                 */
+/*   ------------    ------------  -----------------------------------       */
+/*   setup           sere_setup_t  How bytes are echoed                      */
+/*   port            char *        Where to put the terminal's name          */
+/*   port_len        size_t        Room there                                */
+/*                                                                           */
+/* Returns: SERE_OK if the emulator is running, else SERE_FAILURE            */
+/*                                                                           */
+/* Pre-conditions:                                                           */
+/*                                                                           */
+/* Post-conditions: The terminal named can be opened and tested as a port    */
+/*                                                                           */
+/*****************************************************************************/
+
+extern sere_status_t sere_start(const sere_setup_t *setup, char *port,
+  size_t port_len);
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: sere_serve()                                                        */
+/*                                                                           */
+/* Description: Start a stand-in device server at localhost, echoing back    */
+/*              whatever serbert sends over TCP, raw or with RFC 2217        */
+/*              negotiation. Faults needing PARMRK markers are left out.     */
+/*                                                                           */
+/* Parameters:                                                               */
+/*   Name            Type           Comments                                 */
+/*   ------------    ------------  -----------------------------------       */
+/*   setup           sere_setup_t  How bytes are echoed                      */
+/*   rfc2217         bool          Negotiate with RFC 2217, not raw          */
+/*   port            char *        Where to put the server's port name       */
+/*   port_len        size_t        Room there                                */
+/*                                                                           */
+/* Returns: SERE_OK if the server is running, else SERE_FAILURE              */
+/*                                                                           */
+/* Pre-conditions:                                                           */
+/*                                                                           */
+/* Post-conditions: The port named can be opened and tested as a port        */
+/*                                                                           */
+/*****************************************************************************/
+
+extern sere_status_t sere_serve(const sere_setup_t *setup, bool rfc2217,
+  char *port, size_t port_len);
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: sere_stop()                                                         */
+/*                                                                           */
+/* Description: Stop the emulator and close its pseudo terminal              */
+/*                                                                           */
+/* Parameters:                                                               */
+/*   Name            Type           Comments                                 */
+/*   ------------    ------------  -----------------------------------       */
+/*                                                                           */
+/* Returns: void                                                             */
+/*                                                                           */
+/* Pre-conditions:                                                           */
+/*                                                                           */
+/* Post-conditions: The emulator is stopped, if it was running               */
+/*                                                                           */
+/*****************************************************************************/
+
+extern void sere_stop(void);
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: sere_get_injected()                                                 */
+/*                                                                           */
+/* Description: Get the number of bytes given each fault so far, the ground  */
+/*              truth to check serbert's error counts against                */
+/*                                                                           */
+/* Parameters:                                                               */
+/*   Name            Type           Comments                                 */
+/*   ------------    ------------  -----------------------------------       */
+/*   injected        unsigned long long[]  Bytes given each fault            */
+/*                                                                           */
+/* Returns: void                                                             */
+/*                                                                           */
+/* Pre-conditions: injected holds SERE_FAULTS counts                         */
+/*                                                                           */
+/* Post-conditions:                                                          */
+/*                                                                           */
+/*****************************************************************************/
+
+extern void sere_get_injected(unsigned long long injected[SERE_FAULTS]);
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: sere_set_up()                                                       */
+/*                                                                           */
+/* Description: Set how bytes are echoed, and restart the fault generator    */
+/*              from its seed. sere_start() does this itself.                */
+/*                                                                           */
+/* Parameters:                                                               */
+/*   Name            Type           Comments                                 */
+/*   ------------    ------------  -----------------------------------       */
+/*   setup           sere_setup_t  How bytes are echoed                      */
+/*                                                                           */
+/* Returns: void                                                             */
+/*                                                                           */
+/* Pre-conditions: The emulator isn't running                                */
+/*                                                                           */
+/* Post-conditions: No faults have been injected                             */
+/*                                                                           */
+/*****************************************************************************/
+
+extern void sere_set_up(const sere_setup_t *setup);
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: sere_get_setup()                                                    */
+/*                                                                           */
+/* Description: Get how bytes are echoed, as last set                        */
+/*                                                                           */
+/* Parameters:                                                               */
+/*   Name            Type           Comments                                 */
+/*   ------------    ------------  -----------------------------------       */
+/*                                                                           */
+/* Returns: The setup                                                        */
+/*                                                                           */
+/* Pre-conditions:                                                           */
+/*                                                                           */
+/* Post-conditions:                                                          */
+/*                                                                           */
+/*****************************************************************************/
+
+extern const sere_setup_t *sere_get_setup(void);
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: sere_inject()                                                       */
+/*                                                                           */
+/* Description: Give a block of bytes their faults, as the emulator would    */
+/*              echo them, for a line simulated without a pty                */
+/*                                                                           */
+/* Parameters:                                                               */
+/*   Name            Type           Comments                                 */
+/*   ------------    ------------  -----------------------------------       */
+/*   in              const uint8_t *  The bytes sent                         */
+/*   len             size_t        Bytes sent                                */
+/*   out             uint8_t *     Where to put the bytes to echo            */
+/*   late            bool *        Set if they are to be held late           */
+/*                                                                           */
+/* Returns: Bytes to echo                                                    */
+/*                                                                           */
+/* Pre-conditions: out holds len * SERE_MARK_LEN bytes                       */
+/*                                                                           */
+/* Post-conditions:                                                          */
+/*                                                                           */
+/*****************************************************************************/
+
+extern size_t sere_inject(const uint8_t *in, size_t len, uint8_t *out,
+  bool *late);
+
+
+#endif /* SERE_H */
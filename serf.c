@@ -0,0 +1,428 @@
+/*****************************************************************************/
+/*                                                                           */
+/* Module: serf.c                                                            */
+/*                                                                           */
+/* Description: Flight recorder for serial Bit Error Rate Tests              */
+/*                                                                           */
+/* Copyright (C) 2026 The Serbert contributors                               */
+/*                                                                           */
+/* This file is part of Serbert.                                             */
+/*                                                                           */
+/* Serbert is free software; you can redistribute it and/or modify           */
+/* it under the terms of the GNU General Public License as published by      */
+/* the Free Software Foundation; either version 2 of the License, or         */
+/* any later version.                                                        */
+/*                                                                           */
+/* This program is distributed in the hope that it will be useful,           */
+/* but WITHOUT ANY WARRANTY; without even the implied warranty of            */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             */
+/* GNU General Public License for more details.                              */
+/*                                                                           */
+/* You should have received a copy of the GNU General Public License         */
+/* along with this program; if not, write to the Free Software               */
+/* Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA */
+/*                                                                           */
+/*****************************************************************************/
+
+
+/*****************************************************************************/
+/*      INCLUDED FILES (dependencies)                                        */
+/*****************************************************************************/
+
+#include <stdio.h>       /* Standard I/O definitions - NULL                */
+#include <string.h>      /* Standard string lib - strncpy()                */
+#include <stdint.h>      /* Fixed size integers - uint64_t                 */
+#include <stdbool.h>     /* Boolean types                                  */
+#include <stdatomic.h>   /* Atomic types - atomic_ullong                   */
+#include <time.h>        /* Time defs - clock_gettime()                    */
+#include <unistd.h>      /* UNIX standard - getpid(), ftruncate(), close() */
+#include <fcntl.h>       /* File control - open()                          */
+#include <sys/mman.h>    /* Memory mapping - mmap(), msync()               */
+#include "sers.h"        /* Serial statistics library - SERS_NSEC_IN_SEC   */
+#include "serf.h"        /* Header file for this library                   */
+
+
+/*****************************************************************************/
+/*      INTERNAL MACRO DEFINITIONS                                           */
+/*****************************************************************************/
+
+/*****************************************************************************/
+/*  Name:                                                                    */
+/*  Description:                                                             */
+/*  Parameters:                                                              */
+/*  Client functions:                                                        */
+/*****************************************************************************/
+
+
+/*****************************************************************************/
+/*      INTERNAL TYPE DEFINITIONS                                            */
+/*****************************************************************************/
+
+enum { i_OPEN_FAIL = -1 };           /* open() failure state                 */
+
+enum { i_FILE_MODE = 0644 };         /* Anyone may read a flight record      */
+
+
+/*****************************************************************************/
+/*      INTERNAL VARIABLE DEFINITIONS                                        */
+/*****************************************************************************/
+
+static serf_file_t *i_file = NULL;        /* The flight record, mapped       */
+
+static unsigned long long i_bytes;        /* Bytes recorded                  */
+
+static unsigned long long i_frozen;       /* Freezes started                 */
+
+static serf_freeze_t *i_freeze;           /* The latest freeze               */
+
+static unsigned int i_freeze_count;       /* Bytes it holds                  */
+
+static unsigned int i_pending;            /* Bytes still to add to it        */
+
+
+/*****************************************************************************/
+/*      INTERNAL FUNCTION DEFINITIONS                                        */
+/*****************************************************************************/
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: i_start_freeze()                                                    */
+/*                                                                           */
+/* Description: Start a freeze with the bytes before an errored byte, and    */
+/*              the byte itself                                              */
+/*                                                                           */
+/* Uses: byte - The errored byte, already in the ring                        */
+/*                                                                           */
+/* Returns: void                                                             */
+/*                                                                           */
+/*****************************************************************************/
+
+static void i_start_freeze(const serf_byte_t *byte)
+{
+
+  unsigned long long before;    /* Bytes before the errored one */
+  unsigned long long first;     /* Number of the first byte     */
+  unsigned int byte_no;         /* Byte being copied            */
+
+
+  i_freeze = &i_file->freeze[i_frozen % SERF_FREEZES];
+
+  /* Nothing in the freeze can be trusted until it's filled again */
+  atomic_store_explicit(&i_freeze->count, 0, memory_order_release);
+
+  before = (i_bytes < SERF_CONTEXT) ? i_bytes : SERF_CONTEXT;
+
+  first = i_bytes - before;
+
+  atomic_store_explicit(&i_freeze->first, first, memory_order_relaxed);
+
+  atomic_store_explicit(&i_freeze->trigger, i_bytes, memory_order_relaxed);
+
+  for(byte_no = 0; byte_no < before; byte_no++)
+  {
+
+    i_freeze->bytes[byte_no] =
+      i_file->ring[(first + byte_no) & (SERF_RING_LEN - 1)];
+
+  }
+
+  i_freeze->bytes[before] = *byte;
+
+  i_freeze_count = (unsigned int) before + 1;
+
+  atomic_store_explicit(&i_freeze->count, i_freeze_count,
+    memory_order_release);
+
+  i_pending = SERF_CONTEXT;
+
+  i_frozen++;
+
+  atomic_store_explicit(&i_file->frozen, i_frozen, memory_order_release);
+
+}
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: i_add_to_freeze()                                                   */
+/*                                                                           */
+/* Description: Add a byte after an error to the latest freeze. An error     */
+/*              extends the freeze, until it is full.                        */
+/*                                                                           */
+/* Uses: byte - The byte                                                     */
+/*                                                                           */
+/* Returns: void                                                             */
+/*                                                                           */
+/*****************************************************************************/
+
+static void i_add_to_freeze(const serf_byte_t *byte)
+{
+
+  i_freeze->bytes[i_freeze_count] = *byte;
+
+  i_freeze_count++;
+
+  atomic_store_explicit(&i_freeze->count, i_freeze_count,
+    memory_order_release);
+
+  i_pending--;
+
+  if( (byte->flags & SERF_ERROR) != 0)
+  {
+
+    i_pending = SERF_CONTEXT;
+
+  }
+
+  /* A full freeze is done; the next error starts another */
+  if(i_freeze_count == SERF_FREEZE_LEN)
+  {
+
+    i_pending = 0;
+
+  }
+
+}
+
+
+/*****************************************************************************/
+/*      EXTERNAL VARIABLE DEFINITIONS                                        */
+/*****************************************************************************/
+
+
+/*****************************************************************************/
+/*      EXTERNAL FUNCTION DEFINITIONS                                        */
+/*****************************************************************************/
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: serf_open()                                                         */
+/*                                                                           */
+/* Description: Create the flight record file and map it                     */
+/*                                                                           */
+/* Internal functions used:                                                  */
+/*                                                                           */
+/* Internal variables used: i_file, i_bytes, i_frozen, i_pending             */
+/*                                                                           */
+/* Parameters:                                                               */
+/*   Name            Type           Comments                                 */
+/*   ------------    ------------   -----------------------------------      */
+/*   path            const char *   The file to record in                    */
+/*   port            const char *   Serial port being tested                 */
+/*   baud            unsigned long  Baud rate being tested                   */
+/*                                                                           */
+/* Returns: SERF_OK if the file is ready, else SERF_FAILURE                  */
+/*                                                                           */
+/*****************************************************************************/
+
+extern serf_status_t serf_open(const char *path, const char *port,
+  unsigned long baud)
+{
+
+  serf_status_t status = SERF_FAILURE;  /* Is the file ready?     */
+  int fd;                               /* The file's descriptor  */
+  void *mapped;                         /* Where it's mapped      */
+  struct timespec time_now;             /* The current time       */
+
+
+  if(i_file == NULL)
+  {
+
+    fd = open(path, O_RDWR | O_CREAT | O_TRUNC, i_FILE_MODE);
+
+    if(fd != i_OPEN_FAIL)
+    {
+
+      /* Truncated then extended, so the file starts as all zeros */
+      if(ftruncate(fd, (off_t) sizeof(serf_file_t) ) == 0)
+      {
+
+        mapped = mmap(NULL, sizeof(serf_file_t), PROT_READ | PROT_WRITE,
+          MAP_SHARED, fd, 0);
+
+        if(mapped != MAP_FAILED)
+        {
+
+          i_file = (serf_file_t *) mapped;
+
+          status = SERF_OK;
+
+        }
+
+      }
+
+      (void) close(fd);
+
+    }
+
+  }
+
+  if(status == SERF_OK)
+  {
+
+    i_bytes = 0;
+
+    i_frozen = 0;
+
+    i_pending = 0;
+
+    i_file->version = SERF_VERSION;
+
+    i_file->size = (uint32_t) sizeof(serf_file_t);
+
+    i_file->ring_len = SERF_RING_LEN;
+
+    i_file->freeze_len = SERF_FREEZE_LEN;
+
+    i_file->freezes = SERF_FREEZES;
+
+    i_file->pid = (int32_t) getpid();
+
+    i_file->baud = (uint32_t) baud;
+
+    (void) clock_gettime(CLOCK_REALTIME, &time_now);
+
+    i_file->start_time = ( (int64_t) time_now.tv_sec * SERS_NSEC_IN_SEC) +
+      (int64_t) time_now.tv_nsec;
+
+    (void) strncpy(i_file->port, port, SERF_PORT_LEN - 1);
+
+    atomic_store_explicit(&i_file->magic, (unsigned int) SERF_MAGIC,
+      memory_order_release);
+
+  }
+
+  return status;
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: serf_add()                                                          */
+/*                                                                           */
+/* Description: Record a tested byte, and freeze the bytes around it if it   */
+/*              was in error                                                 */
+/*                                                                           */
+/* Internal functions used: i_start_freeze(), i_add_to_freeze()              */
+/*                                                                           */
+/* Internal variables used: i_file, i_bytes, i_pending                       */
+/*                                                                           */
+/* Parameters:                                                               */
+/*   Name            Type           Comments                                 */
+/*   ------------    ------------   -----------------------------------      */
+/*   tx              unsigned char  The byte sent                            */
+/*   rx              int            The byte received, or SERF_NO_RX         */
+/*   flags           unsigned int   SERF_ERROR etc.                          */
+/*   return_time     long long      The byte's return time in ns, or -1      */
+/*                                                                           */
+/* Returns: void                                                             */
+/*                                                                           */
+/*****************************************************************************/
+
+extern void serf_add(unsigned char tx, int rx, unsigned int flags,
+  long long return_time)
+{
+
+  serf_byte_t byte;             /* The byte's record */
+  struct timespec time_now;     /* The current time  */
+
+
+  if(i_file != NULL)
+  {
+
+    (void) clock_gettime(CLOCK_REALTIME, &time_now);
+
+    byte.time = ( (int64_t) time_now.tv_sec * SERS_NSEC_IN_SEC) +
+      (int64_t) time_now.tv_nsec;
+
+    byte.return_time = 0;
+
+    if(return_time > (long long) UINT32_MAX)
+    {
+
+      byte.return_time = UINT32_MAX;
+
+    }
+    else if(return_time > 0)
+    {
+
+      byte.return_time = (uint32_t) return_time;
+
+    }
+
+    byte.tx = (uint8_t) tx;
+
+    byte.rx = 0;
+
+    if(rx != SERF_NO_RX)
+    {
+
+      byte.rx = (uint8_t) rx;
+
+      flags |= SERF_RX;
+
+    }
+
+    byte.flags = (uint8_t) flags;
+
+    byte.spare = 0;
+
+    i_file->ring[i_bytes & (SERF_RING_LEN - 1)] = byte;
+
+    if(i_pending > 0)
+    {
+
+      i_add_to_freeze(&byte);
+
+    }
+    else if( (flags & SERF_ERROR) != 0)
+    {
+
+      i_start_freeze(&byte);
+
+    }
+
+    i_bytes++;
+
+    atomic_store_explicit(&i_file->bytes, i_bytes, memory_order_release);
+
+  }
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: serf_close()                                                        */
+/*                                                                           */
+/* Description: Mark the test finished, and write the file back              */
+/*                                                                           */
+/* Internal functions used:                                                  */
+/*                                                                           */
+/* Internal variables used: i_file                                           */
+/*                                                                           */
+/* Parameters:                                                               */
+/*   Name            Type           Comments                                 */
+/*   ------------    ------------   -----------------------------------      */
+/*                                                                           */
+/* Returns: void                                                             */
+/*                                                                           */
+/*****************************************************************************/
+
+extern void serf_close(void)
+{
+
+  if(i_file != NULL)
+  {
+
+    atomic_store_explicit(&i_file->finished, 1, memory_order_release);
+
+    (void) msync(i_file, sizeof(serf_file_t), MS_SYNC);
+
+    (void) munmap(i_file, sizeof(serf_file_t) );
+
+    i_file = NULL;
+
+  }
+
+}
@@ -0,0 +1,223 @@
+/*****************************************************************************/
+/*                                                                           */
+/* Module: serf.h                                                            */
+/*                                                                           */
+/* Description: Header file for serf.c                                       */
+/*                                                                           */
+/* Copyright (C) 2026 The Serbert contributors                               */
+/*                                                                           */
+/* This file is part of Serbert.                                             */
+/*                                                                           */
+/* Serbert is free software; you can redistribute it and/or modify           */
+/* it under the terms of the GNU General Public License as published by      */
+/* the Free Software Foundation; either version 2 of the License, or         */
+/* any later version.                                                        */
+/*                                                                           */
+/* This program is distributed in the hope that it will be useful,           */
+/* but WITHOUT ANY WARRANTY; without even the implied warranty of            */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             */
+/* GNU General Public License for more details.                              */
+/*                                                                           */
+/* You should have received a copy of the GNU General Public License         */
+/* along with this program; if not, write to the Free Software               */
+/* Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA */
+/*                                                                           */
+/*****************************************************************************/
+
+#ifndef SERF_H
+
+#define SERF_H
+
+/*****************************************************************************/
+/*      INCLUDED FILES (dependencies)                                        */
+/*****************************************************************************/
+
+#include <stdint.h>      /* Fixed size integers - uint64_t                 */
+#include <stdbool.h>     /* Boolean types                                  */
+#include <stdatomic.h>   /* Atomic types - atomic_ullong                   */
+
+
+/*****************************************************************************/
+/*      MACRO DEFINITIONS                                                    */
+/*****************************************************************************/
+
+/*****************************************************************************/
+/*  Name:                                                                    */
+/*  Description:                                                             */
+/*  Parameters:                                                              */
+/*****************************************************************************/
+
+
+/*****************************************************************************/
+/*      TYPE DEFINITIONS                                                     */
+/*****************************************************************************/
+
+/* Enums & constants */
+
+enum { SERF_MAGIC = 0x53424652 };    /* Marks a flight record, "SBFR"        */
+
+enum { SERF_VERSION = 1 };           /* Layout version; bumped on any change */
+
+enum { SERF_PORT_LEN = 128 };        /* Longest port name held               */
+
+enum { SERF_RING_LEN = 65536 };      /* Bytes kept in the ring, a power of 2 */
+
+enum { SERF_CONTEXT = 32 };          /* Bytes frozen either side of an error */
+
+enum { SERF_FREEZE_LEN = 256 };      /* Most bytes held by one freeze        */
+
+enum { SERF_FREEZES = 64 };          /* Freezes kept, the oldest overwritten */
+
+enum { SERF_NO_RX = -1 };            /* No byte was received                 */
+
+/* Flags describing a byte */
+enum { SERF_RX = 0x01 };             /* A byte came back                     */
+
+enum { SERF_ERROR = 0x02 };          /* The byte was in error                */
+
+enum { SERF_TIMEOUT = 0x04 };        /* It timed out                         */
+
+enum { SERF_FRAMING = 0x08 };        /* It came back with a framing error    */
+
+/* Status of opening a flight record */
+typedef enum serf_status_t
+{
+  SERF_OK,                           /* Flight record open                   */
+  SERF_FAILURE                       /* Flight record could not be opened    */
+} serf_status_t;
+
+/* Types */
+
+/* A tested byte. The byte's number is its position in the record. */
+typedef struct serf_byte_t
+{
+  int64_t time;                      /* When the test ended, ns since epoch  */
+  uint32_t return_time;              /* Return time in ns, 0 if none, capped */
+  uint8_t tx;                        /* Byte sent                            */
+  uint8_t rx;                        /* Byte received, if SERF_RX is set     */
+  uint8_t flags;                     /* SERF_RX etc.                         */
+  uint8_t spare;                     /* Unused, zero                         */
+} serf_byte_t;
+
+/* The bytes either side of an error. More errors while the bytes after */
+/* are being collected extend the freeze, until it is full.             */
+typedef struct serf_freeze_t
+{
+  atomic_ullong first;               /* Number of the first byte held        */
+  atomic_ullong trigger;             /* Number of the errored byte           */
+  atomic_uint count;                 /* Bytes held                           */
+  uint32_t spare;                    /* Unused, zero                         */
+  serf_byte_t bytes[SERF_FREEZE_LEN];
+                                     /* The bytes held                       */
+} serf_freeze_t;
+
+/* The flight record file. Its layout is fixed for a given version. Each */
+/* byte or freeze is written before the count that covers it, so after a */
+/* crash the counts say what can be trusted.                             */
+typedef struct serf_file_t
+{
+  atomic_uint magic;                 /* SERF_MAGIC once the file is ready    */
+  uint32_t version;                  /* SERF_VERSION                         */
+  uint32_t size;                     /* Size of the file                     */
+  uint32_t ring_len;                 /* SERF_RING_LEN                        */
+  uint32_t freeze_len;               /* SERF_FREEZE_LEN                      */
+  uint32_t freezes;                  /* SERF_FREEZES                         */
+  int32_t pid;                       /* Process recording                    */
+  uint32_t baud;                     /* Baud rate being tested               */
+  int64_t start_time;                /* When it started, in ns since epoch   */
+  char port[SERF_PORT_LEN];          /* Serial port being tested             */
+  atomic_ullong bytes;               /* Bytes recorded                       */
+  atomic_ullong frozen;              /* Freezes started                      */
+  atomic_uint finished;              /* Set when the test ended cleanly      */
+  uint32_t spare;                    /* Unused, zero                         */
+  serf_byte_t ring[SERF_RING_LEN];   /* The latest bytes                     */
+  serf_freeze_t freeze[SERF_FREEZES];
+                                     /* The latest freezes                   */
+} serf_file_t;
+
+
+/*****************************************************************************/
+/*      GLOBAL VARIABLES                                                     */
+/*****************************************************************************/
+
+
+/*****************************************************************************/
+/*      FUNCTION PROTOTYPES                                                  */
+/*****************************************************************************/
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: serf_open()                                                         */
+/*                                                                           */
+/* Description: Create the flight record file and map it                     */
+/*                                                                           */
+/* Parameters:                                                               */
+/*   Name            Type           Comments                                 */
+/*   ------------    ------------  -----------------------------------       */
+/*   path            const char *  The file to record in                     */
+/*   port            const char *  Serial port being tested                  */
+/*   baud            unsigned long Baud rate being tested                    */
+/*                                                                           */
+/* Returns: SERF_OK if the file is ready, else SERF_FAILURE                  */
+/*                                                                           */
+/* Pre-conditions: Flight record not open                                    */
+/*                                                                           */
+/* Post-conditions: Bytes added are recorded                                 */
+/*                                                                           */
+/*****************************************************************************/
+
+extern serf_status_t serf_open(const char *path, const char *port,
+  unsigned long baud);
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: serf_add()                                                          */
+/*                                                                           */
+/* Description: Record a tested byte, and freeze the bytes around it if it   */
+/*              was in error. Only one thread may add bytes. Makes no        */
+/*              system calls; the kernel writes the file back, even if the   */
+/*              process crashes.                                             */
+/*                                                                           */
+/* Parameters:                                                               */
+/*   Name            Type           Comments                                 */
+/*   ------------    ------------  -----------------------------------       */
+/*   tx              unsigned char The byte sent                             */
+/*   rx              int           The byte received, or SERF_NO_RX          */
+/*   flags           unsigned int  SERF_ERROR etc. SERF_RX is set from rx.   */
+/*   return_time     long long     The byte's return time in ns, or -1       */
+/*                                                                           */
+/* Returns: void                                                             */
+/*                                                                           */
+/* Pre-conditions:                                                           */
+/*                                                                           */
+/* Post-conditions: Byte recorded, if the flight record is open              */
+/*                                                                           */
+/*****************************************************************************/
+
+extern void serf_add(unsigned char tx, int rx, unsigned int flags,
+  long long return_time);
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: serf_close()                                                        */
+/*                                                                           */
+/* Description: Mark the test finished, and write the file back              */
+/*                                                                           */
+/* Parameters:                                                               */
+/*   Name            Type           Comments                                 */
+/*   ------------    ------------  -----------------------------------       */
+/*                                                                           */
+/* Returns: void                                                             */
+/*                                                                           */
+/* Pre-conditions:                                                           */
+/*                                                                           */
+/* Post-conditions: Flight record closed                                     */
+/*                                                                           */
+/*****************************************************************************/
+
+extern void serf_close(void);
+
+
+#endif /* SERF_H */
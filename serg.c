@@ -0,0 +1,380 @@
+/*****************************************************************************/
+/*                                                                           */
+/* Module: serg.c                                                            */
+/*                                                                           */
+/* Description: Shared memory statistics for serial Bit Error Rate Tests     */
+/*                                                                           */
+/* Copyright (C) 2026 The Serbert contributors                               */
+/*                                                                           */
+/* This file is part of Serbert.                                             */
+/*                                                                           */
+/* Serbert is free software; you can redistribute it and/or modify           */
+/* it under the terms of the GNU General Public License as published by      */
+/* the Free Software Foundation; either version 2 of the License, or         */
+/* any later version.                                                        */
+/*                                                                           */
+/* This program is distributed in the hope that it will be useful,           */
+/* but WITHOUT ANY WARRANTY; without even the implied warranty of            */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             */
+/* GNU General Public License for more details.                              */
+/*                                                                           */
+/* You should have received a copy of the GNU General Public License         */
+/* along with this program; if not, write to the Free Software               */
+/* Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA */
+/*                                                                           */
+/*****************************************************************************/
+
+
+/*****************************************************************************/
+/*      INCLUDED FILES (dependencies)                                        */
+/*****************************************************************************/
+
+#include <stdio.h>       /* Standard I/O definitions - snprintf()          */
+#include <string.h>      /* Standard string lib - strncpy(), memcpy()      */
+#include <stdint.h>      /* Fixed size integers - uint64_t                 */
+#include <stdbool.h>     /* Boolean types                                  */
+#include <stdatomic.h>   /* Atomic types - atomic_uint                     */
+#include <time.h>        /* Time defs - clock_gettime()                    */
+#include <unistd.h>      /* UNIX standard - getpid(), ftruncate(), close() */
+#include <fcntl.h>       /* File control - O_CREAT                         */
+#include <sys/mman.h>    /* Memory mapping - shm_open(), mmap()            */
+#include "sers.h"        /* Serial statistics library                      */
+#include "serg.h"        /* Header file for this library                   */
+
+
+/*****************************************************************************/
+/*      INTERNAL MACRO DEFINITIONS                                           */
+/*****************************************************************************/
+
+/*****************************************************************************/
+/*  Name:                                                                    */
+/*  Description:                                                             */
+/*  Parameters:                                                              */
+/*  Client functions:                                                        */
+/*****************************************************************************/
+
+
+/*****************************************************************************/
+/*      INTERNAL TYPE DEFINITIONS                                            */
+/*****************************************************************************/
+
+enum { i_SHM_FAIL = -1 };            /* shm_open() failure state             */
+
+enum { i_SHM_MODE = 0644 };          /* Anyone may read a segment            */
+
+
+/*****************************************************************************/
+/*      INTERNAL VARIABLE DEFINITIONS                                        */
+/*****************************************************************************/
+
+static serg_segment_t *i_segment = NULL;      /* This process's segment     */
+
+static char i_name[SERG_NAME_LEN];            /* Its name                   */
+
+
+/*****************************************************************************/
+/*      INTERNAL FUNCTION DEFINITIONS                                        */
+/*****************************************************************************/
+
+/*****************************************************************************/
+/*      EXTERNAL VARIABLE DEFINITIONS                                        */
+/*****************************************************************************/
+
+
+/*****************************************************************************/
+/*      EXTERNAL FUNCTION DEFINITIONS                                        */
+/*****************************************************************************/
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: serg_open()                                                         */
+/*                                                                           */
+/* Description: Create this process's segment, and publish it                */
+/*                                                                           */
+/* Internal functions used:                                                  */
+/*                                                                           */
+/* Internal variables used: i_segment, i_name                                */
+/*                                                                           */
+/* Parameters:                                                               */
+/*   Name            Type           Comments                                 */
+/*   ------------    ------------   -----------------------------------      */
+/*   port            const char *   Serial port being tested                 */
+/*   baud            unsigned long  Baud rate being tested                   */
+/*                                                                           */
+/* Returns: SERG_OK if the segment is published, else SERG_FAILURE           */
+/*                                                                           */
+/*****************************************************************************/
+
+extern serg_status_t serg_open(const char *port, unsigned long baud)
+{
+
+  serg_status_t status = SERG_FAILURE;  /* Was the segment published? */
+  int fd;                               /* The segment's descriptor   */
+  void *mapped;                         /* Where it's mapped          */
+  struct timespec time_now;             /* The current time           */
+
+
+  if(i_segment == NULL)
+  {
+
+    (void) snprintf(i_name, sizeof(i_name), "%s%ld", SERG_PREFIX,
+      (long) getpid() );
+
+    fd = shm_open(i_name, O_RDWR | O_CREAT | O_TRUNC, i_SHM_MODE);
+
+    if(fd != i_SHM_FAIL)
+    {
+
+      if(ftruncate(fd, (off_t) sizeof(serg_segment_t) ) == 0)
+      {
+
+        mapped = mmap(NULL, sizeof(serg_segment_t), PROT_READ | PROT_WRITE,
+          MAP_SHARED, fd, 0);
+
+        if(mapped != MAP_FAILED)
+        {
+
+          i_segment = (serg_segment_t *) mapped;
+
+          status = SERG_OK;
+
+        }
+
+      }
+
+      (void) close(fd);
+
+      if(status != SERG_OK)
+      {
+
+        (void) shm_unlink(i_name);
+
+      }
+
+    }
+
+  }
+
+  if(status == SERG_OK)
+  {
+
+    /* The new segment is all zeros, so only the identity needs filling */
+    i_segment->version = SERG_VERSION;
+
+    i_segment->size = (uint32_t) sizeof(serg_segment_t);
+
+    i_segment->pid = (int32_t) getpid();
+
+    i_segment->baud = (uint32_t) baud;
+
+    (void) clock_gettime(CLOCK_REALTIME, &time_now);
+
+    i_segment->start_time = ( (int64_t) time_now.tv_sec * SERS_NSEC_IN_SEC) +
+      (int64_t) time_now.tv_nsec;
+
+    (void) strncpy(i_segment->port, port, SERG_PORT_LEN - 1);
+
+    atomic_store(&i_segment->state, (unsigned int) SERG_RUNNING);
+
+    /* Monitors ignore the segment until this is set */
+    atomic_store_explicit(&i_segment->magic, (unsigned int) SERG_MAGIC,
+      memory_order_release);
+
+  }
+
+  return status;
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: serg_add()                                                          */
+/*                                                                           */
+/* Description: Count a tested byte in the segment                           */
+/*                                                                           */
+/* Internal functions used:                                                  */
+/*                                                                           */
+/* Internal variables used: i_segment                                        */
+/*                                                                           */
+/* Parameters:                                                               */
+/*   Name            Type           Comments                                 */
+/*   ------------    ------------   -----------------------------------      */
+/*   errored         bool           Was the byte corrupt or did it time out? */
+/*   timed_out       bool           Did the byte time out?                   */
+/*   latency         long long      The byte's return time in ns, or -1      */
+/*                                                                           */
+/* Returns: void                                                             */
+/*                                                                           */
+/*****************************************************************************/
+
+extern void serg_add(bool errored, bool timed_out, long long latency)
+{
+
+  unsigned int seq;             /* The counts' sequence number */
+  serg_counts_t *counts;        /* The counts                  */
+
+
+  if(i_segment != NULL)
+  {
+
+    counts = &i_segment->counts;
+
+    /* Only this thread writes the sequence number, so it can't change */
+    seq = atomic_load_explicit(&i_segment->seq, memory_order_relaxed);
+
+    atomic_store_explicit(&i_segment->seq, seq + 1, memory_order_relaxed);
+
+    atomic_thread_fence(memory_order_release);
+
+    counts->bytes++;
+
+    if(errored == true)
+    {
+
+      counts->errors++;
+
+      if(timed_out == true)
+      {
+
+        counts->timeouts++;
+
+      }
+      else
+      {
+
+        counts->corrupts++;
+
+      }
+
+    }
+    else if(latency >= 0)
+    {
+
+      if( (counts->latency_count == 0)
+        || ( (uint64_t) latency < counts->latency_min) )
+      {
+
+        counts->latency_min = (uint64_t) latency;
+
+      }
+
+      if( (uint64_t) latency > counts->latency_max)
+      {
+
+        counts->latency_max = (uint64_t) latency;
+
+      }
+
+      counts->latency_count++;
+
+      counts->latency_sum += (uint64_t) latency;
+
+      counts->latency[sers_hist_bucket( (unsigned long long) latency)]++;
+
+    }
+
+    atomic_store_explicit(&i_segment->seq, seq + 2, memory_order_release);
+
+  }
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: serg_close()                                                        */
+/*                                                                           */
+/* Description: Mark the test finished and remove the segment                */
+/*                                                                           */
+/* Internal functions used:                                                  */
+/*                                                                           */
+/* Internal variables used: i_segment, i_name                                */
+/*                                                                           */
+/* Parameters:                                                               */
+/*   Name            Type           Comments                                 */
+/*   ------------    ------------   -----------------------------------      */
+/*                                                                           */
+/* Returns: void                                                             */
+/*                                                                           */
+/*****************************************************************************/
+
+extern void serg_close(void)
+{
+
+  if(i_segment != NULL)
+  {
+
+    atomic_store_explicit(&i_segment->state, (unsigned int) SERG_FINISHED,
+      memory_order_release);
+
+    (void) munmap(i_segment, sizeof(serg_segment_t) );
+
+    (void) shm_unlink(i_name);
+
+    i_segment = NULL;
+
+  }
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: serg_read()                                                         */
+/*                                                                           */
+/* Description: Take an untorn copy of a segment's counts                    */
+/*                                                                           */
+/* Internal functions used:                                                  */
+/*                                                                           */
+/* Internal variables used:                                                  */
+/*                                                                           */
+/* Parameters:                                                               */
+/*   Name            Type           Comments                                 */
+/*   ------------    ------------   -----------------------------------      */
+/*   segment         serg_segment_t The segment                              */
+/*   counts          serg_counts_t  Where to put the copy                    */
+/*                                                                           */
+/* Returns: The state of the test                                            */
+/*                                                                           */
+/*****************************************************************************/
+
+extern serg_state_t serg_read(serg_segment_t *segment, serg_counts_t *counts)
+{
+
+  unsigned int before;          /* Sequence number before copying   */
+  unsigned int after;           /* Sequence number after copying    */
+  serg_state_t state;           /* State of the test                */
+  unsigned long tries;          /* Times the sequence was looked at */
+
+
+  do
+  {
+
+    /* Wait for the test to finish writing. If it died part way through, */
+    /* the counts won't change again, so give up waiting after a while.  */
+    tries = 0;
+
+    do
+    {
+
+      before = atomic_load_explicit(&segment->seq, memory_order_acquire);
+
+      tries++;
+
+    } while( ( (before & 1U) != 0) && (tries < (unsigned long) SERG_TRIES) );
+
+    state = (serg_state_t) atomic_load_explicit(&segment->state,
+      memory_order_relaxed);
+
+    memcpy(counts, &segment->counts, sizeof(*counts) );
+
+    atomic_thread_fence(memory_order_acquire);
+
+    after = atomic_load_explicit(&segment->seq, memory_order_relaxed);
+
+  } while(before != after);
+
+  return state;
+
+}
@@ -0,0 +1,238 @@
+/*****************************************************************************/
+/*                                                                           */
+/* Module: serg.h                                                            */
+/*                                                                           */
+/* Description: Header file for serg.c                                       */
+/*                                                                           */
+/* Copyright (C) 2026 The Serbert contributors                               */
+/*                                                                           */
+/* This file is part of Serbert.                                             */
+/*                                                                           */
+/* Serbert is free software; you can redistribute it and/or modify           */
+/* it under the terms of the GNU General Public License as published by      */
+/* the Free Software Foundation; either version 2 of the License, or         */
+/* any later version.                                                        */
+/*                                                                           */
+/* This program is distributed in the hope that it will be useful,           */
+/* but WITHOUT ANY WARRANTY; without even the implied warranty of            */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             */
+/* GNU General Public License for more details.                              */
+/*                                                                           */
+/* You should have received a copy of the GNU General Public License         */
+/* along with this program; if not, write to the Free Software               */
+/* Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA */
+/*                                                                           */
+/*****************************************************************************/
+
+#ifndef SERG_H
+
+#define SERG_H
+
+/*****************************************************************************/
+/*      INCLUDED FILES (dependencies)                                        */
+/*****************************************************************************/
+
+#include <stdint.h>      /* Fixed size integers - uint64_t                 */
+#include <stdbool.h>     /* Boolean types                                  */
+#include <stdatomic.h>   /* Atomic types - atomic_uint                     */
+#include "sers.h"        /* Serial statistics library - SERS_HIST_BUCKETS  */
+
+
+/*****************************************************************************/
+/*      MACRO DEFINITIONS                                                    */
+/*****************************************************************************/
+
+/*****************************************************************************/
+/*  Name:                                                                    */
+/*  Description:                                                             */
+/*  Parameters:                                                              */
+/*****************************************************************************/
+
+
+/*****************************************************************************/
+/*      TYPE DEFINITIONS                                                     */
+/*****************************************************************************/
+
+/* Enums & constants */
+
+enum { SERG_MAGIC = 0x53425254 };    /* Marks a serbert segment, "SBRT"      */
+
+enum { SERG_VERSION = 1 };           /* Layout version; bumped on any change */
+
+enum { SERG_CACHE_LINE = 64 };       /* Alignment of each part of a segment  */
+
+enum { SERG_PORT_LEN = 128 };        /* Longest port name held               */
+
+enum { SERG_NAME_LEN = 64 };         /* Longest segment name                 */
+
+enum { SERG_TRIES = 1000000 };       /* Reader's wait for a write to finish  */
+
+#define SERG_PREFIX "/serbert."
+                                     /* Segment name, followed by the pid    */
+
+#define SERG_DIR "/dev/shm"
+                                     /* Where segments are seen as files     */
+
+#define SERG_FILE_PREFIX "serbert."
+                                     /* Segment file name in SERG_DIR        */
+
+/* Status of opening a segment */
+typedef enum serg_status_t
+{
+  SERG_OK,                           /* Segment open                         */
+  SERG_FAILURE                       /* Segment could not be opened          */
+} serg_status_t;
+
+/* State of the test publishing a segment */
+typedef enum serg_state_t
+{
+  SERG_RUNNING,                      /* Test running                         */
+  SERG_FINISHED                      /* Test finished                        */
+} serg_state_t;
+
+/* Types */
+
+/* The counts, as published. Times are in nanoseconds. */
+typedef struct serg_counts_t
+{
+  uint64_t bytes;                    /* Bytes tested                         */
+  uint64_t errors;                   /* Bytes in error                       */
+  uint64_t timeouts;                 /* Bytes that timed out                 */
+  uint64_t corrupts;                 /* Bytes that came back corrupt         */
+  uint64_t latency_count;            /* Good bytes with a return time        */
+  uint64_t latency_sum;              /* Total of their return times          */
+  uint64_t latency_min;              /* Shortest return time                 */
+  uint64_t latency_max;              /* Longest return time                  */
+  uint64_t latency[SERS_HIST_BUCKETS];
+                                     /* Return times, as sers_hist_t buckets */
+} serg_counts_t;
+
+/* The shared memory segment. Its layout is fixed for a given version, and */
+/* each part starts on its own cache line. The identity is written before  */
+/* the magic number is set, and not changed after. The counts are written  */
+/* by the test alone; the sequence number is odd while they're changing.   */
+typedef struct serg_segment_t
+{
+  _Alignas(SERG_CACHE_LINE) atomic_uint magic;
+                                     /* SERG_MAGIC once the segment is ready */
+  uint32_t version;                  /* SERG_VERSION                         */
+  uint32_t size;                     /* Size of the segment                  */
+  int32_t pid;                       /* Process publishing it                */
+  uint32_t baud;                     /* Baud rate being tested               */
+  int64_t start_time;                /* When it started, in ns since epoch   */
+  char port[SERG_PORT_LEN];          /* Serial port being tested             */
+
+  _Alignas(SERG_CACHE_LINE) atomic_uint seq;
+                                     /* Counts' sequence number              */
+  atomic_uint state;                 /* A serg_state_t                       */
+
+  _Alignas(SERG_CACHE_LINE) serg_counts_t counts;
+                                     /* The counts                           */
+} serg_segment_t;
+
+
+/*****************************************************************************/
+/*      GLOBAL VARIABLES                                                     */
+/*****************************************************************************/
+
+
+/*****************************************************************************/
+/*      FUNCTION PROTOTYPES                                                  */
+/*****************************************************************************/
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: serg_open()                                                         */
+/*                                                                           */
+/* Description: Create this process's segment, and publish it                */
+/*                                                                           */
+/* Parameters:                                                               */
+/*   Name            Type           Comments                                 */
+/*   ------------    ------------  -----------------------------------       */
+/*   port            const char *  Serial port being tested                  */
+/*   baud            unsigned long Baud rate being tested                    */
+/*                                                                           */
+/* Returns: SERG_OK if the segment is published, else SERG_FAILURE           */
+/*                                                                           */
+/* Pre-conditions: Segment not open                                          */
+/*                                                                           */
+/* Post-conditions: Counts added are published                               */
+/*                                                                           */
+/*****************************************************************************/
+
+extern serg_status_t serg_open(const char *port, unsigned long baud);
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: serg_add()                                                          */
+/*                                                                           */
+/* Description: Count a tested byte in the segment. Only one thread may      */
+/*              count bytes. Makes no system calls.                          */
+/*                                                                           */
+/* Parameters:                                                               */
+/*   Name            Type           Comments                                 */
+/*   ------------    ------------  -----------------------------------       */
+/*   errored         bool          Was the byte corrupt or did it time out?  */
+/*   timed_out       bool          Did the byte time out?                    */
+/*   latency         long long     The byte's return time in ns, or -1       */
+/*                                                                           */
+/* Returns: void                                                             */
+/*                                                                           */
+/* Pre-conditions:                                                           */
+/*                                                                           */
+/* Post-conditions: Byte counted, if the segment is open                     */
+/*                                                                           */
+/*****************************************************************************/
+
+extern void serg_add(bool errored, bool timed_out, long long latency);
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: serg_close()                                                        */
+/*                                                                           */
+/* Description: Mark the test finished and remove the segment. Monitors that */
+/*              have it mapped can still read the final counts.              */
+/*                                                                           */
+/* Parameters:                                                               */
+/*   Name            Type           Comments                                 */
+/*   ------------    ------------  -----------------------------------       */
+/*                                                                           */
+/* Returns: void                                                             */
+/*                                                                           */
+/* Pre-conditions:                                                           */
+/*                                                                           */
+/* Post-conditions: Segment closed and removed                               */
+/*                                                                           */
+/*****************************************************************************/
+
+extern void serg_close(void);
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: serg_read()                                                         */
+/*                                                                           */
+/* Description: Take a copy of a segment's counts that isn't torn by the     */
+/*              test writing them at the same time                           */
+/*                                                                           */
+/* Parameters:                                                               */
+/*   Name            Type           Comments                                 */
+/*   ------------    ------------  -----------------------------------       */
+/*   segment         serg_segment_t The segment, mapped by the caller        */
+/*   counts          serg_counts_t Where to put the copy                     */
+/*                                                                           */
+/* Returns: The state of the test                                            */
+/*                                                                           */
+/* Pre-conditions: Segment's magic number and version checked                */
+/*                                                                           */
+/* Post-conditions:                                                          */
+/*                                                                           */
+/*****************************************************************************/
+
+extern serg_state_t serg_read(serg_segment_t *segment, serg_counts_t *counts);
+
+
+#endif /* SERG_H */
+
@@ -0,0 +1,251 @@
+/*****************************************************************************/
+/*                                                                           */
+/* Module: serh.c                                                            */
+/*                                                                           */
+/* Description: Tunes the host for the test: real-time scheduling, CPU       */
+/*              pinning, locked memory and timer slack                       */
+/*                                                                           */
+/* Copyright (C) 2026 The Serbert contributors                               */
+/*                                                                           */
+/* This file is part of Serbert.                                             */
+/*                                                                           */
+/* Serbert is free software; you can redistribute it and/or modify           */
+/* it under the terms of the GNU General Public License as published by      */
+/* the Free Software Foundation; either version 2 of the License, or         */
+/* any later version.                                                        */
+/*                                                                           */
+/* This program is distributed in the hope that it will be useful,           */
+/* but WITHOUT ANY WARRANTY; without even the implied warranty of            */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             */
+/* GNU General Public License for more details.                              */
+/*                                                                           */
+/* You should have received a copy of the GNU General Public License         */
+/* along with this program; if not, write to the Free Software               */
+/* Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA */
+/*                                                                           */
+/*****************************************************************************/
+
+/*****************************************************************************/
+/*      INCLUDED FILES (dependencies)                                        */
+/*****************************************************************************/
+
+/* Required for sched_setaffinity() and CPU_SET() */
+#define _GNU_SOURCE
+
+#include <stdbool.h>     /* Boolean types                                  */
+#include <string.h>      /* Standard string lib - memset()                 */
+#include <unistd.h>      /* UNIX standard - sysconf()                      */
+#include <errno.h>       /* Error numbers - errno                          */
+#include <pthread.h>     /* POSIX threads - pthread_setschedparam()        */
+#include <sched.h>       /* Scheduling - SCHED_FIFO, CPU_SET()             */
+#include <sys/mman.h>    /* Memory management - mlockall()                 */
+#include <sys/prctl.h>   /* Process control - prctl()                      */
+#include "serh.h"        /* Header file for this library                   */
+
+
+/*****************************************************************************/
+/*      INTERNAL MACRO DEFINITIONS                                           */
+/*****************************************************************************/
+
+/*****************************************************************************/
+/*  Name:                                                                    */
+/*  Description:                                                             */
+/*  Parameters:                                                              */
+/*  Client functions:                                                        */
+/*****************************************************************************/
+
+
+/*****************************************************************************/
+/*      INTERNAL TYPE DEFINITIONS                                            */
+/*****************************************************************************/
+
+enum { i_PREFAULT_STACK = 256 * 1024 };
+                                     /* Stack faulted in when locking memory */
+
+
+/*****************************************************************************/
+/*      INTERNAL VARIABLE DEFINITIONS                                        */
+/*****************************************************************************/
+
+
+/*****************************************************************************/
+/*      INTERNAL FUNCTION DEFINITIONS                                        */
+/*****************************************************************************/
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: i_prefault_stack()                                                  */
+/*                                                                           */
+/* Description: Touch the stack the test could use, so with memory locked    */
+/*              it's faulted in now, not the first time it's needed          */
+/*                                                                           */
+/* Uses: void                                                                */
+/*                                                                           */
+/* Returns: void                                                             */
+/*                                                                           */
+/*****************************************************************************/
+
+static void i_prefault_stack(void)
+{
+
+  volatile unsigned char stack[i_PREFAULT_STACK]; /* Stack to fault in */
+  size_t index;                                   /* Byte touched      */
+
+
+  for(index = 0; index < sizeof(stack); index += (size_t) getpagesize() )
+  {
+
+    stack[index] = 0;
+
+  }
+
+}
+
+
+/*****************************************************************************/
+/*      EXTERNAL VARIABLE DEFINITIONS                                        */
+/*****************************************************************************/
+
+
+/*****************************************************************************/
+/*      EXTERNAL FUNCTION DEFINITIONS                                        */
+/*****************************************************************************/
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: serh_cpus()                                                         */
+/*                                                                           */
+/* Description: Gets the number of CPUs configured                           */
+/*                                                                           */
+/* Internal functions used:                                                  */
+/*                                                                           */
+/* Internal variables used:                                                  */
+/*                                                                           */
+/* Parameters: void                                                          */
+/*                                                                           */
+/* Returns: The number of CPUs, at least 1                                   */
+/*                                                                           */
+/*****************************************************************************/
+
+extern int serh_cpus(void)
+{
+
+  long cpus;               /* CPUs configured */
+
+
+  cpus = sysconf(_SC_NPROCESSORS_CONF);
+
+  if(cpus < 1)
+  {
+
+    cpus = 1;
+
+  }
+
+  return (int) cpus;
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: serh_apply()                                                        */
+/*                                                                           */
+/* Description: Tunes the host for the calling thread. Memory is locked      */
+/*              first, so the pages are in before the thread can hog a CPU,  */
+/*              then the thread is pinned to its CPU and given its priority. */
+/*              The memory lock is the whole process's, but the rest is the  */
+/*              calling thread's alone, set through its pthread_t.           */
+/*                                                                           */
+/* Internal functions used: i_prefault_stack()                               */
+/*                                                                           */
+/* Internal variables used:                                                  */
+/*                                                                           */
+/* Parameters: setup - What to tune                                          */
+/*                                                                           */
+/* Returns: SERH_OK, or what failed first, with errno set                    */
+/*                                                                           */
+/*****************************************************************************/
+
+extern serh_status_t serh_apply(const serh_setup_t *setup)
+{
+
+  serh_status_t status = SERH_OK;    /* What failed first, if anything */
+  cpu_set_t cpus;                    /* CPU to run on                  */
+  struct sched_param param;          /* Priority to run at             */
+  int error;                         /* Error from a pthread call      */
+
+
+  if(setup->lock == true)
+  {
+
+    /* Lock what's mapped now and all that's mapped later */
+    if(mlockall(MCL_CURRENT | MCL_FUTURE) != 0)
+    {
+
+      status = SERH_LOCK_FAIL;
+
+    }
+    else
+    {
+
+      i_prefault_stack();
+
+    }
+
+  }
+
+  /* Wake from select() as near the timeout as the timer allows */
+  if( (status == SERH_OK)
+    && ( (setup->lock == true) || (setup->priority != SERH_NONE) )
+    && (prctl(PR_SET_TIMERSLACK, (unsigned long) SERH_TIMER_SLACK_NS,
+    0UL, 0UL, 0UL) != 0) )
+  {
+
+    status = SERH_SLACK_FAIL;
+
+  }
+
+  if( (status == SERH_OK) && (setup->cpu != SERH_NONE) )
+  {
+
+    CPU_ZERO(&cpus);
+
+    CPU_SET(setup->cpu, &cpus);
+
+    error = pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus);
+
+    if(error != 0)
+    {
+
+      errno = error;
+
+      status = SERH_CPU_FAIL;
+
+    }
+
+  }
+
+  if( (status == SERH_OK) && (setup->priority != SERH_NONE) )
+  {
+
+    memset(&param, 0, sizeof(param) );
+
+    param.sched_priority = setup->priority;
+
+    error = pthread_setschedparam(pthread_self(), SCHED_FIFO, &param);
+
+    if(error != 0)
+    {
+
+      errno = error;
+
+      status = SERH_PRIORITY_FAIL;
+
+    }
+
+  }
+
+  return status;
+
+}
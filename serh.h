@@ -0,0 +1,138 @@
+/*****************************************************************************/
+/*                                                                           */
+/* Module: serh.h                                                            */
+/*                                                                           */
+/* Description: Header file for serh.c                                       */
+/*                                                                           */
+/* Copyright (C) 2026 The Serbert contributors                               */
+/*                                                                           */
+/* This file is part of Serbert.                                             */
+/*                                                                           */
+/* Serbert is free software; you can redistribute it and/or modify           */
+/* it under the terms of the GNU General Public License as published by      */
+/* the Free Software Foundation; either version 2 of the License, or         */
+/* any later version.                                                        */
+/*                                                                           */
+/* This program is distributed in the hope that it will be useful,           */
+/* but WITHOUT ANY WARRANTY; without even the implied warranty of            */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             */
+/* GNU General Public License for more details.                              */
+/*                                                                           */
+/* You should have received a copy of the GNU General Public License         */
+/* along with this program; if not, write to the Free Software               */
+/* Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA */
+/*                                                                           */
+/*****************************************************************************/
+
+#ifndef SERH_H
+
+#define SERH_H
+
+/*****************************************************************************/
+/*      INCLUDED FILES (dependencies)                                        */
+/*****************************************************************************/
+
+#include <stdbool.h>     /* Boolean types                                  */
+
+
+/*****************************************************************************/
+/*      MACRO DEFINITIONS                                                    */
+/*****************************************************************************/
+
+/*****************************************************************************/
+/*  Name:                                                                    */
+/*  Description:                                                             */
+/*  Parameters:                                                              */
+/*****************************************************************************/
+
+
+/*****************************************************************************/
+/*      TYPE DEFINITIONS                                                     */
+/*****************************************************************************/
+
+/* Enums & constants */
+
+enum { SERH_NONE = -1 };             /* No priority or CPU asked for         */
+
+enum { SERH_MIN_PRIORITY = 1 };      /* Lowest SCHED_FIFO priority           */
+
+enum { SERH_MAX_PRIORITY = 99 };     /* Highest SCHED_FIFO priority          */
+
+enum { SERH_TIMER_SLACK_NS = 1 };    /* Timer slack when tuned, ns           */
+
+/* Types */
+
+/* Result of tuning the host */
+typedef enum serh_status_t
+{
+  SERH_OK,                           /* All that was asked for was done      */
+  SERH_PRIORITY_FAIL,                /* Couldn't run under SCHED_FIFO        */
+  SERH_CPU_FAIL,                     /* Couldn't pin the thread to the CPU   */
+  SERH_LOCK_FAIL,                    /* Couldn't lock memory                 */
+  SERH_SLACK_FAIL                    /* Couldn't set the timer slack         */
+} serh_status_t;
+
+/* How to tune the host for the thread doing the I/O */
+typedef struct serh_setup_t
+{
+  int priority;                      /* SCHED_FIFO priority, or SERH_NONE    */
+  int cpu;                           /* CPU to run on, or SERH_NONE          */
+  bool lock;                         /* Lock and pre-fault memory            */
+} serh_setup_t;
+
+
+/*****************************************************************************/
+/*      GLOBAL VARIABLES                                                     */
+/*****************************************************************************/
+
+
+/*****************************************************************************/
+/*      FUNCTION PROTOTYPES                                                  */
+/*****************************************************************************/
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: serh_cpus()                                                         */
+/*                                                                           */
+/* Description: Gets the number of CPUs configured                           */
+/*                                                                           */
+/* Parameters: void                                                          */
+/*                                                                           */
+/* Returns: The number of CPUs, at least 1                                   */
+/*                                                                           */
+/* Pre-conditions:                                                           */
+/*                                                                           */
+/* Post-conditions:                                                          */
+/*                                                                           */
+/*****************************************************************************/
+
+extern int serh_cpus(void);
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: serh_apply()                                                        */
+/*                                                                           */
+/* Description: Tunes the host for the calling thread, so its timing comes   */
+/*              from the link, not from the host. With a priority or memory  */
+/*              locked, the thread is given the least timer slack too.       */
+/*                                                                           */
+/* Parameters:                                                               */
+/*   Name            Type             Comments                               */
+/*   ------------    ------------     -----------------------------------    */
+/*   setup           serh_setup_t *   What to tune                           */
+/*                                                                           */
+/* Returns: SERH_OK, or what failed first, with errno set                    */
+/*                                                                           */
+/* Pre-conditions:                                                           */
+/*                                                                           */
+/* Post-conditions: Only the calling thread is scheduled and pinned, but     */
+/*                  threads it starts afterwards inherit that, so it should  */
+/*                  be called once they have all started                     */
+/*                                                                           */
+/*****************************************************************************/
+
+extern serh_status_t serh_apply(const serh_setup_t *setup);
+
+
+#endif /* SERH_H */
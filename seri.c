@@ -0,0 +1,594 @@
+/*****************************************************************************/
+/*                                                                           */
+/* Module: seri.c                                                            */
+/*                                                                           */
+/* Description: Interval snapshots for serial Bit Error Rate Tests           */
+/*                                                                           */
+/* Copyright (C) 2026 The Serbert contributors                               */
+/*                                                                           */
+/* This file is part of Serbert.                                             */
+/*                                                                           */
+/* Serbert is free software; you can redistribute it and/or modify           */
+/* it under the terms of the GNU General Public License as published by      */
+/* the Free Software Foundation; either version 2 of the License, or         */
+/* any later version.                                                        */
+/*                                                                           */
+/* This program is distributed in the hope that it will be useful,           */
+/* but WITHOUT ANY WARRANTY; without even the implied warranty of            */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             */
+/* GNU General Public License for more details.                              */
+/*                                                                           */
+/* You should have received a copy of the GNU General Public License         */
+/* along with this program; if not, write to the Free Software               */
+/* Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA */
+/*                                                                           */
+/*****************************************************************************/
+
+
+/*****************************************************************************/
+/*      INCLUDED FILES (dependencies)                                        */
+/*****************************************************************************/
+
+#include <string.h>      /* Standard string lib - memset()                 */
+#include <stdbool.h>     /* Boolean types                                  */
+#include <stdatomic.h>   /* Atomic types - atomic_uint                     */
+#include <pthread.h>     /* Threads - pthread_create(), pthread_cond_t     */
+#include <time.h>        /* Time defs - clock_gettime(), timespec          */
+#include <errno.h>       /* Provides ETIMEDOUT                             */
+#include "sers.h"        /* Serial statistics library                      */
+#include "seri.h"        /* Header file for this library                   */
+
+
+/*****************************************************************************/
+/*      INTERNAL MACRO DEFINITIONS                                           */
+/*****************************************************************************/
+
+/*****************************************************************************/
+/*  Name:                                                                    */
+/*  Description:                                                             */
+/*  Parameters:                                                              */
+/*  Client functions:                                                        */
+/*****************************************************************************/
+
+
+/*****************************************************************************/
+/*      INTERNAL TYPE DEFINITIONS                                            */
+/*****************************************************************************/
+
+/*****************************************************************************/
+/*      INTERNAL VARIABLE DEFINITIONS                                        */
+/*****************************************************************************/
+
+/* The counts are written by the test and read by the timer. The sequence  */
+/* number is odd while they're being written, so the timer can tell when   */
+/* its copy of them was torn and take it again. The test never waits.      */
+static seri_counts_t i_counts;                /* The counts so far          */
+
+static atomic_uint i_seq;                     /* Counts' sequence number    */
+
+static long long i_interval;                  /* Interval length, in ns     */
+
+static seri_report_func_t i_report_func;      /* Given each snapshot        */
+
+static bool i_stopping;                       /* Timer asked to stop        */
+
+static bool i_running = false;                /* Timer running              */
+
+static pthread_t i_thread;                    /* The timer thread           */
+
+static pthread_mutex_t i_mutex = PTHREAD_MUTEX_INITIALIZER;
+                                              /* Guards i_stopping          */
+
+static pthread_cond_t i_cond;                 /* Wakes the timer to stop    */
+
+
+/*****************************************************************************/
+/*      INTERNAL FUNCTION DEFINITIONS                                        */
+/*****************************************************************************/
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: i_timespec_to_ns()                                                  */
+/*                                                                           */
+/* Description: Convert a timespec into nanoseconds                          */
+/*                                                                           */
+/* Uses: time_val - The time to convert                                      */
+/*                                                                           */
+/* Returns: The time in nanoseconds                                          */
+/*                                                                           */
+/*****************************************************************************/
+
+static long long i_timespec_to_ns(struct timespec time_val)
+{
+
+  return ( (long long) time_val.tv_sec * SERS_NSEC_IN_SEC) +
+    (long long) time_val.tv_nsec;
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: i_ns_to_timespec()                                                  */
+/*                                                                           */
+/* Description: Convert nanoseconds into a timespec                          */
+/*                                                                           */
+/* Uses: time_ns - The time to convert                                       */
+/*                                                                           */
+/* Returns: The time as a timespec                                           */
+/*                                                                           */
+/*****************************************************************************/
+
+static struct timespec i_ns_to_timespec(long long time_ns)
+{
+
+  struct timespec time_val;     /* The converted time */
+
+
+  time_val.tv_sec = (time_t) (time_ns / SERS_NSEC_IN_SEC);
+
+  time_val.tv_nsec = (long) (time_ns % SERS_NSEC_IN_SEC);
+
+  return time_val;
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: i_now()                                                             */
+/*                                                                           */
+/* Description: Gets the time from the monotonic clock                       */
+/*                                                                           */
+/* Uses: void                                                                */
+/*                                                                           */
+/* Returns: The time in nanoseconds                                          */
+/*                                                                           */
+/*****************************************************************************/
+
+static long long i_now(void)
+{
+
+  struct timespec time_now;     /* The current time */
+
+
+  (void) clock_gettime(CLOCK_MONOTONIC, &time_now);
+
+  return i_timespec_to_ns(time_now);
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: i_read_counts()                                                     */
+/*                                                                           */
+/* Description: Take a copy of the counts that isn't torn by the test        */
+/*              writing them at the same time                                */
+/*                                                                           */
+/* Uses: copy - Where to put the copy                                        */
+/*                                                                           */
+/* Returns: void                                                             */
+/*                                                                           */
+/*****************************************************************************/
+
+static void i_read_counts(seri_counts_t *copy)
+{
+
+  unsigned int before;          /* Sequence number before copying */
+  unsigned int after;           /* Sequence number after copying  */
+
+
+  do
+  {
+
+    /* Wait for the test to finish writing */
+    do
+    {
+
+      before = atomic_load_explicit(&i_seq, memory_order_acquire);
+
+    } while( (before & 1U) != 0);
+
+    *copy = i_counts;
+
+    atomic_thread_fence(memory_order_acquire);
+
+    after = atomic_load_explicit(&i_seq, memory_order_relaxed);
+
+  } while(before != after);
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: i_diff_counts()                                                     */
+/*                                                                           */
+/* Description: Work out the counts during an interval from the totals at    */
+/*              its start and end                                            */
+/*                                                                           */
+/* Uses: start - Totals at the start                                         */
+/*       end   - Totals at the end                                           */
+/*       delta - Where to put the counts during the interval                 */
+/*                                                                           */
+/* Returns: void                                                             */
+/*                                                                           */
+/*****************************************************************************/
+
+static void i_diff_counts(const seri_counts_t *start, const seri_counts_t *end,
+  seri_counts_t *delta)
+{
+
+  unsigned int bucket;          /* The current bucket */
+  unsigned long long top;       /* Top of a bucket    */
+
+
+  delta->bytes = end->bytes - start->bytes;
+
+  delta->errors = end->errors - start->errors;
+
+  delta->timeouts = end->timeouts - start->timeouts;
+
+  delta->latency.samples = end->latency.samples - start->latency.samples;
+
+  delta->latency_sum = end->latency_sum - start->latency_sum;
+
+  delta->latency.max = 0;
+
+  for(bucket = 0; bucket < (unsigned int) SERS_HIST_BUCKETS; bucket++)
+  {
+
+    delta->latency.count[bucket] = end->latency.count[bucket] -
+      start->latency.count[bucket];
+
+    /* The largest sample can't be told apart within its bucket, so use */
+    /* the top of the highest one, as long as it's not beyond the total */
+    if(delta->latency.count[bucket] > 0)
+    {
+
+      top = end->latency.max;
+
+      if(bucket < (unsigned int) (SERS_HIST_BUCKETS - 1) )
+      {
+
+        top = sers_hist_bucket_low(bucket + 1) - 1;
+
+        if(top > end->latency.max)
+        {
+
+          top = end->latency.max;
+
+        }
+
+      }
+
+      delta->latency.max = top;
+
+    }
+
+  }
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: i_timer()                                                           */
+/*                                                                           */
+/* Description: The timer thread. Takes a snapshot of the counts at the end  */
+/*              of each interval, until asked to stop.                       */
+/*                                                                           */
+/* Uses: arg - Not used                                                      */
+/*                                                                           */
+/* Returns: NULL                                                             */
+/*                                                                           */
+/*****************************************************************************/
+
+static void *i_timer(void *arg)
+{
+
+  seri_snap_t snap;             /* The snapshot                      */
+  seri_counts_t last;           /* Totals at the last snapshot       */
+  long long start;              /* When the timer started            */
+  long long last_time;          /* When the last snapshot was taken  */
+  long long next;               /* When the next snapshot is due     */
+  long long time_now;           /* The current time                  */
+  struct timespec deadline;     /* When to wake                      */
+  int wait_status;              /* Result of waiting                 */
+
+
+  (void) arg;
+
+  memset(&snap, 0, sizeof(snap) );
+
+  i_read_counts(&last);
+
+  start = i_now();
+
+  last_time = start;
+
+  next = start;
+
+  (void) pthread_mutex_lock(&i_mutex);
+
+  while(i_stopping == false)
+  {
+
+    /* Wake on the interval boundaries, skipping any already missed */
+    time_now = i_now();
+
+    do
+    {
+
+      next += i_interval;
+
+    } while(next <= time_now);
+
+    deadline = i_ns_to_timespec(next);
+
+    wait_status = 0;
+
+    while( (i_stopping == false) && (wait_status != ETIMEDOUT) )
+    {
+
+      wait_status = pthread_cond_timedwait(&i_cond, &i_mutex, &deadline);
+
+    }
+
+    if(i_stopping == false)
+    {
+
+      (void) pthread_mutex_unlock(&i_mutex);
+
+      i_read_counts(&snap.total);
+
+      time_now = i_now();
+
+      snap.number++;
+
+      snap.elapsed = time_now - start;
+
+      snap.span = time_now - last_time;
+
+      i_diff_counts(&last, &snap.total, &snap.delta);
+
+      i_report_func(&snap);
+
+      last = snap.total;
+
+      last_time = time_now;
+
+      (void) pthread_mutex_lock(&i_mutex);
+
+    }
+
+  }
+
+  (void) pthread_mutex_unlock(&i_mutex);
+
+  return NULL;
+
+}
+
+
+/*****************************************************************************/
+/*      EXTERNAL VARIABLE DEFINITIONS                                        */
+/*****************************************************************************/
+
+
+/*****************************************************************************/
+/*      EXTERNAL FUNCTION DEFINITIONS                                        */
+/*****************************************************************************/
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: seri_start()                                                        */
+/*                                                                           */
+/* Description: Clear the counts and start the timer thread                  */
+/*                                                                           */
+/* Internal functions used: i_timer()                                        */
+/*                                                                           */
+/* Internal variables used: i_counts, i_seq, i_interval, i_report_func,      */
+/*                          i_stopping, i_running, i_thread, i_cond          */
+/*                                                                           */
+/* Parameters:                                                               */
+/*   Name            Type           Comments                                 */
+/*   ------------    ------------   -----------------------------------      */
+/*   interval        long long      Length of each interval, in ns           */
+/*   func            seri_report_func_t  Function given each snapshot        */
+/*                                                                           */
+/* Returns: SERI_OK if the timer is running, else SERI_FAILURE               */
+/*                                                                           */
+/*****************************************************************************/
+
+extern seri_status_t seri_start(long long interval, seri_report_func_t func)
+{
+
+  seri_status_t status = SERI_FAILURE;  /* Did the timer start?      */
+  pthread_condattr_t cond_attr;         /* Condition variable attrs  */
+
+
+  if( (i_running == false) && (interval > 0) && (func != NULL) )
+  {
+
+    memset(&i_counts, 0, sizeof(i_counts) );
+
+    sers_hist_init(&i_counts.latency);
+
+    atomic_store(&i_seq, 0);
+
+    i_interval = interval;
+
+    i_report_func = func;
+
+    i_stopping = false;
+
+    /* Time the waits on the monotonic clock, so setting the date can't */
+    /* upset the intervals                                              */
+    (void) pthread_condattr_init(&cond_attr);
+
+    (void) pthread_condattr_setclock(&cond_attr, CLOCK_MONOTONIC);
+
+    if(pthread_cond_init(&i_cond, &cond_attr) == 0)
+    {
+
+      if(pthread_create(&i_thread, NULL, i_timer, NULL) == 0)
+      {
+
+        i_running = true;
+
+        status = SERI_OK;
+
+      }
+      else
+      {
+
+        (void) pthread_cond_destroy(&i_cond);
+
+      }
+
+    }
+
+    (void) pthread_condattr_destroy(&cond_attr);
+
+  }
+
+  return status;
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: seri_stop()                                                         */
+/*                                                                           */
+/* Description: Stop the timer thread                                        */
+/*                                                                           */
+/* Internal functions used:                                                  */
+/*                                                                           */
+/* Internal variables used: i_stopping, i_running, i_thread, i_mutex,        */
+/*                          i_cond                                           */
+/*                                                                           */
+/* Parameters:                                                               */
+/*   Name            Type           Comments                                 */
+/*   ------------    ------------   -----------------------------------      */
+/*                                                                           */
+/* Returns: void                                                             */
+/*                                                                           */
+/*****************************************************************************/
+
+extern void seri_stop(void)
+{
+
+  if(i_running == true)
+  {
+
+    (void) pthread_mutex_lock(&i_mutex);
+
+    i_stopping = true;
+
+    (void) pthread_cond_signal(&i_cond);
+
+    (void) pthread_mutex_unlock(&i_mutex);
+
+    (void) pthread_join(i_thread, NULL);
+
+    (void) pthread_cond_destroy(&i_cond);
+
+    i_running = false;
+
+  }
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: seri_add()                                                          */
+/*                                                                           */
+/* Description: Count a tested byte                                          */
+/*                                                                           */
+/* Internal functions used:                                                  */
+/*                                                                           */
+/* Internal variables used: i_counts, i_seq                                  */
+/*                                                                           */
+/* Parameters:                                                               */
+/*   Name            Type           Comments                                 */
+/*   ------------    ------------   -----------------------------------      */
+/*   errored         bool           Was the byte corrupt or did it time out? */
+/*   timed_out       bool           Did the byte time out?                   */
+/*   latency         long long      The byte's return time in ns, or -1      */
+/*                                                                           */
+/* Returns: void                                                             */
+/*                                                                           */
+/*****************************************************************************/
+
+extern void seri_add(bool errored, bool timed_out, long long latency)
+{
+
+  unsigned int seq;             /* The counts' sequence number */
+
+
+  /* Only this thread writes the sequence number, so it can't change */
+  seq = atomic_load_explicit(&i_seq, memory_order_relaxed);
+
+  atomic_store_explicit(&i_seq, seq + 1, memory_order_relaxed);
+
+  atomic_thread_fence(memory_order_release);
+
+  i_counts.bytes++;
+
+  if(errored == true)
+  {
+
+    i_counts.errors++;
+
+  }
+
+  if(timed_out == true)
+  {
+
+    i_counts.timeouts++;
+
+  }
+
+  if( (errored == false) && (latency >= 0) )
+  {
+
+    sers_hist_add(&i_counts.latency, (unsigned long long) latency);
+
+    i_counts.latency_sum += (unsigned long long) latency;
+
+  }
+
+  atomic_store_explicit(&i_seq, seq + 2, memory_order_release);
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: seri_read()                                                         */
+/*                                                                           */
+/* Description: Gets the counts since the timer was last started             */
+/*                                                                           */
+/* Internal functions used: i_read_counts()                                  */
+/*                                                                           */
+/* Internal variables used:                                                  */
+/*                                                                           */
+/* Parameters:                                                               */
+/*   Name            Type           Comments                                 */
+/*   ------------    ------------   -----------------------------------      */
+/*   counts          seri_counts_t  Where to put the counts                  */
+/*                                                                           */
+/* Returns: void                                                             */
+/*                                                                           */
+/*****************************************************************************/
+
+extern void seri_read(seri_counts_t *counts)
+{
+
+  i_read_counts(counts);
+
+}
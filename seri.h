@@ -0,0 +1,193 @@
+/*****************************************************************************/
+/*                                                                           */
+/* Module: seri.h                                                            */
+/*                                                                           */
+/* Description: Header file for seri.c                                       */
+/*                                                                           */
+/* Copyright (C) 2026 The Serbert contributors                               */
+/*                                                                           */
+/* This file is part of Serbert.                                             */
+/*                                                                           */
+/* Serbert is free software; you can redistribute it and/or modify           */
+/* it under the terms of the GNU General Public License as published by      */
+/* the Free Software Foundation; either version 2 of the License, or         */
+/* any later version.                                                        */
+/*                                                                           */
+/* This program is distributed in the hope that it will be useful,           */
+/* but WITHOUT ANY WARRANTY; without even the implied warranty of            */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             */
+/* GNU General Public License for more details.                              */
+/*                                                                           */
+/* You should have received a copy of the GNU General Public License         */
+/* along with this program; if not, write to the Free Software               */
+/* Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA */
+/*                                                                           */
+/*****************************************************************************/
+
+#ifndef SERI_H
+
+#define SERI_H
+
+/*****************************************************************************/
+/*      INCLUDED FILES (dependencies)                                        */
+/*****************************************************************************/
+
+#include <stdbool.h>     /* Boolean types                                  */
+#include "sers.h"        /* Serial statistics library - sers_hist_t        */
+
+
+/*****************************************************************************/
+/*      MACRO DEFINITIONS                                                    */
+/*****************************************************************************/
+
+/*****************************************************************************/
+/*  Name:                                                                    */
+/*  Description:                                                             */
+/*  Parameters:                                                              */
+/*****************************************************************************/
+
+
+/*****************************************************************************/
+/*      TYPE DEFINITIONS                                                     */
+/*****************************************************************************/
+
+/* Enums & constants */
+
+/* Status of starting the timer */
+typedef enum seri_status_t
+{
+  SERI_OK,                           /* Timer running                        */
+  SERI_FAILURE                       /* Timer could not be started           */
+} seri_status_t;
+
+/* Types */
+
+/* Counts of the bytes tested */
+typedef struct seri_counts_t
+{
+  unsigned long long bytes;          /* Bytes tested                         */
+  unsigned long long errors;         /* Bytes in error                       */
+  unsigned long long timeouts;       /* Bytes that timed out                 */
+  sers_hist_t latency;               /* Return times of good bytes           */
+  unsigned long long latency_sum;    /* Their total, in ns                   */
+} seri_counts_t;
+
+/* A snapshot of the counts, taken at the end of an interval */
+typedef struct seri_snap_t
+{
+  unsigned long long number;         /* Which interval, from 1               */
+  long long elapsed;                 /* Time since the timer started, in ns  */
+  long long span;                    /* Length of the interval, in ns        */
+  seri_counts_t delta;               /* Counts during the interval           */
+  seri_counts_t total;               /* Counts since the timer started       */
+} seri_snap_t;
+
+/* Function given each snapshot, called from the timer thread */
+typedef void (*seri_report_func_t)(const seri_snap_t *snap);
+
+
+/*****************************************************************************/
+/*      GLOBAL VARIABLES                                                     */
+/*****************************************************************************/
+
+
+/*****************************************************************************/
+/*      FUNCTION PROTOTYPES                                                  */
+/*****************************************************************************/
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: seri_start()                                                        */
+/*                                                                           */
+/* Description: Clear the counts and start the timer thread, which takes a   */
+/*              snapshot of them at the end of each interval                 */
+/*                                                                           */
+/* Parameters:                                                               */
+/*   Name            Type           Comments                                 */
+/*   ------------    ------------  -----------------------------------       */
+/*   interval        long long     Length of each interval, in ns            */
+/*   func            seri_report_func_t  Function given each snapshot        */
+/*                                                                           */
+/* Returns: SERI_OK if the timer is running, else SERI_FAILURE               */
+/*                                                                           */
+/* Pre-conditions: Timer not running                                         */
+/*                                                                           */
+/* Post-conditions: func is called from the timer thread once per interval   */
+/*                                                                           */
+/*****************************************************************************/
+
+extern seri_status_t seri_start(long long interval, seri_report_func_t func);
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: seri_stop()                                                         */
+/*                                                                           */
+/* Description: Stop the timer thread. The part interval left over is not    */
+/*              reported.                                                    */
+/*                                                                           */
+/* Parameters:                                                               */
+/*   Name            Type           Comments                                 */
+/*   ------------    ------------  -----------------------------------       */
+/*                                                                           */
+/* Returns: void                                                             */
+/*                                                                           */
+/* Pre-conditions:                                                           */
+/*                                                                           */
+/* Post-conditions: Timer not running                                        */
+/*                                                                           */
+/*****************************************************************************/
+
+extern void seri_stop(void);
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: seri_add()                                                          */
+/*                                                                           */
+/* Description: Count a tested byte. Only one thread may count bytes. This   */
+/*              never waits for the timer thread.                            */
+/*                                                                           */
+/* Parameters:                                                               */
+/*   Name            Type           Comments                                 */
+/*   ------------    ------------  -----------------------------------       */
+/*   errored         bool          Was the byte corrupt or did it time out?  */
+/*   timed_out       bool          Did the byte time out?                    */
+/*   latency         long long     The byte's return time in ns, or -1       */
+/*                                                                           */
+/* Returns: void                                                             */
+/*                                                                           */
+/* Pre-conditions:                                                           */
+/*                                                                           */
+/* Post-conditions: Byte counted                                             */
+/*                                                                           */
+/*****************************************************************************/
+
+extern void seri_add(bool errored, bool timed_out, long long latency);
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: seri_read()                                                         */
+/*                                                                           */
+/* Description: Gets the counts since the timer was last started. May be     */
+/*              called from any thread.                                      */
+/*                                                                           */
+/* Parameters:                                                               */
+/*   Name            Type           Comments                                 */
+/*   ------------    ------------  -----------------------------------       */
+/*   counts          seri_counts_t Where to put the counts                   */
+/*                                                                           */
+/* Returns: void                                                             */
+/*                                                                           */
+/* Pre-conditions:                                                           */
+/*                                                                           */
+/* Post-conditions:                                                          */
+/*                                                                           */
+/*****************************************************************************/
+
+extern void seri_read(seri_counts_t *counts);
+
+
+#endif /* SERI_H */
+
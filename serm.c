@@ -0,0 +1,733 @@
+/*****************************************************************************/
+/*                                                                           */
+/* Module: serm.c                                                            */
+/*                                                                           */
+/* Description: Prometheus metrics for serial Bit Error Rate Tests           */
+/*                                                                           */
+/* Copyright (C) 2026 The Serbert contributors                               */
+/*                                                                           */
+/* This file is part of Serbert.                                             */
+/*                                                                           */
+/* Serbert is free software; you can redistribute it and/or modify           */
+/* it under the terms of the GNU General Public License as published by      */
+/* the Free Software Foundation; either version 2 of the License, or         */
+/* any later version.                                                        */
+/*                                                                           */
+/* This program is distributed in the hope that it will be useful,           */
+/* but WITHOUT ANY WARRANTY; without even the implied warranty of            */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             */
+/* GNU General Public License for more details.                              */
+/*                                                                           */
+/* You should have received a copy of the GNU General Public License         */
+/* along with this program; if not, write to the Free Software               */
+/* Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA */
+/*                                                                           */
+/*****************************************************************************/
+
+
+/*****************************************************************************/
+/*      INCLUDED FILES (dependencies)                                        */
+/*****************************************************************************/
+
+#include <stdio.h>       /* Standard I/O definitions - snprintf()          */
+#include <stdlib.h>      /* Standard library - strtol()                    */
+#include <stdarg.h>      /* Variable arguments - va_list                   */
+#include <string.h>      /* Standard string lib - strncmp(), memset()      */
+#include <stdbool.h>     /* Boolean types                                  */
+#include <stdatomic.h>   /* Atomic types - atomic_bool                     */
+#include <pthread.h>     /* Threads - pthread_create()                     */
+#include <unistd.h>      /* UNIX standard - close(), unlink()              */
+#include <poll.h>        /* Waiting on descriptors - poll()                */
+#include <sys/socket.h>  /* Sockets - socket(), bind(), accept()           */
+#include <sys/un.h>      /* Unix sockets - sockaddr_un                     */
+#include <sys/time.h>    /* Time definitions - timeval                     */
+#include <netinet/in.h>  /* Internet sockets - sockaddr_in                 */
+#include <arpa/inet.h>   /* Internet addresses - htonl(), htons()          */
+#include "sers.h"        /* Serial statistics library                      */
+#include "seri.h"        /* Interval snapshot library - seri_read()        */
+#include "serm.h"        /* Header file for this library                   */
+
+
+/*****************************************************************************/
+/*      INTERNAL MACRO DEFINITIONS                                           */
+/*****************************************************************************/
+
+/*****************************************************************************/
+/*  Name:                                                                    */
+/*  Description:                                                             */
+/*  Parameters:                                                              */
+/*  Client functions:                                                        */
+/*****************************************************************************/
+
+
+/*****************************************************************************/
+/*      INTERNAL TYPE DEFINITIONS                                            */
+/*****************************************************************************/
+
+enum { i_MAX_TCP_PORT = 65535 };     /* Highest TCP port number              */
+
+enum { i_SOCKET_FAIL = -1 };         /* Socket call failure state            */
+
+
+/*****************************************************************************/
+/*      INTERNAL VARIABLE DEFINITIONS                                        */
+/*****************************************************************************/
+
+/* Replies, for a page of metrics and for anything else */
+static const char *i_REPLY_OK = "HTTP/1.0 200 OK\r\n"
+  "Content-Type: text/plain; version=0.0.4\r\n"
+  "Connection: close\r\n\r\n";
+
+static const char *i_REPLY_NOT_FOUND = "HTTP/1.0 404 Not Found\r\n"
+  "Content-Type: text/plain\r\n"
+  "Connection: close\r\n\r\n"
+  "Metrics are at /metrics\n";
+
+static int i_listen_fd = i_SOCKET_FAIL;       /* The listening socket       */
+
+static struct sockaddr_un i_un_addr;         /* Unix socket address        */
+
+static bool i_made_socket = false;            /* Unix socket to remove      */
+
+static char i_label[SERM_LABEL_LEN];          /* The escaped port label     */
+
+static atomic_bool i_stopping;                /* Listener asked to stop     */
+
+static bool i_running = false;                /* Listener running           */
+
+static pthread_t i_thread;                    /* The listener thread        */
+
+
+/*****************************************************************************/
+/*      INTERNAL FUNCTION DEFINITIONS                                        */
+/*****************************************************************************/
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: i_escape_label()                                                    */
+/*                                                                           */
+/* Description: Escape a label value, as Prometheus needs, and keep it       */
+/*                                                                           */
+/* Uses: value - The label value                                             */
+/*                                                                           */
+/* Returns: void                                                             */
+/*                                                                           */
+/*****************************************************************************/
+
+static void i_escape_label(const char *value)
+{
+
+  size_t in;                    /* Position in the value */
+  size_t out = 0;               /* Position in the label */
+
+
+  for(in = 0; (value[in] != '\0') && (out < (size_t) (SERM_LABEL_LEN - 3) );
+    in++)
+  {
+
+    switch (value[in])
+    {
+
+      case '\\':
+      case '"':
+
+        i_label[out++] = '\\';
+
+        i_label[out++] = value[in];
+
+        break;
+
+      case '\n':
+
+        i_label[out++] = '\\';
+
+        i_label[out++] = 'n';
+
+        break;
+
+      default:
+
+        i_label[out++] = value[in];
+
+        break;
+
+    } /* End switch() */
+
+  }
+
+  i_label[out] = '\0';
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: i_add_text()                                                        */
+/*                                                                           */
+/* Description: Add text to the page of metrics, as far as it will fit       */
+/*                                                                           */
+/* Uses: body   - The page                                                   */
+/*       used   - How much of the page is used; updated                      */
+/*       format - printf() style format, followed by its arguments           */
+/*                                                                           */
+/* Returns: void                                                             */
+/*                                                                           */
+/*****************************************************************************/
+
+static void i_add_text(char *body, size_t *used, const char *format, ...)
+{
+
+  va_list args;                 /* The arguments for the format */
+  int length;                   /* Length of the text           */
+
+
+  if(*used < (size_t) SERM_BODY_LEN)
+  {
+
+    va_start(args, format);
+
+    length = vsnprintf(&body[*used], (size_t) SERM_BODY_LEN - *used, format,
+      args);
+
+    va_end(args);
+
+    if(length > 0)
+    {
+
+      *used += (size_t) length;
+
+      if(*used > (size_t) SERM_BODY_LEN - 1)
+      {
+
+        *used = (size_t) SERM_BODY_LEN - 1;
+
+      }
+
+    }
+
+  }
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: i_add_counter()                                                     */
+/*                                                                           */
+/* Description: Add a counter to the page of metrics                         */
+/*                                                                           */
+/* Uses: body  - The page                                                    */
+/*       used  - How much of the page is used; updated                       */
+/*       name  - The counter's name                                          */
+/*       help  - What it counts                                              */
+/*       value - Its value                                                   */
+/*                                                                           */
+/* Returns: void                                                             */
+/*                                                                           */
+/*****************************************************************************/
+
+static void i_add_counter(char *body, size_t *used, const char *name,
+  const char *help, unsigned long long value)
+{
+
+  i_add_text(body, used, "# HELP %s %s\n# TYPE %s counter\n", name, help,
+    name);
+
+  i_add_text(body, used, "%s{port=\"%s\"} %llu\n", name, i_label, value);
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: i_make_page()                                                       */
+/*                                                                           */
+/* Description: Make the page of metrics from a snapshot of the counts       */
+/*                                                                           */
+/* Uses: body - Where to put the page, SERM_BODY_LEN long                    */
+/*                                                                           */
+/* Returns: The length of the page                                           */
+/*                                                                           */
+/*****************************************************************************/
+
+static size_t i_make_page(char *body)
+{
+
+  seri_counts_t counts;         /* The snapshot               */
+  size_t used = 0;              /* Length of the page so far  */
+  unsigned int octave;          /* The current octave         */
+  unsigned int bucket;          /* The current bucket         */
+  unsigned long long so_far = 0;/* Samples up to this bucket  */
+  unsigned long long top;       /* Top of the octave, in ns   */
+
+
+  body[0] = '\0';
+
+  /* Read without locking; the test never waits for it */
+  seri_read(&counts);
+
+  i_add_counter(body, &used, "serbert_bytes_total", "Bytes tested.",
+    counts.bytes);
+
+  i_add_counter(body, &used, "serbert_errors_total",
+    "Bytes that were corrupt or timed out.", counts.errors);
+
+  i_add_counter(body, &used, "serbert_timeouts_total",
+    "Bytes that timed out.", counts.timeouts);
+
+  i_add_counter(body, &used, "serbert_corrupt_bytes_total",
+    "Bytes that came back corrupt.", counts.errors - counts.timeouts);
+
+  i_add_text(body, &used, "# HELP serbert_return_time_seconds "
+    "Return times of good bytes.\n"
+    "# TYPE serbert_return_time_seconds histogram\n");
+
+  /* One Prometheus bucket per octave of the histogram */
+  for(octave = 1; octave <= (unsigned int) SERS_HIST_OCTAVES; octave++)
+  {
+
+    for(bucket = (octave - 1) * SERS_HIST_SUB;
+      bucket < octave * SERS_HIST_SUB; bucket++)
+    {
+
+      so_far += counts.latency.count[bucket];
+
+    }
+
+    if(octave < (unsigned int) SERS_HIST_OCTAVES)
+    {
+
+      top = sers_hist_bucket_low(octave * SERS_HIST_SUB) - 1;
+
+      i_add_text(body, &used, "serbert_return_time_seconds_bucket"
+        "{port=\"%s\",le=\"%.9g\"} %llu\n", i_label,
+        (double) top / (double) SERS_NSEC_IN_SEC, so_far);
+
+    }
+
+  }
+
+  i_add_text(body, &used, "serbert_return_time_seconds_bucket"
+    "{port=\"%s\",le=\"+Inf\"} %llu\n", i_label, so_far);
+
+  i_add_text(body, &used, "serbert_return_time_seconds_sum"
+    "{port=\"%s\"} %.9f\n", i_label,
+    (double) counts.latency_sum / (double) SERS_NSEC_IN_SEC);
+
+  i_add_text(body, &used, "serbert_return_time_seconds_count"
+    "{port=\"%s\"} %llu\n", i_label, counts.latency.samples);
+
+  return used;
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: i_write_all()                                                       */
+/*                                                                           */
+/* Description: Write all of a buffer to a socket, unless it fails           */
+/*                                                                           */
+/* Uses: fd     - The socket                                                 */
+/*       buf    - The buffer                                                 */
+/*       length - The length of the buffer                                   */
+/*                                                                           */
+/* Returns: void                                                             */
+/*                                                                           */
+/*****************************************************************************/
+
+static void i_write_all(int fd, const char *buf, size_t length)
+{
+
+  size_t done = 0;              /* Bytes written so far */
+  ssize_t written;              /* Bytes written now    */
+
+
+  do
+  {
+
+    written = send(fd, &buf[done], length - done, MSG_NOSIGNAL);
+
+    if(written > 0)
+    {
+
+      done += (size_t) written;
+
+    }
+
+  } while( (written > 0) && (done < length) );
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: i_serve()                                                           */
+/*                                                                           */
+/* Description: Answer one client's request                                  */
+/*                                                                           */
+/* Uses: fd - The client's socket                                            */
+/*                                                                           */
+/* Returns: void                                                             */
+/*                                                                           */
+/*****************************************************************************/
+
+static void i_serve(int fd)
+{
+
+  char request[SERM_REQUEST_LEN];  /* The request            */
+  char body[SERM_BODY_LEN];        /* The page of metrics    */
+  ssize_t got;                     /* Bytes read now         */
+  size_t used = 0;                 /* Bytes read so far      */
+  size_t length;                   /* Length of the page     */
+  struct timeval wait;             /* Longest wait on client */
+
+
+  wait.tv_sec = SERM_CLIENT_SECS;
+
+  wait.tv_usec = 0;
+
+  (void) setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &wait, sizeof(wait) );
+
+  (void) setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &wait, sizeof(wait) );
+
+  /* Read the request line and headers; only the path matters */
+  do
+  {
+
+    got = recv(fd, &request[used], sizeof(request) - 1 - used, 0);
+
+    if(got > 0)
+    {
+
+      used += (size_t) got;
+
+    }
+
+    request[used] = '\0';
+
+  } while( (got > 0) && (used < sizeof(request) - 1)
+    && (strstr(request, "\r\n\r\n") == NULL) );
+
+  if( (strncmp(request, "GET /metrics ", strlen("GET /metrics ") ) == 0)
+    || (strncmp(request, "GET / ", strlen("GET / ") ) == 0) )
+  {
+
+    length = i_make_page(body);
+
+    i_write_all(fd, i_REPLY_OK, strlen(i_REPLY_OK) );
+
+    i_write_all(fd, body, length);
+
+  }
+  else
+  {
+
+    i_write_all(fd, i_REPLY_NOT_FOUND, strlen(i_REPLY_NOT_FOUND) );
+
+  }
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: i_listener()                                                        */
+/*                                                                           */
+/* Description: The listener thread. Answers clients one at a time until     */
+/*              asked to stop.                                               */
+/*                                                                           */
+/* Uses: arg - Not used                                                      */
+/*                                                                           */
+/* Returns: NULL                                                             */
+/*                                                                           */
+/*****************************************************************************/
+
+static void *i_listener(void *arg)
+{
+
+  struct pollfd listen_poll;    /* Waiting for a client */
+  int client_fd;                /* The client's socket  */
+
+
+  (void) arg;
+
+  listen_poll.fd = i_listen_fd;
+
+  listen_poll.events = POLLIN;
+
+  while(atomic_load(&i_stopping) == false)
+  {
+
+    if(poll(&listen_poll, 1, SERM_POLL_MSEC) > 0)
+    {
+
+      client_fd = accept(i_listen_fd, NULL, NULL);
+
+      if(client_fd != i_SOCKET_FAIL)
+      {
+
+        i_serve(client_fd);
+
+        (void) close(client_fd);
+
+      }
+
+    }
+
+  }
+
+  return NULL;
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: i_open_socket()                                                     */
+/*                                                                           */
+/* Description: Open the listening socket, at localhost or a Unix socket     */
+/*                                                                           */
+/* Uses: address - TCP port number, or Unix socket path starting with '/'    */
+/*                                                                           */
+/* Returns: The socket, or i_SOCKET_FAIL                                     */
+/*                                                                           */
+/*****************************************************************************/
+
+static int i_open_socket(const char *address)
+{
+
+  int fd = i_SOCKET_FAIL;       /* The socket             */
+  long tcp_port;                /* TCP port number        */
+  char *end_ptr;                /* End of the port number */
+  int reuse = 1;                /* Allow quick restarts   */
+  struct sockaddr_in in_addr;   /* TCP address            */
+
+
+  i_made_socket = false;
+
+  if(address[0] == '/')
+  {
+
+    memset(&i_un_addr, 0, sizeof(i_un_addr) );
+
+    i_un_addr.sun_family = AF_UNIX;
+
+    if(strlen(address) < sizeof(i_un_addr.sun_path) )
+    {
+
+      (void) strcpy(i_un_addr.sun_path, address);
+
+      fd = socket(AF_UNIX, SOCK_STREAM, 0);
+
+      if(fd != i_SOCKET_FAIL)
+      {
+
+        if(bind(fd, (struct sockaddr *) &i_un_addr, sizeof(i_un_addr) ) == 0)
+        {
+
+          /* Only remove the socket if this made it */
+          i_made_socket = true;
+
+        }
+        else
+        {
+
+          (void) close(fd);
+
+          fd = i_SOCKET_FAIL;
+
+        }
+
+      }
+
+    }
+
+  }
+  else
+  {
+
+    tcp_port = strtol(address, &end_ptr, 10);
+
+    if( (end_ptr != address) && (*end_ptr == '\0') && (tcp_port > 0)
+      && (tcp_port <= (long) i_MAX_TCP_PORT) )
+    {
+
+      memset(&in_addr, 0, sizeof(in_addr) );
+
+      in_addr.sin_family = AF_INET;
+
+      in_addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+      in_addr.sin_port = htons( (uint16_t) tcp_port);
+
+      fd = socket(AF_INET, SOCK_STREAM, 0);
+
+      if(fd != i_SOCKET_FAIL)
+      {
+
+        (void) setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &reuse,
+          sizeof(reuse) );
+
+        if(bind(fd, (struct sockaddr *) &in_addr, sizeof(in_addr) ) != 0)
+        {
+
+          (void) close(fd);
+
+          fd = i_SOCKET_FAIL;
+
+        }
+
+      }
+
+    }
+
+  }
+
+  if( (fd != i_SOCKET_FAIL) && (listen(fd, SERM_BACKLOG) != 0) )
+  {
+
+    (void) close(fd);
+
+    fd = i_SOCKET_FAIL;
+
+    if(i_made_socket == true)
+    {
+
+      (void) unlink(i_un_addr.sun_path);
+
+      i_made_socket = false;
+
+    }
+
+  }
+
+  return fd;
+
+}
+
+
+/*****************************************************************************/
+/*      EXTERNAL VARIABLE DEFINITIONS                                        */
+/*****************************************************************************/
+
+
+/*****************************************************************************/
+/*      EXTERNAL FUNCTION DEFINITIONS                                        */
+/*****************************************************************************/
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: serm_start()                                                        */
+/*                                                                           */
+/* Description: Start the listener thread                                    */
+/*                                                                           */
+/* Internal functions used: i_escape_label(), i_open_socket(), i_listener()  */
+/*                                                                           */
+/* Internal variables used: i_listen_fd, i_made_socket, i_stopping,          */
+/*                          i_running, i_thread                              */
+/*                                                                           */
+/* Parameters:                                                               */
+/*   Name            Type           Comments                                 */
+/*   ------------    ------------   -----------------------------------      */
+/*   address         const char *   TCP port number, or Unix socket path     */
+/*   port_name       const char *   Serial port, given as the port label     */
+/*                                                                           */
+/* Returns: SERM_OK if the listener is running, else SERM_FAILURE            */
+/*                                                                           */
+/*****************************************************************************/
+
+extern serm_status_t serm_start(const char *address, const char *port_name)
+{
+
+  serm_status_t status = SERM_FAILURE;  /* Did the listener start? */
+
+
+  if(i_running == false)
+  {
+
+    i_escape_label(port_name);
+
+    i_listen_fd = i_open_socket(address);
+
+    if(i_listen_fd != i_SOCKET_FAIL)
+    {
+
+      atomic_store(&i_stopping, false);
+
+      if(pthread_create(&i_thread, NULL, i_listener, NULL) == 0)
+      {
+
+        i_running = true;
+
+        status = SERM_OK;
+
+      }
+      else
+      {
+
+        serm_stop();
+
+      }
+
+    }
+
+  }
+
+  return status;
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: serm_stop()                                                         */
+/*                                                                           */
+/* Description: Stop the listener thread, and remove its Unix socket         */
+/*                                                                           */
+/* Internal functions used:                                                  */
+/*                                                                           */
+/* Internal variables used: i_listen_fd, i_made_socket, i_stopping,          */
+/*                          i_running, i_thread                              */
+/*                                                                           */
+/* Parameters:                                                               */
+/*   Name            Type           Comments                                 */
+/*   ------------    ------------   -----------------------------------      */
+/*                                                                           */
+/* Returns: void                                                             */
+/*                                                                           */
+/*****************************************************************************/
+
+extern void serm_stop(void)
+{
+
+  if(i_running == true)
+  {
+
+    atomic_store(&i_stopping, true);
+
+    (void) pthread_join(i_thread, NULL);
+
+    i_running = false;
+
+  }
+
+  if(i_listen_fd != i_SOCKET_FAIL)
+  {
+
+    (void) close(i_listen_fd);
+
+    i_listen_fd = i_SOCKET_FAIL;
+
+  }
+
+  if(i_made_socket == true)
+  {
+
+    (void) unlink(i_un_addr.sun_path);
+
+    i_made_socket = false;
+
+  }
+
+}
@@ -0,0 +1,129 @@
+/*****************************************************************************/
+/*                                                                           */
+/* Module: serm.h                                                            */
+/*                                                                           */
+/* Description: Header file for serm.c                                       */
+/*                                                                           */
+/* Copyright (C) 2026 The Serbert contributors                               */
+/*                                                                           */
+/* This file is part of Serbert.                                             */
+/*                                                                           */
+/* Serbert is free software; you can redistribute it and/or modify           */
+/* it under the terms of the GNU General Public License as published by      */
+/* the Free Software Foundation; either version 2 of the License, or         */
+/* any later version.                                                        */
+/*                                                                           */
+/* This program is distributed in the hope that it will be useful,           */
+/* but WITHOUT ANY WARRANTY; without even the implied warranty of            */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             */
+/* GNU General Public License for more details.                              */
+/*                                                                           */
+/* You should have received a copy of the GNU General Public License         */
+/* along with this program; if not, write to the Free Software               */
+/* Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA */
+/*                                                                           */
+/*****************************************************************************/
+
+#ifndef SERM_H
+
+#define SERM_H
+
+/*****************************************************************************/
+/*      INCLUDED FILES (dependencies)                                        */
+/*****************************************************************************/
+
+
+/*****************************************************************************/
+/*      MACRO DEFINITIONS                                                    */
+/*****************************************************************************/
+
+/*****************************************************************************/
+/*  Name:                                                                    */
+/*  Description:                                                             */
+/*  Parameters:                                                              */
+/*****************************************************************************/
+
+
+/*****************************************************************************/
+/*      TYPE DEFINITIONS                                                     */
+/*****************************************************************************/
+
+/* Enums & constants */
+
+enum { SERM_BODY_LEN = 16384 };      /* Longest page of metrics              */
+
+enum { SERM_REQUEST_LEN = 1024 };    /* Longest request read                 */
+
+enum { SERM_LABEL_LEN = 512 };       /* Longest port label, once escaped     */
+
+enum { SERM_POLL_MSEC = 100 };       /* Listener stop check, in millisecs    */
+
+enum { SERM_CLIENT_SECS = 1 };       /* Longest wait on a client, in secs    */
+
+enum { SERM_BACKLOG = 4 };           /* Connections waiting to be accepted   */
+
+/* Status of starting the listener */
+typedef enum serm_status_t
+{
+  SERM_OK,                           /* Listener running                     */
+  SERM_FAILURE                       /* Listener could not be started        */
+} serm_status_t;
+
+
+/*****************************************************************************/
+/*      GLOBAL VARIABLES                                                     */
+/*****************************************************************************/
+
+
+/*****************************************************************************/
+/*      FUNCTION PROTOTYPES                                                  */
+/*****************************************************************************/
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: serm_start()                                                        */
+/*                                                                           */
+/* Description: Start the listener thread, which serves the counts from      */
+/*              seri_read() as Prometheus metrics over HTTP                  */
+/*                                                                           */
+/* Parameters:                                                               */
+/*   Name            Type           Comments                                 */
+/*   ------------    ------------  -----------------------------------       */
+/*   address         const char *  TCP port number to listen on at           */
+/*                                 localhost, or the path of a Unix socket   */
+/*   port_name       const char *  Serial port, given as the port label      */
+/*                                                                           */
+/* Returns: SERM_OK if the listener is running, else SERM_FAILURE            */
+/*                                                                           */
+/* Pre-conditions: Listener not running                                      */
+/*                                                                           */
+/* Post-conditions: Metrics served until serm_stop() is called               */
+/*                                                                           */
+/*****************************************************************************/
+
+extern serm_status_t serm_start(const char *address, const char *port_name);
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: serm_stop()                                                         */
+/*                                                                           */
+/* Description: Stop the listener thread, and remove its Unix socket         */
+/*                                                                           */
+/* Parameters:                                                               */
+/*   Name            Type           Comments                                 */
+/*   ------------    ------------  -----------------------------------       */
+/*                                                                           */
+/* Returns: void                                                             */
+/*                                                                           */
+/* Pre-conditions:                                                           */
+/*                                                                           */
+/* Post-conditions: Listener not running                                     */
+/*                                                                           */
+/*****************************************************************************/
+
+extern void serm_stop(void);
+
+
+#endif /* SERM_H */
+
@@ -0,0 +1,519 @@
+/*****************************************************************************/
+/*                                                                           */
+/* Module: sermon.c                                                          */
+/*                                                                           */
+/* Description: serbert-mon, lists serbert tests and their statistics        */
+/*                                                                           */
+/* Copyright (C) 2026 The Serbert contributors                               */
+/*                                                                           */
+/* This file is part of Serbert.                                             */
+/*                                                                           */
+/* Serbert is free software; you can redistribute it and/or modify           */
+/* it under the terms of the GNU General Public License as published by      */
+/* the Free Software Foundation; either version 2 of the License, or         */
+/* any later version.                                                        */
+/*                                                                           */
+/* This program is distributed in the hope that it will be useful,           */
+/* but WITHOUT ANY WARRANTY; without even the implied warranty of            */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             */
+/* GNU General Public License for more details.                              */
+/*                                                                           */
+/* You should have received a copy of the GNU General Public License         */
+/* along with this program; if not, write to the Free Software               */
+/* Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA */
+/*                                                                           */
+/*****************************************************************************/
+
+/*****************************************************************************/
+/*      INCLUDED FILES (dependencies)                                        */
+/*****************************************************************************/
+
+#include <stdio.h>       /* Standard I/O definitions - printf()            */
+#include <stdlib.h>      /* Standard library - strtoul()           */
+#include <string.h>      /* Standard string lib - strncmp(), strcmp()      */
+#include <stdbool.h>     /* Boolean types                                  */
+#include <errno.h>       /* Provides errno                                 */
+#include <limits.h>      /* Variable max sizes - NAME_MAX                  */
+#include <signal.h>      /* Signals - kill()                               */
+#include <time.h>        /* Time defs - clock_gettime(), nanosleep()       */
+#include <unistd.h>      /* UNIX standard - close()                        */
+#include <fcntl.h>       /* File control - open()                          */
+#include <dirent.h>      /* Directories - opendir(), readdir()             */
+#include <sys/stat.h>    /* File status - fstat()                          */
+#include <sys/mman.h>    /* Memory mapping - mmap()                        */
+#include "sers.h"        /* Serial statistics library                      */
+#include "serg.h"        /* Shared memory statistics library               */
+
+
+/*****************************************************************************/
+/*      INTERNAL TYPE DEFINITIONS                                            */
+/*****************************************************************************/
+
+/* Enums & constants */
+
+enum { i_EXIT_OK = 0 };              /* Exit status, all well                */
+
+enum { i_EXIT_FAULT = 1 };           /* Exit status, a fault                 */
+
+enum { i_MAX_TESTS = 256 };          /* Most tests remembered for rates      */
+
+enum { i_DEFAULT_SECS = 1 };         /* Default time between listings        */
+
+enum { i_MAX_SECS = 3600 };          /* Longest time between listings        */
+
+enum { i_OPEN_FAIL = -1 };           /* open() failure state                 */
+
+enum { i_NS_PER_SEC = 1000000000 };  /* Nanoseconds in a second              */
+
+enum { i_NS_PER_US = 1000 };         /* Nanoseconds in a microsecond         */
+
+/* Types */
+
+/* What was last seen of a test, for its rate */
+typedef struct i_seen_t
+{
+  long pid;                          /* Process publishing the test          */
+  unsigned long long bytes;          /* Bytes tested when seen               */
+  long long time;                    /* When seen, in nanoseconds            */
+} i_seen_t;
+
+
+/*****************************************************************************/
+/*      INTERNAL VARIABLE DEFINITIONS                                        */
+/*****************************************************************************/
+
+static i_seen_t i_seen[i_MAX_TESTS];      /* Tests seen in the last listing */
+
+static unsigned int i_seen_count;         /* Number of them                 */
+
+static i_seen_t i_now_seen[i_MAX_TESTS];  /* Tests seen in this listing     */
+
+static unsigned int i_now_seen_count;     /* Number of them                 */
+
+
+/*****************************************************************************/
+/*      INTERNAL FUNCTIONS                                                   */
+/*****************************************************************************/
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: i_get_time()                                                        */
+/*                                                                           */
+/* Description: Gets the monotonic time                                      */
+/*                                                                           */
+/* Uses: void                                                                */
+/*                                                                           */
+/* Returns: The time in nanoseconds                                          */
+/*                                                                           */
+/*****************************************************************************/
+
+static long long i_get_time(void)
+{
+
+  struct timespec now;                    /* The time now */
+
+
+  clock_gettime(CLOCK_MONOTONIC, &now);
+
+  return ( (long long) now.tv_sec * i_NS_PER_SEC) + now.tv_nsec;
+
+}
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: i_get_rate()                                                        */
+/*                                                                           */
+/* Description: Gets a test's byte rate since the last listing, and          */
+/*              remembers this sighting for the next                         */
+/*                                                                           */
+/* Uses: pid - The process publishing the test                               */
+/*       bytes - Bytes tested so far                                         */
+/*       now - The time now, in nanoseconds                                  */
+/*                                                                           */
+/* Returns: Bytes per second, or -1 if the test wasn't seen before          */
+/*                                                                           */
+/*****************************************************************************/
+
+static double i_get_rate(long pid, unsigned long long bytes, long long now)
+{
+
+  double rate = -1.0;                     /* Bytes per second */
+  unsigned int seen_no;                   /* Index into the last listing */
+
+
+  for(seen_no = 0; seen_no < i_seen_count; seen_no++)
+  {
+
+    if( (i_seen[seen_no].pid == pid) && (now > i_seen[seen_no].time)
+      && (bytes >= i_seen[seen_no].bytes) )
+    {
+
+      rate = (double) (bytes - i_seen[seen_no].bytes) * i_NS_PER_SEC
+        / (double) (now - i_seen[seen_no].time);
+
+    }
+
+  }
+
+  if(i_now_seen_count < i_MAX_TESTS)
+  {
+
+    i_now_seen[i_now_seen_count].pid = pid;
+
+    i_now_seen[i_now_seen_count].bytes = bytes;
+
+    i_now_seen[i_now_seen_count].time = now;
+
+    i_now_seen_count++;
+
+  }
+
+  return rate;
+
+}
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: i_get_state_str()                                                   */
+/*                                                                           */
+/* Description: Gets the state of a test as a string. A running test whose   */
+/*              process has gone was killed before it could say so.          */
+/*                                                                           */
+/* Uses: state - The state published                                         */
+/*       pid - The process publishing the test                               */
+/*                                                                           */
+/* Returns: The state string                                                 */
+/*                                                                           */
+/*****************************************************************************/
+
+static const char *i_get_state_str(serg_state_t state, long pid)
+{
+
+  const char *state_str = "running";      /* The state string */
+
+
+  if(state == SERG_FINISHED)
+  {
+
+    state_str = "finished";
+
+  }
+  else if( (kill( (pid_t) pid, 0) != 0) && (errno == ESRCH) )
+  {
+
+    state_str = "dead";
+
+  }
+
+  return state_str;
+
+}
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: i_print_test()                                                      */
+/*                                                                           */
+/* Description: Prints a line for a test from its segment                    */
+/*                                                                           */
+/* Uses: segment - The segment                                               */
+/*       now - The time now, in nanoseconds                                  */
+/*                                                                           */
+/* Returns: void                                                             */
+/*                                                                           */
+/*****************************************************************************/
+
+static void i_print_test(serg_segment_t *segment, long long now)
+{
+
+  serg_counts_t counts;                   /* The counts, read whole */
+  serg_state_t state;                     /* The state of the test */
+  sers_hist_t hist;                       /* Return times, for percentiles */
+  unsigned int bucket;                    /* Bucket being copied */
+  double rate;                            /* Bytes per second */
+  char port[SERG_PORT_LEN];               /* The port, terminated */
+
+
+  state = serg_read(segment, &counts);
+
+  sers_hist_init(&hist);
+
+  for(bucket = 0; bucket < SERS_HIST_BUCKETS; bucket++)
+  {
+
+    hist.count[bucket] = counts.latency[bucket];
+
+  }
+
+  hist.samples = counts.latency_count;
+
+  hist.max = counts.latency_max;
+
+  memcpy(port, segment->port, sizeof(port) );
+
+  port[sizeof(port) - 1] = '\0';
+
+  rate = i_get_rate( (long) segment->pid, counts.bytes, now);
+
+  printf("%7ld %-16s %7lu %12llu %9llu %9llu %9llu ", (long) segment->pid,
+    port, (unsigned long) segment->baud,
+    (unsigned long long) counts.bytes, (unsigned long long) counts.errors,
+    (unsigned long long) counts.timeouts,
+    (unsigned long long) counts.corrupts);
+
+  if(rate < 0.0)
+  {
+
+    printf("%9s ", "-");
+
+  }
+  else
+  {
+
+    printf("%9.0f ", rate);
+
+  }
+
+  printf("%9llu %9llu %s\n",
+    sers_hist_percentile(&hist, 50.0) / i_NS_PER_US,
+    sers_hist_percentile(&hist, 99.0) / i_NS_PER_US,
+    i_get_state_str(state, (long) segment->pid) );
+
+}
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: i_list_test()                                                       */
+/*                                                                           */
+/* Description: Maps a segment file and, if it is a serbert segment of this  */
+/*              version, prints a line for its test                          */
+/*                                                                           */
+/* Uses: name - The file name in SERG_DIR                                    */
+/*       now - The time now, in nanoseconds                                  */
+/*                                                                           */
+/* Returns: void                                                             */
+/*                                                                           */
+/*****************************************************************************/
+
+static void i_list_test(const char *name, long long now)
+{
+
+  char path[sizeof(SERG_DIR) + NAME_MAX + 1];
+                                          /* Path to the segment file */
+  int file;                               /* The segment file */
+  struct stat file_stat;                  /* Its size */
+  serg_segment_t *segment;                /* The segment, mapped */
+
+
+  snprintf(path, sizeof(path), "%s/%s", SERG_DIR, name);
+
+  file = open(path, O_RDONLY);
+
+  if(file != i_OPEN_FAIL)
+  {
+
+    if( (fstat(file, &file_stat) == 0)
+      && ( (size_t) file_stat.st_size >= sizeof(serg_segment_t) ) )
+    {
+
+      segment = mmap(NULL, sizeof(serg_segment_t), PROT_READ, MAP_SHARED,
+        file, 0);
+
+      if(segment != MAP_FAILED)
+      {
+
+        /* A segment being created has no magic number yet */
+        if( (atomic_load_explicit(&segment->magic, memory_order_acquire)
+          == SERG_MAGIC) && (segment->version == SERG_VERSION) )
+        {
+
+          i_print_test(segment, now);
+
+        }
+
+        munmap(segment, sizeof(serg_segment_t) );
+
+      }
+
+    }
+
+    close(file);
+
+  }
+
+}
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: i_list_tests()                                                      */
+/*                                                                           */
+/* Description: Prints a line for each test publishing a segment             */
+/*                                                                           */
+/* Uses: void                                                                */
+/*                                                                           */
+/* Returns: Exit status                                                      */
+/*                                                                           */
+/*****************************************************************************/
+
+static int i_list_tests(void)
+{
+
+  int exit_status = i_EXIT_OK;            /* Exit status */
+  DIR *dir;                               /* SERG_DIR */
+  struct dirent *entry;                   /* Entry in it */
+  long long now;                          /* The time of this listing */
+
+
+  dir = opendir(SERG_DIR);
+
+  if(dir == NULL)
+  {
+
+    fprintf(stderr, "Failure opening %s\n", SERG_DIR);
+
+    exit_status = i_EXIT_FAULT;
+
+  }
+  else
+  {
+
+    now = i_get_time();
+
+    i_now_seen_count = 0;
+
+    printf("%7s %-16s %7s %12s %9s %9s %9s %9s %9s %9s %s\n", "PID",
+      "PORT", "BAUD", "SENT", "ERRS", "TIMEOUTS", "CORRUPT", "BYTES/S",
+      "P50/us", "P99/us", "STATE");
+
+    while( (entry = readdir(dir) ) != NULL)
+    {
+
+      if(strncmp(entry->d_name, SERG_FILE_PREFIX,
+        strlen(SERG_FILE_PREFIX) ) == 0)
+      {
+
+        i_list_test(entry->d_name, now);
+
+      }
+
+    }
+
+    closedir(dir);
+
+    memcpy(i_seen, i_now_seen, sizeof(i_seen) );
+
+    i_seen_count = i_now_seen_count;
+
+    fflush(stdout);
+
+  }
+
+  return exit_status;
+
+}
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: i_print_help()                                                      */
+/*                                                                           */
+/* Description: Prints the usage                                             */
+/*                                                                           */
+/* Uses: void                                                                */
+/*                                                                           */
+/* Returns: void                                                             */
+/*                                                                           */
+/*****************************************************************************/
+
+static void i_print_help(void)
+{
+
+  printf("\nUsage: serbert-mon [-f] [SECS]\n\n");
+
+  printf("Lists the serbert tests run with -S and their statistics\n\n");
+
+  printf(" -f - Follow, listing again every SECS seconds    [1-%d]\n",
+    i_MAX_SECS);
+
+  printf(" -h - Print this help\n\n");
+
+}
+
+
+/*****************************************************************************/
+/*      MAIN                                                                 */
+/*****************************************************************************/
+
+int main(int argc, char *argv[])
+{
+
+  int exit_status = i_EXIT_OK;            /* Exit status */
+  bool follow = false;                    /* Listing again and again? */
+  bool help = false;                      /* Only printing the help? */
+  unsigned long secs = i_DEFAULT_SECS;    /* Time between listings */
+  char *end_ptr;                          /* End of the seconds */
+  int arg_no;                             /* Argument being processed */
+  struct timespec wait;                   /* Wait between listings */
+
+
+  for(arg_no = 1; (arg_no < argc) && (exit_status == i_EXIT_OK)
+    && (help == false); arg_no++)
+  {
+
+    if(strcmp(argv[arg_no], "-f") == 0)
+    {
+
+      follow = true;
+
+    }
+    else if(strcmp(argv[arg_no], "-h") == 0)
+    {
+
+      i_print_help();
+
+      help = true;
+
+    }
+    else
+    {
+
+      secs = strtoul(argv[arg_no], &end_ptr, 10);
+
+      if( (*end_ptr != '\0') || (secs < 1) || (secs > i_MAX_SECS) )
+      {
+
+        fprintf(stderr, "Invalid argument: %s\n", argv[arg_no]);
+
+        i_print_help();
+
+        exit_status = i_EXIT_FAULT;
+
+      }
+
+    }
+
+  }
+
+  if( (exit_status == i_EXIT_OK) && (help == false) )
+  {
+
+    exit_status = i_list_tests();
+
+    wait.tv_sec = (time_t) secs;
+
+    wait.tv_nsec = 0;
+
+    while( (follow == true) && (exit_status == i_EXIT_OK) )
+    {
+
+      nanosleep(&wait, NULL);
+
+      printf("\n");
+
+      exit_status = i_list_tests();
+
+    }
+
+  }
+
+  return exit_status;
+
+}
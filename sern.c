@@ -0,0 +1,679 @@
+/*****************************************************************************/
+/*                                                                           */
+/* Module: sern.c                                                            */
+/*                                                                           */
+/* Description: Telnet and RFC 2217 coding, for serial ports over TCP        */
+/*                                                                           */
+/* Copyright (C) 2026 The Serbert contributors                               */
+/*                                                                           */
+/* This file is part of Serbert.                                             */
+/*                                                                           */
+/* Serbert is free software; you can redistribute it and/or modify           */
+/* it under the terms of the GNU General Public License as published by      */
+/* the Free Software Foundation; either version 2 of the License, or         */
+/* any later version.                                                        */
+/*                                                                           */
+/* This program is distributed in the hope that it will be useful,           */
+/* but WITHOUT ANY WARRANTY; without even the implied warranty of            */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             */
+/* GNU General Public License for more details.                              */
+/*                                                                           */
+/* You should have received a copy of the GNU General Public License         */
+/* along with this program; if not, write to the Free Software               */
+/* Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA */
+/*                                                                           */
+/*****************************************************************************/
+
+/*****************************************************************************/
+/*      INCLUDED FILES (dependencies)                                        */
+/*****************************************************************************/
+
+#include <stdbool.h>     /* Boolean types                                  */
+#include <stdint.h>      /* Fixed size integers - uint8_t                  */
+#include <sys/types.h>   /* System types - ssize_t                         */
+#include <sys/socket.h>  /* Sockets - send()                               */
+#include "sern.h"        /* Header file for this library                   */
+
+
+/*****************************************************************************/
+/*      INTERNAL MACRO DEFINITIONS                                           */
+/*****************************************************************************/
+
+/*****************************************************************************/
+/*  Name:                                                                    */
+/*  Description:                                                             */
+/*  Parameters:                                                              */
+/*  Client functions:                                                        */
+/*****************************************************************************/
+
+
+/*****************************************************************************/
+/*      INTERNAL TYPE DEFINITIONS                                            */
+/*****************************************************************************/
+
+enum { i_COMMAND_LEN = 3 };          /* Bytes in IAC, a command and option   */
+
+enum { i_VALUE_LEN = 4 };            /* Most bytes in an RFC 2217 value      */
+
+enum { i_SUB_LEN = 6 + (2 * i_VALUE_LEN) };
+                                     /* Most bytes in a subnegotiation sent  */
+
+enum { i_LINE_COMMANDS = 4 };        /* Commands setting the line            */
+
+enum { i_BYTE_BITS = 8 };            /* Bits in a byte                       */
+
+
+/*****************************************************************************/
+/*      INTERNAL VARIABLE DEFINITIONS                                        */
+/*****************************************************************************/
+
+/* What a client offers when it connects */
+static const uint8_t i_OFFER[] =
+{
+  SERN_IAC, SERN_WILL, SERN_BINARY, SERN_IAC, SERN_DO, SERN_BINARY,
+  SERN_IAC, SERN_WILL, SERN_SGA, SERN_IAC, SERN_DO, SERN_SGA,
+  SERN_IAC, SERN_WILL, SERN_COM_PORT
+};
+
+
+/*****************************************************************************/
+/*      INTERNAL FUNCTION DEFINITIONS                                        */
+/*****************************************************************************/
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: i_send_all()                                                        */
+/*                                                                           */
+/* Description: Send bytes on a connection, all of them                      */
+/*                                                                           */
+/* Uses: fd - The connection                                                 */
+/*       bytes - The bytes                                                   */
+/*       len - Bytes to send                                                 */
+/*                                                                           */
+/* Returns: 0, or SERN_FAILURE                                               */
+/*                                                                           */
+/*****************************************************************************/
+
+static int i_send_all(int fd, const uint8_t *bytes, size_t len)
+{
+
+  int status = 0;        /* Were they all sent?  */
+  size_t sent = 0;       /* Bytes sent so far    */
+  ssize_t sent_now;      /* Bytes sent each time */
+
+
+  while( (sent < len) && (status == 0) )
+  {
+
+    sent_now = send(fd, bytes + sent, len - sent, MSG_NOSIGNAL);
+
+    if(sent_now > 0)
+    {
+
+      sent += (size_t) sent_now;
+
+    }
+    else
+    {
+
+      status = SERN_FAILURE;
+
+    }
+
+  }
+
+  return status;
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: i_is_known()                                                        */
+/*                                                                           */
+/* Description: Is an option one serbert uses?                               */
+/*                                                                           */
+/* Uses: option - The option                                                 */
+/*       role - Which end is answering                                       */
+/*       will - Is this end asked to use it, not to let the other end?       */
+/*                                                                           */
+/* Returns: true if the option is used                                       */
+/*                                                                           */
+/*****************************************************************************/
+
+static bool i_is_known(uint8_t option, sern_role_t role, bool will)
+{
+
+  bool known;            /* Is the option used? */
+
+
+  known = (option == (uint8_t) SERN_BINARY) || (option == (uint8_t) SERN_SGA);
+
+  /* Only the client uses com port control */
+  known = known || ( (option == (uint8_t) SERN_COM_PORT)
+    && (will == (role == SERN_CLIENT) ) );
+
+  return known;
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: i_answer()                                                          */
+/*                                                                           */
+/* Description: Answer a request to use an option. A server agrees to the    */
+/*              options serbert uses, as it can't start them itself. A       */
+/*              client has offered those already, so only refuses others.    */
+/*              Refusals are never answered, so nothing goes back and forth. */
+/*                                                                           */
+/* Uses: fd - The connection                                                 */
+/*       role - Which end is answering                                       */
+/*       command - WILL, WONT, DO or DONT                                    */
+/*       option - The option                                                 */
+/*                                                                           */
+/* Returns: void                                                             */
+/*                                                                           */
+/*****************************************************************************/
+
+static void i_answer(int fd, sern_role_t role, uint8_t command,
+  uint8_t option)
+{
+
+  uint8_t answer[i_COMMAND_LEN];     /* The answer            */
+  bool will;                         /* Asked to use, not let */
+  bool known;                        /* Is the option used?   */
+
+
+  will = (command == (uint8_t) SERN_DO);
+
+  if( (command == (uint8_t) SERN_WILL) || (command == (uint8_t) SERN_DO) )
+  {
+
+    known = i_is_known(option, role, will);
+
+    answer[0] = (uint8_t) SERN_IAC;
+
+    answer[2] = option;
+
+    if(known == false)
+    {
+
+      answer[1] = (uint8_t) ( (will == true) ? SERN_WONT : SERN_DONT);
+
+      (void) i_send_all(fd, answer, sizeof(answer) );
+
+    }
+    else if(role == SERN_SERVER)
+    {
+
+      answer[1] = (uint8_t) ( (will == true) ? SERN_WILL : SERN_DO);
+
+      (void) i_send_all(fd, answer, sizeof(answer) );
+
+    }
+
+  }
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: i_add_command()                                                     */
+/*                                                                           */
+/* Description: Add an RFC 2217 command to those to send                     */
+/*                                                                           */
+/* Uses: out - The bytes to send                                             */
+/*       len - Bytes to send so far                                          */
+/*       command - The command                                               */
+/*       value - Its value                                                   */
+/*       value_len - Bytes in the value                                      */
+/*                                                                           */
+/* Returns: Bytes to send now                                                */
+/*                                                                           */
+/*****************************************************************************/
+
+static size_t i_add_command(uint8_t *out, size_t len, uint8_t command,
+  const uint8_t *value, size_t value_len)
+{
+
+  out[len] = (uint8_t) SERN_IAC;
+
+  out[len + 1] = (uint8_t) SERN_SB;
+
+  out[len + 2] = (uint8_t) SERN_COM_PORT;
+
+  out[len + 3] = command;
+
+  len += 4;
+
+  len += sern_escape(value, value_len, out + len);
+
+  out[len] = (uint8_t) SERN_IAC;
+
+  out[len + 1] = (uint8_t) SERN_SE;
+
+  return len + 2;
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: i_answer_sub()                                                      */
+/*                                                                           */
+/* Description: Answer a subnegotiation. A server acknowledges RFC 2217      */
+/*              commands with the value asked for, as it has no port to      */
+/*              set; a client takes the acknowledgements without answering.  */
+/*                                                                           */
+/* Uses: fd - The connection                                                 */
+/*       role - Which end is answering                                       */
+/*       decoder - Holding the subnegotiation                                */
+/*                                                                           */
+/* Returns: void                                                             */
+/*                                                                           */
+/*****************************************************************************/
+
+static void i_answer_sub(int fd, sern_role_t role,
+  const sern_decoder_t *decoder)
+{
+
+  uint8_t answer[i_SUB_LEN];     /* The acknowledgement */
+  size_t value_len;              /* Bytes in the value  */
+  size_t len;                    /* Bytes to send       */
+
+
+  if( (role == SERN_SERVER) && (decoder->sub_len >= 2)
+    && (decoder->sub_len <= (size_t) SERN_SUB_LEN)
+    && (decoder->sub[0] == (uint8_t) SERN_COM_PORT)
+    && (decoder->sub[1] < (uint8_t) SERN_SERVER_REPLY) )
+  {
+
+    value_len = decoder->sub_len - 2;
+
+    value_len = (value_len > (size_t) i_VALUE_LEN)
+      ? (size_t) i_VALUE_LEN : value_len;
+
+    len = i_add_command(answer, 0,
+      (uint8_t) (decoder->sub[1] + SERN_SERVER_REPLY), decoder->sub + 2,
+      value_len);
+
+    (void) i_send_all(fd, answer, len);
+
+  }
+
+}
+
+
+/*****************************************************************************/
+/*      EXTERNAL FUNCTION DEFINITIONS                                        */
+/*****************************************************************************/
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: sern_reset()                                                        */
+/*                                                                           */
+/* Description: Start a decoder for a new connection                         */
+/*                                                                           */
+/* Internal functions used:                                                  */
+/*                                                                           */
+/* Internal variables used:                                                  */
+/*                                                                           */
+/* Parameters:                                                               */
+/*   Name            Type             Comments                               */
+/*   ------------    ------------     -----------------------------------    */
+/*   decoder         sern_decoder_t * The decoder                            */
+/*                                                                           */
+/* Returns: void                                                             */
+/*                                                                           */
+/*****************************************************************************/
+
+extern void sern_reset(sern_decoder_t *decoder)
+{
+
+  decoder->state = SERN_DATA;
+
+  decoder->command = 0;
+
+  decoder->sub_len = 0;
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: sern_decode()                                                       */
+/*                                                                           */
+/* Description: Take the data out of bytes received on a telnet connection,  */
+/*              answering the negotiation in them                            */
+/*                                                                           */
+/* Internal functions used: i_answer(), i_answer_sub()                       */
+/*                                                                           */
+/* Internal variables used:                                                  */
+/*                                                                           */
+/* Parameters:                                                               */
+/*   Name            Type             Comments                               */
+/*   ------------    ------------     -----------------------------------    */
+/*   decoder         sern_decoder_t * The connection's decoder               */
+/*   fd              int              The connection, for answers            */
+/*   role            sern_role_t      Which end is decoding                  */
+/*   in              const uint8_t *  The bytes received                     */
+/*   len             size_t           Bytes received                         */
+/*   data            uint8_t *        Where to put the data                  */
+/*                                                                           */
+/* Returns: Data bytes                                                       */
+/*                                                                           */
+/*****************************************************************************/
+
+extern size_t sern_decode(sern_decoder_t *decoder, int fd, sern_role_t role,
+  const uint8_t *in, size_t len, uint8_t *data)
+{
+
+  size_t data_len = 0;      /* Data bytes found   */
+  size_t in_no;             /* Byte being decoded */
+  uint8_t byte;             /* ... and its value  */
+
+
+  for(in_no = 0; in_no < len; in_no++)
+  {
+
+    byte = in[in_no];
+
+    switch(decoder->state)
+    {
+
+      case SERN_DATA:
+
+        if(byte == (uint8_t) SERN_IAC)
+        {
+
+          decoder->state = SERN_COMMAND;
+
+        }
+        else
+        {
+
+          data[data_len] = byte;
+
+          data_len++;
+
+        }
+
+        break;
+
+      case SERN_COMMAND:
+
+        /* Anything not understood, such as a go ahead, is skipped */
+        decoder->state = SERN_DATA;
+
+        if(byte == (uint8_t) SERN_IAC)
+        {
+
+          data[data_len] = byte;
+
+          data_len++;
+
+        }
+        else if(byte == (uint8_t) SERN_SB)
+        {
+
+          decoder->sub_len = 0;
+
+          decoder->state = SERN_SUB;
+
+        }
+        else if(byte >= (uint8_t) SERN_WILL)
+        {
+
+          decoder->command = byte;
+
+          decoder->state = SERN_OPTION;
+
+        }
+
+        break;
+
+      case SERN_OPTION:
+
+        i_answer(fd, role, decoder->command, byte);
+
+        decoder->state = SERN_DATA;
+
+        break;
+
+      case SERN_SUB:
+
+        if(byte == (uint8_t) SERN_IAC)
+        {
+
+          decoder->state = SERN_SUB_IAC;
+
+        }
+        else
+        {
+
+          if(decoder->sub_len < (size_t) SERN_SUB_LEN)
+          {
+
+            decoder->sub[decoder->sub_len] = byte;
+
+          }
+
+          decoder->sub_len++;
+
+        }
+
+        break;
+
+      case SERN_SUB_IAC:
+
+        decoder->state = SERN_SUB;
+
+        if(byte == (uint8_t) SERN_IAC)
+        {
+
+          if(decoder->sub_len < (size_t) SERN_SUB_LEN)
+          {
+
+            decoder->sub[decoder->sub_len] = byte;
+
+          }
+
+          decoder->sub_len++;
+
+        }
+        else
+        {
+
+          /* The end, or the end of a broken one */
+          if(byte == (uint8_t) SERN_SE)
+          {
+
+            i_answer_sub(fd, role, decoder);
+
+          }
+
+          decoder->state = SERN_DATA;
+
+        }
+
+        break;
+
+    }
+
+  }
+
+  return data_len;
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: sern_escape()                                                       */
+/*                                                                           */
+/* Description: Double each 0xFF in data to be sent                          */
+/*                                                                           */
+/* Internal functions used:                                                  */
+/*                                                                           */
+/* Internal variables used:                                                  */
+/*                                                                           */
+/* Parameters:                                                               */
+/*   Name            Type             Comments                               */
+/*   ------------    ------------     -----------------------------------    */
+/*   in              const uint8_t *  The data                               */
+/*   len             size_t           Data bytes                             */
+/*   out             uint8_t *        Where to put it                        */
+/*                                                                           */
+/* Returns: Bytes to send                                                    */
+/*                                                                           */
+/*****************************************************************************/
+
+extern size_t sern_escape(const uint8_t *in, size_t len, uint8_t *out)
+{
+
+  size_t out_len = 0;       /* Bytes to send   */
+  size_t in_no;             /* Byte being sent */
+
+
+  for(in_no = 0; in_no < len; in_no++)
+  {
+
+    out[out_len] = in[in_no];
+
+    out_len++;
+
+    if(in[in_no] == (uint8_t) SERN_IAC)
+    {
+
+      out[out_len] = in[in_no];
+
+      out_len++;
+
+    }
+
+  }
+
+  return out_len;
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: sern_offer()                                                        */
+/*                                                                           */
+/* Description: Offer binary data, suppress go ahead and com port control    */
+/*                                                                           */
+/* Internal functions used: i_send_all()                                     */
+/*                                                                           */
+/* Internal variables used: i_OFFER                                          */
+/*                                                                           */
+/* Parameters:                                                               */
+/*   Name            Type             Comments                               */
+/*   ------------    ------------     -----------------------------------    */
+/*   fd              int              The connection                         */
+/*                                                                           */
+/* Returns: 0, or SERN_FAILURE                                               */
+/*                                                                           */
+/*****************************************************************************/
+
+extern int sern_offer(int fd)
+{
+
+  return i_send_all(fd, i_OFFER, sizeof(i_OFFER) );
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: sern_set_line()                                                     */
+/*                                                                           */
+/* Description: Ask an RFC 2217 server to set the port's baud rate, data     */
+/*              bits, parity and stop bits                                   */
+/*                                                                           */
+/* Internal functions used: i_add_command(), i_send_all()                    */
+/*                                                                           */
+/* Internal variables used:                                                  */
+/*                                                                           */
+/* Parameters:                                                               */
+/*   Name            Type                Comments                            */
+/*   ------------    ------------        -----------------------------       */
+/*   fd              int                 The connection                      */
+/*   line            const sern_line_t * The settings                        */
+/*                                                                           */
+/* Returns: 0, or SERN_FAILURE                                               */
+/*                                                                           */
+/*****************************************************************************/
+
+extern int sern_set_line(int fd, const sern_line_t *line)
+{
+
+  uint8_t out[i_SUB_LEN * i_LINE_COMMANDS];   /* The commands      */
+  uint8_t value[i_VALUE_LEN];                 /* Each one's value  */
+  size_t len;                                 /* Bytes to send     */
+  int byte_no;                                /* Byte of the baud  */
+
+
+  /* The baud rate is sent big endian */
+  for(byte_no = 0; byte_no < i_VALUE_LEN; byte_no++)
+  {
+
+    value[byte_no] = (uint8_t) (line->baud
+      >> (i_BYTE_BITS * (i_VALUE_LEN - 1 - byte_no) ) );
+
+  }
+
+  len = i_add_command(out, 0, (uint8_t) SERN_SET_BAUDRATE, value,
+    (size_t) i_VALUE_LEN);
+
+  len = i_add_command(out, len, (uint8_t) SERN_SET_DATASIZE,
+    &line->data_bits, 1);
+
+  value[0] = (uint8_t) line->parity;
+
+  len = i_add_command(out, len, (uint8_t) SERN_SET_PARITY, value, 1);
+
+  len = i_add_command(out, len, (uint8_t) SERN_SET_STOPSIZE,
+    &line->stop_bits, 1);
+
+  return i_send_all(fd, out, len);
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: sern_purge()                                                        */
+/*                                                                           */
+/* Description: Ask an RFC 2217 server to throw away the bytes waiting in    */
+/*              the port, both ways                                          */
+/*                                                                           */
+/* Internal functions used: i_add_command(), i_send_all()                    */
+/*                                                                           */
+/* Internal variables used:                                                  */
+/*                                                                           */
+/* Parameters:                                                               */
+/*   Name            Type             Comments                               */
+/*   ------------    ------------     -----------------------------------    */
+/*   fd              int              The connection                         */
+/*                                                                           */
+/* Returns: 0, or SERN_FAILURE                                               */
+/*                                                                           */
+/*****************************************************************************/
+
+extern int sern_purge(int fd)
+{
+
+  uint8_t out[i_SUB_LEN];                  /* The command    */
+  const uint8_t value = SERN_PURGE_BOTH;   /* Both buffers   */
+  size_t len;                              /* Bytes to send  */
+
+
+  len = i_add_command(out, 0, (uint8_t) SERN_PURGE_DATA, &value, 1);
+
+  return i_send_all(fd, out, len);
+
+}
@@ -0,0 +1,296 @@
+/*****************************************************************************/
+/*                                                                           */
+/* Module: sern.h                                                            */
+/*                                                                           */
+/* Description: Header file for sern.c                                       */
+/*                                                                           */
+/* Copyright (C) 2026 The Serbert contributors                               */
+/*                                                                           */
+/* This file is part of Serbert.                                             */
+/*                                                                           */
+/* Serbert is free software; you can redistribute it and/or modify           */
+/* it under the terms of the GNU General Public License as published by      */
+/* the Free Software Foundation; either version 2 of the License, or         */
+/* any later version.                                                        */
+/*                                                                           */
+/* This program is distributed in the hope that it will be useful,           */
+/* but WITHOUT ANY WARRANTY; without even the implied warranty of            */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             */
+/* GNU General Public License for more details.                              */
+/*                                                                           */
+/* You should have received a copy of the GNU General Public License         */
+/* along with this program; if not, write to the Free Software               */
+/* Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA */
+/*                                                                           */
+/*****************************************************************************/
+
+#ifndef SERN_H
+
+#define SERN_H
+
+/*****************************************************************************/
+/*      INCLUDED FILES (dependencies)                                        */
+/*****************************************************************************/
+
+#include <stddef.h>      /* Standard definitions - size_t                  */
+#include <stdint.h>      /* Fixed size integers - uint8_t                  */
+
+
+/*****************************************************************************/
+/*      MACRO DEFINITIONS                                                    */
+/*****************************************************************************/
+
+/*****************************************************************************/
+/*  Name:                                                                    */
+/*  Description:                                                             */
+/*  Parameters:                                                              */
+/*****************************************************************************/
+
+
+/*****************************************************************************/
+/*      TYPE DEFINITIONS                                                     */
+/*****************************************************************************/
+
+/* Enums & constants */
+
+enum { SERN_FAILURE = -1 };          /* Returned by a failed operation       */
+
+enum { SERN_SUB_LEN = 16 };          /* Most bytes kept of a subnegotiation  */
+
+/* Telnet commands, RFC 854 */
+enum
+{
+  SERN_SE = 240,                     /* End of subnegotiation                */
+  SERN_SB = 250,                     /* Start of subnegotiation              */
+  SERN_WILL = 251,                   /* Sender will use an option            */
+  SERN_WONT = 252,                   /* Sender won't use an option           */
+  SERN_DO = 253,                     /* Sender asks for an option            */
+  SERN_DONT = 254,                   /* Sender refuses an option             */
+  SERN_IAC = 255                     /* Interpret as command, or a 0xFF byte */
+};
+
+/* Telnet options */
+enum
+{
+  SERN_BINARY = 0,                   /* 8 bit data, RFC 856                  */
+  SERN_SGA = 3,                      /* Suppress go ahead, RFC 858           */
+  SERN_COM_PORT = 44                 /* Com port control, RFC 2217           */
+};
+
+/* RFC 2217 commands, from the client. The server's replies add 100 */
+enum
+{
+  SERN_SET_BAUDRATE = 1,             /* Baud rate, 4 bytes big endian        */
+  SERN_SET_DATASIZE = 2,             /* Data bits, 5 to 8                    */
+  SERN_SET_PARITY = 3,               /* Parity, as sern_parity_t             */
+  SERN_SET_STOPSIZE = 4,             /* Stop bits, 1 or 2                    */
+  SERN_PURGE_DATA = 12,              /* Buffers to throw away, 3 for both    */
+  SERN_SERVER_REPLY = 100            /* Added to a command by the server     */
+};
+
+/* RFC 2217 parity values */
+typedef enum sern_parity_t
+{
+  SERN_PARITY_ASK = 0,               /* No change, ask for the current value */
+  SERN_PARITY_NONE = 1,              /* No parity bit                        */
+  SERN_PARITY_ODD = 2,               /* Odd parity                           */
+  SERN_PARITY_EVEN = 3               /* Even parity                          */
+} sern_parity_t;
+
+enum { SERN_PURGE_BOTH = 3 };        /* Purge the receive and send buffers   */
+
+/* Which end of the connection is decoding */
+typedef enum sern_role_t
+{
+  SERN_CLIENT,                       /* Serbert, controlling the port        */
+  SERN_SERVER                        /* The device server, or a stand-in     */
+} sern_role_t;
+
+/* Where the decoder is up to in the byte stream */
+typedef enum sern_state_t
+{
+  SERN_DATA,                         /* Data bytes                           */
+  SERN_COMMAND,                      /* After IAC                            */
+  SERN_OPTION,                       /* After IAC WILL, WONT, DO or DONT     */
+  SERN_SUB,                          /* Inside a subnegotiation              */
+  SERN_SUB_IAC                       /* After IAC inside a subnegotiation    */
+} sern_state_t;
+
+/* A telnet decoder, one for each end of a connection */
+typedef struct sern_decoder_t
+{
+  sern_state_t state;                /* Where it is up to                    */
+  uint8_t command;                   /* WILL, WONT, DO or DONT being decoded */
+  uint8_t sub[SERN_SUB_LEN];         /* The subnegotiation so far            */
+  size_t sub_len;                    /* Bytes in it, not all kept if long    */
+} sern_decoder_t;
+
+/* A port's line settings, to send with RFC 2217 */
+typedef struct sern_line_t
+{
+  unsigned long baud;                /* Baud rate, 0 for no change           */
+  uint8_t data_bits;                 /* Data bits, 5 to 8, 0 for no change   */
+  sern_parity_t parity;              /* Parity                               */
+  uint8_t stop_bits;                 /* Stop bits, 1 or 2, 0 for no change   */
+} sern_line_t;
+
+
+/*****************************************************************************/
+/*      GLOBAL VARIABLES                                                     */
+/*****************************************************************************/
+
+
+/*****************************************************************************/
+/*      FUNCTION PROTOTYPES                                                  */
+/*****************************************************************************/
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: sern_reset()                                                        */
+/*                                                                           */
+/* Description: Start a decoder for a new connection                         */
+/*                                                                           */
+/* Parameters:                                                               */
+/*   Name            Type             Comments                               */
+/*   ------------    ------------     -----------------------------------    */
+/*   decoder         sern_decoder_t * The decoder                            */
+/*                                                                           */
+/* Returns: void                                                             */
+/*                                                                           */
+/* Pre-conditions:                                                           */
+/*                                                                           */
+/* Post-conditions: The decoder expects data                                 */
+/*                                                                           */
+/*****************************************************************************/
+
+extern void sern_reset(sern_decoder_t *decoder);
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: sern_decode()                                                       */
+/*                                                                           */
+/* Description: Take the data out of bytes received on a telnet connection,  */
+/*              answering the negotiation in them. A client refuses options  */
+/*              it didn't offer; a server takes binary, suppress go ahead    */
+/*              and com port control, and acknowledges RFC 2217 commands.    */
+/*                                                                           */
+/* Parameters:                                                               */
+/*   Name            Type             Comments                               */
+/*   ------------    ------------     -----------------------------------    */
+/*   decoder         sern_decoder_t * The connection's decoder               */
+/*   fd              int              The connection, for answers            */
+/*   role            sern_role_t      Which end is decoding                  */
+/*   in              const uint8_t *  The bytes received                     */
+/*   len             size_t           Bytes received                         */
+/*   data            uint8_t *        Where to put the data, which may be in */
+/*                                    as it is never longer                  */
+/*                                                                           */
+/* Returns: Data bytes                                                       */
+/*                                                                           */
+/* Pre-conditions: Decoder reset for the connection                          */
+/*                                                                           */
+/* Post-conditions: Negotiation answered                                     */
+/*                                                                           */
+/*****************************************************************************/
+
+extern size_t sern_decode(sern_decoder_t *decoder, int fd, sern_role_t role,
+  const uint8_t *in, size_t len, uint8_t *data);
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: sern_escape()                                                       */
+/*                                                                           */
+/* Description: Double each 0xFF in data to be sent, so it isn't taken as a  */
+/*              command                                                      */
+/*                                                                           */
+/* Parameters:                                                               */
+/*   Name            Type             Comments                               */
+/*   ------------    ------------     -----------------------------------    */
+/*   in              const uint8_t *  The data                               */
+/*   len             size_t           Data bytes                             */
+/*   out             uint8_t *        Where to put it, room for 2 * len      */
+/*                                                                           */
+/* Returns: Bytes to send                                                    */
+/*                                                                           */
+/* Pre-conditions:                                                           */
+/*                                                                           */
+/* Post-conditions:                                                          */
+/*                                                                           */
+/*****************************************************************************/
+
+extern size_t sern_escape(const uint8_t *in, size_t len, uint8_t *out);
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: sern_offer()                                                        */
+/*                                                                           */
+/* Description: Offer binary data, suppress go ahead and com port control,   */
+/*              as a client opening an RFC 2217 connection                   */
+/*                                                                           */
+/* Parameters:                                                               */
+/*   Name            Type             Comments                               */
+/*   ------------    ------------     -----------------------------------    */
+/*   fd              int              The connection                         */
+/*                                                                           */
+/* Returns: 0, or SERN_FAILURE                                               */
+/*                                                                           */
+/* Pre-conditions: Connected                                                 */
+/*                                                                           */
+/* Post-conditions: The server's answers are taken by sern_decode()          */
+/*                                                                           */
+/*****************************************************************************/
+
+extern int sern_offer(int fd);
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: sern_set_line()                                                     */
+/*                                                                           */
+/* Description: Ask an RFC 2217 server to set the port's baud rate, data     */
+/*              bits, parity and stop bits, all in one send                  */
+/*                                                                           */
+/* Parameters:                                                               */
+/*   Name            Type                Comments                            */
+/*   ------------    ------------        -----------------------------       */
+/*   fd              int                 The connection                      */
+/*   line            const sern_line_t * The settings                        */
+/*                                                                           */
+/* Returns: 0, or SERN_FAILURE                                               */
+/*                                                                           */
+/* Pre-conditions: Com port control offered                                  */
+/*                                                                           */
+/* Post-conditions:                                                          */
+/*                                                                           */
+/*****************************************************************************/
+
+extern int sern_set_line(int fd, const sern_line_t *line);
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: sern_purge()                                                        */
+/*                                                                           */
+/* Description: Ask an RFC 2217 server to throw away the bytes waiting in    */
+/*              the port, both ways                                          */
+/*                                                                           */
+/* Parameters:                                                               */
+/*   Name            Type             Comments                               */
+/*   ------------    ------------     -----------------------------------    */
+/*   fd              int              The connection                         */
+/*                                                                           */
+/* Returns: 0, or SERN_FAILURE                                               */
+/*                                                                           */
+/* Pre-conditions: Com port control offered                                  */
+/*                                                                           */
+/* Post-conditions:                                                          */
+/*                                                                           */
+/*****************************************************************************/
+
+extern int sern_purge(int fd);
+
+
+#endif /* SERN_H */
@@ -0,0 +1,744 @@
+/*****************************************************************************/
+/*                                                                           */
+/* Module: sero.c                                                            */
+/*                                                                           */
+/* Description: Machine readable output for serial Bit Error Rate Tests      */
+/*                                                                           */
+/* Copyright (C) 2026 The Serbert contributors                               */
+/*                                                                           */
+/* This file is part of Serbert.                                             */
+/*                                                                           */
+/* Serbert is free software; you can redistribute it and/or modify           */
+/* it under the terms of the GNU General Public License as published by      */
+/* the Free Software Foundation; either version 2 of the License, or         */
+/* any later version.                                                        */
+/*                                                                           */
+/* This program is distributed in the hope that it will be useful,           */
+/* but WITHOUT ANY WARRANTY; without even the implied warranty of            */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             */
+/* GNU General Public License for more details.                              */
+/*                                                                           */
+/* You should have received a copy of the GNU General Public License         */
+/* along with this program; if not, write to the Free Software               */
+/* Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA */
+/*                                                                           */
+/*****************************************************************************/
+
+
+/*****************************************************************************/
+/*      INCLUDED FILES (dependencies)                                        */
+/*****************************************************************************/
+
+#include <stdio.h>       /* Standard I/O definitions - fopen(), fprintf()  */
+#include <string.h>      /* Standard string lib - strcmp()                 */
+#include <stdbool.h>     /* Boolean types                                  */
+#include <pthread.h>     /* Threads - pthread_create(), pthread_mutex_t    */
+#include <time.h>        /* Time defs - clock_gettime(), nanosleep()       */
+#include <unistd.h>      /* UNIX standard - dup(), dup2()                  */
+#include "sers.h"        /* Serial statistics library - SERS_NSEC_IN_SEC   */
+#include "sero.h"        /* Header file for this library                   */
+
+
+/*****************************************************************************/
+/*      INTERNAL MACRO DEFINITIONS                                           */
+/*****************************************************************************/
+
+/*****************************************************************************/
+/*  Name:                                                                    */
+/*  Description:                                                             */
+/*  Parameters:                                                              */
+/*  Client functions:                                                        */
+/*****************************************************************************/
+
+
+/*****************************************************************************/
+/*      INTERNAL TYPE DEFINITIONS                                            */
+/*****************************************************************************/
+
+/* The fields a record can have, in the order they're written */
+typedef enum i_column_t
+{
+  i_COL_TYPE,
+  i_COL_TIME,
+  i_COL_NUMBER,
+  i_COL_ELAPSED,
+  i_COL_SPAN,
+  i_COL_KIND,
+  i_COL_TX,
+  i_COL_RX,
+  i_COL_BYTES,
+  i_COL_ERRORS,
+  i_COL_TIMEOUTS,
+  i_COL_CORRUPTS,
+  i_COL_P50,
+  i_COL_P99,
+  i_COL_MAX,
+  i_COL_TOTAL_BYTES,
+  i_COL_TOTAL_ERRORS,
+  i_COL_TOTAL_TIMEOUTS,
+  i_COL_DROPPED,
+  i_COLUMNS
+} i_column_t;
+
+enum { i_FIELD_LEN = 24 };           /* Longest field, as text               */
+
+
+/*****************************************************************************/
+/*      INTERNAL VARIABLE DEFINITIONS                                        */
+/*****************************************************************************/
+
+/* Names of the fields, in i_column_t order */
+static const char *i_COLUMN_NAMES[i_COLUMNS] =
+  { "type", "time_ns", "number", "elapsed_ns", "span_ns", "kind", "tx", "rx",
+    "bytes", "errors", "timeouts", "corrupts", "p50_ns", "p99_ns", "max_ns",
+    "total_bytes", "total_errors", "total_timeouts", "dropped" };
+
+/* Names of the types of record, in sero_type_t order */
+static const char *i_TYPE_NAMES[] = { "interval", "error", "summary" };
+
+/* Names of the kinds of error, in sero_kind_t order */
+static const char *i_KIND_NAMES[] = { "framing", "corrupt", "timeout" };
+
+/* Records are queued by the test and the interval timer, and written by   */
+/* the writer. The lock is only held to copy a record in or out, never     */
+/* while writing, so a slow file can't hold up the test.                   */
+static sero_record_t i_ring[SERO_RING_LEN];   /* The queued records         */
+
+static unsigned int i_head;                   /* Next record to queue       */
+
+static unsigned int i_tail;                   /* Next record to write       */
+
+static unsigned long long i_dropped;          /* Records the queue had no   */
+                                              /* room for                   */
+
+static bool i_stopping;                       /* Writer asked to stop       */
+
+static pthread_mutex_t i_mutex = PTHREAD_MUTEX_INITIALIZER;
+                                              /* Guards the queue           */
+
+static bool i_open = false;                   /* Output open                */
+
+static pthread_t i_thread;                    /* The writer thread          */
+
+static FILE *i_file;                          /* The output                 */
+
+static FILE *i_stdout = NULL;                 /* Stdout kept for the records*/
+
+static sero_format_t i_format;                /* Format to write in         */
+
+static long long i_start;                     /* When the output was opened */
+
+
+/*****************************************************************************/
+/*      INTERNAL FUNCTION DEFINITIONS                                        */
+/*****************************************************************************/
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: i_wall_time()                                                       */
+/*                                                                           */
+/* Description: Gets the time from the wall clock                            */
+/*                                                                           */
+/* Uses: void                                                                */
+/*                                                                           */
+/* Returns: The time in nanoseconds since the epoch                          */
+/*                                                                           */
+/*****************************************************************************/
+
+static long long i_wall_time(void)
+{
+
+  struct timespec time_now;     /* The current time */
+
+
+  (void) clock_gettime(CLOCK_REALTIME, &time_now);
+
+  return ( (long long) time_now.tv_sec * SERS_NSEC_IN_SEC) +
+    (long long) time_now.tv_nsec;
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: i_set_num()                                                         */
+/*                                                                           */
+/* Description: Set a field to a count                                       */
+/*                                                                           */
+/* Uses: field - The field                                                   */
+/*       value - The count                                                   */
+/*                                                                           */
+/* Returns: void                                                             */
+/*                                                                           */
+/*****************************************************************************/
+
+static void i_set_num(char *field, unsigned long long value)
+{
+
+  (void) snprintf(field, i_FIELD_LEN, "%llu", value);
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: i_set_signed()                                                      */
+/*                                                                           */
+/* Description: Set a field to a time or byte, unless it isn't known         */
+/*                                                                           */
+/* Uses: field - The field                                                   */
+/*       value - The time or byte, or SERO_NONE                              */
+/*                                                                           */
+/* Returns: void                                                             */
+/*                                                                           */
+/*****************************************************************************/
+
+static void i_set_signed(char *field, long long value)
+{
+
+  if(value != (long long) SERO_NONE)
+  {
+
+    (void) snprintf(field, i_FIELD_LEN, "%lld", value);
+
+  }
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: i_write_record()                                                    */
+/*                                                                           */
+/* Description: Write out a record, with the fields its type uses            */
+/*                                                                           */
+/* Uses: record  - The record                                                */
+/*       dropped - Records dropped, for a summary                            */
+/*                                                                           */
+/* Returns: void                                                             */
+/*                                                                           */
+/*****************************************************************************/
+
+static void i_write_record(const sero_record_t *record,
+  unsigned long long dropped)
+{
+
+  char fields[i_COLUMNS][i_FIELD_LEN];  /* The fields, empty if not used */
+  unsigned int column;                  /* The current field             */
+  bool first = true;                    /* First field written?          */
+  bool quote;                           /* Is the field text?            */
+
+
+  for(column = 0; column < (unsigned int) i_COLUMNS; column++)
+  {
+
+    fields[column][0] = '\0';
+
+  }
+
+  (void) snprintf(fields[i_COL_TYPE], i_FIELD_LEN, "%s",
+    i_TYPE_NAMES[record->type]);
+
+  i_set_signed(fields[i_COL_TIME], record->time);
+
+  i_set_signed(fields[i_COL_ELAPSED], record->elapsed);
+
+  switch (record->type)
+  {
+
+    case SERO_INTERVAL:
+
+      i_set_num(fields[i_COL_NUMBER], record->number);
+
+      i_set_signed(fields[i_COL_SPAN], record->span);
+
+      i_set_num(fields[i_COL_BYTES], record->bytes);
+
+      i_set_num(fields[i_COL_ERRORS], record->errors);
+
+      i_set_num(fields[i_COL_TIMEOUTS], record->timeouts);
+
+      i_set_signed(fields[i_COL_P50], record->p50);
+
+      i_set_signed(fields[i_COL_P99], record->p99);
+
+      i_set_signed(fields[i_COL_MAX], record->max);
+
+      i_set_num(fields[i_COL_TOTAL_BYTES], record->total_bytes);
+
+      i_set_num(fields[i_COL_TOTAL_ERRORS], record->total_errors);
+
+      i_set_num(fields[i_COL_TOTAL_TIMEOUTS], record->total_timeouts);
+
+      break;
+
+    case SERO_ERROR:
+
+      (void) snprintf(fields[i_COL_KIND], i_FIELD_LEN, "%s",
+        i_KIND_NAMES[record->kind]);
+
+      i_set_signed(fields[i_COL_TX], record->tx);
+
+      i_set_signed(fields[i_COL_RX], record->rx);
+
+      i_set_num(fields[i_COL_BYTES], record->bytes);
+
+      break;
+
+    default:
+
+      i_set_num(fields[i_COL_BYTES], record->bytes);
+
+      i_set_num(fields[i_COL_ERRORS], record->errors);
+
+      i_set_num(fields[i_COL_TIMEOUTS], record->timeouts);
+
+      i_set_num(fields[i_COL_CORRUPTS], record->corrupts);
+
+      i_set_signed(fields[i_COL_P50], record->p50);
+
+      i_set_signed(fields[i_COL_P99], record->p99);
+
+      i_set_signed(fields[i_COL_MAX], record->max);
+
+      i_set_num(fields[i_COL_DROPPED], dropped);
+
+      break;
+
+  } /* End switch() */
+
+  if(i_format == SERO_CSV)
+  {
+
+    for(column = 0; column < (unsigned int) i_COLUMNS; column++)
+    {
+
+      fprintf(i_file, "%s%s", (column == 0) ? "" : ",", fields[column]);
+
+    }
+
+  }
+  else
+  {
+
+    fputc('{', i_file);
+
+    for(column = 0; column < (unsigned int) i_COLUMNS; column++)
+    {
+
+      /* Leave out the fields that aren't used */
+      if(fields[column][0] != '\0')
+      {
+
+        quote = ( (column == (unsigned int) i_COL_TYPE) ||
+          (column == (unsigned int) i_COL_KIND) );
+
+        fprintf(i_file, "%s\"%s\":%s%s%s", (first == true) ? "" : ",",
+          i_COLUMN_NAMES[column], (quote == true) ? "\"" : "",
+          fields[column], (quote == true) ? "\"" : "");
+
+        first = false;
+
+      }
+
+    }
+
+    fputc('}', i_file);
+
+  }
+
+  fputc('\n', i_file);
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: i_writer()                                                          */
+/*                                                                           */
+/* Description: The writer thread. Takes records off the queue and writes    */
+/*              them until asked to stop and the queue is empty.             */
+/*                                                                           */
+/* Uses: arg - Not used                                                      */
+/*                                                                           */
+/* Returns: NULL                                                             */
+/*                                                                           */
+/*****************************************************************************/
+
+static void *i_writer(void *arg)
+{
+
+  sero_record_t record;         /* The record being written        */
+  bool got_one;                 /* Was there a record on the queue? */
+  bool wrote_some = false;      /* Written any since the last flush */
+  bool stopping = false;        /* Asked to stop?                  */
+  struct timespec pause;        /* How long to wait when idle      */
+
+
+  (void) arg;
+
+  pause.tv_sec = 0;
+
+  pause.tv_nsec = SERO_POLL_NSEC;
+
+  do
+  {
+
+    (void) pthread_mutex_lock(&i_mutex);
+
+    got_one = (i_head != i_tail);
+
+    if(got_one == true)
+    {
+
+      record = i_ring[i_tail % SERO_RING_LEN];
+
+      i_tail++;
+
+    }
+    else
+    {
+
+      stopping = i_stopping;
+
+    }
+
+    (void) pthread_mutex_unlock(&i_mutex);
+
+    if(got_one == true)
+    {
+
+      i_write_record(&record, 0);
+
+      wrote_some = true;
+
+    }
+    else
+    {
+
+      /* Let readers of the output see what's been written so far */
+      if(wrote_some == true)
+      {
+
+        (void) fflush(i_file);
+
+        wrote_some = false;
+
+      }
+
+      if(stopping == false)
+      {
+
+        (void) nanosleep(&pause, NULL);
+
+      }
+
+    }
+
+  } while( (got_one == true) || (stopping == false) );
+
+  return NULL;
+
+}
+
+
+/*****************************************************************************/
+/*      EXTERNAL VARIABLE DEFINITIONS                                        */
+/*****************************************************************************/
+
+
+/*****************************************************************************/
+/*      EXTERNAL FUNCTION DEFINITIONS                                        */
+/*****************************************************************************/
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: sero_keep_stdout()                                                  */
+/*                                                                           */
+/* Description: Keep stdout for the records, so they can be piped to another */
+/*              program. The records get a copy of it, and stdout itself is  */
+/*              pointed at stderr, so everything else printed goes there.    */
+/*                                                                           */
+/* Internal functions used:                                                  */
+/*                                                                           */
+/* Internal variables used: i_stdout                                         */
+/*                                                                           */
+/* Parameters: void                                                          */
+/*                                                                           */
+/* Returns: SERO_OK if stdout was kept, else SERO_FAILURE                    */
+/*                                                                           */
+/*****************************************************************************/
+
+extern sero_status_t sero_keep_stdout(void)
+{
+
+  sero_status_t status = SERO_FAILURE;  /* Was stdout kept?      */
+  int fd;                               /* The copy of stdout    */
+
+
+  /* Anything already printed belongs on stdout */
+  (void) fflush(stdout);
+
+  fd = dup(STDOUT_FILENO);
+
+  if(fd >= 0)
+  {
+
+    i_stdout = fdopen(fd, "w");
+
+    if(i_stdout == NULL)
+    {
+
+      (void) close(fd);
+
+    }
+    else if(dup2(STDERR_FILENO, STDOUT_FILENO) < 0)
+    {
+
+      (void) fclose(i_stdout);
+
+      i_stdout = NULL;
+
+    }
+    else
+    {
+
+      status = SERO_OK;
+
+    }
+
+  }
+
+  return status;
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: sero_open()                                                         */
+/*                                                                           */
+/* Description: Open the output and start the writer thread                  */
+/*                                                                           */
+/* Internal functions used: i_wall_time(), i_writer()                        */
+/*                                                                           */
+/* Internal variables used: i_head, i_tail, i_dropped, i_stopping, i_open,   */
+/*                          i_thread, i_file, i_stdout, i_format, i_start    */
+/*                                                                           */
+/* Parameters:                                                               */
+/*   Name            Type           Comments                                 */
+/*   ------------    ------------   -----------------------------------      */
+/*   path            const char *   File to write, or "-" for the stdout     */
+/*                                  kept by sero_keep_stdout()               */
+/*   format          sero_format_t  Format to write the records in           */
+/*                                                                           */
+/* Returns: SERO_OK if the output is open, else SERO_FAILURE                 */
+/*                                                                           */
+/*****************************************************************************/
+
+extern sero_status_t sero_open(const char *path, sero_format_t format)
+{
+
+  sero_status_t status = SERO_FAILURE;  /* Did the output open?   */
+  unsigned int column;                  /* The current CSV column */
+
+
+  if(i_open == false)
+  {
+
+    if(strcmp(path, "-") == 0)
+    {
+
+      i_file = i_stdout;
+
+      i_stdout = NULL;
+
+    }
+    else
+    {
+
+      i_file = fopen(path, "w");
+
+    }
+
+    if(i_file != NULL)
+    {
+
+      /* Buffer plenty, so the writer seldom waits on the file */
+      (void) setvbuf(i_file, NULL, _IOFBF, SERO_BUF_LEN);
+
+      i_format = format;
+
+      if(i_format == SERO_CSV)
+      {
+
+        for(column = 0; column < (unsigned int) i_COLUMNS; column++)
+        {
+
+          fprintf(i_file, "%s%s", (column == 0) ? "" : ",",
+            i_COLUMN_NAMES[column]);
+
+        }
+
+        fputc('\n', i_file);
+
+      }
+
+      i_head = 0;
+
+      i_tail = 0;
+
+      i_dropped = 0;
+
+      i_stopping = false;
+
+      i_start = i_wall_time();
+
+      if(pthread_create(&i_thread, NULL, i_writer, NULL) == 0)
+      {
+
+        i_open = true;
+
+        status = SERO_OK;
+
+      }
+      else
+      {
+
+        (void) fclose(i_file);
+
+      }
+
+    }
+
+  }
+
+  return status;
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: sero_add()                                                          */
+/*                                                                           */
+/* Description: Queue a record to be written                                */
+/*                                                                           */
+/* Internal functions used: i_wall_time()                                    */
+/*                                                                           */
+/* Internal variables used: i_ring, i_head, i_tail, i_dropped, i_mutex,      */
+/*                          i_open, i_start                                  */
+/*                                                                           */
+/* Parameters:                                                               */
+/*   Name            Type           Comments                                 */
+/*   ------------    ------------   -----------------------------------      */
+/*   record          sero_record_t  The record                               */
+/*                                                                           */
+/* Returns: void                                                             */
+/*                                                                           */
+/*****************************************************************************/
+
+extern void sero_add(sero_record_t *record)
+{
+
+  if(i_open == true)
+  {
+
+    record->time = i_wall_time();
+
+    if(record->type != SERO_INTERVAL)
+    {
+
+      record->elapsed = record->time - i_start;
+
+    }
+
+    (void) pthread_mutex_lock(&i_mutex);
+
+    if( (i_head - i_tail) >= (unsigned int) SERO_RING_LEN)
+    {
+
+      i_dropped++;
+
+    }
+    else
+    {
+
+      i_ring[i_head % SERO_RING_LEN] = *record;
+
+      i_head++;
+
+    }
+
+    (void) pthread_mutex_unlock(&i_mutex);
+
+  }
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: sero_close()                                                        */
+/*                                                                           */
+/* Description: Write everything queued, then the summary, and close the     */
+/*              output                                                       */
+/*                                                                           */
+/* Internal functions used: i_wall_time(), i_write_record()                  */
+/*                                                                           */
+/* Internal variables used: i_dropped, i_stopping, i_mutex, i_open,          */
+/*                          i_thread, i_file, i_start                        */
+/*                                                                           */
+/* Parameters:                                                               */
+/*   Name            Type           Comments                                 */
+/*   ------------    ------------   -----------------------------------      */
+/*   summary         sero_record_t  The summary record                       */
+/*                                                                           */
+/* Returns: SERO_OK if everything was written, else SERO_FAILURE             */
+/*                                                                           */
+/*****************************************************************************/
+
+extern sero_status_t sero_close(sero_record_t *summary)
+{
+
+  sero_status_t status = SERO_FAILURE;  /* Was everything written? */
+
+
+  if(i_open == true)
+  {
+
+    (void) pthread_mutex_lock(&i_mutex);
+
+    i_stopping = true;
+
+    (void) pthread_mutex_unlock(&i_mutex);
+
+    (void) pthread_join(i_thread, NULL);
+
+    summary->time = i_wall_time();
+
+    summary->elapsed = summary->time - i_start;
+
+    i_write_record(summary, i_dropped);
+
+    if(ferror(i_file) == 0)
+    {
+
+      status = SERO_OK;
+
+    }
+
+    if(fclose(i_file) != 0)
+    {
+
+      status = SERO_FAILURE;
+
+    }
+
+    i_open = false;
+
+  }
+
+  return status;
+
+}
@@ -0,0 +1,222 @@
+/*****************************************************************************/
+/*                                                                           */
+/* Module: sero.h                                                            */
+/*                                                                           */
+/* Description: Header file for sero.c                                       */
+/*                                                                           */
+/* Copyright (C) 2026 The Serbert contributors                               */
+/*                                                                           */
+/* This file is part of Serbert.                                             */
+/*                                                                           */
+/* Serbert is free software; you can redistribute it and/or modify           */
+/* it under the terms of the GNU General Public License as published by      */
+/* the Free Software Foundation; either version 2 of the License, or         */
+/* any later version.                                                        */
+/*                                                                           */
+/* This program is distributed in the hope that it will be useful,           */
+/* but WITHOUT ANY WARRANTY; without even the implied warranty of            */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             */
+/* GNU General Public License for more details.                              */
+/*                                                                           */
+/* You should have received a copy of the GNU General Public License         */
+/* along with this program; if not, write to the Free Software               */
+/* Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA */
+/*                                                                           */
+/*****************************************************************************/
+
+#ifndef SERO_H
+
+#define SERO_H
+
+/*****************************************************************************/
+/*      INCLUDED FILES (dependencies)                                        */
+/*****************************************************************************/
+
+
+/*****************************************************************************/
+/*      MACRO DEFINITIONS                                                    */
+/*****************************************************************************/
+
+/*****************************************************************************/
+/*  Name:                                                                    */
+/*  Description:                                                             */
+/*  Parameters:                                                              */
+/*****************************************************************************/
+
+
+/*****************************************************************************/
+/*      TYPE DEFINITIONS                                                     */
+/*****************************************************************************/
+
+/* Enums & constants */
+
+enum { SERO_RING_LEN = 4096 };       /* Records the queue holds              */
+
+enum { SERO_BUF_LEN = 65536 };       /* Size of the output file buffer       */
+
+enum { SERO_POLL_NSEC = 10000000 };  /* Writer wait when idle, in nanosecs   */
+
+enum { SERO_NONE = -1 };             /* Value not known, so not written      */
+
+/* Status of opening the output */
+typedef enum sero_status_t
+{
+  SERO_OK,                           /* Output open, writer running          */
+  SERO_FAILURE                       /* Output could not be opened           */
+} sero_status_t;
+
+/* Formats the records can be written in */
+typedef enum sero_format_t
+{
+  SERO_JSON,                         /* JSON Lines, an object per line       */
+  SERO_CSV                           /* CSV, with a header line              */
+} sero_format_t;
+
+/* Types of record */
+typedef enum sero_type_t
+{
+  SERO_INTERVAL,                     /* Results for an interval              */
+  SERO_ERROR,                        /* A single error                       */
+  SERO_SUMMARY                       /* Results for the whole test           */
+} sero_type_t;
+
+/* Kinds of error */
+typedef enum sero_kind_t
+{
+  SERO_FRAMING,                      /* Framing error                        */
+  SERO_CORRUPT,                      /* Corrupt byte                         */
+  SERO_TIMEOUT                       /* Timeout                              */
+} sero_kind_t;
+
+/* Types */
+
+/* A record to write. Times are in nanoseconds. Fields not used by a type  */
+/* of record are ignored, as are times and latencies of SERO_NONE.         */
+typedef struct sero_record_t
+{
+  sero_type_t type;                  /* The type of record                   */
+  long long time;                    /* Wall clock time, set by sero_add()   */
+  unsigned long long number;         /* Interval number, from 1              */
+  long long elapsed;                 /* Time since the test started; set by  */
+                                     /* sero_add() except for intervals      */
+  long long span;                    /* Length of the interval               */
+  sero_kind_t kind;                  /* Kind of error                        */
+  int tx;                            /* Byte sent, or SERO_NONE              */
+  int rx;                            /* Byte received, or SERO_NONE          */
+  unsigned long long bytes;          /* Bytes sent; for an error, those sent */
+                                     /* before the errored byte              */
+  unsigned long long errors;         /* Bytes in error                       */
+  unsigned long long timeouts;       /* Bytes that timed out                 */
+  unsigned long long corrupts;       /* Corrupt bytes                        */
+  long long p50;                     /* Median return time                   */
+  long long p99;                     /* 99th percentile return time          */
+  long long max;                     /* Largest return time                  */
+  unsigned long long total_bytes;    /* Bytes sent so far                    */
+  unsigned long long total_errors;   /* Errors so far                        */
+  unsigned long long total_timeouts; /* Timeouts so far                      */
+} sero_record_t;
+
+
+/*****************************************************************************/
+/*      GLOBAL VARIABLES                                                     */
+/*****************************************************************************/
+
+
+/*****************************************************************************/
+/*      FUNCTION PROTOTYPES                                                  */
+/*****************************************************************************/
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: sero_keep_stdout()                                                  */
+/*                                                                           */
+/* Description: Keep stdout for the records, pointing stdout itself at       */
+/*              stderr so nothing else printed is mixed in with them         */
+/*                                                                           */
+/* Parameters: void                                                          */
+/*                                                                           */
+/* Returns: SERO_OK if stdout was kept, else SERO_FAILURE                    */
+/*                                                                           */
+/* Pre-conditions: Called before the records are opened on "-"               */
+/*                                                                           */
+/* Post-conditions: Everything printed to stdout goes to stderr              */
+/*                                                                           */
+/*****************************************************************************/
+
+extern sero_status_t sero_keep_stdout(void);
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: sero_open()                                                         */
+/*                                                                           */
+/* Description: Open the output and start the writer thread. Elapsed times   */
+/*              are measured from when the output is opened.                 */
+/*                                                                           */
+/* Parameters:                                                               */
+/*   Name            Type           Comments                                 */
+/*   ------------    ------------  -----------------------------------       */
+/*   path            const char *  File to write, or "-" for the stdout      */
+/*                                 kept by sero_keep_stdout()                */
+/*   format          sero_format_t Format to write the records in            */
+/*                                                                           */
+/* Returns: SERO_OK if the output is open, else SERO_FAILURE                 */
+/*                                                                           */
+/* Pre-conditions: Output not open                                           */
+/*                                                                           */
+/* Post-conditions: Records added are written by the writer thread           */
+/*                                                                           */
+/*****************************************************************************/
+
+extern sero_status_t sero_open(const char *path, sero_format_t format);
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: sero_add()                                                          */
+/*                                                                           */
+/* Description: Queue a record to be written. May be called from any         */
+/*              thread. This never waits for the output: if the queue is     */
+/*              full, the record is dropped and counted in the summary.      */
+/*                                                                           */
+/* Parameters:                                                               */
+/*   Name            Type           Comments                                 */
+/*   ------------    ------------  -----------------------------------       */
+/*   record          sero_record_t The record                                */
+/*                                                                           */
+/* Returns: void                                                             */
+/*                                                                           */
+/* Pre-conditions:                                                           */
+/*                                                                           */
+/* Post-conditions: Record queued, if the output is open                     */
+/*                                                                           */
+/*****************************************************************************/
+
+extern void sero_add(sero_record_t *record);
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: sero_close()                                                        */
+/*                                                                           */
+/* Description: Write everything queued, then the summary, and close the     */
+/*              output                                                       */
+/*                                                                           */
+/* Parameters:                                                               */
+/*   Name            Type           Comments                                 */
+/*   ------------    ------------  -----------------------------------       */
+/*   summary         sero_record_t The summary record                        */
+/*                                                                           */
+/* Returns: SERO_OK if everything was written, else SERO_FAILURE             */
+/*                                                                           */
+/* Pre-conditions:                                                           */
+/*                                                                           */
+/* Post-conditions: Output closed                                            */
+/*                                                                           */
+/*****************************************************************************/
+
+extern sero_status_t sero_close(sero_record_t *summary);
+
+
+#endif /* SERO_H */
+
@@ -30,6 +30,7 @@
 /*****************************************************************************/
 
 #include <stdio.h>       /* Standard I/O definitions - fprintf()           */
+#include <stdarg.h>      /* Variable argument lists - va_start()            */
 #include <string.h>      /* Standard string definitions - strerror()       */
 #include <stdbool.h>     /* Boolean types                                  */
 #include <sys/time.h>    /* Standard time definitions - timeval            */
@@ -57,10 +58,55 @@
 /*      INTERNAL VARIABLE DEFINITIONS                                        */
 /*****************************************************************************/
 
+static serp_report_func_t i_report_func = NULL;
+                                   /* Where to send messages, NULL - stderr */
+
 /*****************************************************************************/
 /*      INTERNAL FUNCTION DEFINITIONS                                        */
 /*****************************************************************************/
 
+/*****************************************************************************/
+/*                                                                           */
+/* Name: i_report()                                                          */
+/*                                                                           */
+/* Description: Print an error message to stderr, or pass it to the report   */
+/*              function if one has been set                                 */
+/*                                                                           */
+/* Uses: format - printf() style format, then its arguments                  */
+/*                                                                           */
+/* Returns: void                                                             */
+/*                                                                           */
+/*****************************************************************************/
+
+static void i_report(const char *format, ...)
+{
+
+  va_list args;                       /* The arguments for the format */
+  char message[SERP_MESSAGE_LEN];     /* The formatted message        */
+
+
+  va_start(args, format);
+
+  if(i_report_func != NULL)
+  {
+
+    (void) vsnprintf(message, sizeof(message), format, args);
+
+    i_report_func(message);
+
+  }
+  else
+  {
+
+    (void) vfprintf(stderr, format, args);
+
+  }
+
+  va_end(args);
+
+}
+
+
 /*****************************************************************************/
 /*                                                                           */
 /* Name: i_check_get_port_attribs()                                          */
@@ -93,13 +139,13 @@ static int i_check_get_port_attribs(struct seru_port_setup_t *setup,
 
       errstr = strerror(setup->setup_errno);
 
-      fprintf(stderr,"Get port attributes error: %s\n", errstr);
+      i_report("Get port attributes error: %s\n", errstr);
 
     }
     else
     {
 
-      fprintf(stderr,"Unable to get port attributes\n");
+      i_report("Unable to get port attributes\n");
 
     }
 
@@ -144,13 +190,13 @@ static int i_check_set_port_ispeed(struct seru_port_setup_t *setup,
 
       errstr = strerror(setup->setup_errno);
 
-      fprintf(stderr,"Set input baud rate error: %s\n", errstr);
+      i_report("Set input baud rate error: %s\n", errstr);
 
     }
     else
     {
 
-      fprintf(stderr,"Unable to set input baud rate\n");
+      i_report("Unable to set input baud rate\n");
 
     }
 
@@ -195,13 +241,13 @@ static int i_check_set_port_ospeed(struct seru_port_setup_t *setup,
 
       errstr = strerror(setup->setup_errno);
 
-      fprintf(stderr,"Set output baud rate error: %s\n", errstr);
+      i_report("Set output baud rate error: %s\n", errstr);
 
     }
     else
     {
 
-      fprintf(stderr,"Unable to set output baud rate\n");
+      i_report("Unable to set output baud rate\n");
 
     }
 
@@ -246,13 +292,13 @@ static int i_check_set_port_options(struct seru_port_setup_t *setup,
 
       errstr = strerror(setup->setup_errno);
 
-      fprintf(stderr,"Set port attributes error: %s\n", errstr);
+      i_report("Set port attributes error: %s\n", errstr);
 
     }
     else
     {
 
-      fprintf(stderr,"Unable to set port attributes\n");
+      i_report("Unable to set port attributes\n");
 
     }
 
@@ -297,13 +343,13 @@ static int i_check_set_low_latency(struct seru_port_setup_t *setup,
 
       errstr = strerror(setup->setup_errno);
 
-      fprintf(stderr,"Set port error: ioctl get: %s\n", errstr);
+      i_report("Set port error: ioctl get: %s\n", errstr);
 
     }
     else
     {
 
-      fprintf(stderr,"Unable to set low latency\n");
+      i_report("Unable to set low latency\n");
 
     }
 
@@ -321,13 +367,13 @@ static int i_check_set_low_latency(struct seru_port_setup_t *setup,
 
       errstr = strerror(setup->setup_errno);
 
-      fprintf(stderr,"Set port error: ioctl set: %s\n", errstr);
+      i_report("Set port error: ioctl set: %s\n", errstr);
 
     }
     else
     {
 
-      fprintf(stderr,"Could not set low latency\n");
+      i_report("Could not set low latency\n");
 
     }
 
@@ -378,7 +424,7 @@ extern serp_timeout_t serp_get_timeout(speed_t baud)
   if(timeout == SERU_GET_TIMEOUT_FAIL)
   {
 
-    fprintf(stderr,"Unable to get timeout\n");
+    i_report("Unable to get timeout\n");
 
   }
 
@@ -418,7 +464,7 @@ extern speed_t serp_get_baud(unsigned long baud_num)
   if(baud == SERU_GET_BAUD_FAIL)
   {
 
-    fprintf(stderr,"Baud rate invalid\n");
+    i_report("Baud rate invalid\n");
 
   }
 
@@ -461,7 +507,7 @@ extern serp_baud_str_status_t serp_get_baud_str(speed_t baud,
   if(baud_str_status == SERU_GET_BAUD_STR_FAIL)
   {
 
-    fprintf(stderr,"Invalid baud rate\n");
+    i_report("Invalid baud rate\n");
 
   }
 
@@ -518,13 +564,13 @@ extern int serp_flush_port(int fd, bool diags)
 
       errstr = strerror(flush.flush_errno);
 
-      fprintf(stderr,"Flush port error: %s\n", errstr);
+      i_report("Flush port error: %s\n", errstr);
 
     }
     else
     {
 
-      fprintf(stderr,"Unable to flush the port\n");
+      i_report("Unable to flush the port\n");
 
     }
 
@@ -620,7 +666,7 @@ extern int serp_set_port_config(struct serp_port_setup_t *req_setup,
   if( (setup.status & SERU_STP_BAD_DATA_BITS) > 0)
   {
 
-    fprintf(stderr,"Invalid data bits\n");
+    i_report("Invalid data bits\n");
 
     config_status = SERP_PORT_FAILURE;
 
@@ -630,7 +676,7 @@ extern int serp_set_port_config(struct serp_port_setup_t *req_setup,
   if( (setup.status & SERU_STP_BAD_PARITY) > 0)
   {
 
-    fprintf(stderr,"Invalid parity\n");
+    i_report("Invalid parity\n");
 
     config_status = SERP_PORT_FAILURE;
 
@@ -640,7 +686,7 @@ extern int serp_set_port_config(struct serp_port_setup_t *req_setup,
   if( (setup.status & SERU_STP_BAD_STOP_BITS) > 0)
   {
 
-    fprintf(stderr,"Invalid stop bits\n");
+    i_report("Invalid stop bits\n");
 
     config_status = SERP_PORT_FAILURE;
 
@@ -705,13 +751,13 @@ extern void serp_restore_port_state(int fd, bool diags)
 
       errstr = strerror(restore_params.restore_errno);
 
-      fprintf(stderr,"Restore port state error: %s\n", errstr);
+      i_report("Restore port state error: %s\n", errstr);
 
     }
     else
     {
 
-      fprintf(stderr,"Unable to restore port state\n");
+      i_report("Unable to restore port state\n");
 
     }
 
@@ -763,13 +809,13 @@ extern int serp_save_port_state(int fd, bool diags)
 
       errstr = strerror(save_params.save_errno);
 
-      fprintf(stderr,"Save port state error: %s\n", errstr);
+      i_report("Save port state error: %s\n", errstr);
 
     }
     else
     {
 
-      fprintf(stderr,"Unable to save port state\n");
+      i_report("Unable to save port state\n");
 
     }
 
@@ -813,7 +859,7 @@ extern serp_lock_status_t serp_lock_port(char *serial_port)
 
     case SERU_LOCKED : /* The port was already locked */
 
-      fprintf(stderr, "Serial port locked by another program\n");
+      i_report("Serial port locked by another program\n");
 
       lock_status = SERP_LOCK_FAIL;
 
@@ -821,7 +867,7 @@ extern serp_lock_status_t serp_lock_port(char *serial_port)
 
     case SERU_LOCK_FAIL : /* Failed to lock the port */
 
-      fprintf(stderr, "Unable to lock serial port\n");
+      i_report("Unable to lock serial port\n");
 
       lock_status = SERP_LOCK_FAIL;
 
@@ -912,13 +958,13 @@ extern int serp_open_port(char *serial_port, bool diags)
 
       errstr = strerror(open_params.open_errno);
 
-      fprintf(stderr,"Open port error: %s\n", errstr);
+      i_report("Open port error: %s\n", errstr);
 
     }
     else
     {
 
-      fprintf(stderr, "Unable to open port\n");
+      i_report("Unable to open port\n");
 
     }
 
@@ -934,13 +980,13 @@ extern int serp_open_port(char *serial_port, bool diags)
 
       errstr = strerror(open_params.open_errno);
 
-      fprintf(stderr,"Open port error: fcntl get: %s\n", errstr);
+      i_report("Open port error: fcntl get: %s\n", errstr);
 
     }
     else
     {
 
-      fprintf(stderr,"Cannot open port\n");
+      i_report("Cannot open port\n");
 
     }
 
@@ -956,13 +1002,13 @@ extern int serp_open_port(char *serial_port, bool diags)
 
       errstr = strerror(open_params.open_errno);
 
-      fprintf(stderr,"Open port error: fcntl set: %s\n", errstr);
+      i_report("Open port error: fcntl set: %s\n", errstr);
 
     }
     else
     {
 
-      fprintf(stderr,"Port cannot be opened\n");
+      i_report("Port cannot be opened\n");
 
     }
 
@@ -1022,13 +1068,13 @@ extern void serp_close_port(int fd, bool diags)
 
       errstr = strerror(close_params.close_errno);
 
-      fprintf(stderr,"Close port error: %s\n", errstr);
+      i_report("Close port error: %s\n", errstr);
 
     }
     else
     {
 
-      fprintf(stderr,"Unable to close port\n");
+      i_report("Unable to close port\n");
 
     }
 
@@ -1086,13 +1132,13 @@ extern void serp_get_lines(serp_get_lines_t *req_get_lines, bool diags)
 
       errstr = strerror(get_lines.get_errno);
 
-      fprintf(stderr,"Get control lines error: %s\n", errstr);
+      i_report("Get control lines error: %s\n", errstr);
 
     }
     else
     {
 
-      fprintf(stderr,"Unable to get control lines\n");
+      i_report("Unable to get control lines\n");
 
     }
 
@@ -1159,13 +1205,13 @@ extern void serp_set_lines(serp_set_lines_t *req_set_lines, bool diags)
 
       errstr = strerror(set_lines.set_errno);
 
-      fprintf(stderr,"Set control lines error: %s\n", errstr);
+      i_report("Set control lines error: %s\n", errstr);
 
     }
     else
     {
 
-      fprintf(stderr,"Unable to set control lines\n");
+      i_report("Unable to set control lines\n");
 
     }
 
@@ -1235,13 +1281,13 @@ extern void serp_set_dtr_rts(serp_set_dtr_rts_t *req_set_dtr_rts, bool diags)
 
       errstr = strerror(set_dtr_rts.get_errno);
 
-      fprintf(stderr,"Get control lines error: %s\n", errstr);
+      i_report("Get control lines error: %s\n", errstr);
 
     }
     else
     {
 
-      fprintf(stderr,"Unable to get control lines\n");
+      i_report("Unable to get control lines\n");
 
     }
 
@@ -1252,7 +1298,7 @@ extern void serp_set_dtr_rts(serp_set_dtr_rts_t *req_set_dtr_rts, bool diags)
     if( (set_dtr_rts.set_status & SERU_SET_LINES_INVALID) > 0)
     {
 
-      fprintf(stderr,"Invalid control line state requested\n");
+      i_report("Invalid control line state requested\n");
 
     }
     else
@@ -1268,13 +1314,13 @@ extern void serp_set_dtr_rts(serp_set_dtr_rts_t *req_set_dtr_rts, bool diags)
 
           errstr = strerror(set_dtr_rts.set_errno);
 
-          fprintf(stderr,"Set control lines error: %s\n", errstr);
+          i_report("Set control lines error: %s\n", errstr);
 
         }
         else
         {
 
-          fprintf(stderr,"Unable to set control lines\n");
+          i_report("Unable to set control lines\n");
 
         }
 
@@ -1304,7 +1350,7 @@ extern void serp_set_dtr_rts(serp_set_dtr_rts_t *req_set_dtr_rts, bool diags)
 /* Name: serp_read_port()                                                    */
 /*                                                                           */
 /* Description: Read from the serial port.  Wrapper function for             */
-/*              seru_read_serial()                                           */
+/*              seru_read_serial(), sharing its buffer so nothing is copied  */
 /*                                                                           */
 /* Internal functions used:                                                  */
 /*                                                                           */
@@ -1323,84 +1369,56 @@ extern void serp_set_dtr_rts(serp_set_dtr_rts_t *req_set_dtr_rts, bool diags)
 extern void serp_read_port(serp_rx_buf_t *ret_rx_buf, bool diags)
 {
 
-  seru_rx_buf_t rx_buf; /* Struct for received byte & status */
   char *errstr;         /* The error string                  */
 
 
-  /* Clear status */
-  rx_buf.rx_status = SERU_READ_INIT;
-
-  /* Clear errno */
-  rx_buf.rx_errno = 0;
-
-  /* Clear time errno */
-  rx_buf.time_errno = 0;
-
-  /* Clear RX time */
-  rx_buf.rx_time.tv_sec = 0;
-
-  rx_buf.rx_time.tv_usec = 0;
-
-  /* Transfer file descriptor between structures */
-  rx_buf.fd = ret_rx_buf->fd;
-
-  /* Read byte from serial port */
-  seru_read_port(&rx_buf);
+  /* Read byte from serial port, straight into the caller's buffer */
+  seru_read_port(ret_rx_buf);
 
   /* Did read fail? */
-  if( (rx_buf.rx_status & SERU_READ_FAILURE) > 0)
+  if( (ret_rx_buf->rx_status & SERU_READ_FAILURE) > 0)
   {
 
     /* Do we want a detailed error report? */
     if(diags == true)
     {
 
-      errstr = strerror(rx_buf.rx_errno);
+      errstr = strerror(ret_rx_buf->rx_errno);
 
-      fprintf(stderr,"Read port error: %s\n", errstr);
+      i_report("Read port error: %s\n", errstr);
 
     }
     else
     {
 
-      fprintf(stderr,"Unable to read from port\n");
+      i_report("Unable to read from port\n");
 
     }
 
   }
 
   /* Did Time read fail? */
-  if( (rx_buf.rx_status & SERU_READ_TIME_FAIL) > 0)
+  if( (ret_rx_buf->rx_status & SERU_READ_TIME_FAIL) > 0)
   {
 
     /* Do we want a detailed error report? */
-    if( (diags == true) && (rx_buf.time_errno != 0) )
+    if( (diags == true) && (ret_rx_buf->time_errno != 0) )
     {
 
-      errstr = strerror(rx_buf.time_errno);
+      errstr = strerror(ret_rx_buf->time_errno);
 
-      fprintf(stderr,"Read time error: %s\n", errstr);
+      i_report("Read time error: %s\n", errstr);
 
     }
     else
     {
 
-      fprintf(stderr,"Unable to read time\n");
+      i_report("Unable to read time\n");
 
     }
 
   }
 
-  /* Pass back the byte, status & time */
-
-  ret_rx_buf->rx_status = (serp_rx_status_t) rx_buf.rx_status;
-
-  ret_rx_buf->rx_byte = rx_buf.rx_byte;
-
-  ret_rx_buf->rx_time.tv_sec = rx_buf.rx_time.tv_sec;
-
-  ret_rx_buf->rx_time.tv_usec = rx_buf.rx_time.tv_usec;
-
 }
 
 
@@ -1455,13 +1473,13 @@ extern serp_rx_wait_status_t serp_wait_for_read(int fd,
 
       errstr = strerror(rx_wait.rx_wait_errno);
 
-      fprintf(stderr,"Wait for read error: %s\n", errstr);
+      i_report("Wait for read error: %s\n", errstr);
 
     }
     else
     {
 
-      fprintf(stderr,"Failed wait for read\n");
+      i_report("Failed wait for read\n");
 
     }
 
@@ -1477,7 +1495,7 @@ extern serp_rx_wait_status_t serp_wait_for_read(int fd,
 /* Name: serp_write_port()                                                   */
 /*                                                                           */
 /* Description: Write to the serial port. Wrapper function for               */
-/*              seru_write_port()                                            */
+/*              seru_write_port(), sharing its buffer so nothing is copied   */
 /*                                                                           */
 /* Internal functions used:                                                  */
 /*                                                                           */
@@ -1496,81 +1514,56 @@ extern serp_rx_wait_status_t serp_wait_for_read(int fd,
 extern void serp_write_port(serp_tx_buf_t *req_tx_buf, bool diags)
 {
 
-  seru_tx_buf_t tx_buf; /* Struct for transmit byte & returned status */
   char *errstr;         /* The error string                           */
 
 
-  /* Put the byte to transmit in the TX buffer */
-  tx_buf.tx_byte = req_tx_buf->tx_byte;
-
-  /* Clear the status */
-  tx_buf.tx_status = SERU_WRITE_INIT;
-
-  /* Clear time errno */
-  tx_buf.time_errno = 0;
-
-  /* Clear RX time */
-  tx_buf.tx_time.tv_sec = 0;
-
-  tx_buf.tx_time.tv_usec = 0;
-
-  /* Transfer file descriptor between structures */
-  tx_buf.fd = req_tx_buf->fd;
-
-  /* Write byte to serial port */
-  seru_write_port(&tx_buf);
+  /* Write byte to serial port, straight from the caller's buffer */
+  seru_write_port(req_tx_buf);
 
   /* Was write successful? */
-  if( (tx_buf.tx_status & SERU_WRITE_FAILURE) > 0)
+  if( (req_tx_buf->tx_status & SERU_WRITE_FAILURE) > 0)
   {
 
     /* Do we want a detailed error report? */
     if(diags == true)
     {
 
-      errstr = strerror(tx_buf.tx_errno);
+      errstr = strerror(req_tx_buf->tx_errno);
 
-      fprintf(stderr,"Write port error: %s\n", errstr);
+      i_report("Write port error: %s\n", errstr);
 
     }
     else
     {
 
-      fprintf(stderr,"Unable to write to port\n");
+      i_report("Unable to write to port\n");
 
     }
 
   }
 
   /* Did Time read fail? */
-  if( (tx_buf.tx_status & SERU_WRITE_TIME_FAIL) > 0)
+  if( (req_tx_buf->tx_status & SERU_WRITE_TIME_FAIL) > 0)
   {
 
     /* Do we want a detailed error report? */
     if(diags == true)
     {
 
-      errstr = strerror(tx_buf.time_errno);
+      errstr = strerror(req_tx_buf->time_errno);
 
-      fprintf(stderr,"Read time error: %s\n", errstr);
+      i_report("Read time error: %s\n", errstr);
 
     }
     else
     {
 
-      fprintf(stderr,"Unable to read time\n");
+      i_report("Unable to read time\n");
 
     }
 
   }
 
-  /* Return the status & time */
-  req_tx_buf->tx_status = (serp_tx_status_t) tx_buf.tx_status;
-
-  req_tx_buf->tx_time.tv_sec = tx_buf.tx_time.tv_sec;
-
-  req_tx_buf->tx_time.tv_usec = tx_buf.tx_time.tv_usec;
-
 }
 
 
@@ -1627,13 +1620,13 @@ extern serp_tx_wait_status_t serp_wait_for_write(int fd,
 
       errstr = strerror(tx_wait.tx_wait_errno);
 
-      fprintf(stderr,"Wait for write error: %s\n", errstr);
+      i_report("Wait for write error: %s\n", errstr);
 
     }
     else
     {
 
-      fprintf(stderr,"Failed wait for write\n");
+      i_report("Failed wait for write\n");
 
     }
 
@@ -1645,7 +1638,7 @@ extern serp_tx_wait_status_t serp_wait_for_write(int fd,
     if( (tx_wait.tx_wait_status & SERU_TX_WAIT_TIMEOUT) > 0)
     {
 
-      fprintf(stderr,"Unable to write to port\n");
+      i_report("Unable to write to port\n");
 
     }
 
@@ -1654,3 +1647,207 @@ extern serp_tx_wait_status_t serp_wait_for_write(int fd,
   return (serp_tx_wait_status_t) tx_wait.tx_wait_status;
 
 }
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: serp_set_report_func()                                              */
+/*                                                                           */
+/* Description: Sets where error messages are sent                           */
+/*                                                                           */
+/* Internal functions used:                                                  */
+/*                                                                           */
+/* Internal variables used: i_report_func                                    */
+/*                                                                           */
+/* Parameters:                                                               */
+/*   Name           Type                Comments                             */
+/*   ------------   ------------        ----------------------------------   */
+/*   func           serp_report_func_t  Function to pass messages to, or     */
+/*                                      NULL to print them to stderr         */
+/*                                                                           */
+/* Returns: void                                                             */
+/*                                                                           */
+/*****************************************************************************/
+
+extern void serp_set_report_func(serp_report_func_t func)
+{
+
+  i_report_func = func;
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: serp_get_syscalls()                                                 */
+/*                                                                           */
+/* Description: Gets the number of system calls made on ports so far.        */
+/*              Wrapper function for seru_get_syscalls()                     */
+/*                                                                           */
+/* Internal functions used:                                                  */
+/*                                                                           */
+/* Internal variables used:                                                  */
+/*                                                                           */
+/* Parameters: void                                                          */
+/*                                                                           */
+/* Returns: The system calls made                                            */
+/*                                                                           */
+/*****************************************************************************/
+
+extern unsigned long long serp_get_syscalls(void)
+{
+
+  return seru_get_syscalls();
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: serp_get_time()                                                     */
+/*                                                                           */
+/* Description: Gets the time on the open port's clock.                      */
+/*              Wrapper function for seru_get_time()                         */
+/*                                                                           */
+/* Internal functions used:                                                  */
+/*                                                                           */
+/* Internal variables used:                                                  */
+/*                                                                           */
+/* Parameters: time - Where to put the time                                  */
+/*                                                                           */
+/* Returns: 0, or SERU_TIME_FAILURE                                          */
+/*                                                                           */
+/*****************************************************************************/
+
+extern int serp_get_time(struct timeval *time)
+{
+
+  return seru_get_time(time);
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: serp_sleep()                                                        */
+/*                                                                           */
+/* Description: Sleeps on the open port's clock.                             */
+/*              Wrapper function for seru_sleep()                            */
+/*                                                                           */
+/* Internal functions used:                                                  */
+/*                                                                           */
+/* Internal variables used:                                                  */
+/*                                                                           */
+/* Parameters: time - The time to sleep, left with any not slept             */
+/*                                                                           */
+/* Returns: 0, or SERU_TIME_FAILURE if interrupted                           */
+/*                                                                           */
+/*****************************************************************************/
+
+extern int serp_sleep(struct timespec *time)
+{
+
+  return seru_sleep(time);
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: serp_set_timing()                                                   */
+/*                                                                           */
+/* Description: Turns timing the phases of each byte on or off.              */
+/*              Wrapper function for seru_set_timing()                       */
+/*                                                                           */
+/* Internal functions used:                                                  */
+/*                                                                           */
+/* Internal variables used:                                                  */
+/*                                                                           */
+/* Parameters: timing - true to time the phases                              */
+/*                                                                           */
+/* Returns: void                                                             */
+/*                                                                           */
+/*****************************************************************************/
+
+extern void serp_set_timing(bool timing)
+{
+
+  seru_set_timing(timing);
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: serp_phase_start()                                                  */
+/*                                                                           */
+/* Description: Marks the start of a phase, if timing.                       */
+/*              Wrapper function for seru_phase_start()                      */
+/*                                                                           */
+/* Internal functions used:                                                  */
+/*                                                                           */
+/* Internal variables used:                                                  */
+/*                                                                           */
+/* Parameters: mark - Where to mark the start                                */
+/*                                                                           */
+/* Returns: void                                                             */
+/*                                                                           */
+/*****************************************************************************/
+
+extern void serp_phase_start(serp_phase_mark_t *mark)
+{
+
+  seru_phase_start(mark);
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: serp_phase_end()                                                    */
+/*                                                                           */
+/* Description: Adds the time since a phase was marked to it, if timing.     */
+/*              Wrapper function for seru_phase_end()                        */
+/*                                                                           */
+/* Internal functions used:                                                  */
+/*                                                                           */
+/* Internal variables used:                                                  */
+/*                                                                           */
+/* Parameters: phase - The phase ending                                      */
+/*             mark - Where it started, from serp_phase_start()              */
+/*                                                                           */
+/* Returns: void                                                             */
+/*                                                                           */
+/*****************************************************************************/
+
+extern void serp_phase_end(serp_phase_t phase, const serp_phase_mark_t *mark)
+{
+
+  seru_phase_end( (seru_phase_t) phase, mark);
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: serp_get_phases()                                                   */
+/*                                                                           */
+/* Description: Gets the time spent in each phase so far.                    */
+/*              Wrapper function for seru_get_phases()                       */
+/*                                                                           */
+/* Internal functions used:                                                  */
+/*                                                                           */
+/* Internal variables used:                                                  */
+/*                                                                           */
+/* Parameters: phases - Where to put the SERP_PHASES times                   */
+/*                                                                           */
+/* Returns: void                                                             */
+/*                                                                           */
+/*****************************************************************************/
+
+extern void serp_get_phases(serp_phase_time_t *phases)
+{
+
+  seru_get_phases(phases);
+
+}
@@ -60,6 +60,12 @@
 #define SERP_GET_BAUD_FAIL SERU_GET_BAUD_FAIL
                                      /* Failure to get a baud rate indicator */
 
+#define SERP_MEMORY_PORT SERU_MEMORY_PORT
+                                     /* Port name of the memory loopback     */
+
+#define SERP_SIM_PORT SERU_SIM_PORT
+                                     /* Port name of the simulated line      */
+
 enum { SERP_PORT_FAILURE = SERU_PORT_FAILURE };
                                      /* Serial port access failure indicator */
 
@@ -72,6 +78,8 @@ enum { SERP_TIME_FAILURE = SERU_TIME_FAILURE };
 enum { SERP_TIMEOUT_MAX = SERU_TIMEOUT_MAX };
                                      /* Maximum receive timeout in microsecs */
 
+enum { SERP_MESSAGE_LEN = 128 };     /* Longest error message passed on      */
+
 enum { SERP_CNTRL_LE  = SERU_CNTRL_LE  }; /* Control line - DSR/Line Enable  */
 
 enum { SERP_CNTRL_DTR = SERU_CNTRL_DTR }; /* Control line - DTR              */
@@ -212,14 +220,9 @@ typedef enum serp_rx_status_t
   SERP_READ_OK        = SERU_READ_OK         /* Read was successful          */
 } serp_rx_status_t;
 
-/* Buffer type for the receipt of a serial byte */
-typedef struct serp_rx_buf_t
-{
-  int fd;                     /* The port file descriptor              */
-  unsigned char rx_byte;      /* The received byte                     */
-  serp_rx_status_t rx_status; /* The receive status, any errors, or OK */
-  struct timeval rx_time;     /* The time the byte was received        */
-} serp_rx_buf_t;
+/* Buffer type for the receipt of a serial byte, shared with seru so it */
+/* isn't copied for each byte                                           */
+typedef seru_rx_buf_t serp_rx_buf_t;
 
 /* Type for wait for serial RX status */
 typedef enum serp_rx_wait_status_t
@@ -239,15 +242,8 @@ typedef enum serp_tx_status_t
   SERP_WRITE_TIME_FAIL = SERU_WRITE_TIME_FAIL /* Write was successful    */
 } serp_tx_status_t;
 
-/* Buffer type for the transmision of a serial byte */
-typedef struct serp_tx_buf_t
-{
-  int fd;                     /* The port file descriptor               */
-  unsigned char tx_byte;      /* The byte to transmit                   */
-  serp_tx_status_t tx_status; /* The transmit status, any errors, or OK */
-  struct timeval tx_time;     /* The time the byte was transmitted      */
-  int time_errno;             /* errno on read time fail                */
-} serp_tx_buf_t;
+/* Buffer type for the transmision of a serial byte, shared with seru */
+typedef seru_tx_buf_t serp_tx_buf_t;
 
 /* Type for wait for serial TX status */
 /* These are bitmapped flags          */
@@ -258,6 +254,28 @@ typedef enum serp_tx_wait_status_t
   SERP_TX_WAIT_READY   = SERU_TX_WAIT_READY    /* Port ready for write     */
 } serp_tx_wait_status_t;
 
+/* Type for the phases of sending and receiving a byte that can be timed */
+typedef enum serp_phase_t
+{
+  SERP_PHASE_WAIT_WRITE = SERU_PHASE_WAIT_WRITE, /* Waiting to write   */
+  SERP_PHASE_WRITE      = SERU_PHASE_WRITE,      /* Writing a byte     */
+  SERP_PHASE_WAIT_READ  = SERU_PHASE_WAIT_READ,  /* Waiting to read    */
+  SERP_PHASE_READ       = SERU_PHASE_READ,       /* Reading a byte     */
+  SERP_PHASE_FLUSH      = SERU_PHASE_FLUSH,      /* Flushing the port  */
+  SERP_PHASE_CLOCK      = SERU_PHASE_CLOCK,      /* Reading the clock  */
+  SERP_PHASE_KEYS       = SERU_PHASE_KEYS,       /* Checking the keys  */
+  SERP_PHASES           = SERU_PHASES            /* Number of phases   */
+} serp_phase_t;
+
+/* Type for the time spent in a phase */
+typedef seru_phase_time_t serp_phase_time_t;
+
+/* Type for where a phase started */
+typedef seru_phase_mark_t serp_phase_mark_t;
+
+/* Function error messages can be passed to, instead of printing them */
+typedef void (*serp_report_func_t)(const char *message);
+
 
 /*****************************************************************************/
 /*      GLOBAL VARIABLES                                                     */
@@ -686,5 +704,166 @@ extern serp_tx_wait_status_t serp_wait_for_write(int fd,
  serp_timeout_t write_timeout, bool diags);
 
 
+/*****************************************************************************/
+/*                                                                           */
+/* Name: serp_set_report_func()                                              */
+/*                                                                           */
+/* Description: Sets where error messages are sent. Normally they are        */
+/*              printed to stderr, but they can be passed, with their        */
+/*              newline, to a function instead.                              */
+/*                                                                           */
+/* Parameters:                                                               */
+/*   Name           Type                Comments                             */
+/*   ------------   ------------        ----------------------------------   */
+/*   func           serp_report_func_t  Function to pass messages to, or     */
+/*                                      NULL to print them to stderr         */
+/*                                                                           */
+/* Returns: void                                                             */
+/*                                                                           */
+/* Pre-conditions:                                                           */
+/*                                                                           */
+/* Post-conditions: Messages go to the function, or to stderr                */
+/*                                                                           */
+/*****************************************************************************/
+
+extern void serp_set_report_func(serp_report_func_t func);
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: serp_get_syscalls()                                                 */
+/*                                                                           */
+/* Description: Gets the number of system calls made on ports so far, to     */
+/*              measure the cost of the I/O path                             */
+/*                                                                           */
+/* Parameters: void                                                          */
+/*                                                                           */
+/* Returns: The system calls made                                            */
+/*                                                                           */
+/* Pre-conditions:                                                           */
+/*                                                                           */
+/* Post-conditions:                                                          */
+/*                                                                           */
+/*****************************************************************************/
+
+extern unsigned long long serp_get_syscalls(void);
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: serp_get_time()                                                     */
+/*                                                                           */
+/* Description: Gets the time on the open port's clock, so a simulated       */
+/*              test is timed the same on every run                          */
+/*                                                                           */
+/* Parameters: time - Where to put the time                                  */
+/*                                                                           */
+/* Returns: 0, or SERU_TIME_FAILURE                                          */
+/*                                                                           */
+/* Pre-conditions:                                                           */
+/*                                                                           */
+/* Post-conditions:                                                          */
+/*                                                                           */
+/*****************************************************************************/
+
+extern int serp_get_time(struct timeval *time);
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: serp_sleep()                                                        */
+/*                                                                           */
+/* Description: Sleeps on the open port's clock                              */
+/*                                                                           */
+/* Parameters: time - The time to sleep, left with any not slept             */
+/*                                                                           */
+/* Returns: 0, or SERU_TIME_FAILURE if interrupted                           */
+/*                                                                           */
+/* Pre-conditions:                                                           */
+/*                                                                           */
+/* Post-conditions:                                                          */
+/*                                                                           */
+/*****************************************************************************/
+
+extern int serp_sleep(struct timespec *time);
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: serp_set_timing()                                                   */
+/*                                                                           */
+/* Description: Turns timing the phases of each byte on or off               */
+/*                                                                           */
+/* Parameters: timing - true to time the phases                              */
+/*                                                                           */
+/* Returns: void                                                             */
+/*                                                                           */
+/* Pre-conditions:                                                           */
+/*                                                                           */
+/* Post-conditions: The times so far are cleared                             */
+/*                                                                           */
+/*****************************************************************************/
+
+extern void serp_set_timing(bool timing);
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: serp_phase_start()                                                  */
+/*                                                                           */
+/* Description: Marks the start of a phase, if timing                        */
+/*                                                                           */
+/* Parameters: mark - Where to mark the start                                */
+/*                                                                           */
+/* Returns: void                                                             */
+/*                                                                           */
+/* Pre-conditions:                                                           */
+/*                                                                           */
+/* Post-conditions:                                                          */
+/*                                                                           */
+/*****************************************************************************/
+
+extern void serp_phase_start(serp_phase_mark_t *mark);
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: serp_phase_end()                                                    */
+/*                                                                           */
+/* Description: Adds the time since a phase was marked to it, if timing      */
+/*                                                                           */
+/* Parameters: phase - The phase ending                                      */
+/*             mark - Where it started, from serp_phase_start()              */
+/*                                                                           */
+/* Returns: void                                                             */
+/*                                                                           */
+/* Pre-conditions:                                                           */
+/*                                                                           */
+/* Post-conditions:                                                          */
+/*                                                                           */
+/*****************************************************************************/
+
+extern void serp_phase_end(serp_phase_t phase, const serp_phase_mark_t *mark);
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: serp_get_phases()                                                   */
+/*                                                                           */
+/* Description: Gets the time spent in each phase so far                     */
+/*                                                                           */
+/* Parameters: phases - Where to put the SERP_PHASES times                   */
+/*                                                                           */
+/* Returns: void                                                             */
+/*                                                                           */
+/* Pre-conditions:                                                           */
+/*                                                                           */
+/* Post-conditions:                                                          */
+/*                                                                           */
+/*****************************************************************************/
+
+extern void serp_get_phases(serp_phase_time_t *phases);
+
+
 #endif /* SERP_H */
 
@@ -0,0 +1,616 @@
+/*****************************************************************************/
+/*                                                                           */
+/* Module: serr.c                                                            */
+/*                                                                           */
+/* Description: Asynchronous error reporting for serial Bit Error Rate Tests */
+/*                                                                           */
+/* Copyright (C) 2026 The Serbert contributors                               */
+/*                                                                           */
+/* This file is part of Serbert.                                             */
+/*                                                                           */
+/* Serbert is free software; you can redistribute it and/or modify           */
+/* it under the terms of the GNU General Public License as published by      */
+/* the Free Software Foundation; either version 2 of the License, or         */
+/* any later version.                                                        */
+/*                                                                           */
+/* This program is distributed in the hope that it will be useful,           */
+/* but WITHOUT ANY WARRANTY; without even the implied warranty of            */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             */
+/* GNU General Public License for more details.                              */
+/*                                                                           */
+/* You should have received a copy of the GNU General Public License         */
+/* along with this program; if not, write to the Free Software               */
+/* Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA */
+/*                                                                           */
+/*****************************************************************************/
+
+
+/*****************************************************************************/
+/*      INCLUDED FILES (dependencies)                                        */
+/*****************************************************************************/
+
+#include <stdio.h>       /* Standard I/O definitions - printf(), fputs()   */
+#include <string.h>      /* Standard string lib - strncpy()                */
+#include <stdbool.h>     /* Boolean types                                  */
+#include <stdatomic.h>   /* Atomic types - atomic_uint                     */
+#include <pthread.h>     /* Threads - pthread_create()                     */
+#include <time.h>        /* Time defs - time(), localtime_r(), nanosleep() */
+#include "serr.h"        /* Header file for this library                   */
+
+
+/*****************************************************************************/
+/*      INTERNAL MACRO DEFINITIONS                                           */
+/*****************************************************************************/
+
+/*****************************************************************************/
+/*  Name:                                                                    */
+/*  Description:                                                             */
+/*  Parameters:                                                              */
+/*  Client functions:                                                        */
+/*****************************************************************************/
+
+
+/*****************************************************************************/
+/*      INTERNAL TYPE DEFINITIONS                                            */
+/*****************************************************************************/
+
+/*****************************************************************************/
+/*      INTERNAL VARIABLE DEFINITIONS                                        */
+/*****************************************************************************/
+
+/* What each type of error is called when counted */
+static const char *i_FLOOD_NAMES[SERR_TYPES] =
+  { "framing errors", "corrupt bytes", "timeouts", "error messages" };
+
+/* The queue is a ring with one writer, the test, and one reader, the      */
+/* reporter. Each only moves its own index on, so no locks are needed.     */
+static serr_record_t i_ring[SERR_RING_LEN];   /* The queued errors          */
+
+static atomic_uint i_head;                    /* Next record to write       */
+
+static atomic_uint i_tail;                    /* Next record to read        */
+
+static atomic_ullong i_lost[SERR_TYPES];      /* Errors the queue had no    */
+                                              /* room for, by type          */
+
+static atomic_bool i_stopping;                /* Reporter asked to stop     */
+
+static bool i_running = false;                /* Reporter running           */
+
+static pthread_t i_thread;                    /* The reporter thread        */
+
+/* Used only by the reporter, or when printing straight away */
+
+static time_t i_cached_time = (time_t) -1;    /* Time of the cached string  */
+
+static char i_time_str[SERR_TIME_STR_LEN];    /* The time as a string       */
+
+static time_t i_second;                       /* The second being counted   */
+
+static unsigned long long i_count[SERR_TYPES];/* Errors in that second      */
+
+
+/*****************************************************************************/
+/*      INTERNAL FUNCTION DEFINITIONS                                        */
+/*****************************************************************************/
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: i_get_time_str()                                                    */
+/*                                                                           */
+/* Description: Gets a time as a date and time string. The string is only    */
+/*              made again when the second changes.                          */
+/*                                                                           */
+/* Uses: time_val - The time                                                 */
+/*                                                                           */
+/* Returns: The string                                                       */
+/*                                                                           */
+/*****************************************************************************/
+
+static const char *i_get_time_str(time_t time_val)
+{
+
+  struct tm time_struct;        /* Data structure holding time */
+
+
+  if(time_val != i_cached_time)
+  {
+
+    if(localtime_r(&time_val, &time_struct) != NULL)
+    {
+
+      (void) strftime(i_time_str, SERR_TIME_STR_LEN, "%Y-%m-%d %H:%M:%S",
+        &time_struct);
+
+    }
+    else
+    {
+
+      i_time_str[0] = '\0';
+
+    }
+
+    i_cached_time = time_val;
+
+  }
+
+  return i_time_str;
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: i_print_record()                                                    */
+/*                                                                           */
+/* Description: Print out a single error                                     */
+/*                                                                           */
+/* Uses: record - The error                                                  */
+/*                                                                           */
+/* Returns: void                                                             */
+/*                                                                           */
+/*****************************************************************************/
+
+static void i_print_record(const serr_record_t *record)
+{
+
+  switch (record->type)
+  {
+
+    case SERR_FRAMING:
+
+      printf("%s - Framing error: TX: %02x RX: %02x\n",
+        i_get_time_str(record->time), (unsigned int) record->tx,
+        (unsigned int) record->rx);
+
+      break;
+
+    case SERR_CORRUPT:
+
+      printf("%s - Corrupt byte: TX: %02x RX: %02x\n",
+        i_get_time_str(record->time), (unsigned int) record->tx,
+        (unsigned int) record->rx);
+
+      break;
+
+    case SERR_TIMEOUT:
+
+      printf("%s - Timeout\n", i_get_time_str(record->time) );
+
+      break;
+
+    default:
+
+      fputs(record->text, stderr);
+
+      break;
+
+  } /* End switch() */
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: i_end_second()                                                      */
+/*                                                                           */
+/* Description: Finish counting a second. Where more errors of a type came   */
+/*              than were shown, or the queue had no room for some, print    */
+/*              how many there were in all.                                  */
+/*                                                                           */
+/* Uses: void                                                                */
+/*                                                                           */
+/* Returns: void                                                             */
+/*                                                                           */
+/*****************************************************************************/
+
+static void i_end_second(void)
+{
+
+  unsigned int type;            /* The type of error     */
+  unsigned long long lost;      /* Errors not queued     */
+  FILE *stream;                 /* Where to print        */
+
+
+  for(type = 0; type < (unsigned int) SERR_TYPES; type++)
+  {
+
+    lost = atomic_exchange_explicit(&i_lost[type], 0, memory_order_relaxed);
+
+    if( (i_count[type] > (unsigned long long) SERR_FLOOD_LINES) || (lost > 0) )
+    {
+
+      stream = (type == (unsigned int) SERR_MESSAGE) ? stderr : stdout;
+
+      fprintf(stream, "%s - %llu %s in last second\n",
+        i_get_time_str(i_second), i_count[type] + lost, i_FLOOD_NAMES[type]);
+
+    }
+
+    i_count[type] = 0;
+
+  }
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: i_handle_record()                                                   */
+/*                                                                           */
+/* Description: Count an error against its second, and print it if not too  */
+/*              many of its type have been printed in that second            */
+/*                                                                           */
+/* Uses: record - The error                                                  */
+/*                                                                           */
+/* Returns: void                                                             */
+/*                                                                           */
+/*****************************************************************************/
+
+static void i_handle_record(const serr_record_t *record)
+{
+
+  if(record->time != i_second)
+  {
+
+    i_end_second();
+
+    i_second = record->time;
+
+  }
+
+  i_count[record->type]++;
+
+  if(i_count[record->type] <= (unsigned long long) SERR_FLOOD_LINES)
+  {
+
+    i_print_record(record);
+
+  }
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: i_reporter()                                                        */
+/*                                                                           */
+/* Description: The reporter thread. Takes errors off the queue and reports  */
+/*              them until asked to stop and the queue is empty.             */
+/*                                                                           */
+/* Uses: arg - Not used                                                      */
+/*                                                                           */
+/* Returns: NULL                                                             */
+/*                                                                           */
+/*****************************************************************************/
+
+static void *i_reporter(void *arg)
+{
+
+  unsigned int head;            /* Where the writer is up to       */
+  unsigned int tail;            /* Where the reader is up to       */
+  bool stopping;                /* Asked to stop?                  */
+  bool got_some;                /* Were there errors on the queue? */
+  struct timespec pause;        /* How long to wait when idle      */
+
+
+  (void) arg;
+
+  pause.tv_sec = 0;
+
+  pause.tv_nsec = SERR_POLL_NSEC;
+
+  i_second = time(NULL);
+
+  do
+  {
+
+    /* Look before emptying the queue, so nothing queued before a stop */
+    /* request is missed                                               */
+    stopping = atomic_load_explicit(&i_stopping, memory_order_acquire);
+
+    head = atomic_load_explicit(&i_head, memory_order_acquire);
+
+    tail = atomic_load_explicit(&i_tail, memory_order_relaxed);
+
+    got_some = (head != tail);
+
+    while(tail != head)
+    {
+
+      i_handle_record(&i_ring[tail & (SERR_RING_LEN - 1)]);
+
+      tail++;
+
+      atomic_store_explicit(&i_tail, tail, memory_order_release);
+
+    }
+
+    if(got_some == true)
+    {
+
+      (void) fflush(stdout);
+
+    }
+    else if(stopping == false)
+    {
+
+      /* Report the counts for a second once it has passed */
+      if(time(NULL) != i_second)
+      {
+
+        i_end_second();
+
+        i_second = time(NULL);
+
+        (void) fflush(stdout);
+
+      }
+
+      (void) nanosleep(&pause, NULL);
+
+    }
+
+  } while( (stopping == false) || (got_some == true) );
+
+  i_end_second();
+
+  (void) fflush(stdout);
+
+  return NULL;
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: i_queue()                                                           */
+/*                                                                           */
+/* Description: Put an error on the queue, or just count it if it's full    */
+/*                                                                           */
+/* Uses: record - The error                                                  */
+/*                                                                           */
+/* Returns: void                                                             */
+/*                                                                           */
+/*****************************************************************************/
+
+static void i_queue(const serr_record_t *record)
+{
+
+  unsigned int head;            /* Where the writer is up to */
+  unsigned int tail;            /* Where the reader is up to */
+
+
+  head = atomic_load_explicit(&i_head, memory_order_relaxed);
+
+  tail = atomic_load_explicit(&i_tail, memory_order_acquire);
+
+  if( (head - tail) >= (unsigned int) SERR_RING_LEN)
+  {
+
+    (void) atomic_fetch_add_explicit(&i_lost[record->type], 1,
+      memory_order_relaxed);
+
+  }
+  else
+  {
+
+    i_ring[head & (SERR_RING_LEN - 1)] = *record;
+
+    atomic_store_explicit(&i_head, head + 1, memory_order_release);
+
+  }
+
+}
+
+
+/*****************************************************************************/
+/*      EXTERNAL VARIABLE DEFINITIONS                                        */
+/*****************************************************************************/
+
+
+/*****************************************************************************/
+/*      EXTERNAL FUNCTION DEFINITIONS                                        */
+/*****************************************************************************/
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: serr_start()                                                        */
+/*                                                                           */
+/* Description: Start the reporter thread                                    */
+/*                                                                           */
+/* Internal functions used: i_reporter()                                     */
+/*                                                                           */
+/* Internal variables used: i_head, i_tail, i_lost, i_stopping, i_running,   */
+/*                          i_thread                                         */
+/*                                                                           */
+/* Parameters:                                                               */
+/*   Name            Type           Comments                                 */
+/*   ------------    ------------   -----------------------------------      */
+/*                                                                           */
+/* Returns: SERR_OK if the reporter is running, else SERR_FAILURE            */
+/*                                                                           */
+/*****************************************************************************/
+
+extern serr_status_t serr_start(void)
+{
+
+  serr_status_t status = SERR_FAILURE;  /* Did the reporter start? */
+  unsigned int type;                    /* The type of error       */
+
+
+  if(i_running == false)
+  {
+
+    atomic_store(&i_head, 0);
+
+    atomic_store(&i_tail, 0);
+
+    for(type = 0; type < (unsigned int) SERR_TYPES; type++)
+    {
+
+      atomic_store(&i_lost[type], 0);
+
+      i_count[type] = 0;
+
+    }
+
+    atomic_store(&i_stopping, false);
+
+    if(pthread_create(&i_thread, NULL, i_reporter, NULL) == 0)
+    {
+
+      i_running = true;
+
+      status = SERR_OK;
+
+    }
+
+  }
+
+  return status;
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: serr_stop()                                                         */
+/*                                                                           */
+/* Description: Stop the reporter thread, once the queue is empty            */
+/*                                                                           */
+/* Internal functions used:                                                  */
+/*                                                                           */
+/* Internal variables used: i_stopping, i_running, i_thread                  */
+/*                                                                           */
+/* Parameters:                                                               */
+/*   Name            Type           Comments                                 */
+/*   ------------    ------------   -----------------------------------      */
+/*                                                                           */
+/* Returns: void                                                             */
+/*                                                                           */
+/*****************************************************************************/
+
+extern void serr_stop(void)
+{
+
+  if(i_running == true)
+  {
+
+    atomic_store_explicit(&i_stopping, true, memory_order_release);
+
+    (void) pthread_join(i_thread, NULL);
+
+    i_running = false;
+
+  }
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: serr_report()                                                       */
+/*                                                                           */
+/* Description: Report a framing error, corrupt byte or timeout              */
+/*                                                                           */
+/* Internal functions used: i_queue(), i_print_record()                      */
+/*                                                                           */
+/* Internal variables used: i_running                                        */
+/*                                                                           */
+/* Parameters:                                                               */
+/*   Name            Type           Comments                                 */
+/*   ------------    ------------   -----------------------------------      */
+/*   type            serr_type_t    The type of error                        */
+/*   time            time_t         When it happened                         */
+/*   tx              unsigned char  The byte sent                            */
+/*   rx              unsigned char  The byte received                        */
+/*                                                                           */
+/* Returns: void                                                             */
+/*                                                                           */
+/*****************************************************************************/
+
+extern void serr_report(serr_type_t type, time_t time, unsigned char tx,
+  unsigned char rx)
+{
+
+  serr_record_t record;         /* The error */
+
+
+  record.type = type;
+
+  record.time = time;
+
+  record.tx = tx;
+
+  record.rx = rx;
+
+  record.text[0] = '\0';
+
+  if(i_running == true)
+  {
+
+    i_queue(&record);
+
+  }
+  else
+  {
+
+    i_print_record(&record);
+
+  }
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: serr_message()                                                      */
+/*                                                                           */
+/* Description: Report an error message                                      */
+/*                                                                           */
+/* Internal functions used: i_queue()                                        */
+/*                                                                           */
+/* Internal variables used: i_running                                        */
+/*                                                                           */
+/* Parameters:                                                               */
+/*   Name            Type           Comments                                 */
+/*   ------------    ------------   -----------------------------------      */
+/*   message         const char *   The message, with its newline            */
+/*                                                                           */
+/* Returns: void                                                             */
+/*                                                                           */
+/*****************************************************************************/
+
+extern void serr_message(const char *message)
+{
+
+  serr_record_t record;         /* The message */
+
+
+  if(i_running == true)
+  {
+
+    record.type = SERR_MESSAGE;
+
+    record.time = time(NULL);
+
+    record.tx = 0;
+
+    record.rx = 0;
+
+    (void) strncpy(record.text, message, SERR_TEXT_LEN - 1);
+
+    record.text[SERR_TEXT_LEN - 1] = '\0';
+
+    i_queue(&record);
+
+  }
+  else
+  {
+
+    fputs(message, stderr);
+
+  }
+
+}
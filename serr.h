@@ -0,0 +1,199 @@
+/*****************************************************************************/
+/*                                                                           */
+/* Module: serr.h                                                            */
+/*                                                                           */
+/* Description: Header file for serr.c                                       */
+/*                                                                           */
+/* Copyright (C) 2026 The Serbert contributors                               */
+/*                                                                           */
+/* This file is part of Serbert.                                             */
+/*                                                                           */
+/* Serbert is free software; you can redistribute it and/or modify           */
+/* it under the terms of the GNU General Public License as published by      */
+/* the Free Software Foundation; either version 2 of the License, or         */
+/* any later version.                                                        */
+/*                                                                           */
+/* This program is distributed in the hope that it will be useful,           */
+/* but WITHOUT ANY WARRANTY; without even the implied warranty of            */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             */
+/* GNU General Public License for more details.                              */
+/*                                                                           */
+/* You should have received a copy of the GNU General Public License         */
+/* along with this program; if not, write to the Free Software               */
+/* Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA */
+/*                                                                           */
+/*****************************************************************************/
+
+#ifndef SERR_H
+
+#define SERR_H
+
+/*****************************************************************************/
+/*      INCLUDED FILES (dependencies)                                        */
+/*****************************************************************************/
+
+#include <time.h>        /* Time definitions - time_t                      */
+
+
+/*****************************************************************************/
+/*      MACRO DEFINITIONS                                                    */
+/*****************************************************************************/
+
+/*****************************************************************************/
+/*  Name:                                                                    */
+/*  Description:                                                             */
+/*  Parameters:                                                              */
+/*****************************************************************************/
+
+
+/*****************************************************************************/
+/*      TYPE DEFINITIONS                                                     */
+/*****************************************************************************/
+
+/* Enums & constants */
+
+enum { SERR_RING_LEN = 1024 };       /* Records the queue holds, power of 2  */
+
+enum { SERR_TEXT_LEN = 128 };        /* Longest message text held            */
+
+enum { SERR_FLOOD_LINES = 3 };       /* Lines of each type shown per second  */
+
+enum { SERR_POLL_NSEC = 10000000 };  /* Reporter wait when idle, in nanosecs */
+
+enum { SERR_TIME_STR_LEN = 50 };     /* Max length of a time string          */
+
+/* Status of starting the reporter */
+typedef enum serr_status_t
+{
+  SERR_OK,                           /* Reporter running                     */
+  SERR_FAILURE                       /* Reporter could not be started        */
+} serr_status_t;
+
+/* Types of error reported */
+typedef enum serr_type_t
+{
+  SERR_FRAMING,                      /* Framing error                        */
+  SERR_CORRUPT,                      /* Corrupt byte                         */
+  SERR_TIMEOUT,                      /* Timeout                              */
+  SERR_MESSAGE,                      /* Error message text                   */
+  SERR_TYPES                         /* Number of types                      */
+} serr_type_t;
+
+/* A single error, as queued for the reporter */
+typedef struct serr_record_t
+{
+  serr_type_t type;                  /* The type of error                    */
+  time_t time;                       /* When it happened                     */
+  unsigned char tx;                  /* The byte sent                        */
+  unsigned char rx;                  /* The byte received                    */
+  char text[SERR_TEXT_LEN];          /* Message text, for SERR_MESSAGE       */
+} serr_record_t;
+
+
+/*****************************************************************************/
+/*      GLOBAL VARIABLES                                                     */
+/*****************************************************************************/
+
+
+/*****************************************************************************/
+/*      FUNCTION PROTOTYPES                                                  */
+/*****************************************************************************/
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: serr_start()                                                        */
+/*                                                                           */
+/* Description: Start the reporter thread. Until it is started, and after    */
+/*              it is stopped, errors are printed straight away.             */
+/*                                                                           */
+/* Parameters:                                                               */
+/*   Name            Type           Comments                                 */
+/*   ------------    ------------  -----------------------------------       */
+/*                                                                           */
+/* Returns: SERR_OK if the reporter is running, else SERR_FAILURE            */
+/*                                                                           */
+/* Pre-conditions: Reporter not running                                      */
+/*                                                                           */
+/* Post-conditions: Errors are queued for the reporter                       */
+/*                                                                           */
+/*****************************************************************************/
+
+extern serr_status_t serr_start(void);
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: serr_stop()                                                         */
+/*                                                                           */
+/* Description: Stop the reporter thread, once it has reported everything    */
+/*              queued                                                       */
+/*                                                                           */
+/* Parameters:                                                               */
+/*   Name            Type           Comments                                 */
+/*   ------------    ------------  -----------------------------------       */
+/*                                                                           */
+/* Returns: void                                                             */
+/*                                                                           */
+/* Pre-conditions:                                                           */
+/*                                                                           */
+/* Post-conditions: Reporter not running, all errors reported                */
+/*                                                                           */
+/*****************************************************************************/
+
+extern void serr_stop(void);
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: serr_report()                                                       */
+/*                                                                           */
+/* Description: Report a framing error, corrupt byte or timeout. Only one    */
+/*              thread may report errors. This never waits: if the queue is  */
+/*              full, the error is counted but not shown on its own.         */
+/*                                                                           */
+/* Parameters:                                                               */
+/*   Name            Type           Comments                                 */
+/*   ------------    ------------  -----------------------------------       */
+/*   type            serr_type_t   The type of error                         */
+/*   time            time_t        When it happened                          */
+/*   tx              unsigned char The byte sent                             */
+/*   rx              unsigned char The byte received                         */
+/*                                                                           */
+/* Returns: void                                                             */
+/*                                                                           */
+/* Pre-conditions:                                                           */
+/*                                                                           */
+/* Post-conditions: Error queued, or printed if the reporter isn't running   */
+/*                                                                           */
+/*****************************************************************************/
+
+extern void serr_report(serr_type_t type, time_t time, unsigned char tx,
+  unsigned char rx);
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: serr_message()                                                      */
+/*                                                                           */
+/* Description: Report an error message, which is printed to stderr. Suits   */
+/*              serp_set_report_func(). Must be called from the same thread  */
+/*              as serr_report().                                            */
+/*                                                                           */
+/* Parameters:                                                               */
+/*   Name            Type           Comments                                 */
+/*   ------------    ------------  -----------------------------------       */
+/*   message         const char *  The message, with its newline             */
+/*                                                                           */
+/* Returns: void                                                             */
+/*                                                                           */
+/* Pre-conditions:                                                           */
+/*                                                                           */
+/* Post-conditions: Message queued, or printed if the reporter isn't running */
+/*                                                                           */
+/*****************************************************************************/
+
+extern void serr_message(const char *message);
+
+
+#endif /* SERR_H */
+
@@ -0,0 +1,460 @@
+/*****************************************************************************/
+/*                                                                           */
+/* Module: serread.c                                                         */
+/*                                                                           */
+/* Description: serbert-read, prints samples from a serbert capture          */
+/*                                                                           */
+/* Copyright (C) 2026 The Serbert contributors                               */
+/*                                                                           */
+/* This file is part of Serbert.                                             */
+/*                                                                           */
+/* Serbert is free software; you can redistribute it and/or modify           */
+/* it under the terms of the GNU General Public License as published by      */
+/* the Free Software Foundation; either version 2 of the License, or         */
+/* any later version.                                                        */
+/*                                                                           */
+/* This program is distributed in the hope that it will be useful,           */
+/* but WITHOUT ANY WARRANTY; without even the implied warranty of            */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             */
+/* GNU General Public License for more details.                              */
+/*                                                                           */
+/* You should have received a copy of the GNU General Public License         */
+/* along with this program; if not, write to the Free Software               */
+/* Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA */
+/*                                                                           */
+/*****************************************************************************/
+
+/*****************************************************************************/
+/*      INCLUDED FILES (dependencies)                                        */
+/*****************************************************************************/
+
+#include <stdio.h>       /* Standard I/O definitions - printf()            */
+#include <stdlib.h>      /* Standard library - strtod()                    */
+#include <string.h>      /* Standard string lib - strcmp()                 */
+#include <stdbool.h>     /* Boolean types                                  */
+#include <limits.h>      /* Variable max sizes - LLONG_MAX                 */
+#include <sys/types.h>   /* System types - off_t                           */
+#include "sers.h"        /* Serial statistics library - SERS_NSEC_IN_SEC   */
+#include "serc.h"        /* Capture file library                           */
+
+
+/*****************************************************************************/
+/*      INTERNAL TYPE DEFINITIONS                                            */
+/*****************************************************************************/
+
+/* Enums & constants */
+
+enum { i_EXIT_OK = 0 };              /* Exit status, all well                */
+
+enum { i_EXIT_FAULT = 1 };           /* Exit status, a fault                 */
+
+enum { i_NS_PER_US = 1000 };         /* Nanoseconds in a microsecond         */
+
+/* Types */
+
+/* The time range wanted, in ns from the start */
+typedef struct i_range_t
+{
+  long long start;                   /* Samples from this time               */
+  long long end;                     /* Up to this time                      */
+  bool past_end;                     /* Has a sample after the end been seen?*/
+} i_range_t;
+
+
+/*****************************************************************************/
+/*      INTERNAL VARIABLE DEFINITIONS                                        */
+/*****************************************************************************/
+
+/* Names of the kinds of sample */
+static const char *i_KIND_NAMES[SERC_KINDS] =
+  { "ok", "corrupt", "timeout", "framing" };
+
+
+/*****************************************************************************/
+/*      INTERNAL FUNCTIONS                                                   */
+/*****************************************************************************/
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: i_print_sample()                                                    */
+/*                                                                           */
+/* Description: Prints a sample, if it's in the range wanted                 */
+/*                                                                           */
+/* Uses: sample - The sample                                                 */
+/*       context - The range wanted                                          */
+/*                                                                           */
+/* Returns: void                                                             */
+/*                                                                           */
+/*****************************************************************************/
+
+static void i_print_sample(const serc_sample_t *sample, void *context)
+{
+
+  i_range_t *range = (i_range_t *) context; /* The range wanted */
+
+
+  if(sample->time > range->end)
+  {
+
+    range->past_end = true;
+
+  }
+  else if(sample->time >= range->start)
+  {
+
+    printf("%llu %lld.%06lld %s ", sample->number,
+      sample->time / SERS_NSEC_IN_SEC,
+      (sample->time % SERS_NSEC_IN_SEC) / i_NS_PER_US,
+      i_KIND_NAMES[sample->kind]);
+
+    if(sample->return_time >= 0)
+    {
+
+      printf("%lld", sample->return_time / i_NS_PER_US);
+
+    }
+    else
+    {
+
+      printf("-");
+
+    }
+
+    if(sample->tx >= 0)
+    {
+
+      printf(" %02x", (unsigned int) sample->tx);
+
+    }
+
+    if(sample->rx != SERC_NO_RX)
+    {
+
+      printf(" %02x", (unsigned int) sample->rx);
+
+    }
+
+    printf("\n");
+
+  }
+
+}
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: i_print_summary()                                                   */
+/*                                                                           */
+/* Description: Prints what a capture holds, from its header and index      */
+/*                                                                           */
+/* Uses: capture - The capture                                               */
+/*                                                                           */
+/* Returns: void                                                             */
+/*                                                                           */
+/*****************************************************************************/
+
+static void i_print_summary(const serc_capture_t *capture)
+{
+
+  char port[SERC_PORT_LEN];               /* The port, terminated */
+  const serc_index_t *last;               /* The last block's entry */
+  serc_block_t head;                      /* The last block's header */
+  unsigned long long bytes = 0;           /* Bytes captured */
+  long long span = 0;                     /* Time they cover, in ns */
+  off_t file_len;                         /* Length of the file */
+
+
+  memcpy(port, capture->header.port, sizeof(port) );
+
+  port[sizeof(port) - 1] = '\0';
+
+  (void) fseeko(capture->file, 0, SEEK_END);
+
+  file_len = ftello(capture->file);
+
+  if(capture->blocks > 0)
+  {
+
+    last = &capture->index[capture->blocks - 1];
+
+    span = last->last_time * (long long) capture->header.tick_ns;
+
+    /* Only the last block's header need be read to count the bytes */
+    if( (fseeko(capture->file, (off_t) last->offset, SEEK_SET) == 0)
+      && (fread(&head, sizeof(head), 1, capture->file) == 1) )
+    {
+
+      bytes = head.first_byte + head.samples;
+
+    }
+
+  }
+
+  printf("Capture of %s at %lu baud\n", port,
+    (unsigned long) capture->header.baud);
+
+  printf("Blocks: %lu%s\n", (unsigned long) capture->blocks,
+    (capture->indexed == true) ? "" : " (no index, test did not finish)");
+
+  printf("Covers: %lld.%06lld secs\n", span / SERS_NSEC_IN_SEC,
+    (span % SERS_NSEC_IN_SEC) / i_NS_PER_US);
+
+  printf("Bytes captured: %llu\n", bytes);
+
+  printf("File size: %lld bytes", (long long) file_len);
+
+  if(bytes > 0)
+  {
+
+    printf(", %.2f per byte captured", (double) file_len / (double) bytes);
+
+  }
+
+  printf("\n");
+
+}
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: i_get_secs()                                                        */
+/*                                                                           */
+/* Description: Gets a time in seconds from an argument                      */
+/*                                                                           */
+/* Uses: arg - The argument                                                  */
+/*       time - Where to put the time, in ns                                 */
+/*                                                                           */
+/* Returns: true if the argument is a time, else false                       */
+/*                                                                           */
+/*****************************************************************************/
+
+static bool i_get_secs(const char *arg, long long *time)
+{
+
+  bool valid = false;                     /* Is the argument a time? */
+  double secs;                            /* The time in seconds */
+  char *end_ptr;                          /* End of the time */
+
+
+  if(arg != NULL)
+  {
+
+    secs = strtod(arg, &end_ptr);
+
+    if( (end_ptr != arg) && (*end_ptr == '\0') && (secs >= 0.0)
+      && (secs < 1e9) )
+    {
+
+      *time = (long long) (secs * SERS_NSEC_IN_SEC);
+
+      valid = true;
+
+    }
+
+  }
+
+  return valid;
+
+}
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: i_read_capture()                                                    */
+/*                                                                           */
+/* Description: Prints the samples in a time range from a capture. Only the  */
+/*              blocks covering the range are read.                          */
+/*                                                                           */
+/* Uses: path - The capture file                                             */
+/*       range - The range wanted                                            */
+/*       summary - Print a summary instead of the samples?                   */
+/*                                                                           */
+/* Returns: Exit status                                                      */
+/*                                                                           */
+/*****************************************************************************/
+
+static int i_read_capture(const char *path, i_range_t *range, bool summary)
+{
+
+  int exit_status = i_EXIT_OK;            /* Exit status */
+  serc_capture_t capture;                 /* The capture */
+  serc_status_t load_status;              /* Was it loaded? */
+  size_t block;                           /* Block being read */
+
+
+  if( (load_status = serc_load(path, &capture) ) != SERC_OK)
+  {
+
+    serc_report_load(path, load_status, &capture);
+
+    exit_status = i_EXIT_FAULT;
+
+  }
+  else
+  {
+
+    if(summary == true)
+    {
+
+      i_print_summary(&capture);
+
+    }
+    else
+    {
+
+      for(block = serc_find(&capture, range->start);
+        (block < capture.blocks) && (range->past_end == false)
+        && (exit_status == i_EXIT_OK); block++)
+      {
+
+        if(serc_read_block(&capture, block, i_print_sample, range)
+          != SERC_OK)
+        {
+
+          fprintf(stderr, "Failure reading block %lu of %s\n",
+            (unsigned long) block, path);
+
+          exit_status = i_EXIT_FAULT;
+
+        }
+
+      }
+
+    }
+
+    serc_unload(&capture);
+
+  }
+
+  return exit_status;
+
+}
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: i_print_help()                                                      */
+/*                                                                           */
+/* Description: Prints the usage                                             */
+/*                                                                           */
+/* Uses: void                                                                */
+/*                                                                           */
+/* Returns: void                                                             */
+/*                                                                           */
+/*****************************************************************************/
+
+static void i_print_help(void)
+{
+
+  printf("\nUsage: serbert-read [-hi] [-s SECS] [-e SECS] FILE\n\n");
+
+  printf("Prints the bytes captured by serbert -L, one per line:\n");
+
+  printf("byte number, secs from the start, result, return time in us,\n");
+
+  printf("and for errors the bytes sent and received\n\n");
+
+  printf(" -e - Print bytes up to this many secs from the start\n");
+
+  printf(" -h - Print this help\n");
+
+  printf(" -i - Print a summary of the capture instead\n");
+
+  printf(" -s - Print bytes from this many secs from the start\n\n");
+
+}
+
+
+/*****************************************************************************/
+/*      MAIN                                                                 */
+/*****************************************************************************/
+
+int main(int argc, char *argv[])
+{
+
+  int exit_status = i_EXIT_OK;            /* Exit status */
+  bool help = false;                      /* Only printing the help? */
+  bool summary = false;                   /* Printing a summary? */
+  const char *path = NULL;                /* The capture file */
+  i_range_t range;                        /* The range wanted */
+  int arg_no;                             /* Argument being processed */
+
+
+  range.start = 0;
+
+  range.end = LLONG_MAX;
+
+  range.past_end = false;
+
+  for(arg_no = 1; (arg_no < argc) && (exit_status == i_EXIT_OK)
+    && (help == false); arg_no++)
+  {
+
+    if(strcmp(argv[arg_no], "-h") == 0)
+    {
+
+      i_print_help();
+
+      help = true;
+
+    }
+    else if(strcmp(argv[arg_no], "-i") == 0)
+    {
+
+      summary = true;
+
+    }
+    else if( (strcmp(argv[arg_no], "-s") == 0) && (arg_no + 1 < argc)
+      && (i_get_secs(argv[arg_no + 1], &range.start) == true) )
+    {
+
+      arg_no++;
+
+    }
+    else if( (strcmp(argv[arg_no], "-e") == 0) && (arg_no + 1 < argc)
+      && (i_get_secs(argv[arg_no + 1], &range.end) == true) )
+    {
+
+      arg_no++;
+
+    }
+    else if( (argv[arg_no][0] == '-') || (path != NULL) )
+    {
+
+      fprintf(stderr, "Invalid argument: %s\n", argv[arg_no]);
+
+      i_print_help();
+
+      exit_status = i_EXIT_FAULT;
+
+    }
+    else
+    {
+
+      path = argv[arg_no];
+
+    }
+
+  }
+
+  if( (exit_status == i_EXIT_OK) && (help == false) )
+  {
+
+    if(path == NULL)
+    {
+
+      fprintf(stderr, "No capture file given\n");
+
+      i_print_help();
+
+      exit_status = i_EXIT_FAULT;
+
+    }
+    else
+    {
+
+      exit_status = i_read_capture(path, &range, summary);
+
+    }
+
+  }
+
+  return exit_status;
+
+}
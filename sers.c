@@ -0,0 +1,2427 @@
+/*****************************************************************************/
+/*                                                                           */
+/* Module: sers.c                                                            */
+/*                                                                           */
+/* Description: Statistics for serial Bit Error Rate Tests                   */
+/*                                                                           */
+/* Copyright (C) 2026 The Serbert contributors                               */
+/*                                                                           */
+/* This file is part of Serbert.                                             */
+/*                                                                           */
+/* Serbert is free software; you can redistribute it and/or modify           */
+/* it under the terms of the GNU General Public License as published by      */
+/* the Free Software Foundation; either version 2 of the License, or         */
+/* any later version.                                                        */
+/*                                                                           */
+/* This program is distributed in the hope that it will be useful,           */
+/* but WITHOUT ANY WARRANTY; without even the implied warranty of            */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             */
+/* GNU General Public License for more details.                              */
+/*                                                                           */
+/* You should have received a copy of the GNU General Public License         */
+/* along with this program; if not, write to the Free Software               */
+/* Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA */
+/*                                                                           */
+/*****************************************************************************/
+
+
+/*****************************************************************************/
+/*      INCLUDED FILES (dependencies)                                        */
+/*****************************************************************************/
+
+#include <stdio.h>       /* Standard I/O - printf()                        */
+#include <string.h>      /* Standard string lib - memset()                 */
+#include <math.h>        /* Maths lib - log(), sqrt(), erfc()              */
+#include <stdbool.h>     /* Boolean types                                  */
+#include <time.h>        /* Time functions - localtime_r()                 */
+#include "sers.h"        /* Header file for this library                   */
+
+
+/*****************************************************************************/
+/*      INTERNAL MACRO DEFINITIONS                                           */
+/*****************************************************************************/
+
+/*****************************************************************************/
+/*  Name:                                                                    */
+/*  Description:                                                             */
+/*  Parameters:                                                              */
+/*  Client functions:                                                        */
+/*****************************************************************************/
+
+
+/*****************************************************************************/
+/*      INTERNAL TYPE DEFINITIONS                                            */
+/*****************************************************************************/
+
+/* Enums */
+
+enum { i_NORMAL_RANGE = 40 };  /* Normal quantiles are searched for within */
+                               /* this many standard deviations of 0       */
+
+enum { i_TOD_SHADES = 8 };     /* Shades in the time of day heatmap        */
+
+enum { i_TOD_DECADE = 8 };     /* Added to log10 of an error rate for a    */
+                               /* shade                                    */
+
+enum { i_TOD_LEGEND_LINE = 4 };
+                               /* Shades to a line of the heatmap legend   */
+
+enum { i_TOD_MINUTE_MARK = 10 };
+                               /* Minutes between heatmap column labels    */
+
+
+/*****************************************************************************/
+/*      INTERNAL VARIABLE DEFINITIONS                                        */
+/*****************************************************************************/
+
+/* Names of the days, as numbered by localtime() */
+static const char *i_TOD_DAY_NAMES[SERS_TOD_DAYS] =
+  { "Sun", "Mon", "Tue", "Wed", "Thu", "Fri", "Sat" };
+
+/* Heatmap shades, error free first then a decade of error rate each */
+static const char i_TOD_SHADE_CHARS[i_TOD_SHADES + 1] = ".:-=+*#@";
+
+/*****************************************************************************/
+/*      INTERNAL FUNCTION DEFINITIONS                                        */
+/*****************************************************************************/
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: i_abs_diff()                                                        */
+/*                                                                           */
+/* Description: Gets the magnitude of the difference of two times            */
+/*                                                                           */
+/* Uses: first  - The first time                                             */
+/*       second - The second time                                            */
+/*                                                                           */
+/* Returns: The magnitude of the difference                                  */
+/*                                                                           */
+/*****************************************************************************/
+
+static long long i_abs_diff(long long first, long long second)
+{
+
+  long long diff;     /* The difference */
+
+
+  diff = first - second;
+
+  if(diff < 0)
+  {
+
+    diff = -diff;
+
+  }
+
+  return diff;
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: i_jitter_close_window()                                             */
+/*                                                                           */
+/* Description: Store the peak-to-peak jitter of the current window          */
+/*                                                                           */
+/* Uses: jitter - The jitter measurements                                    */
+/*                                                                           */
+/* Returns: void                                                             */
+/*                                                                           */
+/*****************************************************************************/
+
+static void i_jitter_close_window(sers_jitter_t *jitter)
+{
+
+  long long ptp;       /* Peak-to-peak jitter over the window */
+
+
+  /* Only windows which had return times in them count */
+  if(jitter->window_used == true)
+  {
+
+    ptp = jitter->window_max - jitter->window_min;
+
+    sers_hist_add(&(jitter->ptp_hist), (unsigned long long) ptp);
+
+    if(ptp > jitter->ptp_max)
+    {
+
+      jitter->ptp_max = ptp;
+
+    }
+
+    jitter->window_used = false;
+
+  }
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: i_g821_outage_end()                                                 */
+/*                                                                           */
+/* Description: Note the length of the outage that has just finished        */
+/*                                                                           */
+/* Uses: g821 - The G.821 measurements                                       */
+/*                                                                           */
+/* Returns: void                                                             */
+/*                                                                           */
+/*****************************************************************************/
+
+static void i_g821_outage_end(sers_g821_t *g821)
+{
+
+  if(g821->outage_secs > g821->longest_outage)
+  {
+
+    g821->longest_outage = g821->outage_secs;
+
+  }
+
+  g821->outage_secs = 0;
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: i_g821_second()                                                     */
+/*                                                                           */
+/* Description: Count one finished second. As G.821, unavailability starts   */
+/*              with SERS_G821_WINDOW severely errored seconds in a row, and */
+/*              ends with SERS_G821_WINDOW seconds in a row which are not.   */
+/*              Seconds in such a run are held back until it is known which  */
+/*              side of the change they fall on.                             */
+/*                                                                           */
+/* Uses: g821    - The G.821 measurements                                    */
+/*       errored - Did the second have any errors?                           */
+/*       severe  - Was the second severely errored?                          */
+/*                                                                           */
+/* Returns: void                                                             */
+/*                                                                           */
+/*****************************************************************************/
+
+static void i_g821_second(sers_g821_t *g821, bool errored, bool severe)
+{
+
+  if(g821->available == true)
+  {
+
+    if(severe == true)
+    {
+
+      g821->run++;
+
+      /* Enough in a row to make the link unavailable? */
+      if(g821->run >= (unsigned int) SERS_G821_WINDOW)
+      {
+
+        g821->available = false;
+
+        g821->unavail_secs += g821->run;
+
+        g821->outages++;
+
+        g821->outage_secs = g821->run;
+
+        g821->run = 0;
+
+        g821->run_errored = 0;
+
+      }
+
+    }
+    else
+    {
+
+      /* The link stayed available, so the held back seconds count as SES */
+      g821->avail_secs += g821->run + 1;
+
+      g821->errored_secs += g821->run;
+
+      g821->severe_secs += g821->run;
+
+      g821->run = 0;
+
+      if(errored == true)
+      {
+
+        g821->errored_secs++;
+
+      }
+      else
+      {
+
+        g821->free_secs++;
+
+      }
+
+    }
+
+  }
+  else
+  {
+
+    if(severe == false)
+    {
+
+      g821->run++;
+
+      if(errored == true)
+      {
+
+        g821->run_errored++;
+
+      }
+
+      /* Enough in a row to make the link available again? */
+      if(g821->run >= (unsigned int) SERS_G821_WINDOW)
+      {
+
+        g821->available = true;
+
+        g821->avail_secs += g821->run;
+
+        g821->errored_secs += g821->run_errored;
+
+        g821->free_secs += g821->run - g821->run_errored;
+
+        g821->run = 0;
+
+        g821->run_errored = 0;
+
+        i_g821_outage_end(g821);
+
+      }
+
+    }
+    else
+    {
+
+      /* The link stayed unavailable */
+      g821->unavail_secs += g821->run + 1;
+
+      g821->outage_secs += g821->run + 1;
+
+      g821->run = 0;
+
+      g821->run_errored = 0;
+
+    }
+
+  }
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: i_g821_seconds()                                                    */
+/*                                                                           */
+/* Description: Count a number of finished seconds which are all alike.      */
+/*              Once SERS_G821_WINDOW have been counted one at a time the    */
+/*              availability cannot change, so the rest are added in one go. */
+/*                                                                           */
+/* Uses: g821    - The G.821 measurements                                    */
+/*       count   - The number of seconds                                     */
+/*       errored - Did the seconds have errors?                              */
+/*       severe  - Were the seconds severely errored?                        */
+/*                                                                           */
+/* Returns: void                                                             */
+/*                                                                           */
+/*****************************************************************************/
+
+static void i_g821_seconds(sers_g821_t *g821, long long count, bool errored,
+  bool severe)
+{
+
+  long long done;      /* Seconds counted one at a time */
+
+
+  for(done = 0; (done < count) && (done < (long long) SERS_G821_WINDOW);
+    done++)
+  {
+
+    i_g821_second(g821, errored, severe);
+
+  }
+
+  count -= done;
+
+  if(count > 0)
+  {
+
+    if(severe == true)
+    {
+
+      g821->unavail_secs += (unsigned long long) count;
+
+      g821->outage_secs += (unsigned long long) count;
+
+    }
+    else
+    {
+
+      g821->avail_secs += (unsigned long long) count;
+
+      if(errored == true)
+      {
+
+        g821->errored_secs += (unsigned long long) count;
+
+      }
+      else
+      {
+
+        g821->free_secs += (unsigned long long) count;
+
+      }
+
+    }
+
+  }
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: i_g821_end_second()                                                 */
+/*                                                                           */
+/* Description: Count the current second and move on to another              */
+/*                                                                           */
+/* Uses: g821   - The G.821 measurements                                     */
+/*       second - The second to move on to                                   */
+/*                                                                           */
+/* Returns: void                                                             */
+/*                                                                           */
+/*****************************************************************************/
+
+static void i_g821_end_second(sers_g821_t *g821, long long second)
+{
+
+  bool severe;         /* Was the second severely errored? */
+
+
+  severe = ( (g821->sec_errors * SERS_G821_SES_RATIO) >= g821->sec_bytes)
+    && (g821->sec_errors > 0);
+
+  i_g821_second(g821, g821->sec_errors > 0, severe);
+
+  g821->second = second;
+
+  g821->sec_bytes = 0;
+
+  g821->sec_errors = 0;
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: i_burst_end()                                                       */
+/*                                                                           */
+/* Description: Store the length of the burst that has just finished         */
+/*                                                                           */
+/* Uses: burst - The burst measurements                                      */
+/*                                                                           */
+/* Returns: void                                                             */
+/*                                                                           */
+/*****************************************************************************/
+
+static void i_burst_end(sers_burst_t *burst)
+{
+
+  sers_hist_add(&(burst->len_bytes), burst->burst_bytes);
+
+  sers_hist_add(&(burst->len_time),
+    (unsigned long long) (burst->last_error - burst->burst_start) );
+
+  burst->in_burst = false;
+
+  burst->have_burst = true;
+
+  burst->gap_bytes = 0;
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: i_roll_add_slot()                                                   */
+/*                                                                           */
+/* Description: Add one slot's counts to a window total, or take them off    */
+/*                                                                           */
+/* Uses: window - The window total                                           */
+/*       slot   - The slot                                                   */
+/*       add    - Add the slot if true, take it off if false                 */
+/*                                                                           */
+/* Returns: void                                                             */
+/*                                                                           */
+/*****************************************************************************/
+
+static void i_roll_add_slot(sers_roll_slot_t *window,
+  const sers_roll_slot_t *slot, bool add)
+{
+
+  unsigned int bucket;      /* The current histogram bucket */
+
+
+  /* Most slots are empty on a quiet line, so don't bother with them */
+  if(slot->bytes > 0)
+  {
+
+    if(add == true)
+    {
+
+      window->bytes += slot->bytes;
+
+      window->errors += slot->errors;
+
+      window->timeouts += slot->timeouts;
+
+      window->latency.samples += slot->latency.samples;
+
+      for(bucket = 0; bucket < (unsigned int) SERS_HIST_BUCKETS; bucket++)
+      {
+
+        window->latency.count[bucket] += slot->latency.count[bucket];
+
+      }
+
+    }
+    else
+    {
+
+      window->bytes -= slot->bytes;
+
+      window->errors -= slot->errors;
+
+      window->timeouts -= slot->timeouts;
+
+      window->latency.samples -= slot->latency.samples;
+
+      for(bucket = 0; bucket < (unsigned int) SERS_HIST_BUCKETS; bucket++)
+      {
+
+        window->latency.count[bucket] -= slot->latency.count[bucket];
+
+      }
+
+    }
+
+  }
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: i_roll_count()                                                      */
+/*                                                                           */
+/* Description: Count one byte in a slot or window total                     */
+/*                                                                           */
+/* Uses: slot      - The slot or window total                                */
+/*       errored   - Was the byte corrupt or timed out?                      */
+/*       timed_out - Did the byte time out?                                  */
+/*       latency   - The return time in ns, or < 0 if none                   */
+/*                                                                           */
+/* Returns: void                                                             */
+/*                                                                           */
+/*****************************************************************************/
+
+static void i_roll_count(sers_roll_slot_t *slot, bool errored, bool timed_out,
+  long long latency)
+{
+
+  slot->bytes++;
+
+  if(errored == true)
+  {
+
+    slot->errors++;
+
+  }
+
+  if(timed_out == true)
+  {
+
+    slot->timeouts++;
+
+  }
+
+  /* The largest return time ever is kept as the max of a window total, */
+  /* as it can't be taken off again. Percentiles only use it as a cap.  */
+  if(latency >= 0)
+  {
+
+    sers_hist_add(&(slot->latency), (unsigned long long) latency);
+
+  }
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: i_roll_next_second()                                                */
+/*                                                                           */
+/* Description: Move the rolling windows on by one second                    */
+/*                                                                           */
+/* Uses: roll - The rolling windows                                          */
+/*                                                                           */
+/* Returns: void                                                             */
+/*                                                                           */
+/*****************************************************************************/
+
+static void i_roll_next_second(sers_roll_t *roll)
+{
+
+  sers_roll_slot_t *slot;   /* The slot being reused */
+  long long minute;         /* The minute now        */
+
+
+  roll->second++;
+
+  /* The slot for this second last held the second a minute ago */
+  slot = &(roll->secs[roll->second % SERS_ROLL_SECS]);
+
+  i_roll_add_slot(&(roll->window[SERS_ROLL_1_MIN]), slot, false);
+
+  (void) memset(slot, 0, sizeof(*slot));
+
+  /* Starting a new minute? */
+  if( (roll->second % SERS_ROLL_SECS) == 0)
+  {
+
+    minute = roll->second / SERS_ROLL_SECS;
+
+    /* The minute that has just left the 15 minute window */
+    i_roll_add_slot(&(roll->window[SERS_ROLL_15_MIN]),
+      &(roll->mins[ (minute + SERS_ROLL_MINS - SERS_ROLL_SHORT_MINS)
+      % SERS_ROLL_MINS]), false);
+
+    /* The slot for this minute last held the minute an hour ago */
+    slot = &(roll->mins[minute % SERS_ROLL_MINS]);
+
+    i_roll_add_slot(&(roll->window[SERS_ROLL_1_HOUR]), slot, false);
+
+    (void) memset(slot, 0, sizeof(*slot));
+
+  }
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: i_normal_quantile()                                                 */
+/*                                                                           */
+/* Description: Gets the point of the standard normal distribution that is   */
+/*              exceeded with a given chance, by bisection. It is only       */
+/*              needed once for a test.                                      */
+/*                                                                           */
+/* Uses: alpha - The chance, 0 to 1                                          */
+/*                                                                           */
+/* Returns: The point                                                        */
+/*                                                                           */
+/*****************************************************************************/
+
+static double i_normal_quantile(double alpha)
+{
+
+  double low = -i_NORMAL_RANGE;   /* Point known to be too low  */
+  double high = i_NORMAL_RANGE;   /* Point known to be too high */
+  double mid;                     /* The point being tried      */
+  unsigned int tries;             /* Number of bisections done  */
+
+
+  for(tries = 0; tries < (unsigned int) SERS_BER_TRIES; tries++)
+  {
+
+    mid = (low + high) / 2.0;
+
+    if(0.5 * erfc(mid / sqrt(2.0) ) > alpha)
+    {
+
+      low = mid;
+
+    }
+    else
+    {
+
+      high = mid;
+
+    }
+
+  }
+
+  return high;
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: i_poisson_upper()                                                   */
+/*                                                                           */
+/* Description: Gets the upper confidence limit on the mean number of        */
+/*              events, given the number seen: the mean at which seeing no   */
+/*              more has the test's chance. With none seen it is exact,      */
+/*              otherwise it is the Wilson-Hilferty form of the chi-square   */
+/*              quantile, within 0.5% at 95% confidence, and closer with     */
+/*              more events.                                                 */
+/*                                                                           */
+/* Uses: ber    - The target BER test                                        */
+/*       events - The number of events seen                                  */
+/*                                                                           */
+/* Returns: The mean                                                         */
+/*                                                                           */
+/*****************************************************************************/
+
+static double i_poisson_upper(const sers_ber_t *ber, unsigned long long events)
+{
+
+  double limit;             /* The mean                      */
+  double next;              /* One more than the events seen */
+  double root;              /* Cube root of limit / next     */
+
+
+  if(events == 0)
+  {
+
+    limit = -log(ber->alpha);
+
+  }
+  else
+  {
+
+    next = (double) events + 1.0;
+
+    root = 1.0 - (1.0 / (9.0 * next) ) + (ber->z / (3.0 * sqrt(next) ) );
+
+    limit = next * root * root * root;
+
+  }
+
+  return limit;
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: i_poisson_lower()                                                   */
+/*                                                                           */
+/* Description: Gets the lower confidence limit on the mean number of        */
+/*              events, given the number seen: the mean at which seeing at   */
+/*              least as many has the test's chance. With one seen it is     */
+/*              exact, otherwise it is the Wilson-Hilferty form, which is    */
+/*              close with many events and errs low with few, so the target  */
+/*              isn't disproven too soon.                                    */
+/*                                                                           */
+/* Uses: ber    - The target BER test                                        */
+/*       events - The number of events seen, at least 1                      */
+/*                                                                           */
+/* Returns: The mean                                                         */
+/*                                                                           */
+/*****************************************************************************/
+
+static double i_poisson_lower(const sers_ber_t *ber, unsigned long long events)
+{
+
+  double limit = 0.0;       /* The mean                      */
+  double seen;              /* The events seen               */
+  double root;              /* Cube root of limit / seen     */
+
+
+  if(events == 1)
+  {
+
+    limit = -log(1.0 - ber->alpha);
+
+  }
+  else
+  {
+
+    seen = (double) events;
+
+    root = 1.0 - (1.0 / (9.0 * seen) ) - (ber->z / (3.0 * sqrt(seen) ) );
+
+    if(root > 0.0)
+    {
+
+      limit = seen * root * root * root;
+
+    }
+
+  }
+
+  return limit;
+
+}
+
+
+/*****************************************************************************/
+/*      EXTERNAL VARIABLE DEFINITIONS                                        */
+/*****************************************************************************/
+
+
+/*****************************************************************************/
+/*      EXTERNAL FUNCTION DEFINITIONS                                        */
+/*****************************************************************************/
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: sers_hist_init()                                                    */
+/*                                                                           */
+/* Description: Clear a histogram                                            */
+/*                                                                           */
+/* Internal functions used:                                                  */
+/*                                                                           */
+/* Internal variables used:                                                  */
+/*                                                                           */
+/* Parameters:                                                               */
+/*   Name            Type           Comments                                 */
+/*   ------------    ------------   -----------------------------------      */
+/*   hist            sers_hist_t    The histogram to clear                   */
+/*                                                                           */
+/* Returns: void                                                             */
+/*                                                                           */
+/*****************************************************************************/
+
+extern void sers_hist_init(sers_hist_t *hist)
+{
+
+  (void) memset(hist, 0, sizeof(*hist));
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: sers_hist_bucket()                                                  */
+/*                                                                           */
+/* Description: Gets the bucket a value falls into. Values below             */
+/*              SERS_HIST_SUB have a bucket each, above that each power of   */
+/*              two is split into SERS_HIST_SUB equal buckets.               */
+/*                                                                           */
+/* Internal functions used:                                                  */
+/*                                                                           */
+/* Internal variables used:                                                  */
+/*                                                                           */
+/* Parameters:                                                               */
+/*   Name            Type               Comments                             */
+/*   ------------    ------------       -----------------------------------  */
+/*   value           unsigned long long The value, in nanoseconds            */
+/*                                                                           */
+/* Returns: The bucket number                                                */
+/*                                                                           */
+/*****************************************************************************/
+
+extern unsigned int sers_hist_bucket(unsigned long long value)
+{
+
+  unsigned int bucket;   /* The bucket the value belongs in     */
+  unsigned int msb;      /* The most significant bit of value   */
+  unsigned int sub;      /* The bucket within the octave        */
+
+
+  if(value < (unsigned long long) SERS_HIST_SUB)
+  {
+
+    bucket = (unsigned int) value;
+
+  }
+  else
+  {
+
+    msb = 63 - (unsigned int) __builtin_clzll(value);
+
+    /* Take the bits just below the most significant one */
+    sub = (unsigned int) (value >> (msb - SERS_HIST_SUB_BITS))
+      & (SERS_HIST_SUB - 1);
+
+    bucket = ( (msb - SERS_HIST_SUB_BITS + 1) * SERS_HIST_SUB) + sub;
+
+    /* Pile anything too big into the last bucket */
+    if(bucket >= (unsigned int) SERS_HIST_BUCKETS)
+    {
+
+      bucket = SERS_HIST_BUCKETS - 1;
+
+    }
+
+  }
+
+  return bucket;
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: sers_hist_bucket_low()                                              */
+/*                                                                           */
+/* Description: Gets the lowest value held by a bucket                       */
+/*                                                                           */
+/* Internal functions used:                                                  */
+/*                                                                           */
+/* Internal variables used:                                                  */
+/*                                                                           */
+/* Parameters:                                                               */
+/*   Name            Type           Comments                                 */
+/*   ------------    ------------   -----------------------------------      */
+/*   bucket          unsigned int   The bucket number                        */
+/*                                                                           */
+/* Returns: The lowest value, in nanoseconds                                 */
+/*                                                                           */
+/*****************************************************************************/
+
+extern unsigned long long sers_hist_bucket_low(unsigned int bucket)
+{
+
+  unsigned long long low;  /* The lowest value in the bucket */
+  unsigned int shift;      /* Scaling of the octave          */
+
+
+  if(bucket < (unsigned int) SERS_HIST_SUB)
+  {
+
+    low = (unsigned long long) bucket;
+
+  }
+  else
+  {
+
+    shift = (bucket / SERS_HIST_SUB) - 1;
+
+    low = (unsigned long long) (SERS_HIST_SUB + (bucket % SERS_HIST_SUB))
+      << shift;
+
+  }
+
+  return low;
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: sers_hist_merge()                                                   */
+/*                                                                           */
+/* Description: Add the samples of one histogram to another                  */
+/*                                                                           */
+/* Internal functions used:                                                  */
+/*                                                                           */
+/* Internal variables used:                                                  */
+/*                                                                           */
+/* Parameters:                                                               */
+/*   Name            Type           Comments                                 */
+/*   ------------    ------------   -----------------------------------      */
+/*   into            sers_hist_t    The histogram added to                   */
+/*   from            sers_hist_t    The histogram whose samples are added    */
+/*                                                                           */
+/* Returns: void                                                             */
+/*                                                                           */
+/*****************************************************************************/
+
+extern void sers_hist_merge(sers_hist_t *into, const sers_hist_t *from)
+{
+
+  unsigned int bucket;    /* Bucket being added */
+
+
+  for(bucket = 0; bucket < SERS_HIST_BUCKETS; bucket++)
+  {
+
+    into->count[bucket] += from->count[bucket];
+
+  }
+
+  into->samples += from->samples;
+
+  if(from->max > into->max)
+  {
+
+    into->max = from->max;
+
+  }
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: sers_hist_add()                                                     */
+/*                                                                           */
+/* Description: Add a sample to a histogram                                  */
+/*                                                                           */
+/* Internal functions used:                                                  */
+/*                                                                           */
+/* Internal variables used:                                                  */
+/*                                                                           */
+/* Parameters:                                                               */
+/*   Name            Type               Comments                             */
+/*   ------------    ------------       -----------------------------------  */
+/*   hist            sers_hist_t        The histogram                        */
+/*   value           unsigned long long The sample, in nanoseconds           */
+/*                                                                           */
+/* Returns: void                                                             */
+/*                                                                           */
+/*****************************************************************************/
+
+extern void sers_hist_add(sers_hist_t *hist, unsigned long long value)
+{
+
+  hist->count[sers_hist_bucket(value)]++;
+
+  hist->samples++;
+
+  if(value > hist->max)
+  {
+
+    hist->max = value;
+
+  }
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: sers_hist_percentile()                                              */
+/*                                                                           */
+/* Description: Gets the value below which a percentage of samples fall      */
+/*                                                                           */
+/* Internal functions used:                                                  */
+/*                                                                           */
+/* Internal variables used:                                                  */
+/*                                                                           */
+/* Parameters:                                                               */
+/*   Name            Type           Comments                                 */
+/*   ------------    ------------   -----------------------------------      */
+/*   hist            sers_hist_t    The histogram                            */
+/*   percent         double         The percentile wanted, 0 to 100          */
+/*                                                                           */
+/* Returns: The top of the bucket holding the percentile, in nanoseconds     */
+/*                                                                           */
+/*****************************************************************************/
+
+extern unsigned long long sers_hist_percentile(const sers_hist_t *hist,
+  double percent)
+{
+
+  unsigned long long value = 0;  /* The percentile value                 */
+  unsigned long long wanted;     /* No. of samples at or below the value */
+  unsigned long long so_far = 0; /* Samples counted so far               */
+  unsigned int bucket;           /* The current bucket                   */
+  bool found = false;            /* Found the bucket yet?                */
+
+
+  if(hist->samples > 0)
+  {
+
+    /* Work out how many samples must be at or below the value */
+    wanted = (unsigned long long) ( ( (double) hist->samples * percent)
+      / 100.0);
+
+    if(wanted < 1)
+    {
+
+      wanted = 1;
+
+    }
+
+    for(bucket = 0; (bucket < (unsigned int) SERS_HIST_BUCKETS) &&
+      (found == false); bucket++)
+    {
+
+      so_far += hist->count[bucket];
+
+      if(so_far >= wanted)
+      {
+
+        found = true;
+
+        /* Use the top of the bucket, but never beyond the largest sample */
+        if(bucket < (unsigned int) (SERS_HIST_BUCKETS - 1) )
+        {
+
+          value = sers_hist_bucket_low(bucket + 1) - 1;
+
+        }
+        else
+        {
+
+          value = hist->max;
+
+        }
+
+        if(value > hist->max)
+        {
+
+          value = hist->max;
+
+        }
+
+      }
+
+    }
+
+  }
+
+  return value;
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: sers_jitter_init()                                                  */
+/*                                                                           */
+/* Description: Reset the jitter measurements                                */
+/*                                                                           */
+/* Internal functions used: sers_hist_init()                                 */
+/*                                                                           */
+/* Internal variables used:                                                  */
+/*                                                                           */
+/* Parameters:                                                               */
+/*   Name            Type           Comments                                 */
+/*   ------------    ------------   -----------------------------------      */
+/*   jitter          sers_jitter_t  The jitter measurements                  */
+/*                                                                           */
+/* Returns: void                                                             */
+/*                                                                           */
+/*****************************************************************************/
+
+extern void sers_jitter_init(sers_jitter_t *jitter)
+{
+
+  jitter->have_last = false;
+
+  jitter->last_transit = 0;
+
+  jitter->jitter = 0;
+
+  jitter->window = 0;
+
+  jitter->window_used = false;
+
+  jitter->window_min = 0;
+
+  jitter->window_max = 0;
+
+  jitter->ptp_max = 0;
+
+  sers_hist_init(&(jitter->diff_hist));
+
+  sers_hist_init(&(jitter->ptp_hist));
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: sers_jitter_add()                                                   */
+/*                                                                           */
+/* Description: Add a return time to the jitter measurements. The smoothed   */
+/*              jitter is the RFC 3550 estimator, J += (|D| - J) / 16, kept  */
+/*              scaled by 16 so integer maths loses nothing. Peak-to-peak    */
+/*              jitter is taken over each second of receive time.            */
+/*                                                                           */
+/* Internal functions used: i_abs_diff()                                     */
+/*                          i_jitter_close_window()                          */
+/*                          sers_hist_add()                                  */
+/*                                                                           */
+/* Internal variables used:                                                  */
+/*                                                                           */
+/* Parameters:                                                               */
+/*   Name            Type           Comments                                 */
+/*   ------------    ------------   -----------------------------------      */
+/*   jitter          sers_jitter_t  The jitter measurements                  */
+/*   transit         long long      The return time, in nanoseconds          */
+/*   rx_time         long long      When the byte was received, in nanosecs  */
+/*                                                                           */
+/* Returns: void                                                             */
+/*                                                                           */
+/*****************************************************************************/
+
+extern void sers_jitter_add(sers_jitter_t *jitter, long long transit,
+  long long rx_time)
+{
+
+  long long diff;         /* Change in return time since the last byte */
+  long long window;       /* The second this byte was received in      */
+
+
+  if(jitter->have_last == true)
+  {
+
+    diff = i_abs_diff(transit, jitter->last_transit);
+
+    /* RFC 3550 A.8: J += |D| - ((J + 8) >> 4), with J scaled by 16 */
+    jitter->jitter += diff - ( (jitter->jitter + (SERS_JITTER_GAIN / 2) )
+      / SERS_JITTER_GAIN);
+
+    sers_hist_add(&(jitter->diff_hist), (unsigned long long) diff);
+
+  }
+
+  jitter->last_transit = transit;
+
+  jitter->have_last = true;
+
+  /* Has the byte arrived in a new peak-to-peak window? */
+  window = rx_time / SERS_NSEC_IN_SEC;
+
+  if(window != jitter->window)
+  {
+
+    i_jitter_close_window(jitter);
+
+    jitter->window = window;
+
+  }
+
+  if(jitter->window_used == false)
+  {
+
+    jitter->window_min = transit;
+
+    jitter->window_max = transit;
+
+    jitter->window_used = true;
+
+  }
+  else
+  {
+
+    if(transit < jitter->window_min)
+    {
+
+      jitter->window_min = transit;
+
+    }
+
+    if(transit > jitter->window_max)
+    {
+
+      jitter->window_max = transit;
+
+    }
+
+  }
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: sers_jitter_close()                                                 */
+/*                                                                           */
+/* Description: Close the current peak-to-peak window                        */
+/*                                                                           */
+/* Internal functions used: i_jitter_close_window()                          */
+/*                                                                           */
+/* Internal variables used:                                                  */
+/*                                                                           */
+/* Parameters:                                                               */
+/*   Name            Type           Comments                                 */
+/*   ------------    ------------   -----------------------------------      */
+/*   jitter          sers_jitter_t  The jitter measurements                  */
+/*                                                                           */
+/* Returns: void                                                             */
+/*                                                                           */
+/*****************************************************************************/
+
+extern void sers_jitter_close(sers_jitter_t *jitter)
+{
+
+  i_jitter_close_window(jitter);
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: sers_jitter_get()                                                   */
+/*                                                                           */
+/* Description: Gets the current smoothed jitter                             */
+/*                                                                           */
+/* Internal functions used:                                                  */
+/*                                                                           */
+/* Internal variables used:                                                  */
+/*                                                                           */
+/* Parameters:                                                               */
+/*   Name            Type           Comments                                 */
+/*   ------------    ------------   -----------------------------------      */
+/*   jitter          sers_jitter_t  The jitter measurements                  */
+/*                                                                           */
+/* Returns: The smoothed jitter, in nanoseconds                              */
+/*                                                                           */
+/*****************************************************************************/
+
+extern long long sers_jitter_get(const sers_jitter_t *jitter)
+{
+
+  return jitter->jitter / SERS_JITTER_GAIN;
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: sers_g821_init()                                                    */
+/*                                                                           */
+/* Description: Reset the G.821 measurements                                 */
+/*                                                                           */
+/* Internal functions used:                                                  */
+/*                                                                           */
+/* Internal variables used:                                                  */
+/*                                                                           */
+/* Parameters:                                                               */
+/*   Name            Type           Comments                                 */
+/*   ------------    ------------   -----------------------------------      */
+/*   g821            sers_g821_t    The G.821 measurements                   */
+/*                                                                           */
+/* Returns: void                                                             */
+/*                                                                           */
+/*****************************************************************************/
+
+extern void sers_g821_init(sers_g821_t *g821)
+{
+
+  (void) memset(g821, 0, sizeof(*g821));
+
+  g821->available = true;
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: sers_g821_add_second()                                              */
+/*                                                                           */
+/* Description: Add the results of testing the bytes of a whole second to    */
+/*              the G.821 measurements                                       */
+/*                                                                           */
+/* Internal functions used: i_g821_end_second(), i_g821_seconds()            */
+/*                                                                           */
+/* Internal variables used:                                                  */
+/*                                                                           */
+/* Parameters:                                                               */
+/*   Name            Type               Comments                             */
+/*   ------------    ------------       -----------------------------------  */
+/*   g821            sers_g821_t        The G.821 measurements               */
+/*   second          long long          The second                           */
+/*   bytes           unsigned long long Bytes tested in it                   */
+/*   errors          unsigned long long Errored bytes in it                  */
+/*                                                                           */
+/* Returns: void                                                             */
+/*                                                                           */
+/*****************************************************************************/
+
+extern void sers_g821_add_second(sers_g821_t *g821, long long second,
+  unsigned long long bytes, unsigned long long errors)
+{
+
+  if(g821->started == false)
+  {
+
+    g821->second = second;
+
+    g821->started = true;
+
+  }
+
+  /* Finish off the current second, and any idle ones since */
+  if(second > g821->second)
+  {
+
+    i_g821_end_second(g821, second);
+
+    i_g821_seconds(g821, second - g821->second - 1, false, false);
+
+    g821->second = second;
+
+  }
+
+  g821->sec_bytes += bytes;
+
+  g821->sec_errors += errors;
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: sers_g821_add()                                                     */
+/*                                                                           */
+/* Description: Add the result of testing one byte. The byte counts in the   */
+/*              second it was sent. Seconds with no bytes sent are error     */
+/*              free, unless an errored byte was outstanding the whole time, */
+/*              e.g. a long timeout, in which case they are severely errored.*/
+/*                                                                           */
+/* Internal functions used: i_g821_end_second(), i_g821_seconds()            */
+/*                                                                           */
+/* Internal variables used:                                                  */
+/*                                                                           */
+/* Parameters:                                                               */
+/*   Name            Type           Comments                                 */
+/*   ------------    ------------   -----------------------------------      */
+/*   g821            sers_g821_t    The G.821 measurements                   */
+/*   start           long long      When the byte was sent, in nanoseconds   */
+/*   end             long long      When the test of the byte ended, in ns   */
+/*   errored         bool           Was the byte corrupt or timed out?       */
+/*                                                                           */
+/* Returns: void                                                             */
+/*                                                                           */
+/*****************************************************************************/
+
+extern void sers_g821_add(sers_g821_t *g821, long long start, long long end,
+  bool errored)
+{
+
+  long long start_sec;    /* The second the byte was sent in         */
+  long long end_sec;      /* The second the test of the byte ended   */
+
+
+  start_sec = start / SERS_NSEC_IN_SEC;
+
+  end_sec = end / SERS_NSEC_IN_SEC;
+
+  if(g821->started == false)
+  {
+
+    g821->second = start_sec;
+
+    g821->started = true;
+
+  }
+
+  /* Finish off the current second, and any idle ones since */
+  if(start_sec > g821->second)
+  {
+
+    i_g821_end_second(g821, start_sec);
+
+    i_g821_seconds(g821, start_sec - g821->second - 1, false, false);
+
+    g821->second = start_sec;
+
+  }
+
+  g821->sec_bytes++;
+
+  if(errored == true)
+  {
+
+    g821->sec_errors++;
+
+    /* The line was bad for every whole second the byte was outstanding */
+    if(end_sec > (start_sec + 1) )
+    {
+
+      i_g821_end_second(g821, end_sec);
+
+      i_g821_seconds(g821, end_sec - start_sec - 1, true, true);
+
+    }
+
+  }
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: sers_g821_close()                                                   */
+/*                                                                           */
+/* Description: Count the current second, then settle the seconds whose      */
+/*              availability is undecided as the state the link is now in    */
+/*                                                                           */
+/* Internal functions used: i_g821_end_second(), i_g821_outage_end()         */
+/*                                                                           */
+/* Internal variables used:                                                  */
+/*                                                                           */
+/* Parameters:                                                               */
+/*   Name            Type           Comments                                 */
+/*   ------------    ------------   -----------------------------------      */
+/*   g821            sers_g821_t    The G.821 measurements                   */
+/*                                                                           */
+/* Returns: void                                                             */
+/*                                                                           */
+/*****************************************************************************/
+
+extern void sers_g821_close(sers_g821_t *g821)
+{
+
+  if(g821->started == true)
+  {
+
+    i_g821_end_second(g821, g821->second + 1);
+
+    if(g821->available == true)
+    {
+
+      g821->avail_secs += g821->run;
+
+      g821->errored_secs += g821->run;
+
+      g821->severe_secs += g821->run;
+
+    }
+    else
+    {
+
+      g821->unavail_secs += g821->run;
+
+      g821->outage_secs += g821->run;
+
+      i_g821_outage_end(g821);
+
+    }
+
+    g821->run = 0;
+
+    g821->run_errored = 0;
+
+    g821->started = false;
+
+  }
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: sers_burst_init()                                                   */
+/*                                                                           */
+/* Description: Reset the error burst measurements                           */
+/*                                                                           */
+/* Internal functions used:                                                  */
+/*                                                                           */
+/* Internal variables used:                                                  */
+/*                                                                           */
+/* Parameters:                                                               */
+/*   Name            Type           Comments                                 */
+/*   ------------    ------------   -----------------------------------      */
+/*   burst           sers_burst_t   The burst measurements                   */
+/*                                                                           */
+/* Returns: void                                                             */
+/*                                                                           */
+/*****************************************************************************/
+
+extern void sers_burst_init(sers_burst_t *burst)
+{
+
+  (void) memset(burst, 0, sizeof(*burst));
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: sers_burst_add()                                                    */
+/*                                                                           */
+/* Description: Add the result of testing one byte. A burst is a run of      */
+/*              errored bytes with no good byte between them. Its length in  */
+/*              time runs from its first errored byte to its last, and the   */
+/*              gap runs from the last errored byte of one burst to the      */
+/*              first of the next.                                           */
+/*                                                                           */
+/* Internal functions used: i_burst_end()                                    */
+/*                                                                           */
+/* Internal variables used:                                                  */
+/*                                                                           */
+/* Parameters:                                                               */
+/*   Name            Type           Comments                                 */
+/*   ------------    ------------   -----------------------------------      */
+/*   burst           sers_burst_t   The burst measurements                   */
+/*   time            long long      When the test of the byte ended, in ns   */
+/*   errored         bool           Was the byte corrupt or timed out?       */
+/*                                                                           */
+/* Returns: void                                                             */
+/*                                                                           */
+/*****************************************************************************/
+
+extern void sers_burst_add(sers_burst_t *burst, long long time, bool errored)
+{
+
+  if(errored == true)
+  {
+
+    /* Start of a new burst? */
+    if(burst->in_burst == false)
+    {
+
+      /* There is only a gap if there was a burst before */
+      if(burst->have_burst == true)
+      {
+
+        sers_hist_add(&(burst->gap_bytes_hist), burst->gap_bytes);
+
+        sers_hist_add(&(burst->gap_time),
+          (unsigned long long) (time - burst->last_error) );
+
+      }
+
+      burst->in_burst = true;
+
+      burst->burst_bytes = 0;
+
+      burst->burst_start = time;
+
+    }
+
+    burst->burst_bytes++;
+
+    burst->last_error = time;
+
+  }
+  else
+  {
+
+    /* A good byte ends any burst */
+    if(burst->in_burst == true)
+    {
+
+      i_burst_end(burst);
+
+    }
+
+    burst->gap_bytes++;
+
+  }
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: sers_burst_close()                                                  */
+/*                                                                           */
+/* Description: End any burst still going on                                 */
+/*                                                                           */
+/* Internal functions used: i_burst_end()                                    */
+/*                                                                           */
+/* Internal variables used:                                                  */
+/*                                                                           */
+/* Parameters:                                                               */
+/*   Name            Type           Comments                                 */
+/*   ------------    ------------   -----------------------------------      */
+/*   burst           sers_burst_t   The burst measurements                   */
+/*                                                                           */
+/* Returns: void                                                             */
+/*                                                                           */
+/*****************************************************************************/
+
+extern void sers_burst_close(sers_burst_t *burst)
+{
+
+  if(burst->in_burst == true)
+  {
+
+    i_burst_end(burst);
+
+  }
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: sers_roll_init()                                                    */
+/*                                                                           */
+/* Description: Reset the rolling windows                                    */
+/*                                                                           */
+/* Internal functions used:                                                  */
+/*                                                                           */
+/* Internal variables used:                                                  */
+/*                                                                           */
+/* Parameters:                                                               */
+/*   Name            Type           Comments                                 */
+/*   ------------    ------------   -----------------------------------      */
+/*   roll            sers_roll_t    The rolling windows                      */
+/*                                                                           */
+/* Returns: void                                                             */
+/*                                                                           */
+/*****************************************************************************/
+
+extern void sers_roll_init(sers_roll_t *roll)
+{
+
+  (void) memset(roll, 0, sizeof(*roll));
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: sers_roll_advance()                                                 */
+/*                                                                           */
+/* Description: Move the rolling windows on to a time. After an hour or      */
+/*              more every slot has gone, so the windows are just cleared.   */
+/*                                                                           */
+/* Internal functions used: i_roll_next_second()                             */
+/*                                                                           */
+/* Internal variables used:                                                  */
+/*                                                                           */
+/* Parameters:                                                               */
+/*   Name            Type           Comments                                 */
+/*   ------------    ------------   -----------------------------------      */
+/*   roll            sers_roll_t    The rolling windows                      */
+/*   time            long long      The time now, in nanoseconds             */
+/*                                                                           */
+/* Returns: void                                                             */
+/*                                                                           */
+/*****************************************************************************/
+
+extern void sers_roll_advance(sers_roll_t *roll, long long time)
+{
+
+  long long second;         /* The second to move on to */
+
+
+  second = time / SERS_NSEC_IN_SEC;
+
+  if(roll->started == false)
+  {
+
+    roll->second = second;
+
+    roll->started = true;
+
+  }
+  else if( (second - roll->second) > (SERS_ROLL_SECS * SERS_ROLL_MINS) )
+  {
+
+    sers_roll_init(roll);
+
+    roll->second = second;
+
+    roll->started = true;
+
+  }
+  else
+  {
+
+    while(roll->second < second)
+    {
+
+      i_roll_next_second(roll);
+
+    }
+
+  }
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: sers_roll_add()                                                     */
+/*                                                                           */
+/* Description: Add the result of testing one byte to the rolling windows    */
+/*                                                                           */
+/* Internal functions used: i_roll_count()                                   */
+/*                                                                           */
+/* Internal variables used:                                                  */
+/*                                                                           */
+/* Parameters:                                                               */
+/*   Name            Type           Comments                                 */
+/*   ------------    ------------   -----------------------------------      */
+/*   roll            sers_roll_t    The rolling windows                      */
+/*   time            long long      When the test of the byte ended, in ns   */
+/*   errored         bool           Was the byte corrupt or timed out?       */
+/*   timed_out       bool           Did the byte time out?                   */
+/*   latency         long long      The return time in ns, or < 0 if none    */
+/*                                                                           */
+/* Returns: void                                                             */
+/*                                                                           */
+/*****************************************************************************/
+
+extern void sers_roll_add(sers_roll_t *roll, long long time, bool errored,
+  bool timed_out, long long latency)
+{
+
+  unsigned int window;      /* The current window */
+
+
+  sers_roll_advance(roll, time);
+
+  i_roll_count(&(roll->secs[roll->second % SERS_ROLL_SECS]), errored,
+    timed_out, latency);
+
+  i_roll_count(&(roll->mins[ (roll->second / SERS_ROLL_SECS)
+    % SERS_ROLL_MINS]), errored, timed_out, latency);
+
+  for(window = 0; window < (unsigned int) SERS_ROLL_WINDOWS; window++)
+  {
+
+    i_roll_count(&(roll->window[window]), errored, timed_out, latency);
+
+  }
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: sers_bits_init()                                                    */
+/*                                                                           */
+/* Description: Reset the bit and byte value error counts                    */
+/*                                                                           */
+/* Internal functions used:                                                  */
+/*                                                                           */
+/* Internal variables used:                                                  */
+/*                                                                           */
+/* Parameters:                                                               */
+/*   Name            Type           Comments                                 */
+/*   ------------    ------------   -----------------------------------      */
+/*   bits            sers_bits_t    The error counts                         */
+/*                                                                           */
+/* Returns: void                                                             */
+/*                                                                           */
+/*****************************************************************************/
+
+extern void sers_bits_init(sers_bits_t *bits)
+{
+
+  (void) memset(bits, 0, sizeof(*bits));
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: sers_bits_add()                                                     */
+/*                                                                           */
+/* Description: Count a byte sent, and whether it was errored                */
+/*                                                                           */
+/* Internal functions used:                                                  */
+/*                                                                           */
+/* Internal variables used:                                                  */
+/*                                                                           */
+/* Parameters:                                                               */
+/*   Name            Type           Comments                                 */
+/*   ------------    ------------   -----------------------------------      */
+/*   bits            sers_bits_t    The error counts                         */
+/*   tx              unsigned char  The byte sent                            */
+/*   errored         bool           Was the byte corrupt or timed out?       */
+/*                                                                           */
+/* Returns: void                                                             */
+/*                                                                           */
+/*****************************************************************************/
+
+extern void sers_bits_add(sers_bits_t *bits, unsigned char tx, bool errored)
+{
+
+  bits->sent[tx]++;
+
+  if(errored == true)
+  {
+
+    bits->errors[tx]++;
+
+  }
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: sers_bits_merge()                                                   */
+/*                                                                           */
+/* Description: Add one set of errors by bit and value to another            */
+/*                                                                           */
+/* Internal functions used:                                                  */
+/*                                                                           */
+/* Internal variables used:                                                  */
+/*                                                                           */
+/* Parameters:                                                               */
+/*   Name            Type           Comments                                 */
+/*   ------------    ------------   -----------------------------------      */
+/*   into            sers_bits_t    The errors added to                      */
+/*   from            sers_bits_t    The errors added                         */
+/*                                                                           */
+/* Returns: void                                                             */
+/*                                                                           */
+/*****************************************************************************/
+
+extern void sers_bits_merge(sers_bits_t *into, const sers_bits_t *from)
+{
+
+  unsigned int value;     /* Byte value being added   */
+  unsigned int bit;       /* Bit position being added */
+
+
+  for(value = 0; value < SERS_BYTE_VALUES; value++)
+  {
+
+    into->sent[value] += from->sent[value];
+
+    into->errors[value] += from->errors[value];
+
+  }
+
+  for(bit = 0; bit < SERS_BIT_POSITIONS; bit++)
+  {
+
+    into->flips[bit] += from->flips[bit];
+
+  }
+
+  into->rises += from->rises;
+
+  into->falls += from->falls;
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: sers_bits_corrupt()                                                 */
+/*                                                                           */
+/* Description: Count the bits that differ in a corrupt byte, by position    */
+/*              and by direction                                             */
+/*                                                                           */
+/* Internal functions used:                                                  */
+/*                                                                           */
+/* Internal variables used:                                                  */
+/*                                                                           */
+/* Parameters:                                                               */
+/*   Name            Type           Comments                                 */
+/*   ------------    ------------   -----------------------------------      */
+/*   bits            sers_bits_t    The error counts                         */
+/*   tx              unsigned char  The byte sent                            */
+/*   rx              unsigned char  The byte received                        */
+/*   framing         bool           Was a framing or parity error reported?  */
+/*                                                                           */
+/* Returns: void                                                             */
+/*                                                                           */
+/*****************************************************************************/
+
+extern void sers_bits_corrupt(sers_bits_t *bits, unsigned char tx,
+  unsigned char rx, bool framing)
+{
+
+  unsigned int diff;    /* Bits that differ, still to be counted */
+  unsigned int bit;     /* Position of the lowest differing bit  */
+
+
+  diff = (unsigned int) (tx ^ rx);
+
+  /* Work through just the bits that differ */
+  while(diff != 0)
+  {
+
+    bit = (unsigned int) __builtin_ctz(diff);
+
+    bits->flips[bit]++;
+
+    diff &= diff - 1;
+
+  }
+
+  bits->rises += (unsigned long long) __builtin_popcount( (unsigned int)
+    (~tx & rx) );
+
+  bits->falls += (unsigned long long) __builtin_popcount( (unsigned int)
+    (tx & ~rx) );
+
+  if(framing == true)
+  {
+
+    bits->flips[SERS_BIT_STOP]++;
+
+  }
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: sers_tod_init()                                                     */
+/*                                                                           */
+/* Description: Clear the errors by time of day                              */
+/*                                                                           */
+/* Internal functions used:                                                  */
+/*                                                                           */
+/* Internal variables used:                                                  */
+/*                                                                           */
+/* Parameters:                                                               */
+/*   Name            Type           Comments                                 */
+/*   ------------    ------------   -----------------------------------      */
+/*   tod             sers_tod_t     The errors by time of day                */
+/*                                                                           */
+/* Returns: void                                                             */
+/*                                                                           */
+/*****************************************************************************/
+
+extern void sers_tod_init(sers_tod_t *tod)
+{
+
+  (void) memset(tod, 0, sizeof(*tod));
+
+  /* No second has been broken down yet */
+  tod->second = -1;
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: sers_tod_add()                                                      */
+/*                                                                           */
+/* Description: Add the result of testing a byte to the errors by time of    */
+/*              day                                                          */
+/*                                                                           */
+/* Internal functions used:                                                  */
+/*                                                                           */
+/* Internal variables used:                                                  */
+/*                                                                           */
+/* Parameters:                                                               */
+/*   Name            Type           Comments                                 */
+/*   ------------    ------------   -----------------------------------      */
+/*   tod             sers_tod_t     The errors by time of day                */
+/*   time            long long      When the test of the byte ended, in ns   */
+/*                                  since the epoch                          */
+/*   errored         bool           Was the byte corrupt or did it time out? */
+/*   timed_out       bool           Did it time out?                         */
+/*                                                                           */
+/* Returns: void                                                             */
+/*                                                                           */
+/*****************************************************************************/
+
+extern void sers_tod_add(sers_tod_t *tod, long long time, bool errored,
+  bool timed_out)
+{
+
+  time_t second;          /* The second the byte's test ended in */
+  struct tm local;        /* Its local time                      */
+
+
+  second = (time_t) (time / SERS_NSEC_IN_SEC);
+
+  /* Breaking the time down takes a while, so only do it once a second */
+  if( ( (long long) second != tod->second)
+    && (localtime_r(&second, &local) != NULL) )
+  {
+
+    tod->second = (long long) second;
+
+    tod->minute = (unsigned int) ( (local.tm_hour * SERS_TOD_HOUR_MINS)
+      + local.tm_min);
+
+    tod->day = (unsigned int) local.tm_wday;
+
+  }
+
+  /* Only count once the time has been broken down */
+  if(tod->second >= 0)
+  {
+
+    tod->bytes[tod->minute]++;
+
+    tod->day_bytes[tod->day]++;
+
+    if(errored == true)
+    {
+
+      tod->errors[tod->minute]++;
+
+      tod->day_errors[tod->day]++;
+
+    }
+
+    if(timed_out == true)
+    {
+
+      tod->timeouts[tod->minute]++;
+
+      tod->day_timeouts[tod->day]++;
+
+    }
+
+  }
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: sers_tod_merge()                                                    */
+/*                                                                           */
+/* Description: Add one set of errors by time of day to another              */
+/*                                                                           */
+/* Internal functions used:                                                  */
+/*                                                                           */
+/* Internal variables used:                                                  */
+/*                                                                           */
+/* Parameters:                                                               */
+/*   Name            Type           Comments                                 */
+/*   ------------    ------------   -----------------------------------      */
+/*   into            sers_tod_t     The errors added to                      */
+/*   from            sers_tod_t     The errors added                         */
+/*                                                                           */
+/* Returns: void                                                             */
+/*                                                                           */
+/*****************************************************************************/
+
+extern void sers_tod_merge(sers_tod_t *into, const sers_tod_t *from)
+{
+
+  unsigned int minute;    /* Minute of the day being added  */
+  unsigned int day;       /* Day of the week being added    */
+
+
+  for(minute = 0; minute < SERS_TOD_MINS; minute++)
+  {
+
+    into->bytes[minute] += from->bytes[minute];
+
+    into->errors[minute] += from->errors[minute];
+
+    into->timeouts[minute] += from->timeouts[minute];
+
+  }
+
+  for(day = 0; day < SERS_TOD_DAYS; day++)
+  {
+
+    into->day_bytes[day] += from->day_bytes[day];
+
+    into->day_errors[day] += from->day_errors[day];
+
+    into->day_timeouts[day] += from->day_timeouts[day];
+
+  }
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: sers_tod_shade()                                                    */
+/*                                                                           */
+/* Description: Get the heatmap shade for an error rate, one for each decade */
+/*                                                                           */
+/* Internal functions used:                                                  */
+/*                                                                           */
+/* Internal variables used: i_TOD_SHADE_CHARS                                */
+/*                                                                           */
+/* Parameters:                                                               */
+/*   Name            Type           Comments                                 */
+/*   ------------    ------------   -----------------------------------      */
+/*   errors          unsigned long long Errored bytes                        */
+/*   bytes           unsigned long long Bytes tested                         */
+/*                                                                           */
+/* Returns: The shade, a space if nothing was tested                         */
+/*                                                                           */
+/*****************************************************************************/
+
+extern char sers_tod_shade(unsigned long long errors,
+  unsigned long long bytes)
+{
+
+  char shade = ' ';    /* The shade        */
+  int level = 0;       /* Its number       */
+
+
+  if(bytes > 0)
+  {
+
+    if(errors > 0)
+    {
+
+      level = (int) floor(log10( (double) errors / (double) bytes) )
+        + i_TOD_DECADE;
+
+      level = (level < 1) ? 1 : level;
+
+      level = (level > i_TOD_SHADES - 1) ? i_TOD_SHADES - 1 : level;
+
+    }
+
+    shade = i_TOD_SHADE_CHARS[level];
+
+  }
+
+  return shade;
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: sers_tod_print()                                                    */
+/*                                                                           */
+/* Description: Print the errors by local time as a heatmap, a row for each  */
+/*              hour of the day and a column for each minute, with its       */
+/*              legend, then the errors by day of the week. Interference     */
+/*              from equipment on a timer shows up as a column or row of     */
+/*              darker shades.                                               */
+/*                                                                           */
+/* Internal functions used:                                                  */
+/*                                                                           */
+/* Internal variables used: i_TOD_SHADE_CHARS, i_TOD_DAY_NAMES               */
+/*                                                                           */
+/* Parameters:                                                               */
+/*   Name            Type           Comments                                 */
+/*   ------------    ------------   -----------------------------------      */
+/*   tod             sers_tod_t     The errors by time of day                */
+/*                                                                           */
+/* Returns: void                                                             */
+/*                                                                           */
+/*****************************************************************************/
+
+extern void sers_tod_print(const sers_tod_t *tod)
+{
+
+  unsigned int minute;         /* Minute of the day        */
+  unsigned int worst = 0;      /* Minute with most errors  */
+  unsigned int day;            /* Day of the week          */
+  int level;                   /* Shade in the legend      */
+
+
+  printf("\nErrors by local time, an hour to a row and a minute to a column:");
+
+  printf("\n     ");
+
+  for(minute = 0; minute < (unsigned int) SERS_TOD_HOUR_MINS;
+    minute += i_TOD_MINUTE_MARK)
+  {
+
+    printf("%-*u", i_TOD_MINUTE_MARK, minute);
+
+  }
+
+  for(minute = 0; minute < (unsigned int) SERS_TOD_MINS; minute++)
+  {
+
+    if( (minute % SERS_TOD_HOUR_MINS) == 0)
+    {
+
+      printf("\n  %02u ", minute / SERS_TOD_HOUR_MINS);
+
+    }
+
+    printf("%c", sers_tod_shade(tod->errors[minute], tod->bytes[minute]) );
+
+    if(tod->errors[minute] > tod->errors[worst])
+    {
+
+      worst = minute;
+
+    }
+
+  }
+
+  /* The legend, a few shades to a line */
+  for(level = 0; level < i_TOD_SHADES; level++)
+  {
+
+    printf( ( (level % i_TOD_LEGEND_LINE) == 0) ? "\n  " : "  ");
+
+    if(level == 0)
+    {
+
+      printf("%c none    ", i_TOD_SHADE_CHARS[level]);
+
+    }
+    else if(level == 1)
+    {
+
+      printf("%c <  1e-%d ", i_TOD_SHADE_CHARS[level], i_TOD_DECADE - 2);
+
+    }
+    else
+    {
+
+      printf("%c >= 1e-%d ", i_TOD_SHADE_CHARS[level],
+        i_TOD_DECADE - level);
+
+    }
+
+  }
+
+  if(tod->errors[worst] > 0)
+  {
+
+    printf("\nWorst minute of the day = %02u:%02u, %llu errors in %llu bytes",
+      worst / SERS_TOD_HOUR_MINS, worst % SERS_TOD_HOUR_MINS,
+      tod->errors[worst], tod->bytes[worst]);
+
+  }
+
+  printf("\nErrors by day of the week:");
+
+  for(day = 0; day < (unsigned int) SERS_TOD_DAYS; day++)
+  {
+
+    if(tod->day_bytes[day] > 0)
+    {
+
+      printf("\n  %s : %llu errors, %llu timeouts in %llu bytes",
+        i_TOD_DAY_NAMES[day], tod->day_errors[day], tod->day_timeouts[day],
+        tod->day_bytes[day]);
+
+    }
+
+  }
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: sers_ber_init()                                                     */
+/*                                                                           */
+/* Description: Start a test against a target bit error ratio                */
+/*                                                                           */
+/* Internal functions used: i_normal_quantile(), i_poisson_upper()           */
+/*                                                                           */
+/* Internal variables used:                                                  */
+/*                                                                           */
+/* Parameters:                                                               */
+/*   Name            Type           Comments                                 */
+/*   ------------    ------------   -----------------------------------      */
+/*   ber             sers_ber_t     The target BER test                      */
+/*   target          double         The target bit error ratio, 0 to 1       */
+/*   confidence      double         The confidence level wanted, 0 to 100    */
+/*                                                                           */
+/* Returns: void                                                             */
+/*                                                                           */
+/*****************************************************************************/
+
+extern void sers_ber_init(sers_ber_t *ber, double target, double confidence)
+{
+
+  (void) memset(ber, 0, sizeof(*ber));
+
+  ber->target = target;
+
+  ber->alpha = (100.0 - confidence) / 100.0;
+
+  ber->z = i_normal_quantile(ber->alpha);
+
+  ber->limit = i_poisson_upper(ber, 0);
+
+  ber->proof_bits = ber->limit / target;
+
+  ber->state = SERS_BER_TESTING;
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: sers_ber_update()                                                   */
+/*                                                                           */
+/* Description: Check the target against the bits tested and errors so far   */
+/*                                                                           */
+/* Internal functions used: i_poisson_lower(), i_poisson_upper()             */
+/*                                                                           */
+/* Internal variables used:                                                  */
+/*                                                                           */
+/* Parameters:                                                               */
+/*   Name            Type               Comments                             */
+/*   ------------    ------------       -----------------------------------  */
+/*   ber             sers_ber_t         The target BER test                  */
+/*   bits            unsigned long long Bits tested so far                   */
+/*   errors          unsigned long long Bit errors seen so far               */
+/*                                                                           */
+/* Returns: Whether the target is proven, disproven or still being tested    */
+/*                                                                           */
+/*****************************************************************************/
+
+extern sers_ber_state_t sers_ber_update(sers_ber_t *ber,
+  unsigned long long bits, unsigned long long errors)
+{
+
+  if(ber->state == SERS_BER_TESTING)
+  {
+
+    if(errors > ber->errors)
+    {
+
+      ber->errors = errors;
+
+      /* Disproven if this many errors is unlikely at the target ratio */
+      if( (double) bits * ber->target <= i_poisson_lower(ber, errors) )
+      {
+
+        ber->state = SERS_BER_DISPROVEN;
+
+      }
+
+      /* More errors need more bits to prove the target */
+      ber->limit = i_poisson_upper(ber, errors);
+
+      ber->proof_bits = ber->limit / ber->target;
+
+    }
+
+    if( (ber->state == SERS_BER_TESTING)
+      && ( (double) bits >= ber->proof_bits) )
+    {
+
+      ber->state = SERS_BER_PROVEN;
+
+    }
+
+  }
+
+  return ber->state;
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: sers_ber_upper()                                                    */
+/*                                                                           */
+/* Description: Gets the upper confidence bound on the bit error ratio       */
+/*                                                                           */
+/* Internal functions used:                                                  */
+/*                                                                           */
+/* Internal variables used:                                                  */
+/*                                                                           */
+/* Parameters:                                                               */
+/*   Name            Type               Comments                             */
+/*   ------------    ------------       -----------------------------------  */
+/*   ber             sers_ber_t         The target BER test                  */
+/*   bits            unsigned long long Bits tested so far                   */
+/*                                                                           */
+/* Returns: The upper bound, or 1 if no bits have been tested                */
+/*                                                                           */
+/*****************************************************************************/
+
+extern double sers_ber_upper(const sers_ber_t *ber, unsigned long long bits)
+{
+
+  double upper = 1.0;        /* The upper bound */
+
+
+  if(bits > 0)
+  {
+
+    upper = ber->limit / (double) bits;
+
+    if(upper > 1.0)
+    {
+
+      upper = 1.0;
+
+    }
+
+  }
+
+  return upper;
+
+}
+
@@ -0,0 +1,1028 @@
+/*****************************************************************************/
+/*                                                                           */
+/* Module: sers.h                                                            */
+/*                                                                           */
+/* Description: Header file for sers.c                                       */
+/*                                                                           */
+/* Copyright (C) 2026 The Serbert contributors                               */
+/*                                                                           */
+/* This file is part of Serbert.                                             */
+/*                                                                           */
+/* Serbert is free software; you can redistribute it and/or modify           */
+/* it under the terms of the GNU General Public License as published by      */
+/* the Free Software Foundation; either version 2 of the License, or         */
+/* any later version.                                                        */
+/*                                                                           */
+/* This program is distributed in the hope that it will be useful,           */
+/* but WITHOUT ANY WARRANTY; without even the implied warranty of            */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             */
+/* GNU General Public License for more details.                              */
+/*                                                                           */
+/* You should have received a copy of the GNU General Public License         */
+/* along with this program; if not, write to the Free Software               */
+/* Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA */
+/*                                                                           */
+/*****************************************************************************/
+
+#ifndef SERS_H
+
+#define SERS_H
+
+/*****************************************************************************/
+/*      INCLUDED FILES (dependencies)                                        */
+/*****************************************************************************/
+
+#include <stdbool.h>     /* Boolean types                                  */
+
+
+/*****************************************************************************/
+/*      MACRO DEFINITIONS                                                    */
+/*****************************************************************************/
+
+/*****************************************************************************/
+/*  Name:                                                                    */
+/*  Description:                                                             */
+/*  Parameters:                                                              */
+/*****************************************************************************/
+
+
+/*****************************************************************************/
+/*      TYPE DEFINITIONS                                                     */
+/*****************************************************************************/
+
+/* Enums & constants */
+
+enum { SERS_NSEC_IN_USEC = 1000 };   /* Nanoseconds in a microsecond         */
+
+enum { SERS_NSEC_IN_SEC = 1000000000 };
+                                     /* Nanoseconds in a second              */
+
+enum { SERS_HIST_SUB_BITS = 2 };     /* Log2 of the buckets in each octave   */
+
+enum { SERS_HIST_SUB = 1 << SERS_HIST_SUB_BITS };
+                                     /* Number of buckets in each octave     */
+
+enum { SERS_HIST_OCTAVES = 34 };     /* Octaves covered - 1ns to over 16secs */
+
+enum { SERS_HIST_BUCKETS = SERS_HIST_SUB * SERS_HIST_OCTAVES };
+                                     /* Number of buckets in a histogram     */
+
+enum { SERS_JITTER_GAIN = 16 };      /* RFC 3550 jitter filter gain, 1/16    */
+
+enum { SERS_G821_WINDOW = 10 };      /* Secs to enter or leave unavailability*/
+
+enum { SERS_G821_SES_RATIO = 100 };  /* 1 errored byte in this many is a SES */
+
+enum { SERS_ROLL_SECS = 60 };        /* Seconds held for the rolling windows */
+
+enum { SERS_ROLL_MINS = 60 };        /* Minutes held for the rolling windows */
+
+enum { SERS_ROLL_SHORT_MINS = 15 };  /* Length of the middle window, in mins */
+
+enum { SERS_BER_TRIES = 64 };        /* Bisections to find a normal quantile */
+
+enum { SERS_BYTE_VALUES = 256 };     /* Number of values a byte can have     */
+
+enum { SERS_DATA_BITS = 8 };         /* Data bits in a byte                  */
+
+enum { SERS_BIT_STOP = SERS_DATA_BITS };
+                                     /* Position used for stop/parity errors */
+
+enum { SERS_BIT_POSITIONS = SERS_DATA_BITS + 1 };
+                                     /* Bit positions counted               */
+
+enum { SERS_TOD_HOUR_MINS = 60 };    /* Minutes in an hour                   */
+
+enum { SERS_TOD_MINS = 24 * SERS_TOD_HOUR_MINS };
+                                     /* Minutes in a day                     */
+
+enum { SERS_TOD_DAYS = 7 };          /* Days in a week                       */
+
+/* Progress of a test against a target bit error ratio */
+typedef enum { SERS_BER_TESTING, SERS_BER_PROVEN,
+               SERS_BER_DISPROVEN } sers_ber_state_t;
+
+/* The rolling windows kept */
+typedef enum { SERS_ROLL_1_MIN, SERS_ROLL_15_MIN, SERS_ROLL_1_HOUR,
+               SERS_ROLL_WINDOWS } sers_roll_window_t;
+
+/* Types */
+
+/* Log-linear histogram of times in nanoseconds. Each power of two is split */
+/* into SERS_HIST_SUB buckets, so a bucket is never more than 25% wide.     */
+typedef struct sers_hist_t
+{
+  unsigned long long count[SERS_HIST_BUCKETS];
+                                     /* The number of samples in each bucket */
+  unsigned long long samples;        /* The total number of samples          */
+  unsigned long long max;            /* The largest sample seen              */
+} sers_hist_t;
+
+/* Return time jitter, after RFC 3550 section 6.4.1 */
+typedef struct sers_jitter_t
+{
+  bool have_last;            /* Is there a previous return time to use?    */
+  long long last_transit;    /* The previous return time in nanosecs       */
+  long long jitter;          /* Smoothed jitter, scaled by SERS_JITTER_GAIN*/
+  long long window;          /* The second the peak-to-peak window covers  */
+  bool window_used;          /* Has a sample landed in the window?         */
+  long long window_min;      /* Min return time in the window              */
+  long long window_max;      /* Max return time in the window              */
+  long long ptp_max;         /* Worst peak-to-peak jitter over any window  */
+  sers_hist_t diff_hist;     /* Successive return time differences         */
+  sers_hist_t ptp_hist;      /* Peak-to-peak jitter of each 1 sec window   */
+} sers_jitter_t;
+
+/* ITU-T G.821 error performance, measured in one second buckets. Each byte */
+/* is about 10 bits on the line, so 1 errored byte in SERS_G821_SES_RATIO   */
+/* is taken as the G.821 severely errored bit error ratio of 1 in 1000.     */
+typedef struct sers_g821_t
+{
+  bool started;                      /* Has the first second been seen?      */
+  long long second;                  /* The second now being filled          */
+  unsigned long long sec_bytes;      /* Bytes tested in the current second   */
+  unsigned long long sec_errors;     /* Errored bytes in the current second  */
+  bool available;                    /* Is the link available?               */
+  unsigned int run;                  /* Seconds that may change availability */
+  unsigned int run_errored;          /* Errored seconds in the run           */
+  unsigned long long avail_secs;     /* Available seconds                    */
+  unsigned long long unavail_secs;   /* Unavailable seconds                  */
+  unsigned long long errored_secs;   /* Errored seconds (ES)                 */
+  unsigned long long severe_secs;    /* Severely errored seconds (SES)       */
+  unsigned long long free_secs;      /* Error free seconds (EFS)             */
+  unsigned long long outages;        /* Number of periods of unavailability  */
+  unsigned long long outage_secs;    /* Length of the current outage         */
+  unsigned long long longest_outage; /* Length of the longest outage         */
+} sers_g821_t;
+
+/* Bursts of errored bytes, and the gaps between them */
+typedef struct sers_burst_t
+{
+  bool in_burst;                     /* Is a burst going on?                 */
+  bool have_burst;                   /* Has a burst finished yet?            */
+  unsigned long long burst_bytes;    /* Errored bytes in the current burst   */
+  long long burst_start;             /* Time of its first errored byte, ns   */
+  long long last_error;              /* Time of the last errored byte, ns    */
+  unsigned long long gap_bytes;      /* Good bytes since the last burst      */
+  sers_hist_t len_bytes;             /* Burst lengths in bytes               */
+  sers_hist_t len_time;              /* Burst lengths in nanoseconds         */
+  sers_hist_t gap_bytes_hist;        /* Gaps between bursts in bytes         */
+  sers_hist_t gap_time;              /* Gaps between bursts in nanoseconds   */
+} sers_burst_t;
+
+/* Counts for one slot of the rolling windows, or a whole window */
+typedef struct sers_roll_slot_t
+{
+  unsigned long long bytes;          /* Bytes tested                         */
+  unsigned long long errors;         /* Errored bytes                        */
+  unsigned long long timeouts;       /* Bytes which timed out                */
+  sers_hist_t latency;               /* Return times of good bytes           */
+} sers_roll_slot_t;
+
+/* Error rates and return times over the last minute, 15 minutes and hour. */
+/* The last minute is made of one second slots, the others of one minute   */
+/* slots, so they move on a minute at a time. Each window keeps a running  */
+/* total, so adding a byte or moving on a slot takes a fixed time.         */
+typedef struct sers_roll_t
+{
+  bool started;                      /* Has the first byte been added?       */
+  long long second;                  /* The current second                   */
+  sers_roll_slot_t secs[SERS_ROLL_SECS];
+                                     /* Per second counts, by second % 60    */
+  sers_roll_slot_t mins[SERS_ROLL_MINS];
+                                     /* Per minute counts, by minute % 60    */
+  sers_roll_slot_t window[SERS_ROLL_WINDOWS];
+                                     /* Running totals for each window       */
+} sers_roll_t;
+
+/* Errors by bit position and by the value of the byte sent. The serial     */
+/* driver marks parity and framing errors the same way, so they share one   */
+/* position after the data bits.                                            */
+typedef struct sers_bits_t
+{
+  unsigned long long sent[SERS_BYTE_VALUES];
+                                     /* Bytes sent, by value                 */
+  unsigned long long errors[SERS_BYTE_VALUES];
+                                     /* Errored bytes, by value sent         */
+  unsigned long long flips[SERS_BIT_POSITIONS];
+                                     /* Errors at each bit position          */
+  unsigned long long rises;          /* Data bits sent as 0 received as 1    */
+  unsigned long long falls;          /* Data bits sent as 1 received as 0    */
+} sers_bits_t;
+
+/* Errors by the local minute of the day and day of the week they happened */
+/* in, to show errors which recur at the same time each day or week. The   */
+/* local time of the last second seen is kept, so the time need only be    */
+/* broken down once a second.                                              */
+typedef struct sers_tod_t
+{
+  unsigned long long bytes[SERS_TOD_MINS];
+                                     /* Bytes tested, by minute of the day   */
+  unsigned long long errors[SERS_TOD_MINS];
+                                     /* Errored bytes, by minute of the day  */
+  unsigned long long timeouts[SERS_TOD_MINS];
+                                     /* Bytes timed out, by minute of the day*/
+  unsigned long long day_bytes[SERS_TOD_DAYS];
+                                     /* Bytes tested, by day of the week     */
+  unsigned long long day_errors[SERS_TOD_DAYS];
+                                     /* Errored bytes, by day of the week    */
+  unsigned long long day_timeouts[SERS_TOD_DAYS];
+                                     /* Bytes timed out, by day of the week  */
+  long long second;                  /* Last second seen, since the epoch    */
+  unsigned int minute;               /* Its minute of the day                */
+  unsigned int day;                  /* Its day of the week, 0 is Sunday     */
+} sers_tod_t;
+
+/* Statistical test of a target bit error ratio. Errors are taken to follow */
+/* a Poisson distribution, so the target is proven once enough bits have    */
+/* been tested for the errors seen to be unlikely at any higher ratio, and  */
+/* disproven once the errors seen are unlikely at the target ratio. The     */
+/* confidence limits are worked out in closed form, from the normal         */
+/* quantile of the confidence level.                                        */
+typedef struct sers_ber_t
+{
+  double target;                     /* The target bit error ratio           */
+  double alpha;                      /* 1 - the confidence level, 0 to 1     */
+  double z;                          /* Normal quantile exceeded with alpha  */
+  unsigned long long errors;         /* Bit errors seen so far               */
+  double limit;                      /* Upper confidence limit on the errors */
+                                     /* expected, given the errors seen      */
+  double proof_bits;                 /* Bits needed to prove the target      */
+  sers_ber_state_t state;            /* Proven, disproven or still testing   */
+} sers_ber_t;
+
+
+/*****************************************************************************/
+/*      GLOBAL VARIABLES                                                     */
+/*****************************************************************************/
+
+
+/*****************************************************************************/
+/*      FUNCTION PROTOTYPES                                                  */
+/*****************************************************************************/
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: sers_hist_init()                                                    */
+/*                                                                           */
+/* Description: Clear a histogram                                            */
+/*                                                                           */
+/* Parameters:                                                               */
+/*   Name            Type           Comments                                 */
+/*   ------------    ------------  -----------------------------------       */
+/*   hist            sers_hist_t   The histogram to clear                    */
+/*                                                                           */
+/* Returns: void                                                             */
+/*                                                                           */
+/* Pre-conditions:                                                           */
+/*                                                                           */
+/* Post-conditions: Histogram is empty                                       */
+/*                                                                           */
+/*****************************************************************************/
+
+extern void sers_hist_init(sers_hist_t *hist);
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: sers_hist_bucket()                                                  */
+/*                                                                           */
+/* Description: Gets the bucket a value falls into                           */
+/*                                                                           */
+/* Parameters:                                                               */
+/*   Name            Type               Comments                             */
+/*   ------------    ------------       -----------------------------------  */
+/*   value           unsigned long long The value, in nanoseconds            */
+/*                                                                           */
+/* Returns: The bucket number, 0 to SERS_HIST_BUCKETS - 1                    */
+/*                                                                           */
+/* Pre-conditions:                                                           */
+/*                                                                           */
+/* Post-conditions:                                                          */
+/*                                                                           */
+/*****************************************************************************/
+
+extern unsigned int sers_hist_bucket(unsigned long long value);
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: sers_hist_bucket_low()                                              */
+/*                                                                           */
+/* Description: Gets the lowest value held by a bucket                       */
+/*                                                                           */
+/* Parameters:                                                               */
+/*   Name            Type           Comments                                 */
+/*   ------------    ------------  -----------------------------------       */
+/*   bucket          unsigned int  The bucket number                         */
+/*                                                                           */
+/* Returns: The lowest value, in nanoseconds                                 */
+/*                                                                           */
+/* Pre-conditions:                                                           */
+/*                                                                           */
+/* Post-conditions:                                                          */
+/*                                                                           */
+/*****************************************************************************/
+
+extern unsigned long long sers_hist_bucket_low(unsigned int bucket);
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: sers_hist_merge()                                                   */
+/*                                                                           */
+/* Description: Add the samples of one histogram to another, as when each    */
+/*              thread of an analysis keeps its own                          */
+/*                                                                           */
+/* Parameters:                                                               */
+/*   Name            Type           Comments                                 */
+/*   ------------    ------------  -----------------------------------       */
+/*   into            sers_hist_t   The histogram added to                    */
+/*   from            sers_hist_t   The histogram whose samples are added     */
+/*                                                                           */
+/* Returns: void                                                             */
+/*                                                                           */
+/* Pre-conditions: Histograms initialised                                    */
+/*                                                                           */
+/* Post-conditions: Samples added                                            */
+/*                                                                           */
+/*****************************************************************************/
+
+extern void sers_hist_merge(sers_hist_t *into, const sers_hist_t *from);
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: sers_hist_add()                                                     */
+/*                                                                           */
+/* Description: Add a sample to a histogram                                  */
+/*                                                                           */
+/* Parameters:                                                               */
+/*   Name            Type               Comments                             */
+/*   ------------    ------------       -----------------------------------  */
+/*   hist            sers_hist_t        The histogram                        */
+/*   value           unsigned long long The sample, in nanoseconds           */
+/*                                                                           */
+/* Returns: void                                                             */
+/*                                                                           */
+/* Pre-conditions: Histogram initialised                                     */
+/*                                                                           */
+/* Post-conditions: Sample counted                                           */
+/*                                                                           */
+/*****************************************************************************/
+
+extern void sers_hist_add(sers_hist_t *hist, unsigned long long value);
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: sers_hist_percentile()                                              */
+/*                                                                           */
+/* Description: Gets the value below which a percentage of samples fall      */
+/*                                                                           */
+/* Parameters:                                                               */
+/*   Name            Type           Comments                                 */
+/*   ------------    ------------  -----------------------------------       */
+/*   hist            sers_hist_t   The histogram                             */
+/*   percent         double        The percentile wanted, 0 to 100           */
+/*                                                                           */
+/* Returns: The top of the bucket holding the percentile, in nanoseconds,    */
+/*          or 0 if the histogram is empty                                   */
+/*                                                                           */
+/* Pre-conditions: Histogram initialised                                     */
+/*                                                                           */
+/* Post-conditions:                                                          */
+/*                                                                           */
+/*****************************************************************************/
+
+extern unsigned long long sers_hist_percentile(const sers_hist_t *hist,
+  double percent);
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: sers_jitter_init()                                                  */
+/*                                                                           */
+/* Description: Reset the jitter measurements                                */
+/*                                                                           */
+/* Parameters:                                                               */
+/*   Name            Type           Comments                                 */
+/*   ------------    ------------  -----------------------------------       */
+/*   jitter          sers_jitter_t The jitter measurements                   */
+/*                                                                           */
+/* Returns: void                                                             */
+/*                                                                           */
+/* Pre-conditions:                                                           */
+/*                                                                           */
+/* Post-conditions: No samples held                                          */
+/*                                                                           */
+/*****************************************************************************/
+
+extern void sers_jitter_init(sers_jitter_t *jitter);
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: sers_jitter_add()                                                   */
+/*                                                                           */
+/* Description: Add a return time to the jitter measurements                 */
+/*                                                                           */
+/* Parameters:                                                               */
+/*   Name            Type           Comments                                 */
+/*   ------------    ------------  -----------------------------------       */
+/*   jitter          sers_jitter_t The jitter measurements                   */
+/*   transit         long long     The return time, in nanoseconds           */
+/*   rx_time         long long     When the byte was received, in nanosecs   */
+/*                                                                           */
+/* Returns: void                                                             */
+/*                                                                           */
+/* Pre-conditions: Jitter measurements initialised                           */
+/*                                                                           */
+/* Post-conditions: Smoothed jitter and histograms updated                   */
+/*                                                                           */
+/*****************************************************************************/
+
+extern void sers_jitter_add(sers_jitter_t *jitter, long long transit,
+  long long rx_time);
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: sers_jitter_close()                                                 */
+/*                                                                           */
+/* Description: Close the current peak-to-peak window, so the final part     */
+/*              second of a test is included in the results                  */
+/*                                                                           */
+/* Parameters:                                                               */
+/*   Name            Type           Comments                                 */
+/*   ------------    ------------  -----------------------------------       */
+/*   jitter          sers_jitter_t The jitter measurements                   */
+/*                                                                           */
+/* Returns: void                                                             */
+/*                                                                           */
+/* Pre-conditions: Jitter measurements initialised                           */
+/*                                                                           */
+/* Post-conditions: Peak-to-peak histogram updated                           */
+/*                                                                           */
+/*****************************************************************************/
+
+extern void sers_jitter_close(sers_jitter_t *jitter);
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: sers_jitter_get()                                                   */
+/*                                                                           */
+/* Description: Gets the current smoothed jitter                             */
+/*                                                                           */
+/* Parameters:                                                               */
+/*   Name            Type           Comments                                 */
+/*   ------------    ------------  -----------------------------------       */
+/*   jitter          sers_jitter_t The jitter measurements                   */
+/*                                                                           */
+/* Returns: The smoothed jitter, in nanoseconds                              */
+/*                                                                           */
+/* Pre-conditions: Jitter measurements initialised                           */
+/*                                                                           */
+/* Post-conditions:                                                          */
+/*                                                                           */
+/*****************************************************************************/
+
+extern long long sers_jitter_get(const sers_jitter_t *jitter);
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: sers_g821_init()                                                    */
+/*                                                                           */
+/* Description: Reset the G.821 measurements                                 */
+/*                                                                           */
+/* Parameters:                                                               */
+/*   Name            Type           Comments                                 */
+/*   ------------    ------------  -----------------------------------       */
+/*   g821            sers_g821_t   The G.821 measurements                    */
+/*                                                                           */
+/* Returns: void                                                             */
+/*                                                                           */
+/* Pre-conditions:                                                           */
+/*                                                                           */
+/* Post-conditions: No seconds counted, link available                       */
+/*                                                                           */
+/*****************************************************************************/
+
+extern void sers_g821_init(sers_g821_t *g821);
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: sers_g821_add_second()                                              */
+/*                                                                           */
+/* Description: Add the results of testing the bytes of a whole second to    */
+/*              the G.821 measurements, for counts gathered elsewhere        */
+/*                                                                           */
+/* Parameters:                                                               */
+/*   Name            Type           Comments                                 */
+/*   ------------    ------------  -----------------------------------       */
+/*   g821            sers_g821_t   The G.821 measurements                    */
+/*   second          long long     The second                                */
+/*   bytes           unsigned long long Bytes tested in it                   */
+/*   errors          unsigned long long Errored bytes in it                  */
+/*                                                                           */
+/* Returns: void                                                             */
+/*                                                                           */
+/* Pre-conditions: G.821 measurements initialised, second not before the     */
+/*                 last second added                                         */
+/*                                                                           */
+/* Post-conditions: Any seconds that have finished are counted               */
+/*                                                                           */
+/*****************************************************************************/
+
+extern void sers_g821_add_second(sers_g821_t *g821, long long second,
+  unsigned long long bytes, unsigned long long errors);
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: sers_g821_add()                                                     */
+/*                                                                           */
+/* Description: Add the result of testing one byte to the G.821 measurements */
+/*                                                                           */
+/* Parameters:                                                               */
+/*   Name            Type           Comments                                 */
+/*   ------------    ------------  -----------------------------------       */
+/*   g821            sers_g821_t   The G.821 measurements                    */
+/*   start           long long     When the byte was sent, in nanoseconds    */
+/*   end             long long     When the test of the byte ended, in nsecs */
+/*   errored         bool          Was the byte corrupt or did it time out?  */
+/*                                                                           */
+/* Returns: void                                                             */
+/*                                                                           */
+/* Pre-conditions: G.821 measurements initialised, start not before the     */
+/*                 start of the last byte added                              */
+/*                                                                           */
+/* Post-conditions: Any seconds that have finished are counted               */
+/*                                                                           */
+/*****************************************************************************/
+
+extern void sers_g821_add(sers_g821_t *g821, long long start, long long end,
+  bool errored);
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: sers_g821_close()                                                   */
+/*                                                                           */
+/* Description: Count the current second and settle any seconds whose        */
+/*              availability is still undecided, at the end of a test        */
+/*                                                                           */
+/* Parameters:                                                               */
+/*   Name            Type           Comments                                 */
+/*   ------------    ------------  -----------------------------------       */
+/*   g821            sers_g821_t   The G.821 measurements                    */
+/*                                                                           */
+/* Returns: void                                                             */
+/*                                                                           */
+/* Pre-conditions: G.821 measurements initialised                            */
+/*                                                                           */
+/* Post-conditions: All seconds counted                                      */
+/*                                                                           */
+/*****************************************************************************/
+
+extern void sers_g821_close(sers_g821_t *g821);
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: sers_burst_init()                                                   */
+/*                                                                           */
+/* Description: Reset the error burst measurements                           */
+/*                                                                           */
+/* Parameters:                                                               */
+/*   Name            Type           Comments                                 */
+/*   ------------    ------------  -----------------------------------       */
+/*   burst           sers_burst_t  The burst measurements                    */
+/*                                                                           */
+/* Returns: void                                                             */
+/*                                                                           */
+/* Pre-conditions:                                                           */
+/*                                                                           */
+/* Post-conditions: No bursts held                                           */
+/*                                                                           */
+/*****************************************************************************/
+
+extern void sers_burst_init(sers_burst_t *burst);
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: sers_burst_add()                                                    */
+/*                                                                           */
+/* Description: Add the result of testing one byte to the burst measurements */
+/*                                                                           */
+/* Parameters:                                                               */
+/*   Name            Type           Comments                                 */
+/*   ------------    ------------  -----------------------------------       */
+/*   burst           sers_burst_t  The burst measurements                    */
+/*   time            long long     When the test of the byte ended, in ns    */
+/*   errored         bool          Was the byte corrupt or timed out?        */
+/*                                                                           */
+/* Returns: void                                                             */
+/*                                                                           */
+/* Pre-conditions: Burst measurements initialised                            */
+/*                                                                           */
+/* Post-conditions: Histograms updated when a burst ends or begins           */
+/*                                                                           */
+/*****************************************************************************/
+
+extern void sers_burst_add(sers_burst_t *burst, long long time, bool errored);
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: sers_burst_close()                                                  */
+/*                                                                           */
+/* Description: End any burst still going on, at the end of a test           */
+/*                                                                           */
+/* Parameters:                                                               */
+/*   Name            Type           Comments                                 */
+/*   ------------    ------------  -----------------------------------       */
+/*   burst           sers_burst_t  The burst measurements                    */
+/*                                                                           */
+/* Returns: void                                                             */
+/*                                                                           */
+/* Pre-conditions: Burst measurements initialised                            */
+/*                                                                           */
+/* Post-conditions: Burst length histograms updated                          */
+/*                                                                           */
+/*****************************************************************************/
+
+extern void sers_burst_close(sers_burst_t *burst);
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: sers_roll_init()                                                    */
+/*                                                                           */
+/* Description: Reset the rolling windows                                    */
+/*                                                                           */
+/* Parameters:                                                               */
+/*   Name            Type           Comments                                 */
+/*   ------------    ------------  -----------------------------------       */
+/*   roll            sers_roll_t   The rolling windows                       */
+/*                                                                           */
+/* Returns: void                                                             */
+/*                                                                           */
+/* Pre-conditions:                                                           */
+/*                                                                           */
+/* Post-conditions: All windows empty                                        */
+/*                                                                           */
+/*****************************************************************************/
+
+extern void sers_roll_init(sers_roll_t *roll);
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: sers_roll_advance()                                                 */
+/*                                                                           */
+/* Description: Move the rolling windows on to a time, dropping the slots    */
+/*              which have fallen out of them                                */
+/*                                                                           */
+/* Parameters:                                                               */
+/*   Name            Type           Comments                                 */
+/*   ------------    ------------  -----------------------------------       */
+/*   roll            sers_roll_t   The rolling windows                       */
+/*   time            long long     The time now, in nanoseconds              */
+/*                                                                           */
+/* Returns: void                                                             */
+/*                                                                           */
+/* Pre-conditions: Rolling windows initialised                               */
+/*                                                                           */
+/* Post-conditions: Windows end at the given time                            */
+/*                                                                           */
+/*****************************************************************************/
+
+extern void sers_roll_advance(sers_roll_t *roll, long long time);
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: sers_roll_add()                                                     */
+/*                                                                           */
+/* Description: Add the result of testing one byte to the rolling windows    */
+/*                                                                           */
+/* Parameters:                                                               */
+/*   Name            Type           Comments                                 */
+/*   ------------    ------------  -----------------------------------       */
+/*   roll            sers_roll_t   The rolling windows                       */
+/*   time            long long     When the test of the byte ended, in ns    */
+/*   errored         bool          Was the byte corrupt or timed out?        */
+/*   timed_out       bool          Did the byte time out?                    */
+/*   latency         long long     The return time in ns, or < 0 if none     */
+/*                                                                           */
+/* Returns: void                                                             */
+/*                                                                           */
+/* Pre-conditions: Rolling windows initialised                               */
+/*                                                                           */
+/* Post-conditions: Byte counted in all windows                              */
+/*                                                                           */
+/*****************************************************************************/
+
+extern void sers_roll_add(sers_roll_t *roll, long long time, bool errored,
+  bool timed_out, long long latency);
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: sers_bits_init()                                                    */
+/*                                                                           */
+/* Description: Reset the bit and byte value error counts                    */
+/*                                                                           */
+/* Parameters:                                                               */
+/*   Name            Type           Comments                                 */
+/*   ------------    ------------  -----------------------------------       */
+/*   bits            sers_bits_t   The error counts                          */
+/*                                                                           */
+/* Returns: void                                                             */
+/*                                                                           */
+/* Pre-conditions:                                                           */
+/*                                                                           */
+/* Post-conditions: All counts zero                                          */
+/*                                                                           */
+/*****************************************************************************/
+
+extern void sers_bits_init(sers_bits_t *bits);
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: sers_bits_add()                                                     */
+/*                                                                           */
+/* Description: Count a byte sent, and whether it was errored                */
+/*                                                                           */
+/* Parameters:                                                               */
+/*   Name            Type           Comments                                 */
+/*   ------------    ------------  -----------------------------------       */
+/*   bits            sers_bits_t   The error counts                          */
+/*   tx              unsigned char The byte sent                             */
+/*   errored         bool          Was the byte corrupt or timed out?        */
+/*                                                                           */
+/* Returns: void                                                             */
+/*                                                                           */
+/* Pre-conditions: Error counts initialised                                  */
+/*                                                                           */
+/* Post-conditions: Byte counted against its value                           */
+/*                                                                           */
+/*****************************************************************************/
+
+extern void sers_bits_add(sers_bits_t *bits, unsigned char tx, bool errored);
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: sers_bits_merge()                                                   */
+/*                                                                           */
+/* Description: Add one set of errors by bit and value to another            */
+/*                                                                           */
+/* Parameters:                                                               */
+/*   Name            Type           Comments                                 */
+/*   ------------    ------------  -----------------------------------       */
+/*   into            sers_bits_t   The errors added to                       */
+/*   from            sers_bits_t   The errors added                          */
+/*                                                                           */
+/* Returns: void                                                             */
+/*                                                                           */
+/* Pre-conditions: Both initialised                                          */
+/*                                                                           */
+/* Post-conditions: Errors added                                             */
+/*                                                                           */
+/*****************************************************************************/
+
+extern void sers_bits_merge(sers_bits_t *into, const sers_bits_t *from);
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: sers_bits_corrupt()                                                 */
+/*                                                                           */
+/* Description: Count the bits that differ in a corrupt byte                 */
+/*                                                                           */
+/* Parameters:                                                               */
+/*   Name            Type           Comments                                 */
+/*   ------------    ------------  -----------------------------------       */
+/*   bits            sers_bits_t   The error counts                          */
+/*   tx              unsigned char The byte sent                             */
+/*   rx              unsigned char The byte received                         */
+/*   framing         bool          Was a framing or parity error reported?   */
+/*                                                                           */
+/* Returns: void                                                             */
+/*                                                                           */
+/* Pre-conditions: Error counts initialised                                  */
+/*                                                                           */
+/* Post-conditions: Bit position and direction counts updated                */
+/*                                                                           */
+/*****************************************************************************/
+
+extern void sers_bits_corrupt(sers_bits_t *bits, unsigned char tx,
+  unsigned char rx, bool framing);
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: sers_tod_init()                                                     */
+/*                                                                           */
+/* Description: Clear the errors by time of day                              */
+/*                                                                           */
+/* Parameters:                                                               */
+/*   Name            Type           Comments                                 */
+/*   ------------    ------------  -----------------------------------       */
+/*   tod             sers_tod_t    The errors by time of day                 */
+/*                                                                           */
+/* Returns: void                                                             */
+/*                                                                           */
+/* Pre-conditions:                                                           */
+/*                                                                           */
+/* Post-conditions: All counts zero                                          */
+/*                                                                           */
+/*****************************************************************************/
+
+extern void sers_tod_init(sers_tod_t *tod);
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: sers_tod_add()                                                      */
+/*                                                                           */
+/* Description: Add the result of testing a byte to the errors by time of    */
+/*              day                                                          */
+/*                                                                           */
+/* Parameters:                                                               */
+/*   Name            Type           Comments                                 */
+/*   ------------    ------------  -----------------------------------       */
+/*   tod             sers_tod_t    The errors by time of day                 */
+/*   time            long long     When the test of the byte ended, in ns    */
+/*                                 since the epoch                           */
+/*   errored         bool          Was the byte corrupt or did it time out?  */
+/*   timed_out       bool          Did it time out?                          */
+/*                                                                           */
+/* Returns: void                                                             */
+/*                                                                           */
+/* Pre-conditions: Errors by time of day initialised                         */
+/*                                                                           */
+/* Post-conditions: Counts for the byte's local minute and day updated       */
+/*                                                                           */
+/*****************************************************************************/
+
+extern void sers_tod_add(sers_tod_t *tod, long long time, bool errored,
+  bool timed_out);
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: sers_tod_merge()                                                    */
+/*                                                                           */
+/* Description: Add one set of errors by time of day to another, such as     */
+/*              those found by each thread analysing a capture               */
+/*                                                                           */
+/* Parameters:                                                               */
+/*   Name            Type           Comments                                 */
+/*   ------------    ------------  -----------------------------------       */
+/*   into            sers_tod_t    The errors added to                       */
+/*   from            sers_tod_t    The errors added                          */
+/*                                                                           */
+/* Returns: void                                                             */
+/*                                                                           */
+/* Pre-conditions: Both initialised                                          */
+/*                                                                           */
+/* Post-conditions: into holds the counts of both                            */
+/*                                                                           */
+/*****************************************************************************/
+
+extern void sers_tod_merge(sers_tod_t *into, const sers_tod_t *from);
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: sers_tod_shade()                                                    */
+/*                                                                           */
+/* Description: Get the heatmap shade for an error rate, one for each decade */
+/*                                                                           */
+/* Parameters:                                                               */
+/*   Name            Type           Comments                                 */
+/*   ------------    ------------  -----------------------------------       */
+/*   errors          unsigned long long Errored bytes                        */
+/*   bytes           unsigned long long Bytes tested                         */
+/*                                                                           */
+/* Returns: The shade, a space if nothing was tested                         */
+/*                                                                           */
+/* Pre-conditions:                                                           */
+/*                                                                           */
+/* Post-conditions:                                                          */
+/*                                                                           */
+/*****************************************************************************/
+
+extern char sers_tod_shade(unsigned long long errors,
+  unsigned long long bytes);
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: sers_tod_print()                                                    */
+/*                                                                           */
+/* Description: Print the errors by local time to stdout as a heatmap, a row */
+/*              for each hour and a column for each minute, with its legend, */
+/*              then the errors by day of the week                           */
+/*                                                                           */
+/* Parameters:                                                               */
+/*   Name            Type           Comments                                 */
+/*   ------------    ------------  -----------------------------------       */
+/*   tod             sers_tod_t    The errors by time of day                 */
+/*                                                                           */
+/* Returns: void                                                             */
+/*                                                                           */
+/* Pre-conditions: Errors by time of day initialised                         */
+/*                                                                           */
+/* Post-conditions:                                                          */
+/*                                                                           */
+/*****************************************************************************/
+
+extern void sers_tod_print(const sers_tod_t *tod);
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: sers_ber_init()                                                     */
+/*                                                                           */
+/* Description: Start a test against a target bit error ratio                */
+/*                                                                           */
+/* Parameters:                                                               */
+/*   Name            Type           Comments                                 */
+/*   ------------    ------------  -----------------------------------       */
+/*   ber             sers_ber_t    The target BER test                       */
+/*   target          double        The target bit error ratio, 0 to 1        */
+/*   confidence      double        The confidence level wanted, 0 to 100     */
+/*                                                                           */
+/* Returns: void                                                             */
+/*                                                                           */
+/* Pre-conditions:                                                           */
+/*                                                                           */
+/* Post-conditions: No bits tested, target neither proven nor disproven      */
+/*                                                                           */
+/*****************************************************************************/
+
+extern void sers_ber_init(sers_ber_t *ber, double target, double confidence);
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: sers_ber_update()                                                   */
+/*                                                                           */
+/* Description: Check the target against the bits tested and errors so far.  */
+/*              The limits are only worked out again, in closed form, when   */
+/*              the errors change; otherwise it is a single comparison.      */
+/*                                                                           */
+/* Parameters:                                                               */
+/*   Name            Type               Comments                             */
+/*   ------------    ------------       -----------------------------------  */
+/*   ber             sers_ber_t         The target BER test                  */
+/*   bits            unsigned long long Bits tested so far                   */
+/*   errors          unsigned long long Bit errors seen so far               */
+/*                                                                           */
+/* Returns: Whether the target is proven, disproven or still being tested    */
+/*                                                                           */
+/* Pre-conditions: Target BER test initialised                               */
+/*                                                                           */
+/* Post-conditions: Once proven or disproven, the result does not change     */
+/*                                                                           */
+/*****************************************************************************/
+
+extern sers_ber_state_t sers_ber_update(sers_ber_t *ber,
+  unsigned long long bits, unsigned long long errors);
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: sers_ber_upper()                                                    */
+/*                                                                           */
+/* Description: Gets the upper confidence bound on the bit error ratio       */
+/*                                                                           */
+/* Parameters:                                                               */
+/*   Name            Type               Comments                             */
+/*   ------------    ------------       -----------------------------------  */
+/*   ber             sers_ber_t         The target BER test                  */
+/*   bits            unsigned long long Bits tested so far                   */
+/*                                                                           */
+/* Returns: The bit error ratio the true one is below, to the confidence     */
+/*          level, or 1 if no bits have been tested                          */
+/*                                                                           */
+/* Pre-conditions: Target BER test updated with the errors so far            */
+/*                                                                           */
+/* Post-conditions:                                                          */
+/*                                                                           */
+/*****************************************************************************/
+
+extern double sers_ber_upper(const sers_ber_t *ber, unsigned long long bits);
+
+
+#endif /* SERS_H */
+
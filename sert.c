@@ -0,0 +1,1857 @@
+/*****************************************************************************/
+/*                                                                           */
+/* Module: sert.c                                                            */
+/*                                                                           */
+/* Description: Serial transports, how bytes reach a port                    */
+/*                                                                           */
+/* Copyright (C) 2026 The Serbert contributors                               */
+/*                                                                           */
+/* This file is part of Serbert.                                             */
+/*                                                                           */
+/* Serbert is free software; you can redistribute it and/or modify           */
+/* it under the terms of the GNU General Public License as published by      */
+/* the Free Software Foundation; either version 2 of the License, or         */
+/* any later version.                                                        */
+/*                                                                           */
+/* This program is distributed in the hope that it will be useful,           */
+/* but WITHOUT ANY WARRANTY; without even the implied warranty of            */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             */
+/* GNU General Public License for more details.                              */
+/*                                                                           */
+/* You should have received a copy of the GNU General Public License         */
+/* along with this program; if not, write to the Free Software               */
+/* Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA */
+/*                                                                           */
+/*****************************************************************************/
+
+
+/*****************************************************************************/
+/*      INCLUDED FILES (dependencies)                                        */
+/*****************************************************************************/
+
+#include <stdio.h>       /* Standard I/O definitions - snprintf()          */
+#include <stdint.h>      /* Fixed size integers - uint8_t                  */
+#include <string.h>      /* Standard string lib - strncmp(), memset()      */
+#include <errno.h>       /* Error numbers - errno                          */
+#include <limits.h>      /* Variable max sizes - INT_MAX                   */
+#include <unistd.h>      /* UNIX standard - read(), write(), close()       */
+#include <time.h>        /* Time functions - nanosleep()                   */
+#include <fcntl.h>       /* File control - open(), fcntl()                 */
+#include <sys/select.h>  /* Select stuff - select()                        */
+#include <sys/ioctl.h>   /* ioctl() stuff - TIOCMGET                       */
+#include <sys/socket.h>  /* Sockets - socket(), connect(), send()          */
+#include <netinet/in.h>  /* Internet sockets - IPPROTO_TCP                 */
+#include <netinet/tcp.h> /* TCP options - TCP_NODELAY                      */
+#include <netdb.h>       /* Address lookup - getaddrinfo()                 */
+#include <linux/serial.h>
+                         /* Serial stuff - serial_struct                   */
+#include "sers.h"        /* Serial statistics library - SERS_NSEC_IN_SEC   */
+#include "sere.h"        /* Loopback emulator - sere_inject()              */
+#include "sern.h"        /* Telnet coding - sern_decode()                  */
+#include "sert.h"        /* Header file for this library                   */
+
+
+/*****************************************************************************/
+/*      INTERNAL MACRO DEFINITIONS                                           */
+/*****************************************************************************/
+
+/*****************************************************************************/
+/*  Name:                                                                    */
+/*  Description:                                                             */
+/*  Parameters:                                                              */
+/*  Client functions:                                                        */
+/*****************************************************************************/
+
+
+/*****************************************************************************/
+/*      INTERNAL TYPE DEFINITIONS                                            */
+/*****************************************************************************/
+
+enum { i_MEMORY_FD = INT_MAX };      /* Descriptor of the memory loopback    */
+
+enum { i_LINES_OUT = TIOCM_RTS | TIOCM_DTR };
+                                     /* Control lines a port drives          */
+
+/* A baud rate constant, and its number */
+struct i_speed_t
+{
+  speed_t speed;                     /* The constant                         */
+  unsigned long baud;                /* The baud rate                        */
+};
+
+
+/*****************************************************************************/
+/*      INTERNAL VARIABLE DEFINITIONS                                        */
+/*****************************************************************************/
+
+static unsigned long long i_syscalls = 0;     /* System calls made on ports */
+
+static int i_lines = 0;                       /* Emulated lines driven      */
+
+static bool i_memory_in_use = false;          /* Memory loopback open       */
+
+static struct termios i_memory_options;       /* Its settings               */
+
+static unsigned char i_ring[SERT_MEMORY_LEN]; /* Bytes looped back          */
+
+static long long i_ring_due[SERT_MEMORY_LEN]; /* When each can be read      */
+
+static size_t i_ring_start = 0;               /* First byte held            */
+
+static size_t i_ring_len = 0;                 /* Bytes held                 */
+
+static long long i_sim_now = 0;               /* Virtual time, ns, or 0     */
+
+static long long i_sim_free_at = 0;           /* When the rate allows more  */
+
+static uint8_t i_sim_out[SERT_MEMORY_LEN * SERE_MARK_LEN];
+                                              /* Bytes to be looped back    */
+
+static bool i_net_in_use = false;             /* Connection open            */
+
+static bool i_net_rfc2217;                    /* ... with RFC 2217          */
+
+static bool i_net_closed;                     /* ... and closed by server   */
+
+static struct termios i_net_options;          /* Its settings               */
+
+static sern_decoder_t i_net_decoder;          /* Its telnet decoder         */
+
+static uint8_t i_net_in[SERT_NET_LEN];        /* Bytes received             */
+
+static uint8_t i_net_data[2 * SERT_NET_LEN];  /* Data to be read            */
+
+static size_t i_net_start = 0;                /* First byte of data         */
+
+static size_t i_net_len = 0;                  /* Bytes of data              */
+
+static uint8_t i_net_out[2 * SERT_NET_LEN];   /* Data escaped to be sent    */
+
+/* Baud rates sent with RFC 2217, as serbert supports */
+static const struct i_speed_t i_SPEEDS[] =
+{
+  { B50, 50 }, { B75, 75 }, { B110, 110 }, { B134, 134 }, { B150, 150 },
+  { B200, 200 }, { B300, 300 }, { B600, 600 }, { B1200, 1200 },
+  { B1800, 1800 }, { B2400, 2400 }, { B4800, 4800 }, { B9600, 9600 },
+  { B19200, 19200 }, { B38400, 38400 }, { B57600, 57600 },
+  { B115200, 115200 },
+  { 0, 0 }                                    /* Marks end of table         */
+};
+
+
+/*****************************************************************************/
+/*      INTERNAL FUNCTION DEFINITIONS                                        */
+/*****************************************************************************/
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: i_tty_open()                                                        */
+/*                                                                           */
+/* Description: Open a tty, non-blocking at first                            */
+/*                                                                           */
+/* Uses: port - The port's name                                              */
+/*                                                                           */
+/* Returns: The descriptor, or SERT_FAILURE                                  */
+/*                                                                           */
+/*****************************************************************************/
+
+static int i_tty_open(const char *port)
+{
+
+  i_syscalls++;
+
+  return open(port, O_RDWR | O_NOCTTY | O_SYNC | O_NONBLOCK);
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: i_tty_get_flags()                                                   */
+/*                                                                           */
+/* Description: Get a tty's file status flags                                */
+/*                                                                           */
+/* Uses: fd - The tty                                                        */
+/*                                                                           */
+/* Returns: The flags, or SERT_FAILURE                                       */
+/*                                                                           */
+/*****************************************************************************/
+
+static int i_tty_get_flags(int fd)
+{
+
+  i_syscalls++;
+
+  return fcntl(fd, F_GETFL, 0);
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: i_tty_set_flags()                                                   */
+/*                                                                           */
+/* Description: Set a tty's file status flags                                */
+/*                                                                           */
+/* Uses: fd - The tty                                                        */
+/*       flags - The flags                                                   */
+/*                                                                           */
+/* Returns: 0, or SERT_FAILURE                                               */
+/*                                                                           */
+/*****************************************************************************/
+
+static int i_tty_set_flags(int fd, int flags)
+{
+
+  i_syscalls++;
+
+  return fcntl(fd, F_SETFL, flags);
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: i_tty_get_config()                                                  */
+/*                                                                           */
+/* Description: Get a tty's settings                                         */
+/*                                                                           */
+/* Uses: fd - The tty                                                        */
+/*       options - Where to put the settings                                 */
+/*                                                                           */
+/* Returns: 0, or SERT_FAILURE                                               */
+/*                                                                           */
+/*****************************************************************************/
+
+static int i_tty_get_config(int fd, struct termios *options)
+{
+
+  i_syscalls++;
+
+  return tcgetattr(fd, options);
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: i_tty_configure()                                                   */
+/*                                                                           */
+/* Description: Set a tty's settings, now                                    */
+/*                                                                           */
+/* Uses: fd - The tty                                                        */
+/*       options - The settings                                              */
+/*                                                                           */
+/* Returns: 0, or SERT_FAILURE                                               */
+/*                                                                           */
+/*****************************************************************************/
+
+static int i_tty_configure(int fd, const struct termios *options)
+{
+
+  i_syscalls++;
+
+  return tcsetattr(fd, TCSANOW, options);
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: i_tty_control()                                                     */
+/*                                                                           */
+/* Description: Get or set a tty's control lines or serial flags             */
+/*                                                                           */
+/* Uses: fd - The tty                                                        */
+/*       request - The ioctl() request                                       */
+/*       arg - The request's argument                                        */
+/*                                                                           */
+/* Returns: 0, or SERT_FAILURE                                               */
+/*                                                                           */
+/*****************************************************************************/
+
+static int i_tty_control(int fd, unsigned long request, void *arg)
+{
+
+  i_syscalls++;
+
+  return ioctl(fd, request, arg);
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: i_tty_read()                                                        */
+/*                                                                           */
+/* Description: Read a block from a tty                                      */
+/*                                                                           */
+/* Uses: fd - The tty                                                        */
+/*       buf - Where to put the bytes                                        */
+/*       len - Most bytes to read                                            */
+/*                                                                           */
+/* Returns: The bytes read, or SERT_FAILURE                                  */
+/*                                                                           */
+/*****************************************************************************/
+
+static ssize_t i_tty_read(int fd, void *buf, size_t len)
+{
+
+  i_syscalls++;
+
+  return read(fd, buf, len);
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: i_tty_write()                                                       */
+/*                                                                           */
+/* Description: Write a block to a tty                                       */
+/*                                                                           */
+/* Uses: fd - The tty                                                        */
+/*       buf - The bytes                                                     */
+/*       len - Bytes to write                                                */
+/*                                                                           */
+/* Returns: The bytes written, or SERT_FAILURE                               */
+/*                                                                           */
+/*****************************************************************************/
+
+static ssize_t i_tty_write(int fd, const void *buf, size_t len)
+{
+
+  i_syscalls++;
+
+  return write(fd, buf, len);
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: i_tty_wait()                                                        */
+/*                                                                           */
+/* Description: Wait until a tty can be read or written, or a timeout        */
+/*                                                                           */
+/* Uses: fd - The tty                                                        */
+/*       for_write - Wait to write, not to read                              */
+/*       timeout - Longest to wait                                           */
+/*                                                                           */
+/* Returns: 1 if ready, 0 on timeout, or SERT_FAILURE                        */
+/*                                                                           */
+/*****************************************************************************/
+
+static int i_tty_wait(int fd, bool for_write, struct timeval *timeout)
+{
+
+  fd_set wait_set;      /* The tty, for select() */
+
+
+  /* Put the tty alone in the set */
+  FD_ZERO(&wait_set);
+
+  FD_SET(fd, &wait_set);
+
+  i_syscalls++;
+
+  return select(fd + 1, for_write ? NULL : &wait_set,
+    for_write ? &wait_set : NULL, NULL, timeout);
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: i_tty_flush()                                                       */
+/*                                                                           */
+/* Description: Throw away all input and output waiting in a tty             */
+/*                                                                           */
+/* Uses: fd - The tty                                                        */
+/*                                                                           */
+/* Returns: 0, or SERT_FAILURE                                               */
+/*                                                                           */
+/*****************************************************************************/
+
+static int i_tty_flush(int fd)
+{
+
+  i_syscalls++;
+
+  return tcflush(fd, TCIOFLUSH);
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: i_tty_close()                                                       */
+/*                                                                           */
+/* Description: Close a tty                                                  */
+/*                                                                           */
+/* Uses: fd - The tty                                                        */
+/*                                                                           */
+/* Returns: 0, or SERT_FAILURE                                               */
+/*                                                                           */
+/*****************************************************************************/
+
+static int i_tty_close(int fd)
+{
+
+  i_syscalls++;
+
+  return close(fd);
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: i_tty_now()                                                         */
+/*                                                                           */
+/* Description: Get the time of day, as a tty's bytes are timed              */
+/*                                                                           */
+/* Uses: time - Where to put the time                                        */
+/*                                                                           */
+/* Returns: 0, or SERT_FAILURE                                               */
+/*                                                                           */
+/*****************************************************************************/
+
+static int i_tty_now(struct timeval *time)
+{
+
+  return gettimeofday(time, NULL);
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: i_tty_sleep()                                                       */
+/*                                                                           */
+/* Description: Sleep, between bytes sent to a tty                           */
+/*                                                                           */
+/* Uses: time - The time to sleep, left with any not slept if interrupted    */
+/*                                                                           */
+/* Returns: 0, or SERT_FAILURE                                               */
+/*                                                                           */
+/*****************************************************************************/
+
+static int i_tty_sleep(struct timespec *time)
+{
+
+  return nanosleep(time, time);
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: i_emulate_control()                                                 */
+/*                                                                           */
+/* Description: Emulate the control lines and serial flags, for ports that   */
+/*              have none. The lines are looped back as by a loopback plug:  */
+/*              RTS to CTS, and DTR to DSR and CD. Serial flags are          */
+/*              accepted, and read back as all clear.                        */
+/*                                                                           */
+/* Uses: fd - The port, not used                                             */
+/*       request - The ioctl() request                                       */
+/*       arg - The request's argument                                        */
+/*                                                                           */
+/* Returns: 0, or SERT_FAILURE for any other request                         */
+/*                                                                           */
+/*****************************************************************************/
+
+static int i_emulate_control(int fd, unsigned long request, void *arg)
+{
+
+  int status = 0;      /* Result of the request */
+  int lines;           /* Lines seen            */
+
+
+  (void) fd;
+
+  switch(request)
+  {
+
+    case TIOCMGET:
+
+      lines = i_lines;
+
+      lines |= ( (i_lines & TIOCM_RTS) != 0) ? TIOCM_CTS : 0;
+
+      lines |= ( (i_lines & TIOCM_DTR) != 0) ? (TIOCM_DSR | TIOCM_CD) : 0;
+
+      *(int *) arg = lines;
+
+      break;
+
+    case TIOCMSET:
+
+      i_lines = *(int *) arg & i_LINES_OUT;
+
+      break;
+
+    case TIOCGSERIAL:
+
+      (void) memset(arg, 0, sizeof(struct serial_struct) );
+
+      break;
+
+    case TIOCSSERIAL:
+
+      /* Nothing to make faster */
+
+      break;
+
+    default:
+
+      errno = ENOTTY;
+
+      status = SERT_FAILURE;
+
+      break;
+
+  }
+
+  return status;
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: i_ring_put()                                                        */
+/*                                                                           */
+/* Description: Add bytes to be looped back, as many as there is room for    */
+/*                                                                           */
+/* Uses: bytes - The bytes                                                   */
+/*       len - Bytes to add                                                  */
+/*       due - When they can be read                                         */
+/*                                                                           */
+/* Returns: The bytes added                                                  */
+/*                                                                           */
+/*****************************************************************************/
+
+static size_t i_ring_put(const unsigned char *bytes, size_t len, long long due)
+{
+
+  size_t put = 0;         /* Bytes added     */
+  size_t end;             /* Where they go   */
+
+
+  while( (put < len) && (i_ring_len < SERT_MEMORY_LEN) )
+  {
+
+    end = (i_ring_start + i_ring_len) % SERT_MEMORY_LEN;
+
+    i_ring[end] = bytes[put];
+
+    i_ring_due[end] = due;
+
+    put++;
+
+    i_ring_len++;
+
+  }
+
+  return put;
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: i_memory_open()                                                     */
+/*                                                                           */
+/* Description: Open the memory loopback, empty. Only one can be open.       */
+/*                                                                           */
+/* Uses: port - Not used                                                     */
+/*                                                                           */
+/* Returns: The loopback's descriptor, or SERT_FAILURE                       */
+/*                                                                           */
+/*****************************************************************************/
+
+static int i_memory_open(const char *port)
+{
+
+  int fd = SERT_FAILURE;       /* The loopback's descriptor */
+
+
+  (void) port;
+
+  if(i_memory_in_use == true)
+  {
+
+    errno = EBUSY;
+
+  }
+  else
+  {
+
+    (void) memset(&i_memory_options, 0, sizeof(i_memory_options) );
+
+    i_ring_start = 0;
+
+    i_ring_len = 0;
+
+    i_lines = 0;
+
+    /* Bytes looped back are due at once, unless time is simulated */
+    i_sim_now = 0;
+
+    i_sim_free_at = 0;
+
+    i_memory_in_use = true;
+
+    fd = i_MEMORY_FD;
+
+  }
+
+  return fd;
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: i_memory_get_flags()                                                */
+/*                                                                           */
+/* Description: Get the memory loopback's file status flags, of which it     */
+/*              has none                                                     */
+/*                                                                           */
+/* Uses: fd - Not used                                                       */
+/*                                                                           */
+/* Returns: 0                                                                */
+/*                                                                           */
+/*****************************************************************************/
+
+static int i_memory_get_flags(int fd)
+{
+
+  (void) fd;
+
+  return 0;
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: i_memory_set_flags()                                                */
+/*                                                                           */
+/* Description: Set the memory loopback's file status flags. It never        */
+/*              blocks, so they are ignored.                                 */
+/*                                                                           */
+/* Uses: fd - Not used                                                       */
+/*       flags - Not used                                                    */
+/*                                                                           */
+/* Returns: 0                                                                */
+/*                                                                           */
+/*****************************************************************************/
+
+static int i_memory_set_flags(int fd, int flags)
+{
+
+  (void) fd;
+
+  (void) flags;
+
+  return 0;
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: i_memory_get_config()                                               */
+/*                                                                           */
+/* Description: Get the memory loopback's settings, as last set              */
+/*                                                                           */
+/* Uses: fd - Not used                                                       */
+/*       options - Where to put the settings                                 */
+/*                                                                           */
+/* Returns: 0                                                                */
+/*                                                                           */
+/*****************************************************************************/
+
+static int i_memory_get_config(int fd, struct termios *options)
+{
+
+  (void) fd;
+
+  *options = i_memory_options;
+
+  return 0;
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: i_memory_configure()                                                */
+/*                                                                           */
+/* Description: Set the memory loopback's settings. They are kept, to be     */
+/*              read back, but bytes are looped back the same whatever       */
+/*              they are.                                                    */
+/*                                                                           */
+/* Uses: fd - Not used                                                       */
+/*       options - The settings                                              */
+/*                                                                           */
+/* Returns: 0                                                                */
+/*                                                                           */
+/*****************************************************************************/
+
+static int i_memory_configure(int fd, const struct termios *options)
+{
+
+  (void) fd;
+
+  i_memory_options = *options;
+
+  return 0;
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: i_memory_read()                                                     */
+/*                                                                           */
+/* Description: Read a block of the bytes looped back, that are due          */
+/*                                                                           */
+/* Uses: fd - Not used                                                       */
+/*       buf - Where to put the bytes                                        */
+/*       len - Most bytes to read                                            */
+/*                                                                           */
+/* Returns: The bytes read                                                   */
+/*                                                                           */
+/*****************************************************************************/
+
+static ssize_t i_memory_read(int fd, void *buf, size_t len)
+{
+
+  unsigned char *bytes = buf;  /* Where the next byte goes */
+  size_t got = 0;              /* Bytes read               */
+
+
+  (void) fd;
+
+  while( (got < len) && (i_ring_len > 0)
+    && (i_ring_due[i_ring_start] <= i_sim_now) )
+  {
+
+    bytes[got] = i_ring[i_ring_start];
+
+    got++;
+
+    i_ring_start = (i_ring_start + 1) % SERT_MEMORY_LEN;
+
+    i_ring_len--;
+
+  }
+
+  return (ssize_t) got;
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: i_memory_write()                                                    */
+/*                                                                           */
+/* Description: Write a block to be looped back at once, as much of it as    */
+/*              there is room for. If there is no room the write fails with  */
+/*              EAGAIN, as it would on a full port that doesn't block.       */
+/*                                                                           */
+/* Uses: fd - Not used                                                       */
+/*       buf - The bytes                                                     */
+/*       len - Bytes to write                                                */
+/*                                                                           */
+/* Returns: The bytes written, or SERT_FAILURE                               */
+/*                                                                           */
+/*****************************************************************************/
+
+static ssize_t i_memory_write(int fd, const void *buf, size_t len)
+{
+
+  ssize_t written;             /* Bytes written */
+
+
+  (void) fd;
+
+  written = (ssize_t) i_ring_put(buf, len, 0);
+
+  if( (written == 0) && (len > 0) )
+  {
+
+    errno = EAGAIN;
+
+    written = SERT_FAILURE;
+
+  }
+
+  return written;
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: i_memory_wait()                                                     */
+/*                                                                           */
+/* Description: See if the memory loopback can be read or written. Nothing   */
+/*              else can fill or empty it, so there is never a need to wait, */
+/*              and a timeout is returned straight away.                     */
+/*                                                                           */
+/* Uses: fd - Not used                                                       */
+/*       for_write - Wait to write, not to read                              */
+/*       timeout - Not used                                                  */
+/*                                                                           */
+/* Returns: 1 if ready, or 0 for a timeout                                   */
+/*                                                                           */
+/*****************************************************************************/
+
+static int i_memory_wait(int fd, bool for_write, struct timeval *timeout)
+{
+
+  (void) fd;
+
+  (void) timeout;
+
+  return (for_write ? (i_ring_len < SERT_MEMORY_LEN) : (i_ring_len > 0) )
+    ? 1 : 0;
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: i_memory_flush()                                                    */
+/*                                                                           */
+/* Description: Throw away the bytes waiting in the memory loopback          */
+/*                                                                           */
+/* Uses: fd - Not used                                                       */
+/*                                                                           */
+/* Returns: 0                                                                */
+/*                                                                           */
+/*****************************************************************************/
+
+static int i_memory_flush(int fd)
+{
+
+  (void) fd;
+
+  i_ring_len = 0;
+
+  return 0;
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: i_memory_close()                                                    */
+/*                                                                           */
+/* Description: Close the memory loopback                                    */
+/*                                                                           */
+/* Uses: fd - Not used                                                       */
+/*                                                                           */
+/* Returns: 0                                                                */
+/*                                                                           */
+/*****************************************************************************/
+
+static int i_memory_close(int fd)
+{
+
+  (void) fd;
+
+  i_memory_in_use = false;
+
+  return 0;
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: i_sim_open()                                                        */
+/*                                                                           */
+/* Description: Open the simulated line, a memory loopback with the          */
+/*              emulator's faults, delay and rate, and a virtual clock       */
+/*              starting at SERT_SIM_EPOCH                                   */
+/*                                                                           */
+/* Uses: port - Not used                                                     */
+/*                                                                           */
+/* Returns: The line's descriptor, or SERT_FAILURE                           */
+/*                                                                           */
+/*****************************************************************************/
+
+static int i_sim_open(const char *port)
+{
+
+  int fd;                /* The line's descriptor */
+
+
+  fd = i_memory_open(port);
+
+  if(fd != SERT_FAILURE)
+  {
+
+    i_sim_now = (long long) SERT_SIM_EPOCH * SERS_NSEC_IN_SEC;
+
+  }
+
+  return fd;
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: i_sim_write()                                                       */
+/*                                                                           */
+/* Description: Write a block to the simulated line. The clock moves on by   */
+/*              the time to send it at the emulator's rate, and the bytes    */
+/*              are looped back with their faults, after the delay and the   */
+/*              time to send them back. Only as many are written as can be   */
+/*              looped back whatever their faults; if none can, the write    */
+/*              fails with EAGAIN and the clock doesn't move.                */
+/*                                                                           */
+/* Uses: fd - Not used                                                       */
+/*       buf - The bytes                                                     */
+/*       len - Bytes to write                                                */
+/*                                                                           */
+/* Returns: The bytes written, or SERT_FAILURE                               */
+/*                                                                           */
+/*****************************************************************************/
+
+static ssize_t i_sim_write(int fd, const void *buf, size_t len)
+{
+
+  const sere_setup_t *setup;   /* How the line behaves          */
+  long long send_ns;           /* Time to send the bytes        */
+  long long due;               /* When they are looped back     */
+  size_t out_len;              /* Bytes looped back             */
+  size_t room;                 /* Bytes there is room to write  */
+  bool late;                   /* Bytes to be held late         */
+  ssize_t written;             /* Bytes written                 */
+
+
+  (void) fd;
+
+  /* Each byte can be looped back as up to SERE_MARK_LEN */
+  room = (SERT_MEMORY_LEN - i_ring_len) / SERE_MARK_LEN;
+
+  if( (room == 0) && (len > 0) )
+  {
+
+    errno = EAGAIN;
+
+    written = SERT_FAILURE;
+
+  }
+  else
+  {
+
+    setup = sere_get_setup();
+
+    len = (len > room) ? room : len;
+
+    send_ns = (setup->rate > 0)
+      ? ( (long long) len * SERS_NSEC_IN_SEC) / (long long) setup->rate : 0;
+
+    i_sim_now += send_ns;
+
+    out_len = sere_inject(buf, len, i_sim_out, &late);
+
+    due = i_sim_now + ( (long long) setup->delay_us * SERS_NSEC_IN_USEC)
+      + send_ns;
+
+    due += late ? (long long) setup->late_us * SERS_NSEC_IN_USEC : 0;
+
+    due = (due < i_sim_free_at) ? i_sim_free_at : due;
+
+    i_sim_free_at = due;
+
+    (void) i_ring_put(i_sim_out, out_len, due);
+
+    written = (ssize_t) len;
+
+  }
+
+  return written;
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: i_sim_wait()                                                        */
+/*                                                                           */
+/* Description: Wait on the simulated line. The clock moves on to when the   */
+/*              next byte is due, or by the whole timeout if it isn't due    */
+/*              by then. It can be written while there is room to loop back  */
+/*              a byte; nothing but a read makes more, so otherwise the      */
+/*              clock moves on by the whole timeout.                         */
+/*                                                                           */
+/* Uses: fd - Not used                                                       */
+/*       for_write - Wait to write, not to read                              */
+/*       timeout - Longest to wait                                           */
+/*                                                                           */
+/* Returns: 1 if ready, or 0 on timeout                                      */
+/*                                                                           */
+/*****************************************************************************/
+
+static int i_sim_wait(int fd, bool for_write, struct timeval *timeout)
+{
+
+  int ready = 1;          /* Can the line be used? */
+  long long until;        /* End of the timeout    */
+
+
+  (void) fd;
+
+  until = i_sim_now + ( (long long) timeout->tv_sec * SERS_NSEC_IN_SEC)
+    + ( (long long) timeout->tv_usec * SERS_NSEC_IN_USEC);
+
+  if(for_write == true)
+  {
+
+    if(SERT_MEMORY_LEN - i_ring_len < SERE_MARK_LEN)
+    {
+
+      i_sim_now = until;
+
+      ready = 0;
+
+    }
+
+  }
+  else
+  {
+
+    if( (i_ring_len > 0) && (i_ring_due[i_ring_start] <= until) )
+    {
+
+      i_sim_now = (i_ring_due[i_ring_start] > i_sim_now)
+        ? i_ring_due[i_ring_start] : i_sim_now;
+
+    }
+    else
+    {
+
+      i_sim_now = until;
+
+      ready = 0;
+
+    }
+
+  }
+
+  return ready;
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: i_sim_get_now()                                                     */
+/*                                                                           */
+/* Description: Get the time on the simulated line's virtual clock           */
+/*                                                                           */
+/* Uses: time - Where to put the time                                        */
+/*                                                                           */
+/* Returns: 0                                                                */
+/*                                                                           */
+/*****************************************************************************/
+
+static int i_sim_get_now(struct timeval *time)
+{
+
+  time->tv_sec = (time_t) (i_sim_now / SERS_NSEC_IN_SEC);
+
+  time->tv_usec = (suseconds_t) ( (i_sim_now % SERS_NSEC_IN_SEC)
+    / SERS_NSEC_IN_USEC);
+
+  return 0;
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: i_sim_sleep()                                                       */
+/*                                                                           */
+/* Description: Move the simulated line's virtual clock on, without waiting  */
+/*                                                                           */
+/* Uses: time - The time to sleep                                            */
+/*                                                                           */
+/* Returns: 0                                                                */
+/*                                                                           */
+/*****************************************************************************/
+
+static int i_sim_sleep(struct timespec *time)
+{
+
+  i_sim_now += ( (long long) time->tv_sec * SERS_NSEC_IN_SEC) + time->tv_nsec;
+
+  return 0;
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: i_net_connect()                                                     */
+/*                                                                           */
+/* Description: Connect to a device server, with Nagle's algorithm off so    */
+/*              each byte sent goes at once                                  */
+/*                                                                           */
+/* Uses: address - HOST:PORT, with an IPv6 host in square brackets           */
+/*                                                                           */
+/* Returns: The connection, or SERT_FAILURE                                  */
+/*                                                                           */
+/*****************************************************************************/
+
+static int i_net_connect(const char *address)
+{
+
+  int fd = SERT_FAILURE;          /* The connection           */
+  char host[SERT_NET_ADDR_LEN];   /* Host part of the address */
+  char *service;                  /* Port part                */
+  char *host_start = host;        /* Host, without brackets   */
+  struct addrinfo hints;          /* Connections wanted       */
+  struct addrinfo *found = NULL;  /* Addresses found          */
+  struct addrinfo *next;          /* Address being tried      */
+  int nodelay = 1;                /* Send each byte at once   */
+
+
+  (void) snprintf(host, sizeof(host), "%s", address);
+
+  service = strrchr(host, ':');
+
+  if( (service == NULL) || (strlen(address) >= sizeof(host) ) )
+  {
+
+    errno = EINVAL;
+
+  }
+  else
+  {
+
+    *service = '\0';
+
+    service++;
+
+    if( (host[0] == '[') && (service[-2] == ']') )
+    {
+
+      host_start++;
+
+      service[-2] = '\0';
+
+    }
+
+    (void) memset(&hints, 0, sizeof(hints) );
+
+    hints.ai_family = AF_UNSPEC;
+
+    hints.ai_socktype = SOCK_STREAM;
+
+    if(getaddrinfo(host_start, service, &hints, &found) != 0)
+    {
+
+      errno = EHOSTUNREACH;
+
+    }
+
+    for(next = found; (next != NULL) && (fd == SERT_FAILURE);
+      next = next->ai_next)
+    {
+
+      fd = socket(next->ai_family, next->ai_socktype, next->ai_protocol);
+
+      if( (fd != SERT_FAILURE)
+        && (connect(fd, next->ai_addr, next->ai_addrlen) != 0) )
+      {
+
+        (void) close(fd);
+
+        fd = SERT_FAILURE;
+
+      }
+
+    }
+
+    if(found != NULL)
+    {
+
+      freeaddrinfo(found);
+
+    }
+
+  }
+
+  if(fd != SERT_FAILURE)
+  {
+
+    (void) setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &nodelay,
+      sizeof(nodelay) );
+
+  }
+
+  return fd;
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: i_net_open()                                                        */
+/*                                                                           */
+/* Description: Connect to a port on a device server, raw or with RFC 2217   */
+/*              negotiation, given as tcp:HOST:PORT or rfc2217:HOST:PORT.    */
+/*              Only one can be open.                                        */
+/*                                                                           */
+/* Uses: port - The port's name                                              */
+/*                                                                           */
+/* Returns: The connection, or SERT_FAILURE                                  */
+/*                                                                           */
+/*****************************************************************************/
+
+static int i_net_open(const char *port)
+{
+
+  int fd = SERT_FAILURE;       /* The connection */
+
+
+  i_net_rfc2217 = (strncmp(port, SERT_RFC2217_PREFIX,
+    strlen(SERT_RFC2217_PREFIX) ) == 0);
+
+  if(i_net_in_use == true)
+  {
+
+    errno = EBUSY;
+
+  }
+  else
+  {
+
+    i_syscalls++;
+
+    fd = i_net_connect(strchr(port, ':') + 1);
+
+  }
+
+  if( (fd != SERT_FAILURE) && (i_net_rfc2217 == true)
+    && (sern_offer(fd) != 0) )
+  {
+
+    (void) close(fd);
+
+    fd = SERT_FAILURE;
+
+  }
+
+  if(fd != SERT_FAILURE)
+  {
+
+    (void) memset(&i_net_options, 0, sizeof(i_net_options) );
+
+    sern_reset(&i_net_decoder);
+
+    i_net_start = 0;
+
+    i_net_len = 0;
+
+    i_net_closed = false;
+
+    i_lines = 0;
+
+    i_net_in_use = true;
+
+  }
+
+  return fd;
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: i_net_fill()                                                        */
+/*                                                                           */
+/* Description: Receive what has arrived on the connection, and queue the    */
+/*              data in it to be read. With PARMRK set, 0xFF is doubled as   */
+/*              the line discipline would, as serbert expects.               */
+/*                                                                           */
+/* Uses: fd - The connection                                                 */
+/*       flags - recv() flags                                                */
+/*                                                                           */
+/* Returns: The bytes received, 0 if the server has gone, or SERT_FAILURE    */
+/*                                                                           */
+/*****************************************************************************/
+
+static ssize_t i_net_fill(int fd, int flags)
+{
+
+  ssize_t got;                 /* Bytes received          */
+  size_t data_len;             /* Data in them            */
+  size_t room;                 /* Bytes the queue can take */
+  size_t data_no;              /* Data byte being queued  */
+  size_t end;                  /* Where it goes           */
+
+
+  /* Leave room for each byte to be doubled */
+  room = (sizeof(i_net_data) - i_net_len) / 2;
+
+  room = (room > sizeof(i_net_in) ) ? sizeof(i_net_in) : room;
+
+  i_syscalls++;
+
+  got = recv(fd, i_net_in, room, flags);
+
+  if(got == 0)
+  {
+
+    i_net_closed = true;
+
+  }
+
+  data_len = (got > 0) ? (size_t) got : 0;
+
+  if(i_net_rfc2217 == true)
+  {
+
+    data_len = sern_decode(&i_net_decoder, fd, SERN_CLIENT, i_net_in,
+      data_len, i_net_in);
+
+  }
+
+  for(data_no = 0; data_no < data_len; data_no++)
+  {
+
+    end = (i_net_start + i_net_len) % sizeof(i_net_data);
+
+    i_net_data[end] = i_net_in[data_no];
+
+    i_net_len++;
+
+    if( (i_net_in[data_no] == (uint8_t) SERN_IAC)
+      && ( (i_net_options.c_iflag & PARMRK) != 0) )
+    {
+
+      i_net_data[(end + 1) % sizeof(i_net_data)] = i_net_in[data_no];
+
+      i_net_len++;
+
+    }
+
+  }
+
+  return got;
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: i_net_configure()                                                   */
+/*                                                                           */
+/* Description: Set a connection's settings. They are kept, to be read back  */
+/*              and for PARMRK, and with RFC 2217 the baud rate, data bits,  */
+/*              parity and stop bits are sent to the server.                 */
+/*                                                                           */
+/* Uses: fd - The connection                                                 */
+/*       options - The settings                                              */
+/*                                                                           */
+/* Returns: 0, or SERT_FAILURE                                               */
+/*                                                                           */
+/*****************************************************************************/
+
+static int i_net_configure(int fd, const struct termios *options)
+{
+
+  int status = 0;              /* Were the settings sent?   */
+  sern_line_t line;            /* The line settings         */
+  speed_t speed;               /* The baud rate constant    */
+  int speed_no = 0;            /* Loop counter              */
+  tcflag_t size;               /* Data bits, as a flag      */
+
+
+  i_net_options = *options;
+
+  if(i_net_rfc2217 == true)
+  {
+
+    speed = cfgetospeed(options);
+
+    while( (i_SPEEDS[speed_no].baud != 0)
+      && (i_SPEEDS[speed_no].speed != speed) )
+    {
+
+      speed_no++;
+
+    }
+
+    line.baud = i_SPEEDS[speed_no].baud;
+
+    size = options->c_cflag & CSIZE;
+
+    line.data_bits = (size == CS5) ? 5 : (size == CS6) ? 6
+      : (size == CS7) ? 7 : 8;
+
+    line.parity = ( (options->c_cflag & PARENB) == 0) ? SERN_PARITY_NONE
+      : ( (options->c_cflag & PARODD) != 0) ? SERN_PARITY_ODD
+      : SERN_PARITY_EVEN;
+
+    line.stop_bits = ( (options->c_cflag & CSTOPB) != 0) ? 2 : 1;
+
+    /* Without a baud rate, as when the settings from opening are put */
+    /* back, the server's are left as they were                       */
+    if(line.baud == 0)
+    {
+
+      line.data_bits = 0;
+
+      line.parity = SERN_PARITY_ASK;
+
+      line.stop_bits = 0;
+
+    }
+
+    i_syscalls++;
+
+    status = sern_set_line(fd, &line);
+
+  }
+
+  return status;
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: i_net_get_config()                                                  */
+/*                                                                           */
+/* Description: Get a connection's settings, as last set                     */
+/*                                                                           */
+/* Uses: fd - Not used                                                       */
+/*       options - Where to put the settings                                 */
+/*                                                                           */
+/* Returns: 0                                                                */
+/*                                                                           */
+/*****************************************************************************/
+
+static int i_net_get_config(int fd, struct termios *options)
+{
+
+  (void) fd;
+
+  *options = i_net_options;
+
+  return 0;
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: i_net_read()                                                        */
+/*                                                                           */
+/* Description: Read a block of data from the connection, waiting for some   */
+/*              unless it is non-blocking                                    */
+/*                                                                           */
+/* Uses: fd - The connection                                                 */
+/*       buf - Where to put the bytes                                        */
+/*       len - Most bytes to read                                            */
+/*                                                                           */
+/* Returns: The bytes read, or SERT_FAILURE                                  */
+/*                                                                           */
+/*****************************************************************************/
+
+static ssize_t i_net_read(int fd, void *buf, size_t len)
+{
+
+  unsigned char *bytes = buf;  /* Where the next byte goes   */
+  ssize_t got = 0;             /* Bytes read                 */
+  ssize_t filled = 1;          /* Bytes received each time   */
+
+
+  /* Negotiation alone holds no data, so keep going until there is some */
+  while( (i_net_len == 0) && (filled > 0) )
+  {
+
+    filled = i_net_fill(fd, 0);
+
+  }
+
+  if(i_net_len == 0)
+  {
+
+    /* The server has gone, or the receive failed */
+    errno = (filled == 0) ? ECONNRESET : errno;
+
+    got = SERT_FAILURE;
+
+  }
+
+  while( (got != SERT_FAILURE) && ( (size_t) got < len) && (i_net_len > 0) )
+  {
+
+    bytes[got] = i_net_data[i_net_start];
+
+    got++;
+
+    i_net_start = (i_net_start + 1) % sizeof(i_net_data);
+
+    i_net_len--;
+
+  }
+
+  return got;
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: i_net_write()                                                       */
+/*                                                                           */
+/* Description: Write a block to the connection, escaped for RFC 2217, in    */
+/*              one send                                                     */
+/*                                                                           */
+/* Uses: fd - The connection                                                 */
+/*       buf - The bytes                                                     */
+/*       len - Bytes to write                                                */
+/*                                                                           */
+/* Returns: The bytes written, or SERT_FAILURE                               */
+/*                                                                           */
+/*****************************************************************************/
+
+static ssize_t i_net_write(int fd, const void *buf, size_t len)
+{
+
+  const uint8_t *out = buf;    /* The bytes to send   */
+  size_t out_len;              /* How many            */
+  ssize_t sent;                /* Bytes sent          */
+
+
+  len = (len > (size_t) SERT_NET_LEN) ? (size_t) SERT_NET_LEN : len;
+
+  out_len = len;
+
+  if(i_net_rfc2217 == true)
+  {
+
+    out_len = sern_escape(buf, len, i_net_out);
+
+    out = i_net_out;
+
+  }
+
+  i_syscalls++;
+
+  sent = send(fd, out, out_len, MSG_NOSIGNAL);
+
+  /* A part sent is finished, so it isn't split by the escaping */
+  while( (sent > 0) && ( (size_t) sent < out_len) )
+  {
+
+    out += sent;
+
+    out_len -= (size_t) sent;
+
+    i_syscalls++;
+
+    sent = send(fd, out, out_len, MSG_NOSIGNAL);
+
+  }
+
+  return (sent > 0) ? (ssize_t) len : SERT_FAILURE;
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: i_net_wait()                                                        */
+/*                                                                           */
+/* Description: Wait until the connection can be written, or has data to be  */
+/*              read, or a timeout. Negotiation is taken as it arrives,      */
+/*              without ending the wait.                                     */
+/*                                                                           */
+/* Uses: fd - The connection                                                 */
+/*       for_write - Wait to write, not to read                              */
+/*       timeout - Longest to wait, left with the time not waited            */
+/*                                                                           */
+/* Returns: 1 if ready, 0 on timeout, or SERT_FAILURE                        */
+/*                                                                           */
+/*****************************************************************************/
+
+static int i_net_wait(int fd, bool for_write, struct timeval *timeout)
+{
+
+  int ready;              /* Can the connection be used? */
+  bool waiting;           /* Still waiting for data?     */
+
+
+  if(for_write == true)
+  {
+
+    ready = i_tty_wait(fd, true, timeout);
+
+  }
+  else
+  {
+
+    waiting = (i_net_len == 0) && (i_net_closed == false);
+
+    ready = (waiting == true) ? 0 : 1;
+
+    while(waiting == true)
+    {
+
+      /* select() leaves the time not waited in timeout */
+      ready = i_tty_wait(fd, false, timeout);
+
+      if(ready > 0)
+      {
+
+        if( (i_net_fill(fd, MSG_DONTWAIT) == SERT_FAILURE)
+          && (errno != EAGAIN) && (errno != EWOULDBLOCK) )
+        {
+
+          ready = SERT_FAILURE;
+
+        }
+        else
+        {
+
+          ready = ( (i_net_len > 0) || (i_net_closed == true) ) ? 1 : 0;
+
+        }
+
+      }
+
+      /* Go on waiting only if negotiation alone arrived */
+      waiting = (ready == 0) && ( (timeout->tv_sec > 0)
+        || (timeout->tv_usec > 0) );
+
+    }
+
+  }
+
+  return ready;
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: i_net_flush()                                                       */
+/*                                                                           */
+/* Description: Throw away the data received and any still arriving. With    */
+/*              RFC 2217, if there was any, ask the server to empty the port */
+/*              too. serbert flushes after every byte, so the server is only */
+/*              asked when it is needed.                                     */
+/*                                                                           */
+/* Uses: fd - The connection                                                 */
+/*                                                                           */
+/* Returns: 0, or SERT_FAILURE                                               */
+/*                                                                           */
+/*****************************************************************************/
+
+static int i_net_flush(int fd)
+{
+
+  int status = 0;        /* Was the server asked? */
+  bool stale;             /* Was there any data?   */
+
+
+  stale = (i_net_len > 0);
+
+  i_net_start = 0;
+
+  i_net_len = 0;
+
+  while(i_net_fill(fd, MSG_DONTWAIT) > 0)
+  {
+
+    stale = stale || (i_net_len > 0);
+
+    i_net_start = 0;
+
+    i_net_len = 0;
+
+  }
+
+  if( (i_net_rfc2217 == true) && (stale == true) )
+  {
+
+    i_syscalls++;
+
+    status = sern_purge(fd);
+
+  }
+
+  return status;
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: i_net_close()                                                       */
+/*                                                                           */
+/* Description: Close the connection                                         */
+/*                                                                           */
+/* Uses: fd - The connection                                                 */
+/*                                                                           */
+/* Returns: 0, or SERT_FAILURE                                               */
+/*                                                                           */
+/*****************************************************************************/
+
+static int i_net_close(int fd)
+{
+
+  i_net_in_use = false;
+
+  i_syscalls++;
+
+  return close(fd);
+
+}
+
+
+/* The transports. A pseudo terminal is a tty, without control lines or */
+/* serial flags. The simulated line is the memory loopback, with the    */
+/* emulator's faults and a virtual clock. Device servers are reached    */
+/* over TCP, with the control lines emulated. Only ttys and pseudo     */
+/* terminals have a device node that other programs may share.         */
+
+static const sert_ops_t i_tty =
+{
+  "tty", true, i_tty_open, i_tty_get_flags, i_tty_set_flags,
+  i_tty_get_config, i_tty_configure, i_tty_control, i_tty_read, i_tty_write,
+  i_tty_wait, i_tty_flush, i_tty_close, i_tty_now, i_tty_sleep
+};
+
+static const sert_ops_t i_pty =
+{
+  "pty", true, i_tty_open, i_tty_get_flags, i_tty_set_flags,
+  i_tty_get_config, i_tty_configure, i_emulate_control, i_tty_read,
+  i_tty_write, i_tty_wait, i_tty_flush, i_tty_close, i_tty_now, i_tty_sleep
+};
+
+static const sert_ops_t i_memory =
+{
+  "memory", false, i_memory_open, i_memory_get_flags, i_memory_set_flags,
+  i_memory_get_config, i_memory_configure, i_emulate_control, i_memory_read,
+  i_memory_write, i_memory_wait, i_memory_flush, i_memory_close, i_tty_now,
+  i_tty_sleep
+};
+
+static const sert_ops_t i_sim =
+{
+  "simulate", false, i_sim_open, i_memory_get_flags, i_memory_set_flags,
+  i_memory_get_config, i_memory_configure, i_emulate_control, i_memory_read,
+  i_sim_write, i_sim_wait, i_memory_flush, i_memory_close, i_sim_get_now,
+  i_sim_sleep
+};
+
+static const sert_ops_t i_tcp =
+{
+  "tcp", false, i_net_open, i_tty_get_flags, i_tty_set_flags,
+  i_net_get_config, i_net_configure, i_emulate_control, i_net_read,
+  i_net_write, i_net_wait, i_net_flush, i_net_close, i_tty_now, i_tty_sleep
+};
+
+
+/*****************************************************************************/
+/*      EXTERNAL FUNCTION DEFINITIONS                                        */
+/*****************************************************************************/
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: sert_find()                                                         */
+/*                                                                           */
+/* Description: Find the transport for a port                                */
+/*                                                                           */
+/* Internal functions used:                                                  */
+/*                                                                           */
+/* Internal variables used: i_tty, i_pty, i_memory, i_sim, i_tcp             */
+/*                                                                           */
+/* Parameters:                                                               */
+/*   Name            Type           Comments                                 */
+/*   ------------    ------------   -----------------------------------      */
+/*   port            const char *   The port's name                          */
+/*                                                                           */
+/* Returns: The transport's operations                                       */
+/*                                                                           */
+/*****************************************************************************/
+
+extern const sert_ops_t *sert_find(const char *port)
+{
+
+  const sert_ops_t *ops = &i_tty;   /* The port's transport */
+
+
+  if(strcmp(port, SERT_MEMORY_PORT) == 0)
+  {
+
+    ops = &i_memory;
+
+  }
+  else if(strcmp(port, SERT_SIM_PORT) == 0)
+  {
+
+    ops = &i_sim;
+
+  }
+  else if( (strncmp(port, SERT_TCP_PREFIX, strlen(SERT_TCP_PREFIX) ) == 0)
+    || (strncmp(port, SERT_RFC2217_PREFIX, strlen(SERT_RFC2217_PREFIX) )
+    == 0) )
+  {
+
+    ops = &i_tcp;
+
+  }
+  else if(strncmp(port, SERT_PTY_PREFIX, strlen(SERT_PTY_PREFIX) ) == 0)
+  {
+
+    ops = &i_pty;
+
+  }
+
+  return ops;
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: sert_get_syscalls()                                                 */
+/*                                                                           */
+/* Description: Get the number of system calls made on ports so far          */
+/*                                                                           */
+/* Internal functions used:                                                  */
+/*                                                                           */
+/* Internal variables used: i_syscalls                                       */
+/*                                                                           */
+/* Parameters:                                                               */
+/*   Name            Type           Comments                                 */
+/*   ------------    ------------   -----------------------------------      */
+/*                                                                           */
+/* Returns: The system calls made                                            */
+/*                                                                           */
+/*****************************************************************************/
+
+extern unsigned long long sert_get_syscalls(void)
+{
+
+  return i_syscalls;
+
+}
@@ -0,0 +1,166 @@
+/*****************************************************************************/
+/*                                                                           */
+/* Module: sert.h                                                            */
+/*                                                                           */
+/* Description: Header file for sert.c                                       */
+/*                                                                           */
+/* Copyright (C) 2026 The Serbert contributors                               */
+/*                                                                           */
+/* This file is part of Serbert.                                             */
+/*                                                                           */
+/* Serbert is free software; you can redistribute it and/or modify           */
+/* it under the terms of the GNU General Public License as published by      */
+/* the Free Software Foundation; either version 2 of the License, or         */
+/* any later version.                                                        */
+/*                                                                           */
+/* This program is distributed in the hope that it will be useful,           */
+/* but WITHOUT ANY WARRANTY; without even the implied warranty of            */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             */
+/* GNU General Public License for more details.                              */
+/*                                                                           */
+/* You should have received a copy of the GNU General Public License         */
+/* along with this program; if not, write to the Free Software               */
+/* Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA */
+/*                                                                           */
+/*****************************************************************************/
+
+#ifndef SERT_H
+
+#define SERT_H
+
+/*****************************************************************************/
+/*      INCLUDED FILES (dependencies)                                        */
+/*****************************************************************************/
+
+#include <stdbool.h>     /* Boolean types                                  */
+#include <sys/types.h>   /* System types - ssize_t                         */
+#include <sys/time.h>    /* Time definitions - struct timeval              */
+#include <time.h>        /* Time definitions - struct timespec             */
+#include <termios.h>     /* Terminal settings - struct termios             */
+
+
+/*****************************************************************************/
+/*      MACRO DEFINITIONS                                                    */
+/*****************************************************************************/
+
+/*****************************************************************************/
+/*  Name:                                                                    */
+/*  Description:                                                             */
+/*  Parameters:                                                              */
+/*****************************************************************************/
+
+
+/*****************************************************************************/
+/*      TYPE DEFINITIONS                                                     */
+/*****************************************************************************/
+
+/* Enums & constants */
+
+enum { SERT_FAILURE = -1 };          /* Returned by a failed operation       */
+
+enum { SERT_MEMORY_LEN = 4096 };     /* Bytes the memory loopback holds      */
+
+#define SERT_MEMORY_PORT "memory"
+                                     /* Port name of the memory loopback     */
+
+#define SERT_SIM_PORT "simulate"
+                                     /* Port name of the simulated line      */
+
+enum { SERT_SIM_EPOCH = 1767225600 };
+                                     /* Simulated clock start, 1 Jan 2026    */
+
+enum { SERT_NET_LEN = 4096 };        /* Most bytes sent or received at once  */
+
+enum { SERT_NET_ADDR_LEN = 256 };    /* Longest HOST:PORT                    */
+
+#define SERT_TCP_PREFIX "tcp:"
+                                     /* Start of raw TCP port names          */
+
+#define SERT_RFC2217_PREFIX "rfc2217:"
+                                     /* Start of RFC 2217 port names         */
+
+#define SERT_PTY_PREFIX "/dev/pts/"
+                                     /* Start of pseudo terminal port names  */
+
+/* The operations on a port. Each returns as the system call it replaces     */
+/* would, SERT_FAILURE with errno set if it fails.                           */
+typedef struct sert_ops_t
+{
+  const char *name;                               /* Transport's name      */
+  bool device;                                    /* Is there a device     */
+                                                  /* node, to be locked?   */
+  int (*open)(const char *port);                  /* Open, non-blocking    */
+  int (*get_flags)(int fd);                       /* fcntl(F_GETFL)        */
+  int (*set_flags)(int fd, int flags);            /* fcntl(F_SETFL)        */
+  int (*get_config)(int fd, struct termios *options); /* tcgetattr()       */
+  int (*configure)(int fd, const struct termios *options);
+                                                  /* tcsetattr(TCSANOW)    */
+  int (*control)(int fd, unsigned long request, void *arg); /* ioctl()     */
+  ssize_t (*read)(int fd, void *buf, size_t len); /* Read a block          */
+  ssize_t (*write)(int fd, const void *buf, size_t len);
+                                                  /* Write a block         */
+  int (*wait)(int fd, bool for_write, struct timeval *timeout);
+                                                  /* select() on one fd    */
+  int (*flush)(int fd);                           /* tcflush(TCIOFLUSH)    */
+  int (*close)(int fd);                           /* Close                 */
+  int (*now)(struct timeval *time);               /* gettimeofday()        */
+  int (*sleep)(struct timespec *time);            /* nanosleep(), with the */
+                                                  /* rest left in time     */
+} sert_ops_t;
+
+
+/*****************************************************************************/
+/*      GLOBAL VARIABLES                                                     */
+/*****************************************************************************/
+
+
+/*****************************************************************************/
+/*      FUNCTION PROTOTYPES                                                  */
+/*****************************************************************************/
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: sert_find()                                                         */
+/*                                                                           */
+/* Description: Find the transport for a port: the memory loopback, the      */
+/*              simulated line, a device server over TCP, a pseudo terminal  */
+/*              or, for anything else, a tty                                 */
+/*                                                                           */
+/* Parameters:                                                               */
+/*   Name            Type           Comments                                 */
+/*   ------------    ------------  -----------------------------------       */
+/*   port            const char *  The port's name                           */
+/*                                                                           */
+/* Returns: The transport's operations                                       */
+/*                                                                           */
+/* Pre-conditions:                                                           */
+/*                                                                           */
+/* Post-conditions:                                                          */
+/*                                                                           */
+/*****************************************************************************/
+
+extern const sert_ops_t *sert_find(const char *port);
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: sert_get_syscalls()                                                 */
+/*                                                                           */
+/* Description: Get the number of system calls made on ports so far          */
+/*                                                                           */
+/* Parameters:                                                               */
+/*   Name            Type           Comments                                 */
+/*   ------------    ------------  -----------------------------------       */
+/*                                                                           */
+/* Returns: The system calls made                                            */
+/*                                                                           */
+/* Pre-conditions:                                                           */
+/*                                                                           */
+/* Post-conditions:                                                          */
+/*                                                                           */
+/*****************************************************************************/
+
+extern unsigned long long sert_get_syscalls(void);
+
+
+#endif /* SERT_H */
@@ -33,6 +33,9 @@
 #define _XOPEN_SOURCE
 #define _XOPEN_SOURCE_EXTENDED
 
+/* Required for clock_gettime() */
+#define _POSIX_C_SOURCE 199309L
+
 #include <stdio.h>       /* Standard I/O definitions  - fopen()            */
 #include <unistd.h>      /* UNIX standard function definitions - close()   */
                          /* getpid()                                       */
@@ -41,12 +44,14 @@
 #include <errno.h>       /* Um, error numbers - errno                      */
 #include <fcntl.h>       /* File control definitions - open(), fcntl()     */
 #include <termios.h>     /* Standard input/output definitions              */
-#include <sys/select.h>  /* Select stuff - select()                        */
 #include <stdbool.h>     /* Boolean types                                  */
 #include <sys/time.h>    /* Standard time definitions - gettimeofday()     */
+#include <time.h>        /* Clocks - clock_gettime()                       */
 #include <sys/ioctl.h>   /* ioctl() stuff                                  */
 #include <linux/serial.h>
                          /* Serial stuff - ASYNC_LOW_LATENCY, serial_struct*/
+#include "sert.h"        /* Serial transports - sert_find()                */
+#include "serd.h"        /* Static trace probes - SERD_PROBE3()            */
 #include "seru.h"        /* Header file for the serial utils library       */
 
 
@@ -76,6 +81,8 @@ typedef enum lock_state_t {i_UNLOCKED, i_LOCKED} lock_state_t;
 
 enum { i_RX_BUF_SIZE = 30 }; /* Length of the RX buffer            */
 
+enum { i_NSEC_IN_SEC = 1000000000 }; /* Nanoseconds in a second    */
+
 
 /* String literals */
 
@@ -107,6 +114,14 @@ static struct termios i_saved_options;
 
 static bool i_use_parity;            /* Is parity being used                 */
 
+static const sert_ops_t *i_ops = NULL;
+                                     /* Transport of the open port           */
+
+static bool i_timing = false;        /* Are the phases being timed           */
+
+static seru_phase_time_t i_phases[SERU_PHASES];
+                                     /* Time spent in each phase             */
+
 
 /* Table to hold baud rate data */
 
@@ -805,7 +820,7 @@ static int i_get_port_attribs(struct seru_port_setup_t *setup,
 
 
   /* Get the current options for the port */
-  getattr_return = tcgetattr(setup->fd, options);
+  getattr_return = i_ops->get_config(setup->fd, options);
 
   /* Was tcgetattr successful? */
   if(getattr_return == SERU_PORT_FAILURE)
@@ -937,7 +952,8 @@ static void i_set_port_options(struct seru_port_setup_t *setup,
   i_set_port_c_cc(options->c_cc);
 
   /* Set the new options for the port */
-  tcsetattr_return = tcsetattr(setup->fd, TCSANOW, options);
+  tcsetattr_return = i_ops->configure(setup->fd, options);
+
   /* Warning - success returned if any set attributes were successful  */
   /* Check that attributes have been set with a tcgetattr              */
 
@@ -977,7 +993,7 @@ static void i_set_low_latency(struct seru_port_setup_t *setup)
   {
 
     /* Set low latency. First get exising flags */ 
-    ioctl_return = ioctl (setup->fd, TIOCGSERIAL, &ioctlflags);
+    ioctl_return = i_ops->control(setup->fd, TIOCGSERIAL, &ioctlflags);
 
     /* Did the flag fetch go well? */
     if(ioctl_return == SERU_PORT_FAILURE)
@@ -998,7 +1014,7 @@ static void i_set_low_latency(struct seru_port_setup_t *setup)
 
 
       /* Write the flag */
-      ioctl_return = ioctl (setup->fd, TIOCSSERIAL, &ioctlflags);
+      ioctl_return = i_ops->control(setup->fd, TIOCSSERIAL, &ioctlflags);
 
       /* Did the flag write go well? */
       if(ioctl_return == SERU_PORT_FAILURE)
@@ -1185,7 +1201,7 @@ extern seru_baud_str_status_t seru_get_baud_str(speed_t baud,
 /*                                                                           */
 /* Internal functions used:                                                  */
 /*                                                                           */
-/* Internal variables used:                                                  */
+/* Internal variables used: i_ops                                            */
 /*                                                                           */
 /* Parameters:                                                               */
 /*   Name            Type               Comments                             */
@@ -1201,10 +1217,15 @@ extern void seru_flush_port(struct seru_port_flush_t *flush)
 
   int tcflush_return = SERU_PORT_SUCCESS; /* Return value from tcflush */
   int flush_result = SERU_FLUSH_OK;       /* Result of flush to return */
+  seru_phase_mark_t mark;                 /* Start of the flush        */
 
 
   /* Flush all input and output */
-  tcflush_return =  tcflush(flush->fd, TCIOFLUSH);
+  seru_phase_start(&mark);
+
+  tcflush_return = i_ops->flush(flush->fd);
+
+  seru_phase_end(SERU_PHASE_FLUSH, &mark);
 
   if(tcflush_return == SERU_PORT_FAILURE)
   {
@@ -1218,6 +1239,8 @@ extern void seru_flush_port(struct seru_port_flush_t *flush)
 
   flush->status = flush_result;
 
+  SERD_PROBE2(port_flush, flush->fd, flush_result);
+
 }
 
 
@@ -1299,7 +1322,7 @@ extern void seru_set_port_config(struct seru_port_setup_t *setup)
 /*                                                                           */
 /* Internal functions used:                                                  */
 /*                                                                           */
-/* Internal variables used: i_saved_options                                  */
+/* Internal variables used: i_saved_options, i_ops                           */
 /*                                                                           */
 /* Parameters:                                                               */
 /*   Name                Type                 Comments                       */
@@ -1318,8 +1341,9 @@ extern int seru_restore_port_state(seru_restore_port_t *restore_port_params)
 
 
   /* Restore the options for the port */
-  tcsetattr_return = tcsetattr(restore_port_params->fd, TCSANOW,
+  tcsetattr_return = i_ops->configure(restore_port_params->fd,
     &i_saved_options);
+
   /* Warning - success returned if any set attributes were successful  */
   /* Check that attributes have been set with a tcgetattr              */
 
@@ -1339,7 +1363,7 @@ extern int seru_restore_port_state(seru_restore_port_t *restore_port_params)
 /*                                                                           */
 /* Internal functions used:                                                  */
 /*                                                                           */
-/* Internal variables used: i_saved_options                                  */
+/* Internal variables used: i_saved_options, i_ops                           */
 /*                                                                           */
 /* Parameters:                                                               */
 /*   Name             Type              Comments                             */
@@ -1358,7 +1382,8 @@ extern int seru_save_port_state(seru_save_port_t *save_port_params)
 
 
   /* Get the current options for the port */
-  getattr_return = tcgetattr(save_port_params->fd, &i_saved_options);
+  getattr_return = i_ops->get_config(save_port_params->fd,
+    &i_saved_options);
 
   /* Report errno, even if an error may not have occurred */
   save_port_params->save_errno = errno;
@@ -1372,7 +1397,8 @@ extern int seru_save_port_state(seru_save_port_t *save_port_params)
 /*                                                                           */
 /* Name: seru_lock_port()                                                    */
 /*                                                                           */
-/* Description: Locks a serial port                                          */
+/* Description: Locks a serial port. A port with no device node, such as    */
+/*              the memory loopback or one over TCP, needs no lock.          */
 /*                                                                           */
 /* Internal functions used:                                                  */
 /*   i_get_lock_file_name()                                                  */
@@ -1400,43 +1426,55 @@ extern seru_lock_status_t seru_lock_port(char *serial_port)
   seru_lock_status_t locked_status;     /* The final lock state      */
 
 
-  /* Get the name of the lock file */
-  i_get_lock_file_name(serial_port, lock_file_name);
-
-  i_get_lock_name(lock_file_name, lock_file);
+  /* Only a port with a device node can be shared with other programs */
+  if(sert_find(serial_port)->device == false)
+  {
 
-  /* Is the file already locked */
-  port_state = i_check_for_lock(lock_file);
+    locked_status = SERU_LOCK_OK;
 
-  if(port_state == i_UNLOCKED)
+  }
+  else
   {
 
-    /* Not already locked, so lock the port */
-    port_state = i_create_lock_file(lock_file);
+    /* Get the name of the lock file */
+    i_get_lock_file_name(serial_port, lock_file_name);
+
+    i_get_lock_name(lock_file_name, lock_file);
+
+    /* Is the file already locked */
+    port_state = i_check_for_lock(lock_file);
 
-    /* Did wesuccessfullyy create the lock file? */
     if(port_state == i_UNLOCKED)
     {
 
-      /* Failed to lock the port */ 
-      locked_status = SERU_LOCK_FAIL;
+      /* Not already locked, so lock the port */
+      port_state = i_create_lock_file(lock_file);
+
+      /* Did wesuccessfullyy create the lock file? */
+      if(port_state == i_UNLOCKED)
+      {
+
+        /* Failed to lock the port */ 
+        locked_status = SERU_LOCK_FAIL;
+
+      }
+      else
+      {
+
+        /* Success locking the port */ 
+        locked_status = SERU_LOCK_OK;
+
+      }
 
     }
     else
     {
 
-      /* Success locking the port */ 
-      locked_status = SERU_LOCK_OK;
+      /* The port is already locked*/ 
+      locked_status = SERU_LOCKED;
 
     }
 
-  }
-  else
-  {
-
-    /* The port is already locked*/ 
-    locked_status = SERU_LOCKED;
-
   }
 
   return locked_status;
@@ -1472,13 +1510,19 @@ extern void seru_unlock_port(char *serial_port)
   char lock_file[FILENAME_MAX];         /* The lock file name        */
 
 
-  /* Get the name of the lock file */
-  i_get_lock_file_name(serial_port, lock_file_name);
+  /* Only a port with a device node was locked */
+  if(sert_find(serial_port)->device == true)
+  {
+
+    /* Get the name of the lock file */
+    i_get_lock_file_name(serial_port, lock_file_name);
 
-  i_get_lock_name(lock_file_name, lock_file);
+    i_get_lock_name(lock_file_name, lock_file);
 
-  /* Remove lock file, discard result, as if it fails, what can we do? */
-  (void) remove(lock_file);
+    /* Remove lock file, discard result, as if it fails, what can we do? */
+    (void) remove(lock_file);
+
+  }
 
 }
 
@@ -1487,11 +1531,12 @@ extern void seru_unlock_port(char *serial_port)
 /*                                                                           */
 /* Name: seru_open_port()                                                    */
 /*                                                                           */
-/* Description: Opens serial port. Wrapper function for open()               */
+/* Description: Opens serial port, through the transport its name picks:     */
+/*              the memory loopback, a pseudo terminal or a tty              */
 /*                                                                           */
 /* Internal functions used:                                                  */
 /*                                                                           */
-/* Internal variables used:                                                  */
+/* Internal variables used: i_ops                                            */
 /*                                                                           */
 /* Parameters:                                                               */
 /*   Name           Type              Comments                               */
@@ -1517,8 +1562,11 @@ extern void seru_open_port(char *serial_port, seru_port_open_t *open_params)
   /* Clear errno  */
   open_params->open_errno = 0;
 
+  /* Find how the port is reached */
+  i_ops = sert_find(serial_port);
+
   /* Try opening given serial port, initially non-blocking */
-  fd = open(serial_port, O_RDWR | O_NOCTTY | O_SYNC | O_NONBLOCK);
+  fd = i_ops->open(serial_port);
 
   if(fd == SERU_PORT_FAILURE)
   {
@@ -1534,14 +1582,14 @@ extern void seru_open_port(char *serial_port, seru_port_open_t *open_params)
   {
 
     /* Get the current flags */
-    oldflags = fcntl(fd, F_GETFL, 0);
+    oldflags = i_ops->get_flags(fd);
 
     /* Did we get the flags successfully? */
     if(oldflags != SERU_PORT_FAILURE)
     {
 
       /* clear O_NONBLOCK to allow read() and write() to block */
-      fcntl_return = fcntl(fd, F_SETFL, oldflags & ~O_NONBLOCK);
+      fcntl_return = i_ops->set_flags(fd, oldflags & ~O_NONBLOCK);
 
       if(fcntl_return == SERU_PORT_FAILURE)
       {
@@ -1596,7 +1644,7 @@ extern void seru_open_port(char *serial_port, seru_port_open_t *open_params)
 /*                                                                           */
 /* Internal functions used:                                                  */
 /*                                                                           */
-/* Internal variables used:                                                  */
+/* Internal variables used: i_ops                                            */
 /*                                                                           */
 /* Parameters:                                                               */
 /*   Name           Type                Comments                             */
@@ -1620,7 +1668,7 @@ extern void seru_close_port(seru_port_close_t *close_params)
   close_params->close_errno = 0;
 
   /* Close the port */
-  close_status = close(close_params->fd);
+  close_status = i_ops->close(close_params->fd);
 
   if(close_status == SERU_PORT_FAILURE)
   {
@@ -1651,7 +1699,7 @@ extern void seru_close_port(seru_port_close_t *close_params)
 /*                                                                           */
 /* Internal functions used:                                                  */
 /*                                                                           */
-/* Internal variables used:                                                  */
+/* Internal variables used: i_ops                                            */
 /*                                                                           */
 /* Parameters:                                                               */
 /*   Name         Type              Comments                                 */
@@ -1675,7 +1723,8 @@ extern void seru_get_lines(seru_get_lines_t *get_lines)
   get_lines->get_errno = 0;
 
   /* Get the control lines */
-  ioctl_return = ioctl(get_lines->fd, TIOCMGET, &(get_lines->lines) );
+  ioctl_return = i_ops->control(get_lines->fd, TIOCMGET,
+    &(get_lines->lines) );
 
   /* Did things go badly? */
   if(ioctl_return == SERU_PORT_FAILURE)
@@ -1705,7 +1754,7 @@ extern void seru_get_lines(seru_get_lines_t *get_lines)
 /*                                                                           */
 /* Internal functions used:                                                  */
 /*                                                                           */
-/* Internal variables used:                                                  */
+/* Internal variables used: i_ops                                            */
 /*                                                                           */
 /* Parameters:                                                               */
 /*   Name         Type              Comments                                 */
@@ -1729,7 +1778,8 @@ extern void seru_set_lines(seru_set_lines_t *set_lines)
   set_lines->set_errno = 0;
 
   /* Set the control lines */
-  ioctl_return = ioctl(set_lines->fd, TIOCMSET, &(set_lines->lines) );
+  ioctl_return = i_ops->control(set_lines->fd, TIOCMSET,
+    &(set_lines->lines) );
 
   /* Did things go badly? */
   if(ioctl_return == SERU_PORT_FAILURE)
@@ -1872,7 +1922,7 @@ extern void seru_set_dtr_rts(seru_set_dtr_rts_t *set_dtr_rts)
 /*                                                                           */
 /* Internal functions used:                                                  */
 /*                                                                           */
-/* Internal variables used:                                                  */
+/* Internal variables used: i_ops                                            */
 /*                                                                           */
 /* Parameters:                                                               */
 /*   Name           Type            Comments                                 */
@@ -1894,11 +1944,15 @@ extern void seru_read_port_raw(seru_rx_buf_t *rx_buf)
   unsigned char read_buf[i_RX_BUF_SIZE];
                              /* Receive buffer                            */
   int gettimeofday_return;   /* Go on, guess                              */
+  seru_phase_mark_t mark;    /* Start of the read, then of the clock      */
 
 
   /* Reset status */
   rx_buf->rx_status = SERU_READ_INIT;
 
+  /* Clear the byte, so a failed read doesn't leave one from before */
+  rx_buf->rx_byte = 0;
+
   /* Clear errno */
   rx_buf->rx_errno = 0;
 
@@ -1911,11 +1965,18 @@ extern void seru_read_port_raw(seru_rx_buf_t *rx_buf)
   rx_buf->rx_time.tv_usec = 0;
 
   /* Read from serial port */
-  read_return = read(rx_buf->fd, read_buf, 1);
+  seru_phase_start(&mark);
+
+  read_return = i_ops->read(rx_buf->fd, read_buf, 1);
+
+  seru_phase_end(SERU_PHASE_READ, &mark);
 
   /* Get current time */
+  seru_phase_start(&mark);
 
-  gettimeofday_return = gettimeofday( &(rx_buf->rx_time), NULL);
+  gettimeofday_return = i_ops->now( &(rx_buf->rx_time));
+
+  seru_phase_end(SERU_PHASE_CLOCK, &mark);
 
   if( (gettimeofday_return == SERU_TIME_FAILURE) || 
     (  rx_buf->rx_time.tv_sec == SERU_TIME_FAILURE) )
@@ -1962,6 +2023,9 @@ extern void seru_read_port_raw(seru_rx_buf_t *rx_buf)
 
   }
 
+  SERD_PROBE5(port_read, rx_buf->fd, rx_buf->rx_byte, rx_buf->rx_status,
+    rx_buf->rx_time.tv_sec, rx_buf->rx_time.tv_usec);
+
 }
 
 
@@ -2087,7 +2151,7 @@ extern void seru_read_port(seru_rx_buf_t *rx_buf)
 /*                                                                           */
 /* Internal functions used:                                                  */
 /*                                                                           */
-/* Internal variables used:                                                  */
+/* Internal variables used: i_ops                                            */
 /*                                                                           */
 /* Parameters:                                                               */
 /*   Name            Type            Comments                                */
@@ -2101,9 +2165,9 @@ extern void seru_read_port(seru_rx_buf_t *rx_buf)
 extern void seru_wait_for_read(seru_rx_wait_t *rx_wait)
 {
 
-  fd_set read_set;                      /* Parameters for select()    */
   struct timeval timeout;               /* Timeout parameters         */
   int select_return;                    /* Return value from select() */
+  seru_phase_mark_t mark;               /* Start of the wait          */
 
 
   /* Reset status */
@@ -2112,19 +2176,17 @@ extern void seru_wait_for_read(seru_rx_wait_t *rx_wait)
   /* Clear errno  */
   rx_wait->rx_wait_errno = 0;
 
-  /* Clear the read fd set */
-  FD_ZERO(&read_set);
-
-  /* Put the required fd in the read fd set */
-  FD_SET(rx_wait->fd, &read_set);
-
   /* Set the timeout, secs and microsecs */
   timeout.tv_sec = 0;
 
   timeout.tv_usec = rx_wait->read_timeout;
 
   /* Wait until we are ready to read, or timeout */
-  select_return = select( (rx_wait->fd + 1), &read_set, NULL, NULL, &timeout);
+  seru_phase_start(&mark);
+
+  select_return = i_ops->wait(rx_wait->fd, false, &timeout);
+
+  seru_phase_end(SERU_PHASE_WAIT_READ, &mark);
 
   if(select_return == SERU_PORT_FAILURE)
   {
@@ -2155,6 +2217,9 @@ extern void seru_wait_for_read(seru_rx_wait_t *rx_wait)
 
   }
 
+  SERD_PROBE3(port_wait_read, rx_wait->fd, rx_wait->read_timeout,
+    rx_wait->rx_wait_status);
+
 }
 
 
@@ -2166,7 +2231,7 @@ extern void seru_wait_for_read(seru_rx_wait_t *rx_wait)
 /*                                                                           */
 /* Internal functions used:                                                  */
 /*                                                                           */
-/* Internal variables used:                                                  */
+/* Internal variables used: i_ops                                            */
 /*                                                                           */
 /* Parameters:                                                               */
 /*   Name            Type            Comments                                */
@@ -2184,6 +2249,7 @@ extern void seru_write_port(seru_tx_buf_t *tx_buf)
   ssize_t write_return;     /* Value returned by a write to serial port */
   int gettimeofday_return;  /* The value returning after calling the    */
                             /* gettimeofday function                    */
+  seru_phase_mark_t mark;   /* Start of the write, then of the clock    */
 
 
   /* Reset status */
@@ -2201,10 +2267,18 @@ extern void seru_write_port(seru_tx_buf_t *tx_buf)
   tx_buf->tx_time.tv_usec = 0;
 
   /* Write byte to serial port */
-  write_return = write(tx_buf->fd, &(tx_buf->tx_byte), 1);
+  seru_phase_start(&mark);
+
+  write_return = i_ops->write(tx_buf->fd, &(tx_buf->tx_byte), 1);
+
+  seru_phase_end(SERU_PHASE_WRITE, &mark);
 
   /* Get current time */
-  gettimeofday_return = gettimeofday( &(tx_buf->tx_time), NULL);
+  seru_phase_start(&mark);
+
+  gettimeofday_return = i_ops->now( &(tx_buf->tx_time));
+
+  seru_phase_end(SERU_PHASE_CLOCK, &mark);
 
   if( (gettimeofday_return == SERU_TIME_FAILURE) || 
     (  tx_buf->tx_time.tv_sec == SERU_TIME_FAILURE) )
@@ -2240,6 +2314,9 @@ extern void seru_write_port(seru_tx_buf_t *tx_buf)
 
   }
 
+  SERD_PROBE5(port_write, tx_buf->fd, tx_buf->tx_byte, tx_buf->tx_status,
+    tx_buf->tx_time.tv_sec, tx_buf->tx_time.tv_usec);
+
 }
 
 
@@ -2251,7 +2328,7 @@ extern void seru_write_port(seru_tx_buf_t *tx_buf)
 /*                                                                           */
 /* Internal functions used:                                                  */
 /*                                                                           */
-/* Internal variables used:                                                  */
+/* Internal variables used: i_ops                                            */
 /*                                                                           */
 /* Parameters:                                                               */
 /*   Name            Type            Comments                                */
@@ -2265,9 +2342,9 @@ extern void seru_write_port(seru_tx_buf_t *tx_buf)
 extern void seru_wait_for_write(seru_tx_wait_t *tx_wait)
 {
 
-  fd_set write_set;                     /* Parameters for select()    */
   struct timeval timeout;               /* Timeout parameters         */
   int select_return;                    /* Return value from select() */
+  seru_phase_mark_t mark;               /* Start of the wait          */
 
 
   /* Reset status */
@@ -2276,19 +2353,17 @@ extern void seru_wait_for_write(seru_tx_wait_t *tx_wait)
   /* Clear errno  */
   tx_wait->tx_wait_errno = 0;
 
-  /* Clear the write fd set */
-  FD_ZERO(&write_set);
-
-  /* Put the required fd in the write fd set */
-  FD_SET(tx_wait->fd, &write_set);
-
   /* Set the timeout, secs and microsecs */
   timeout.tv_sec = 0;
 
   timeout.tv_usec = tx_wait->write_timeout;
 
   /* Wait until we are ready to write, or timeout */
-  select_return = select( (tx_wait->fd + 1), NULL, &write_set, NULL, &timeout);
+  seru_phase_start(&mark);
+
+  select_return = i_ops->wait(tx_wait->fd, true, &timeout);
+
+  seru_phase_end(SERU_PHASE_WAIT_WRITE, &mark);
 
   if(select_return == SERU_PORT_FAILURE)
   {
@@ -2319,4 +2394,254 @@ extern void seru_wait_for_write(seru_tx_wait_t *tx_wait)
 
   }
 
+  SERD_PROBE3(port_wait_write, tx_wait->fd, tx_wait->write_timeout,
+    tx_wait->tx_wait_status);
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: seru_get_syscalls()                                                 */
+/*                                                                           */
+/* Description: Gets the number of system calls made on ports so far         */
+/*                                                                           */
+/* Internal functions used:                                                  */
+/*                                                                           */
+/* Internal variables used:                                                  */
+/*                                                                           */
+/* Parameters: void                                                          */
+/*                                                                           */
+/* Returns: The system calls made                                            */
+/*                                                                           */
+/*****************************************************************************/
+
+extern unsigned long long seru_get_syscalls(void)
+{
+
+  return sert_get_syscalls();
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: seru_get_time()                                                     */
+/*                                                                           */
+/* Description: Gets the time on the open port's clock, which is virtual     */
+/*              for the simulated line, or the time of day                   */
+/*                                                                           */
+/* Internal functions used:                                                  */
+/*                                                                           */
+/* Internal variables used: i_ops                                            */
+/*                                                                           */
+/* Parameters: time - Where to put the time                                  */
+/*                                                                           */
+/* Returns: 0, or SERU_TIME_FAILURE                                          */
+/*                                                                           */
+/*****************************************************************************/
+
+extern int seru_get_time(struct timeval *time)
+{
+
+  const sert_ops_t *ops;   /* The port's transport, or a tty's */
+  seru_phase_mark_t mark;  /* Start of reading the clock       */
+  int now_return;          /* Value returned by the clock      */
+
+
+  ops = (i_ops != NULL) ? i_ops : sert_find("");
+
+  seru_phase_start(&mark);
+
+  now_return = ops->now(time);
+
+  seru_phase_end(SERU_PHASE_CLOCK, &mark);
+
+  return now_return;
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: seru_sleep()                                                        */
+/*                                                                           */
+/* Description: Sleeps on the open port's clock, which only moves the        */
+/*              virtual clock on for the simulated line                      */
+/*                                                                           */
+/* Internal functions used:                                                  */
+/*                                                                           */
+/* Internal variables used: i_ops                                            */
+/*                                                                           */
+/* Parameters: time - The time to sleep, left with any not slept             */
+/*                                                                           */
+/* Returns: 0, or SERU_TIME_FAILURE if interrupted                           */
+/*                                                                           */
+/*****************************************************************************/
+
+extern int seru_sleep(struct timespec *time)
+{
+
+  const sert_ops_t *ops;   /* The port's transport, or a tty's */
+
+
+  ops = (i_ops != NULL) ? i_ops : sert_find("");
+
+  return ops->sleep(time);
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: seru_set_timing()                                                   */
+/*                                                                           */
+/* Description: Turns timing the phases of each byte on or off, clearing     */
+/*              the times so far. Off, marking a phase costs only a test.    */
+/*                                                                           */
+/* Internal functions used:                                                  */
+/*                                                                           */
+/* Internal variables used: i_timing, i_phases                               */
+/*                                                                           */
+/* Parameters: timing - true to time the phases                              */
+/*                                                                           */
+/* Returns: void                                                             */
+/*                                                                           */
+/*****************************************************************************/
+
+extern void seru_set_timing(bool timing)
+{
+
+  i_timing = timing;
+
+  memset(i_phases, 0, sizeof(i_phases) );
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: seru_phase_start()                                                  */
+/*                                                                           */
+/* Description: Marks the monotonic time and port system calls made at the   */
+/*              start of a phase, if timing                                  */
+/*                                                                           */
+/* Internal functions used:                                                  */
+/*                                                                           */
+/* Internal variables used: i_timing                                         */
+/*                                                                           */
+/* Parameters: mark - Where to mark the start                                */
+/*                                                                           */
+/* Returns: void                                                             */
+/*                                                                           */
+/*****************************************************************************/
+
+extern void seru_phase_start(seru_phase_mark_t *mark)
+{
+
+  struct timespec now;     /* The monotonic time */
+
+
+  if(i_timing == true)
+  {
+
+    now.tv_sec = 0;
+
+    now.tv_nsec = 0;
+
+    (void) clock_gettime(CLOCK_MONOTONIC, &now);
+
+    mark->ns = ( (long long) now.tv_sec * i_NSEC_IN_SEC) + now.tv_nsec;
+
+    mark->syscalls = sert_get_syscalls();
+
+  }
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: seru_phase_end()                                                    */
+/*                                                                           */
+/* Description: Adds the time and port system calls since a phase was        */
+/*              marked to it, if timing                                      */
+/*                                                                           */
+/* Internal functions used:                                                  */
+/*                                                                           */
+/* Internal variables used: i_timing, i_phases                               */
+/*                                                                           */
+/* Parameters: phase - The phase ending                                      */
+/*             mark - Where it started, from seru_phase_start()              */
+/*                                                                           */
+/* Returns: void                                                             */
+/*                                                                           */
+/*****************************************************************************/
+
+extern void seru_phase_end(seru_phase_t phase, const seru_phase_mark_t *mark)
+{
+
+  struct timespec now;     /* The monotonic time    */
+  long long taken;         /* Time in the phase, ns */
+
+
+  if(i_timing == true)
+  {
+
+    now.tv_sec = 0;
+
+    now.tv_nsec = 0;
+
+    (void) clock_gettime(CLOCK_MONOTONIC, &now);
+
+    taken = ( (long long) now.tv_sec * i_NSEC_IN_SEC) + now.tv_nsec
+      - mark->ns;
+
+    /* The clock can't go back, but don't count it if it seems to */
+    if(taken < 0)
+    {
+
+      taken = 0;
+
+    }
+
+    i_phases[phase].calls++;
+
+    i_phases[phase].syscalls += sert_get_syscalls() - mark->syscalls;
+
+    i_phases[phase].total_ns += (unsigned long long) taken;
+
+    if( (unsigned long long) taken > i_phases[phase].max_ns)
+    {
+
+      i_phases[phase].max_ns = (unsigned long long) taken;
+
+    }
+
+  }
+
+}
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: seru_get_phases()                                                   */
+/*                                                                           */
+/* Description: Gets the time spent in each phase so far                     */
+/*                                                                           */
+/* Internal functions used:                                                  */
+/*                                                                           */
+/* Internal variables used: i_phases                                         */
+/*                                                                           */
+/* Parameters: phases - Where to put the SERU_PHASES times                   */
+/*                                                                           */
+/* Returns: void                                                             */
+/*                                                                           */
+/*****************************************************************************/
+
+extern void seru_get_phases(seru_phase_time_t *phases)
+{
+
+  memcpy(phases, i_phases, sizeof(i_phases) );
+
 }
@@ -37,6 +37,7 @@
 #include <sys/time.h>    /* Standard time definitions - timeval            */
 #include <sys/ioctl.h>   /* ioctl() stuff                                  */
 #include <stdbool.h>     /* Boolean types                                  */
+#include "sert.h"        /* Serial transports - SERT_MEMORY_PORT           */
 
 /*****************************************************************************/
 /*      MACRO DEFINITIONS                                                    */
@@ -60,6 +61,12 @@
 
 #define SERU_GET_BAUD_FAIL UINT_MAX  /* Failure to get a baud rate indicator */
 
+#define SERU_MEMORY_PORT SERT_MEMORY_PORT
+                                     /* Port name of the memory loopback     */
+
+#define SERU_SIM_PORT SERT_SIM_PORT
+                                     /* Port name of the simulated line      */
+
 enum { SERU_PORT_FAILURE = -1 };     /* Serial port access failure indicator */
 
 enum { SERU_PORT_SUCCESS = 0 };      /* Serial port access success indicator */
@@ -369,6 +376,35 @@ typedef struct seru_tx_wait_t
   int tx_wait_errno;                    /* errno on tx wait fail         */
 } seru_tx_wait_t;
 
+/* Type for the phases of sending and receiving a byte that can be timed */
+typedef enum seru_phase_t
+{
+  SERU_PHASE_WAIT_WRITE, /* Waiting until the port can be written */
+  SERU_PHASE_WRITE,      /* Writing a byte                        */
+  SERU_PHASE_WAIT_READ,  /* Waiting until a byte can be read      */
+  SERU_PHASE_READ,       /* Reading a byte, or part of a marker   */
+  SERU_PHASE_FLUSH,      /* Flushing the port                     */
+  SERU_PHASE_CLOCK,      /* Reading the port's clock              */
+  SERU_PHASE_KEYS,       /* Checking the keyboard                 */
+  SERU_PHASES            /* Number of phases                      */
+} seru_phase_t;
+
+/* Type for the time spent in a phase */
+typedef struct seru_phase_time_t
+{
+  unsigned long long calls;    /* Times the phase was gone through    */
+  unsigned long long syscalls; /* Port system calls made in it        */
+  unsigned long long total_ns; /* Time spent in it, in ns             */
+  unsigned long long max_ns;   /* Longest time spent in it at once    */
+} seru_phase_time_t;
+
+/* Type for where a phase started */
+typedef struct seru_phase_mark_t
+{
+  long long ns;                /* Monotonic time it started, in ns    */
+  unsigned long long syscalls; /* Port system calls made by then      */
+} seru_phase_mark_t;
+
 
 /*****************************************************************************/
 /*      GLOBAL VARIABLES                                                     */
@@ -583,7 +619,8 @@ extern void seru_unlock_port(char *serial_port);
 /*                                                                           */
 /* Name: seru_open_port()                                                    */
 /*                                                                           */
-/* Description: Opens serial port. Wrapper function for open()               */
+/* Description: Opens serial port, through the transport its name picks:     */
+/*              the memory loopback, a pseudo terminal or a tty              */
 /*                                                                           */
 /* Parameters                                                                */
 /*   Name           Type              Comments                               */
@@ -801,5 +838,139 @@ extern void seru_write_port(seru_tx_buf_t *tx_buf);
 extern void seru_wait_for_write(seru_tx_wait_t *tx_wait);
 
 
+/*****************************************************************************/
+/*                                                                           */
+/* Name: seru_get_syscalls()                                                 */
+/*                                                                           */
+/* Description: Gets the number of system calls made on ports so far         */
+/*                                                                           */
+/* Parameters: void                                                          */
+/*                                                                           */
+/* Returns: The system calls made                                            */
+/*                                                                           */
+/* Pre-conditions:                                                           */
+/*                                                                           */
+/* Post-conditions:                                                          */
+/*                                                                           */
+/*****************************************************************************/
+
+extern unsigned long long seru_get_syscalls(void);
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: seru_get_time()                                                     */
+/*                                                                           */
+/* Description: Gets the time on the open port's clock                       */
+/*                                                                           */
+/* Parameters: time - Where to put the time                                  */
+/*                                                                           */
+/* Returns: 0, or SERU_TIME_FAILURE                                          */
+/*                                                                           */
+/* Pre-conditions:                                                           */
+/*                                                                           */
+/* Post-conditions: Virtual time for the simulated line, else time of day    */
+/*                                                                           */
+/*****************************************************************************/
+
+extern int seru_get_time(struct timeval *time);
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: seru_sleep()                                                        */
+/*                                                                           */
+/* Description: Sleeps on the open port's clock                              */
+/*                                                                           */
+/* Parameters: time - The time to sleep, left with any not slept             */
+/*                                                                           */
+/* Returns: 0, or SERU_TIME_FAILURE if interrupted                           */
+/*                                                                           */
+/* Pre-conditions:                                                           */
+/*                                                                           */
+/* Post-conditions: The simulated line's virtual clock moves on at once      */
+/*                                                                           */
+/*****************************************************************************/
+
+extern int seru_sleep(struct timespec *time);
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: seru_set_timing()                                                   */
+/*                                                                           */
+/* Description: Turns timing the phases of each byte on or off               */
+/*                                                                           */
+/* Parameters: timing - true to time the phases                              */
+/*                                                                           */
+/* Returns: void                                                             */
+/*                                                                           */
+/* Pre-conditions:                                                           */
+/*                                                                           */
+/* Post-conditions: The times so far are cleared                             */
+/*                                                                           */
+/*****************************************************************************/
+
+extern void seru_set_timing(bool timing);
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: seru_phase_start()                                                  */
+/*                                                                           */
+/* Description: Marks the start of a phase, if timing                        */
+/*                                                                           */
+/* Parameters: mark - Where to mark the start                                */
+/*                                                                           */
+/* Returns: void                                                             */
+/*                                                                           */
+/* Pre-conditions:                                                           */
+/*                                                                           */
+/* Post-conditions:                                                          */
+/*                                                                           */
+/*****************************************************************************/
+
+extern void seru_phase_start(seru_phase_mark_t *mark);
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: seru_phase_end()                                                    */
+/*                                                                           */
+/* Description: Adds the time since a phase was marked to it, if timing      */
+/*                                                                           */
+/* Parameters: phase - The phase ending                                      */
+/*             mark - Where it started, from seru_phase_start()              */
+/*                                                                           */
+/* Returns: void                                                             */
+/*                                                                           */
+/* Pre-conditions:                                                           */
+/*                                                                           */
+/* Post-conditions:                                                          */
+/*                                                                           */
+/*****************************************************************************/
+
+extern void seru_phase_end(seru_phase_t phase, const seru_phase_mark_t *mark);
+
+
+/*****************************************************************************/
+/*                                                                           */
+/* Name: seru_get_phases()                                                   */
+/*                                                                           */
+/* Description: Gets the time spent in each phase so far                     */
+/*                                                                           */
+/* Parameters: phases - Where to put the SERU_PHASES times                   */
+/*                                                                           */
+/* Returns: void                                                             */
+/*                                                                           */
+/* Pre-conditions:                                                           */
+/*                                                                           */
+/* Post-conditions:                                                          */
+/*                                                                           */
+/*****************************************************************************/
+
+extern void seru_get_phases(seru_phase_time_t *phases);
+
+
 #endif /* SERU_H */
 